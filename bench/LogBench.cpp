@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// 日志热路径微基准：对比异步文本日志（LOG_INFO拼接字符串）与结构化二进制日志（LOGF_INFO）
+// 每次调用在调用线程上的耗时；单核机器上后台写入线程会与调用线程分时运行，结果包含其一部分开销
+#include "../include/util/BinaryLogger.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+template<typename Func>
+double measureNs(size_t operations, Func&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(operations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    std::string logDir = (std::filesystem::temp_directory_path() / "course_log_bench").string();
+    std::filesystem::remove_all(logDir);
+
+    Logger& logger = Logger::getInstance();
+    if (!logger.initialize(logDir, LogLevel::INFO)
+        || !logger.startAsync(AsyncLogOptions{count + 16, LogOverflowPolicy::BLOCK})) {
+        std::cerr << "日志初始化失败: " << logDir << std::endl;
+        return 1;
+    }
+    BinaryLogOptions binaryOptions;
+    binaryOptions.threadBufferSize = count * 64;
+    if (!BinaryLogger::getInstance().open(logDir, binaryOptions)) {
+        std::cerr << "二进制日志打开失败: " << logDir << std::endl;
+        return 1;
+    }
+
+    std::string studentId = "student001";
+    std::string courseId = "CS101";
+    double textNs = measureNs(count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            LOG_INFO("选课成功：学生 " + studentId + " 选择课程 " + courseId + "，序号 " + std::to_string(i));
+        }
+    });
+    logger.flush(); // 单核机器上后台线程与调用线程分时运行，先写完文本日志再测下一项
+
+    // 第一轮触及线程缓冲区的全部页面，第二轮计时
+    double binaryNs = 0;
+    for (int round = 0; round < 2; ++round) {
+        binaryNs = measureNs(count, [&] {
+            for (size_t i = 0; i < count; ++i) {
+                LOGF_INFO("选课成功：学生 {} 选择课程 {}，序号 {}", studentId, courseId, i);
+            }
+        });
+        BinaryLogger::getInstance().flush();
+    }
+    double disabledNs = measureNs(count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            LOGF_DEBUG("未启用的级别：学生 {} 选择课程 {}，序号 {}", studentId, courseId, i);
+        }
+    });
+
+    BinaryLogger::getInstance().close();
+    logger.stopAsync();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "日志条数: " << count << std::endl;
+    std::cout << "LOG_INFO(异步文本): " << textNs << " ns/条" << std::endl;
+    std::cout << "LOGF_INFO(二进制): " << binaryNs << " ns/条，丢弃 "
+              << BinaryLogger::getInstance().droppedCount() << " 条" << std::endl;
+    std::cout << "LOGF_DEBUG(级别未启用): " << disabledNs << " ns/条" << std::endl;
+    std::cout << "日志目录: " << logDir << std::endl;
+    return 0;
+}
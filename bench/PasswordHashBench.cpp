@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// 密码哈希微基准：对比旧实现（每次新建EVP_MD_CTX、拼接字符串、stringstream转十六进制）
+// 与PasswordHasher（复用上下文、二进制比较）
+#include "../include/util/PasswordHasher.h"
+
+#include <openssl/sha.h>
+#include <openssl/evp.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 旧版User::generatePasswordHash的实现，仅用于对比
+std::string legacyHash(const std::string& password, const std::string& salt) {
+    std::string combined = password + salt;
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    EVP_MD_CTX* mdctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(mdctx, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(mdctx, combined.c_str(), combined.length());
+    unsigned int hashLen = SHA256_DIGEST_LENGTH;
+    EVP_DigestFinal_ex(mdctx, hash, &hashLen);
+    EVP_MD_CTX_free(mdctx);
+
+    std::stringstream ss;
+    for (unsigned char i : hash) {
+        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(i);
+    }
+    return ss.str();
+}
+
+template<typename Func>
+double measureNs(size_t operations, Func&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(operations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+
+    std::vector<std::string> passwords;
+    std::vector<std::string> salts;
+    std::vector<std::string> stored;
+    passwords.reserve(count);
+    salts.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        passwords.push_back("password" + std::to_string(i));
+        salts.push_back("Salt" + std::to_string(i * 7919 % 100000) + "AbCdEfGhIjK");
+    }
+
+    // 校验两种实现结果一致
+    for (size_t i = 0; i < count; ++i) {
+        stored.push_back(legacyHash(passwords[i], salts[i]));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!PasswordHasher::verify(passwords[i], salts[i], stored[i]) ||
+            PasswordHasher::hashHex(passwords[i], salts[i]) != stored[i]) {
+            std::cerr << "结果不一致: " << i << std::endl;
+            return 1;
+        }
+    }
+
+    volatile size_t sink = 0;
+    double legacyNs = measureNs(count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            sink = sink + (legacyHash(passwords[i], salts[i]) == stored[i]);
+        }
+    });
+    double singleNs = measureNs(count, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            sink = sink + PasswordHasher::verify(passwords[i], salts[i], stored[i]);
+        }
+    });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "凭据数量: " << count << std::endl;
+    std::cout << "旧实现(新建上下文+拼接+stringstream): " << legacyNs << " ns/次" << std::endl;
+    std::cout << "PasswordHasher::verify(复用上下文): " << singleNs << " ns/次" << std::endl;
+    return 0;
+}
@@ -18,11 +18,16 @@
 
 #include "../model/Course.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <vector>
 #include <mutex>
 #include <string>
 #include <functional>
+#include "../util/StorageBackend.h"
+
+class SnapshotWriter;
+class SnapshotReader;
 
 class CourseManager {
 public:
@@ -32,10 +37,17 @@ public:
 
     bool removeCourse(const std::string& courseId);
 
-    Course* getCourse(const std::string& courseId);
+    // 课程对象发布后不再修改，修改和同步都以新对象替换；调用方持有的指针保持有效，但不会看到之后的修改
+    std::shared_ptr<const Course> getCourse(const std::string& courseId);
 
+    // 复制当前课程，在副本上应用course的基本信息（不含已选学生）后替换
     bool updateCourseInfo(const Course& course);
 
+    // 以添加或移除一名已选学生后的副本替换课程；课程不存在或学生已在（不在）名单中时返回false
+    bool addStudent(const std::string& courseId, const std::string& studentId);
+
+    bool removeStudent(const std::string& courseId, const std::string& studentId);
+
     std::vector<std::string> getAllCourseIds() const;
 
     // 获取某教师的所有课程ID
@@ -49,15 +61,48 @@ public:
 
     bool loadData();
 
+    // 增量同步其他进程写入的课程：只替换、添加或删除与存储不一致的课程，
+    // 尚未写盘的本地修改保持不变。返回变化的课程数，数据未变化时返回0
+    size_t syncFromStorage();
+
     bool saveData(bool alreadyLocked = false);
 
+    // 只写入指定课程对应的行（课程已删除时删除该行）
+    bool saveRows(const std::vector<std::string>& courseIds);
+
+    // 活动分区中课程的全部学期，按名称升序
+    std::vector<std::string> getSemesters() const;
+
+    // 将学期semester的课程写入归档分区后从内存和活动分区中删除，返回被归档的课程ID
+    std::vector<std::string> archiveSemester(const std::string& semester);
+
+    // 读取已归档学期semester的课程，返回的副本不加入管理器
+    std::vector<std::unique_ptr<Course>> loadArchivedCourses(const std::string& semester) const;
+
+    // 将全部课程写入二进制快照的COURSES和COURSE_STUDENTS段
+    void writeSnapshot(SnapshotWriter& writer) const;
+
+    bool loadSnapshot(const SnapshotReader& reader);
+
 private:
     CourseManager() = default;
     
     CourseManager(const CourseManager&) = delete;
 
     CourseManager& operator=(const CourseManager&) = delete;
+
+    // 课程最近一次与存储同步时的状态，作为写入冲突检查和三方合并的基线
+    struct StoredCourse {
+        uint64_t version = 0;                        // 记录版本
+        std::unordered_set<std::string> students;    // 已选学生
+    };
+
+    static nlohmann::json toJson(const Course& course);
+
+    // 由存储记录构建课程对象，字符串字段从record中移出
+    static std::unique_ptr<Course> fromJson(nlohmann::json& courseJson);
     
-    std::unordered_map<std::string, std::unique_ptr<Course>> courses_; // 课程映射表
+    std::unordered_map<std::string, std::shared_ptr<const Course>> courses_; // 课程映射表（已发布的课程不再修改）
+    std::unordered_map<std::string, StoredCourse> bases_; // 各课程的同步基线
     mutable std::mutex mutex_; // 互斥锁
 }; 
\ No newline at end of file
@@ -25,6 +25,10 @@
 #include <mutex>
 #include <string>
 #include <functional>
+#include "../util/StorageBackend.h"
+
+class SnapshotWriter;
+class SnapshotReader;
 
 class EnrollmentManager {
 public:
@@ -35,20 +39,39 @@ public:
 
     bool dropCourse(const std::string& studentId, const std::string& courseId);
 
-    Enrollment* getEnrollment(const std::string& studentId, const std::string& courseId);
+    // 选课记录发布后不再修改，同步时以新对象替换；调用方持有的指针保持有效
+    std::shared_ptr<const Enrollment> getEnrollment(const std::string& studentId, const std::string& courseId);
 
-    std::vector<Enrollment*> getStudentEnrollments(const std::string& studentId) const; 
+    std::vector<std::shared_ptr<const Enrollment>> getStudentEnrollments(const std::string& studentId) const; 
 
-    std::vector<Enrollment*> getCourseEnrollments(const std::string& courseId) const; 
+    std::vector<std::shared_ptr<const Enrollment>> getCourseEnrollments(const std::string& courseId) const; 
 
     bool isEnrolled(const std::string& studentId, const std::string& courseId) const;
 
-    std::vector<Enrollment*> findEnrollments(const std::function<bool(const Enrollment&)>& predicate) const;
+    std::vector<std::shared_ptr<const Enrollment>> findEnrollments(const std::function<bool(const Enrollment&)>& predicate) const;
 
     bool loadData();
 
+    // 增量同步其他进程写入的选课记录：只添加、删除或更新与存储不一致的记录，
+    // 尚未写盘的本地修改保持不变。返回变化的记录数，数据未变化时返回0
+    size_t syncFromStorage();
+
     bool saveData(bool alreadyLocked = false);
 
+    // 只写入指定键（generateKey格式）对应的行（记录已删除时删除该行）
+    bool saveRows(const std::vector<std::string>& keys);
+
+    // 将课程courseIds（均属于学期semester）的选课记录写入归档分区后从内存和活动分区中删除，返回归档的记录数
+    size_t archiveCourses(const std::string& semester, const std::vector<std::string>& courseIds);
+
+    // 读取已归档学期semester的选课记录，返回的副本不加入管理器
+    std::vector<std::unique_ptr<Enrollment>> loadArchivedEnrollments(const std::string& semester) const;
+
+    // 将全部选课记录写入二进制快照的ENROLLMENTS段
+    void writeSnapshot(SnapshotWriter& writer) const;
+
+    bool loadSnapshot(const SnapshotReader& reader);
+
     bool removeEnrollment(const std::string& studentId, const std::string& courseId);
 
 private:
@@ -62,7 +85,16 @@ private:
     bool addEnrollment(std::unique_ptr<Enrollment> enrollment);
     
     static std::string generateKey(const std::string& studentId, const std::string& courseId);
+
+    // 记录最近一次与存储同步时的版本，未同步过的记录为0；调用方需持有mutex_
+    uint64_t versionOf(const std::string& key) const;
+
+    static nlohmann::json toJson(const Enrollment& enrollment);
+
+    // 由存储记录构建选课记录，字符串字段从record中移出
+    static std::unique_ptr<Enrollment> fromJson(nlohmann::json& enrollmentJson);
     
-    std::unordered_map<std::string, std::unique_ptr<Enrollment>> enrollments_; // 选课记录映射表
+    std::unordered_map<std::string, std::shared_ptr<const Enrollment>> enrollments_; // 选课记录映射表（已发布的记录不再修改）
+    std::unordered_map<std::string, uint64_t> versions_; // 各记录最近一次与存储同步时的版本（写入冲突检查的基线）
     mutable std::mutex mutex_; // 互斥锁
 };
\ No newline at end of file
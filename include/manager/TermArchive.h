@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "../model/Course.h"
+#include "../model/Enrollment.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 一个已归档学期的只读数据
+struct ArchivedTerm {
+    std::string semester;                                  // 学期
+    std::vector<std::unique_ptr<Course>> courses;          // 该学期的课程
+    std::vector<std::unique_ptr<Enrollment>> enrollments;  // 该学期的选课记录
+
+    // 按ID查找课程，不存在时返回nullptr
+    const Course* findCourse(const std::string& courseId) const;
+};
+
+// 学期归档：CourseManager和EnrollmentManager只持有活动学期的数据，
+// 更早的学期移入存储后端的归档分区，查询历史时按学期加载并缓存
+class TermArchive {
+public:
+    static TermArchive& getInstance();
+
+    // 保留最近activeTerms个学期（按学期名排序），更早学期的课程和选课记录移入归档分区；
+    // activeTerms为0时不归档。只在初始化阶段调用，返回归档的学期数
+    size_t archiveOldTerms(size_t activeTerms);
+
+    // 已归档的学期，按名称升序
+    std::vector<std::string> terms() const;
+
+    // 加载学期semester的归档数据，首次访问时从存储读取，之后返回缓存
+    std::shared_ptr<const ArchivedTerm> load(const std::string& semester);
+
+private:
+    TermArchive() = default;
+
+    TermArchive(const TermArchive&) = delete;
+
+    TermArchive& operator=(const TermArchive&) = delete;
+
+    std::map<std::string, std::shared_ptr<const ArchivedTerm>> loaded_; // 已加载的学期
+    mutable std::mutex mutex_; // 保护loaded_
+};
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "../model/User.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// 不可变的用户目录快照
+// 用户按ID哈希分布到固定数量的分桶中，写入时只复制被修改的分桶，其余分桶在新旧版本间共享
+// 持有快照期间，其中的用户对象不会被释放
+class UserDirectory {
+public:
+    static constexpr size_t BUCKET_COUNT = 256; // 分桶数量
+
+    using Bucket = std::unordered_map<std::string, std::shared_ptr<User>>;
+
+    UserDirectory();
+
+    static std::shared_ptr<const UserDirectory> build(std::vector<std::shared_ptr<User>> users, uint64_t version);
+
+    // 返回插入（或替换）一个用户后的新版本，原快照保持不变
+    std::shared_ptr<const UserDirectory> with(std::shared_ptr<User> user) const;
+
+    // 返回删除一个用户后的新版本，用户不存在时返回nullptr
+    std::shared_ptr<const UserDirectory> without(const std::string& userId) const;
+
+    // 返回的指针在目录发布新版本后仍使对象保持有效
+    std::shared_ptr<User> find(const std::string& userId) const;
+
+    std::shared_ptr<Student> findStudent(const std::string& studentId) const;
+
+    std::shared_ptr<Teacher> findTeacher(const std::string& teacherId) const;
+
+    std::shared_ptr<Admin> findAdmin(const std::string& adminId) const;
+
+    bool contains(const std::string& userId) const;
+
+    std::vector<std::string> idsOfType(UserType type) const;
+
+    template<typename Func>
+    void forEach(Func&& func) const {
+        for (const auto& bucket : buckets_) {
+            for (const auto& pair : *bucket) {
+                func(*pair.second);
+            }
+        }
+    }
+
+    size_t size() const { return size_; }
+
+    uint64_t version() const { return version_; }
+
+private:
+    static size_t bucketIndex(const std::string& userId);
+
+    std::array<std::shared_ptr<const Bucket>, BUCKET_COUNT> buckets_; // 分桶（在版本间共享）
+    size_t size_ = 0;        // 用户总数
+    uint64_t version_ = 0;   // 版本号，每次写入递增
+};
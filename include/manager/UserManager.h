@@ -17,12 +17,19 @@
 #pragma once
 
 #include "../model/User.h"
+#include "../system/LoginThrottle.h"
+#include "UserDirectory.h"
+#include "UserProfileCache.h"
 #include <unordered_map>
 #include <memory>
 #include <vector>
 #include <mutex>
 #include <string>
 #include <functional>
+#include "../util/StorageBackend.h"
+
+class SnapshotWriter;
+class SnapshotReader;
 
 class UserManager {
 public:
@@ -42,19 +49,24 @@ public:
     bool removeUser(const std::string& userId);
 
     
-    User* getUser(const std::string& userId);
+    // 用户对象发布后不再修改，修改通过updateUserInfo等接口生成新对象；
+    // 调用方持有的指针保持有效，但不会看到之后的修改
+    std::shared_ptr<User> getUser(const std::string& userId);
 
     
-    Student* getStudent(const std::string& studentId);
+    std::shared_ptr<Student> getStudent(const std::string& studentId);
 
 
-    Teacher* getTeacher(const std::string& teacherId);
+    std::shared_ptr<Teacher> getTeacher(const std::string& teacherId);
 
     
-    Admin* getAdmin(const std::string& adminId);
+    std::shared_ptr<Admin> getAdmin(const std::string& adminId);
 
     
-    User* authenticate(const std::string& userId, const std::string& password);
+    std::shared_ptr<User> authenticate(const std::string& userId, const std::string& password, const std::string& source = "local");
+
+    // 登录被限流时返回仍需等待的秒数，否则返回0
+    int getLoginRetrySeconds(const std::string& userId, const std::string& source = "local") const;
 
     
     std::vector<std::string> getAllStudentIds() const;
@@ -68,10 +80,17 @@ public:
     
     bool loadData();
 
+    // 增量同步其他进程写入的用户：只替换、添加或删除与存储不一致的用户，
+    // 尚未写盘的本地修改保持不变。返回变化的用户数，数据未变化时返回0
+    size_t syncFromStorage();
+
     
     bool saveData(bool alreadyLocked);
 
-    
+    // 只写入指定用户对应的行（用户已删除时删除该行），供支持单行写入的存储后端使用
+    bool saveRows(const std::vector<std::string>& userIds);
+
+    // 复制当前用户对象，在副本上应用user的资料并发布，已发布的对象保持不变
     bool updateUserInfo(const User& user);
 
 
@@ -83,9 +102,20 @@ public:
     
     std::vector<std::string> findUsers(const std::function<bool(const User&)>& predicate) const;
 
+    // 获取当前用户目录快照：无锁读取，适合逐行显示等批量查询
+    std::shared_ptr<const UserDirectory> snapshot() const;
+
+    // 将全部用户写入二进制快照的USERS段
+    void writeSnapshot(SnapshotWriter& writer) const;
+
+    // 从二进制快照加载用户，格式错误时抛出FILE_CORRUPTED
+    bool loadSnapshot(const SnapshotReader& reader);
+
 private:
     
-    UserManager() = default;
+    UserManager();
+
+    ~UserManager();
     
     
     UserManager(const UserManager&) = delete;
@@ -93,9 +123,31 @@ private:
     
     UserManager& operator=(const UserManager&) = delete;
     
-    std::unordered_map<std::string, std::unique_ptr<User>> users_; // 用户映射表
-    mutable std::mutex mutex_; // 互斥锁
+    std::shared_ptr<const UserDirectory> directory_ = std::make_shared<const UserDirectory>(); // 当前发布的用户目录
+    std::unordered_map<std::string, uint64_t> versions_; // 各用户最近一次与存储同步时的版本（写入冲突检查的基线）
+    mutable std::mutex mutex_; // 互斥锁（仅写入方使用）
+    LoginThrottle loginThrottle_; // 登录失败限流器（无锁）
+    UserProfileCache profileCache_; // 从存储按需读取的用户资料
     
     // 添加用户
     bool addUser(std::unique_ptr<User> user);
+
+    // 用户最近一次与存储同步时的版本，未同步过的用户为0；调用方需持有mutex_
+    uint64_t versionOf(const std::string& userId) const;
+
+    // 用户对象转换为存储记录，未知类型返回null
+    static nlohmann::json toJson(const User& user);
+
+    static nlohmann::json toJson(const User& user, const UserProfile& profile);
+
+    static std::shared_ptr<const UserProfile> profileFromJson(const nlohmann::json& userJson);
+
+    // 由存储记录构建用户对象，未知类型返回nullptr
+    static std::unique_ptr<User> fromJson(nlohmann::json& userJson);
+
+    // 原子发布新版本的用户目录，调用方需持有mutex_
+    void publish(std::shared_ptr<const UserDirectory> directory);
+
+    // 写入被拒绝的用户改用存储中的当前记录，调用方需持有mutex_
+    void adoptStored(const std::vector<RowConflict>& conflicts);
 }; 
\ No newline at end of file
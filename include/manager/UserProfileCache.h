@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "../model/User.h"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// 用户资料的LRU缓存：从存储加载的用户只常驻ID和登录凭据，访问资料时经由此处按主键读取，
+// 最多保留capacity份最近使用的资料；淘汰的资料在调用方不再持有后释放
+class UserProfileCache : public UserProfileLoader {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024; // 默认缓存的资料份数
+
+    // 按用户ID从存储读取资料，用户不存在时返回nullptr
+    using Fetch = std::function<std::shared_ptr<const UserProfile>(const std::string& userId)>;
+
+    explicit UserProfileCache(Fetch fetch, size_t capacity = DEFAULT_CAPACITY);
+
+    std::shared_ptr<const UserProfile> acquire(const User& user) override;
+
+    // 放入与存储一致的资料（如刚写盘的常驻资料）
+    void put(const std::string& userId, std::shared_ptr<const UserProfile> profile);
+
+    // 存储中的记录已变化时丢弃缓存的资料
+    void invalidate(const std::string& userId);
+
+    void clear();
+
+    size_t size() const;
+
+    // 未命中缓存、从存储读取的次数
+    uint64_t misses() const;
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const UserProfile>>;
+
+    // 插入或更新并移到最前，超出容量时淘汰最久未用的资料；调用方需持有mutex_
+    void insert(const std::string& userId, std::shared_ptr<const UserProfile> profile);
+
+    Fetch fetch_;
+    size_t capacity_;
+    std::list<Entry> entries_; // 按最近使用排序，最近的在前
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_; // 用户ID -> entries_中的位置
+    uint64_t misses_ = 0;
+    mutable std::mutex mutex_;
+};
@@ -40,9 +40,10 @@ public:
 
     Course& operator=(Course&& other) noexcept;
 
-    Course(const Course&) = delete;
+    // 管理器中的课程发布后不再修改，修改时复制一份再替换
+    Course(const Course&) = default;
 
-    Course& operator=(const Course&) = delete;
+    Course& operator=(const Course&) = default;
 
     ~Course() = default;
 
@@ -25,6 +25,9 @@ public:
     Enrollment() = default;
     
     Enrollment(std::string studentId, std::string courseId);
+
+    // 从持久化数据恢复时使用，保留原选课时间
+    Enrollment(std::string studentId, std::string courseId, std::string enrollmentTime);
     
     Enrollment(Enrollment&& other) noexcept;
     
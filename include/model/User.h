@@ -20,6 +20,7 @@
 #include <memory>
 #include <vector>
 #include <utility>
+#include <functional>
 
 
 enum class UserType {
@@ -28,6 +29,30 @@ enum class UserType {
     ADMIN       // 管理员用户
 };
 
+// 用户资料：ID和登录凭据以外的信息，各类型用户只使用其中的部分字段
+struct UserProfile {
+    std::string name;        // 姓名
+    std::string gender;      // 性别（学生）
+    int age = 0;             // 年龄（学生）
+    std::string department;  // 系别（学生、教师）
+    std::string classInfo;   // 班级信息（学生）
+    std::string title;       // 职称（教师）
+    std::string contact;     // 联系方式（学生、教师）
+};
+
+class User;
+
+// 按需读取未常驻的用户资料，由UserManager注册
+class UserProfileLoader {
+public:
+    virtual ~UserProfileLoader() = default;
+
+    // 返回用户在存储中的资料，读取失败时返回nullptr
+    virtual std::shared_ptr<const UserProfile> acquire(const User& user) = 0;
+};
+
+// 用户对象常驻ID和登录凭据；资料在新建或修改后常驻，
+// 从存储加载的用户只在访问资料时经由UserProfileLoader读取（带缓存）
 class User {
 public:
     User() = default;
@@ -47,28 +72,59 @@ public:
     bool verifyPassword(const std::string& password) const;
     
     virtual UserType getType() const = 0;
+
+    // 复制出同类型的新用户对象（共享当前资料），用于在副本上修改后整体发布
+    virtual std::unique_ptr<User> clone() const = 0;
     
     const std::string& getId() const { return id_; }
     
-    const std::string& getName() const { return name_; }
+    std::string getName() const { return profile()->name; }
     
-    void setName(std::string name) { name_ = std::move(name); }
+    void setName(std::string name);
 
     void setPassword(std::string password);
     
     const std::string& getSalt() const { return salt_; }
 
+    // 资料是否常驻（新建或修改后尚未交给缓存）
+    bool hasResidentProfile() const;
+
+    static void setProfileLoader(UserProfileLoader* loader);
+
 protected:
     std::string id_;       // 用户ID
-    std::string name_;     // 用户姓名
     std::string password_; // 密码(SHA-256哈希)
     std::string salt_;     // 密码盐值
     
+    // 当前资料：常驻时直接返回，否则经由加载器读取；调用方持有返回值期间资料有效。
+    // 读取失败时返回空资料，只用于显示
+    std::shared_ptr<const UserProfile> profile() const;
+
+    // 同profile()，但读取失败时返回空指针；写入和修改资料前须以此确认读到了存储中的资料
+    std::shared_ptr<const UserProfile> loadProfile() const;
+
+    // 复制当前资料并应用修改，修改后的资料常驻；资料读取失败时抛出SystemException，不做修改
+    void updateProfile(const std::function<void(UserProfile&)>& update);
+
+    // 设置常驻资料，profile为空表示之后按需加载
+    void setProfile(std::shared_ptr<const UserProfile> profile);
+
+    // 常驻资料仍为expected时改为按需加载并返回true（资料已写盘且之后未再修改）
+    bool releaseProfile(std::shared_ptr<const UserProfile> expected);
+
+    // 复制ID、登录凭据和资料指针，供clone使用
+    void copyFrom(const User& other);
+    
     static std::string generatePasswordHash(const std::string& password, const std::string& salt);
     
     static std::string generateSalt();
     
     friend class UserManager;
+
+private:
+    std::shared_ptr<const UserProfile> profile_; // 常驻资料（原子读写），为空时按需加载
+
+    static UserProfileLoader* profileLoader_;    // 资料加载器
 };
 
 
@@ -81,9 +137,9 @@ public:
             std::string gender, int age, std::string department,
             std::string classInfo, std::string contact);
     
-    Student(Student&& other) noexcept;
+    Student(Student&& other) noexcept = default;
 
-    Student& operator=(Student&& other) noexcept;
+    Student& operator=(Student&& other) noexcept = default;
     
     Student(const Student&) = delete;
     
@@ -91,28 +147,23 @@ public:
     
      // Getters and setters
     UserType getType() const override { return UserType::STUDENT; }
+
+    std::unique_ptr<User> clone() const override;
     
-    const std::string& getGender() const { return gender_; }
-    void setGender(std::string gender) { gender_ = std::move(gender); }
+    std::string getGender() const { return profile()->gender; }
+    void setGender(std::string gender);
     
-    int getAge() const { return age_; }
-    void setAge(int age) { age_ = age; }
+    int getAge() const { return profile()->age; }
+    void setAge(int age);
     
-    const std::string& getDepartment() const { return department_; }
-    void setDepartment(std::string department) { department_ = std::move(department); }
+    std::string getDepartment() const { return profile()->department; }
+    void setDepartment(std::string department);
     
-    const std::string& getClassInfo() const { return classInfo_; }
-    void setClassInfo(std::string classInfo) { classInfo_ = std::move(classInfo); }
+    std::string getClassInfo() const { return profile()->classInfo; }
+    void setClassInfo(std::string classInfo);
     
-    const std::string& getContact() const { return contact_; }
-    void setContact(std::string contact) { contact_ = std::move(contact); }
-
-private:
-    std::string gender_;     // 性别
-    int age_ = 0;            // 年龄
-    std::string department_; // 系别
-    std::string classInfo_;  // 班级信息
-    std::string contact_;    // 联系方式
+    std::string getContact() const { return profile()->contact; }
+    void setContact(std::string contact);
 };
 
 
@@ -123,30 +174,27 @@ public:
     Teacher(std::string id, std::string name, std::string password,
             std::string department, std::string title, std::string contact);
 
-    Teacher(Teacher&& other) noexcept;
+    Teacher(Teacher&& other) noexcept = default;
     
-    Teacher& operator=(Teacher&& other) noexcept;
+    Teacher& operator=(Teacher&& other) noexcept = default;
 
     Teacher(const Teacher&) = delete;
     
     Teacher& operator=(const Teacher&) = delete;
 
     UserType getType() const override { return UserType::TEACHER; }
+
+    std::unique_ptr<User> clone() const override;
     
     // Getters and setters
-    const std::string& getDepartment() const { return department_; }
-    void setDepartment(std::string department) { department_ = std::move(department); }
+    std::string getDepartment() const { return profile()->department; }
+    void setDepartment(std::string department);
     
-    const std::string& getTitle() const { return title_; }
-    void setTitle(std::string title) { title_ = std::move(title); }
+    std::string getTitle() const { return profile()->title; }
+    void setTitle(std::string title);
     
-    const std::string& getContact() const { return contact_; }
-    void setContact(std::string contact) { contact_ = std::move(contact); }
-
-private:
-    std::string department_; // 系别
-    std::string title_;      // 职称
-    std::string contact_;    // 联系方式
+    std::string getContact() const { return profile()->contact; }
+    void setContact(std::string contact);
 };
 
  
@@ -157,13 +205,15 @@ public:
     
     Admin(std::string id, std::string name, std::string password);
     
-    Admin(Admin&& other) noexcept;
+    Admin(Admin&& other) noexcept = default;
     
-    Admin& operator=(Admin&& other) noexcept;
+    Admin& operator=(Admin&& other) noexcept = default;
     
     Admin(const Admin&) = delete;
     
     Admin& operator=(const Admin&) = delete;
     
     UserType getType() const override { return UserType::ADMIN; }
-}; 
\ No newline at end of file
+
+    std::unique_ptr<User> clone() const override;
+};
\ No newline at end of file
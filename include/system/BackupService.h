@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+// 在线备份与校验恢复
+// 备份读取存储后端在同一时间点的只读视图（StorageBackend::openSnapshot），逐表流式写出到目标目录，
+// 期间本进程和其他进程的修改照常提交。每张表及每个归档分区写成与JsonStorage相同格式和目录结构的
+// JSON数组文件（可选gzip压缩），目录中的backup.json最后写入，记录各文件的记录数和未压缩内容的SHA-256；
+// 缺少backup.json的目录不是完整的备份
+class BackupService {
+public:
+    static constexpr const char* MANIFEST_FILE = "backup.json"; // 备份清单文件名
+    static constexpr int FORMAT_VERSION = 2;                    // 备份格式版本（2起包含归档分区）
+
+    // 将当前存储后端的三张表及全部归档分区备份到targetDir，compress为true时各文件以gzip压缩
+    static bool backup(const std::string& targetDir, bool compress);
+
+    // 流式校验sourceDir中的备份，返回发现的问题，为空表示备份完整
+    static std::vector<std::string> verify(const std::string& sourceDir);
+
+    // 校验通过后经由StorageBackend::replaceImage整体替换当前存储（含归档分区），写入时再次核对
+    // 记录数和校验和，全部通过才一次提交；失败时不修改存储
+    static bool restore(const std::string& sourceDir);
+
+private:
+    BackupService() = delete;
+};
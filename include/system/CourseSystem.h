@@ -24,6 +24,7 @@
 #include "../manager/EnrollmentManager.h"
 #include "../util/Logger.h"
 #include "../util/I18nManager.h"
+#include "../util/StorageBackend.h"
 
 #include <string>
 #include <memory>
@@ -34,12 +35,19 @@ class CourseSystem {
 public:
     static CourseSystem& getInstance();
     
-    bool initialize(const std::string& dataDir);
+    // storage指定数据存储后端；首次使用SQLite时自动从JSON文件导入
+    bool initialize(const std::string& dataDir, const StorageOptions& storage = StorageOptions());
+
+    // 只打开数据目录和存储后端，不加载数据；供备份、恢复等一次性命令使用
+    bool openStorage(const std::string& dataDir, const StorageOptions& storage = StorageOptions());
     
     int run();
     
     void shutdown();
 
+    // 将当前数据写入二进制快照（data.snapshot），下次启动时优先加载
+    bool writeSnapshot();
+
     bool login(const std::string& userId, const std::string& password);
     
     void logout();
@@ -48,9 +56,14 @@ public:
 
     std::string getText(const std::string& key) const;
 
+    const std::string& getText(TextId id) const;
+
     template<typename... Args>
     std::string getFormattedText(const std::string& key, Args... args) const;
 
+    template<typename... Args>
+    std::string getFormattedText(TextId id, Args... args) const;
+
     bool changePassword(const std::string& userId, const std::string& oldPassword,
                         const std::string& newPassword, const std::string& confirmPassword);
 
@@ -86,7 +99,13 @@ private:
     
     void handleUserInfoModification();
 
+    // 快照存在且与存储后端的数据版本一致时从快照加载，否则返回false
+    bool loadFromSnapshot();
+
+    // 检查加载后的引用完整性（选课记录中的学生和课程、课程的授课教师），记录警告并返回问题数量
+    size_t verifyReferences() const;
+
     bool initialized_ = false;      // 是否已初始化
     bool running_ = false;          // 是否正在运行
-    User* currentUser_ = nullptr;   // 当前登录用户
+    std::shared_ptr<User> currentUser_;   // 当前登录用户
 }; 
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 数据目录监视器
+// 通过inotify监视数据目录，其他进程（如管理工具）写入users.json、courses.json、enrollment.json
+// 或数据清单后，只把发生变化的记录增量同步到各管理器，不重新加载整张表。
+// 本进程自己的写入由数据清单中的代数识别，不会触发同步。仅Linux可用
+class DataWatcher {
+public:
+    static DataWatcher& getInstance();
+
+    // 开始监视数据目录；平台不支持或inotify初始化失败时返回false
+    bool start(const std::string& dataDir);
+
+    // 停止监视线程
+    void stop();
+
+    bool isRunning() const;
+
+private:
+    static constexpr int DEBOUNCE_MS = 100;    // 最后一个事件后等待的毫秒数，合并同一次写入产生的多个事件
+    static constexpr int POLL_TIMEOUT_MS = 200; // 等待事件的超时，决定stop()的响应时间
+
+    DataWatcher() = default;
+
+    ~DataWatcher();
+
+    DataWatcher(const DataWatcher&) = delete;
+
+    DataWatcher& operator=(const DataWatcher&) = delete;
+
+    void run();
+
+    // 读取并解析所有就绪的事件，返回受影响的数据集位图（DataSet）
+    uint32_t readEvents();
+
+    // 按数据集位图同步各管理器
+    void sync(uint32_t sets);
+
+    mutable std::mutex mutex_;           // 保护启动和停止
+    std::thread worker_;                 // 监视线程
+    std::atomic<bool> stopping_{false};  // 是否请求监视线程退出
+    int inotifyFd_ = -1;                 // inotify文件描述符
+    bool running_ = false;               // 是否正在监视
+};
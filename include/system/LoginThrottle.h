@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// 登录限流器：按账户和来源统计滑动窗口内的失败次数，超过阈值后按指数退避拒绝登录
+// 计数保存在固定大小的原子槽位表中，检查和记录均无锁，在哈希密码之前完成
+class LoginThrottle {
+public:
+    LoginThrottle();
+
+    LoginThrottle(const LoginThrottle&) = delete;
+
+    LoginThrottle& operator=(const LoginThrottle&) = delete;
+
+    // 返回仍需等待的毫秒数，0表示允许尝试
+    int64_t retryDelayMs(const std::string& account, const std::string& source) const;
+
+    // 记录一次失败，返回本次失败后需要等待的毫秒数（0表示尚未触发限流）
+    int64_t recordFailure(const std::string& account, const std::string& source);
+
+    // 登录成功后清除该账户的失败计数（来源计数保留）
+    void recordSuccess(const std::string& account);
+
+private:
+    static constexpr size_t TABLE_SIZE = 4096;         // 槽位数量（2的幂）
+    static constexpr size_t MAX_PROBES = 8;            // 线性探测的最大次数
+    static constexpr size_t WINDOW_BUCKETS = 6;        // 滑动窗口的分桶数
+    static constexpr int64_t BUCKET_MS = 10000;        // 每个分桶的时长
+    static constexpr uint32_t ACCOUNT_THRESHOLD = 5;   // 单账户窗口内允许的失败次数
+    static constexpr uint32_t SOURCE_THRESHOLD = 30;   // 单来源窗口内允许的失败次数
+    static constexpr int64_t BASE_DELAY_MS = 1000;     // 首次限流的等待时长
+    static constexpr int64_t MAX_DELAY_MS = 300000;    // 等待时长上限
+
+    struct Slot {
+        std::atomic<uint64_t> key{0};                                // 键的哈希值，0表示空槽
+        std::atomic<int64_t> lastTouchMs{0};                         // 最近一次记录失败的时间
+        std::atomic<int64_t> blockedUntilMs{0};                      // 限流截止时间
+        std::array<std::atomic<int64_t>, WINDOW_BUCKETS> epochs{};   // 各分桶对应的时间片编号
+        std::array<std::atomic<uint32_t>, WINDOW_BUCKETS> counts{};  // 各分桶内的失败次数
+    };
+
+    static uint64_t makeKey(char kind, const std::string& value);
+
+    static int64_t nowMs();
+
+    const Slot* findSlot(uint64_t key) const;
+
+    Slot* findSlot(uint64_t key);
+
+    Slot* acquireSlot(uint64_t key, int64_t now);
+
+    static uint32_t windowCount(const Slot& slot, int64_t now);
+
+    static int64_t recordInSlot(Slot& slot, int64_t now, uint32_t threshold);
+
+    static void resetSlot(Slot& slot);
+
+    std::array<Slot, TABLE_SIZE> slots_;
+};
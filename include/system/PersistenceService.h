@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+// 需要持久化的数据集（按位组合）
+enum class DataSet : uint32_t {
+    USERS = 1,         // 用户表
+    COURSES = 2,       // 课程表
+    ENROLLMENTS = 4    // 选课记录表
+};
+
+// 后台持久化服务
+// 修改操作只标记数据集（或其中的行）为脏并立即返回，由后台线程在合并窗口结束后写盘：
+// 只写被修改的行（saveRows），行版本冲突时与其他进程的修改合并；标记整个数据集时整表重写（saveData）。
+// 修改到落盘的延迟不超过MAX_STALENESS_MS（写入失败时按RETRY_DELAY_MS重试）
+class PersistenceService {
+public:
+    static PersistenceService& getInstance();
+
+    // 启动后台写入线程
+    void start();
+
+    // 停止后台线程并写出所有未落盘的修改
+    void stop();
+
+    // 标记数据集中主键为key的行需要写盘，key为空表示整个数据集。服务未运行时返回false，调用方应自行同步保存
+    bool markDirty(DataSet set, const std::string& key = std::string());
+
+    // 立即同步写出所有未落盘的修改，供需要持久性保证的调用方使用
+    bool flush();
+
+    bool isRunning() const;
+
+    // 主键为key的行（或整个数据集）是否有尚未写盘的本地修改
+    bool isPending(DataSet set, const std::string& key) const;
+
+    // 阻止后台写入和flush()，返回的锁释放前不会有进行中的写入；用于同步其他进程的修改
+    std::unique_lock<std::mutex> holdWrites();
+
+private:
+    static constexpr int MAX_STALENESS_MS = 200;  // 合并窗口：首次标记后最多等待的毫秒数
+    static constexpr int RETRY_DELAY_MS = 5000;   // 写入失败后的重试间隔
+
+    PersistenceService() = default;
+
+    ~PersistenceService();
+
+    PersistenceService(const PersistenceService&) = delete;
+
+    PersistenceService& operator=(const PersistenceService&) = delete;
+
+    // 单个数据集的待写内容
+    struct Pending {
+        bool all = false;                      // 是否需要整表重写
+        std::unordered_set<std::string> keys;  // 被修改行的主键
+    };
+
+    static size_t indexOf(DataSet set);
+
+    void run();
+
+    // 取出并写出当前所有脏数据集，失败的数据集重新标记
+    bool writePending();
+
+    mutable std::mutex mutex_;       // 保护dirty_、pending_、running_、stopping_
+    std::condition_variable cv_;     // 唤醒后台线程
+    std::mutex writeMutex_;          // 串行化后台写入与flush()
+    std::thread worker_;             // 后台写入线程
+    uint32_t dirty_ = 0;             // 脏数据集位图
+    std::array<Pending, 3> pending_; // 各数据集的待写内容
+    bool running_ = false;           // 是否接受异步写入
+    bool stopping_ = false;          // 是否请求后台线程退出
+};
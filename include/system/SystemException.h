@@ -62,6 +62,11 @@ public:
     std::string getFormattedMessage() const;
 
     static std::string errorTypeToString(ErrorType type);
+
+    // 异常构造时的观察者，例如飞行记录器在文件损坏时转储最近的日志；为空时不通知
+    using Observer = void (*)(const SystemException& exception);
+
+    static void setObserver(Observer observer);
     
 private:
     ErrorType type_;     // 错误类型
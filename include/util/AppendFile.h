@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+// 以追加模式打开的文件
+// POSIX平台每次append是一次O_APPEND写入，多个进程同时写同一文件时各自的内容保持完整，
+// 写入后文件描述符的位置即本次写入的末尾，据此得到内容在文件中的实际偏移
+class AppendFile {
+public:
+    explicit AppendFile(const std::string& path);
+
+    ~AppendFile();
+
+    AppendFile(const AppendFile&) = delete;
+
+    AppendFile& operator=(const AppendFile&) = delete;
+
+    bool isOpen() const;
+
+    // 追加写入，返回写入内容在文件中的起始偏移；失败时返回false
+    bool append(const char* data, size_t size, uint64_t& offset);
+
+    // 当前文件大小
+    uint64_t size() const;
+
+    // 文件最后修改时间
+    std::time_t modified() const;
+
+    // path当前是否仍指向打开的文件；日志被其他进程轮转（改名）后返回false
+    bool isFile(const std::string& path) const;
+
+private:
+#if defined(__unix__) || defined(__APPLE__)
+    int fd_ = -1;
+#else
+    void* file_ = nullptr;   // std::FILE*
+#endif
+};
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Logger.h"
+#include "AppendFile.h"
+#include "FlightRecorder.h"
+#include "LogRotator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 二进制日志中参数的类型标记
+enum class BinaryArgType : uint8_t {
+    INT = 1,        // int64
+    UINT = 2,       // uint64（含bool）
+    DOUBLE = 3,     // double
+    STRING = 4      // uint16长度 + 字节
+};
+
+// 调用处注册的格式
+struct LogFormat {
+    LogLevel level;
+    const char* format;
+    const char* file;
+    int line;
+};
+
+// 二进制日志配置
+struct BinaryLogOptions {
+    size_t threadBufferSize = 64 * 1024;                  // 每个线程的缓冲区字节数（向上取2的幂）
+    LogOverflowPolicy overflow = LogOverflowPolicy::BLOCK; // 线程缓冲区满时的策略，与文本日志的含义相同
+    LogRotationOptions rotation;                          // 轮转配置，与文本日志的含义相同
+};
+
+// 结构化二进制日志
+// 调用处用LOGF_*宏给出格式字符串（以{}为占位符）和原始参数：格式在首次执行时注册为整数ID，
+// 之后每条日志只把格式ID、时间戳和参数的二进制形式复制进当前线程的单生产者缓冲区，不拼接字符串也不加锁。
+// 后台线程成批取出各线程缓冲区的记录，按时间戳排序后追加到course_system.binlog（与文本日志一样按大小和日期轮转，
+// 每个段都以文件头和完整的格式定义开始，可单独解码），
+// 由course_log_decode按格式定义还原为与文本日志相同的行。
+// 未open()时LOGF_*宏在调用线程格式化后交给Logger，写入文本日志
+//
+// 文件格式（小端序）：8字节文件头MAGIC，随后是若干批次，每批一次追加写入：
+//   'B' u32进程ID u32批次长度，批次内容为以下条目的序列：
+//   'F' u32格式ID u8级别 u32行号 u16文件名长度 文件名 u16格式长度 格式字符串  —— 格式定义，先于引用它的记录
+//   'R' u16记录长度 u32格式ID i64时间戳（纳秒） 参数...                        —— 一条日志
+// 格式ID只在同一进程内有效，多个进程追加同一文件时按批次头中的进程ID区分
+class BinaryLogger {
+public:
+    static BinaryLogger& getInstance();
+
+    // 打开logDir下的二进制日志文件并启动写入线程；已打开时返回true
+    bool open(const std::string& logDir, const BinaryLogOptions& options = BinaryLogOptions());
+
+    // 停止写入线程并写出全部已缓冲的记录，之后LOGF_*宏回到文本日志
+    void close();
+
+    bool isOpen() const {
+        return open_.load(std::memory_order_relaxed);
+    }
+
+    // 等待调用前提交的记录写入文件
+    void flush();
+
+    // 因线程缓冲区满而丢弃的记录数（DROP和COUNT策略）
+    uint64_t droppedCount() const;
+
+    // 注册调用处的格式，返回从1开始的格式ID，注册表已满时返回0；每个调用处只在首次执行时调用一次
+    static uint32_t registerFormat(LogLevel level, const char* format, const char* file, int line);
+
+    // 已注册的格式数；formatAt(1..formatCount())不加锁，可在信号处理函数中读取
+    static uint32_t formatCount();
+
+    static const LogFormat& formatAt(uint32_t formatId);
+
+    // 记录一条日志：已打开时写入二进制缓冲区，否则格式化后写入文本日志
+    template<typename... Args>
+    void log(LogLevel level, uint32_t formatId, const char* format, const Args&... args) {
+        char record[MAX_RECORD_SIZE];
+        size_t size = encode(record, formatId, args...);
+
+        if (formatId != 0 && isOpen()) {
+            FlightRecorder::record(record, size);
+            if (commit(record, size) && level == LogLevel::CRITICAL) {
+                flush(); // 严重错误之后进程可能随即退出
+            }
+            if (level == LogLevel::CRITICAL) {
+                FlightRecorder::getInstance().dumpOnFailure("严重错误");
+            }
+            return;
+        }
+        // 文本日志自行记入飞行记录器
+        Logger::getInstance().log(level, render(format, record + RECORD_HEADER_SIZE, size - RECORD_HEADER_SIZE));
+    }
+
+    // 只记入飞行记录器，用于低于当前日志级别的调用处
+    template<typename... Args>
+    static void recordOnly(uint32_t formatId, const char* /*format*/, const Args&... args) {
+        if (formatId == 0) {
+            return;
+        }
+        char record[FlightRecorder::SLOT_SIZE];
+        size_t size = encode(record, formatId, args...);
+        FlightRecorder::record(record, size);
+    }
+
+    // 把记录的二进制形式写入定长缓冲区，空间不足时截断字符串参数、丢弃放不下的数值参数
+    class RecordEncoder {
+    public:
+        RecordEncoder(char* buffer, size_t capacity) : begin_(buffer), cursor_(buffer), end_(buffer + capacity) {}
+
+        void begin(uint32_t formatId, int64_t timestampNs) {
+            cursor_ = begin_ + sizeof(uint16_t);
+            raw(formatId);
+            raw(timestampNs);
+        }
+
+        template<typename T>
+        void put(const T& value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                scalar(BinaryArgType::UINT, static_cast<uint64_t>(value));
+            } else if constexpr (std::is_enum_v<T>) {
+                put(static_cast<std::underlying_type_t<T>>(value));
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                scalar(BinaryArgType::INT, static_cast<int64_t>(value));
+            } else if constexpr (std::is_integral_v<T>) {
+                scalar(BinaryArgType::UINT, static_cast<uint64_t>(value));
+            } else if constexpr (std::is_floating_point_v<T>) {
+                scalar(BinaryArgType::DOUBLE, static_cast<double>(value));
+            } else if constexpr (std::is_pointer_v<T>) {
+                string(value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+            } else {
+                string(std::string_view(value));
+            }
+        }
+
+        // 写入记录长度，返回记录的总字节数
+        size_t finish() {
+            uint16_t size = static_cast<uint16_t>(cursor_ - begin_);
+            std::memcpy(begin_, &size, sizeof(size));
+            return size;
+        }
+
+    private:
+        template<typename T>
+        void raw(T value) {
+            std::memcpy(cursor_, &value, sizeof(value));
+            cursor_ += sizeof(value);
+        }
+
+        template<typename T>
+        void scalar(BinaryArgType type, T value) {
+            if (static_cast<size_t>(end_ - cursor_) >= 1 + sizeof(value)) {
+                *cursor_++ = static_cast<char>(type);
+                raw(value);
+            }
+        }
+
+        void string(std::string_view value) {
+            size_t room = static_cast<size_t>(end_ - cursor_);
+            if (room < 1 + sizeof(uint16_t)) {
+                return;
+            }
+            size_t length = std::min({value.size(), MAX_STRING_ARG, room - 1 - sizeof(uint16_t)});
+            *cursor_++ = static_cast<char>(BinaryArgType::STRING);
+            raw(static_cast<uint16_t>(length));
+            std::memcpy(cursor_, value.data(), length);
+            cursor_ += length;
+        }
+
+        char* begin_;
+        char* cursor_;
+        char* end_;
+    };
+
+    // 把一条记录编码进buffer，返回记录的字节数
+    template<size_t N, typename... Args>
+    static size_t encode(char (&buffer)[N], uint32_t formatId, const Args&... args) {
+        RecordEncoder encoder(buffer, N);
+        encoder.begin(formatId, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        (encoder.put(args), ...);
+        return encoder.finish();
+    }
+
+    // 按格式把一条记录的参数区还原为文本；占位符多于参数时保留{}，多余的参数忽略
+    static std::string render(std::string_view format, const char* args, size_t size);
+
+    static constexpr const char* LOG_FILE = "course_system.binlog"; // 日志目录下的二进制日志文件名
+    static constexpr char MAGIC[8] = {'C', 'S', 'B', 'L', 'O', 'G', '\0', '\1'}; // 文件头，末字节为格式版本
+    static constexpr size_t MAX_RECORD_SIZE = 2048;   // 单条记录的最大字节数，超出的字符串参数被截断
+    static constexpr size_t MAX_STRING_ARG = 512;     // 单个字符串参数的最大字节数
+    static constexpr size_t RECORD_HEADER_SIZE = 14;  // u16长度 + u32格式ID + i64时间戳
+    static constexpr size_t MAX_FORMATS = 4096;       // 可注册的格式数上限
+
+private:
+    BinaryLogger();
+
+    ~BinaryLogger();
+
+    BinaryLogger(const BinaryLogger&) = delete;
+
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    class ThreadBuffer;
+
+    // 当前线程的缓冲区，首次调用时创建并登记
+    ThreadBuffer& localBuffer();
+
+    // 把编码好的记录复制进当前线程的缓冲区；缓冲区满时按策略等待，或计入丢弃数并返回false
+    bool commit(const char* record, size_t size);
+
+    // batch_中偏移position处记录的字节数
+    uint16_t recordSize(size_t position) const;
+
+    // 打开（或轮转后重新打开）日志文件，新文件先写入文件头
+    bool openFile();
+
+    // 本批写入后超出大小上限或跨天时轮转，新段重新写出全部格式定义
+    void rotateIfDue(size_t incoming);
+
+    // 后台写入线程
+    void run();
+
+    // 取出各线程缓冲区中的全部记录写入文件，返回记录数；只由写入线程（或其停止后的调用方）调用
+    size_t drain();
+
+    static constexpr int IDLE_WAIT_MS = 20;      // 无记录时写入线程的轮询间隔
+
+    std::atomic<bool> open_{false};              // 是否写入二进制日志
+    std::mutex mutex_;                           // 串行化open()和close()
+    std::string logDir_;                         // 日志目录
+    std::unique_ptr<AppendFile> file_;           // 二进制日志文件
+    std::unique_ptr<LogRotator> rotator_;        // 按大小和日期轮转日志段
+    std::atomic<size_t> threadBufferSize_{BinaryLogOptions().threadBufferSize}; // 新建线程缓冲区的字节数
+    LogOverflowPolicy overflow_ = LogOverflowPolicy::BLOCK; // 线程缓冲区满时的策略
+
+    std::mutex buffersMutex_;                    // 保护buffers_
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_; // 已登记的线程缓冲区
+
+    std::thread writer_;                         // 后台写入线程
+    std::mutex wakeMutex_;                       // 配合以下条件变量
+    std::condition_variable wakeCv_;             // 唤醒写入线程
+    std::condition_variable progressCv_;         // 写入线程完成一轮后通知flush()
+    bool stopping_ = false;                      // 是否请求写入线程退出（受wakeMutex_保护）
+    uint64_t flushRequests_ = 0;                 // flush()请求的轮次（受wakeMutex_保护）
+    uint64_t flushedRequests_ = 0;               // 已完成的轮次（受wakeMutex_保护）
+    std::atomic<bool> nudged_{false};            // 有线程缓冲区越过半满，需要提前写出
+
+    std::string batch_;                          // 从线程缓冲区取出的原始记录（仅写入线程）
+    std::string output_;                         // 待写入文件的批次（仅写入线程）
+    size_t writtenFormats_ = 0;                  // 已写入文件的格式定义数（仅写入线程）
+    std::atomic<uint64_t> dropped_{0};           // 丢弃的记录数
+    uint64_t reportedDrops_ = 0;                 // 已写入汇总的丢弃数（仅写入线程）
+    uint32_t dropFormatId_ = 0;                  // COUNT策略下丢弃汇总的格式ID
+};
+
+#define LOGF_FORMAT_(format, ...) format
+
+// 结构化日志宏：LOGF_INFO("学生 {} 选择课程 {}", studentId, courseId)
+// 格式必须是字符串字面量；级别判断与LOG_*宏相同，
+// 未启用的级别只在飞行记录器开启时编码参数记入内存，不格式化也不写文件
+#define LOGF_AT(level, ...)                                                                   \
+    do {                                                                                      \
+        if constexpr (static_cast<int>(level) >= COURSE_LOG_MIN_LEVEL) {                      \
+            static const uint32_t courseLogFormatId_ =                                        \
+                BinaryLogger::registerFormat(level, LOGF_FORMAT_(__VA_ARGS__, ""), __FILE__, __LINE__); \
+            if (Logger::getInstance().isEnabled(level)) {                                     \
+                BinaryLogger::getInstance().log(level, courseLogFormatId_, __VA_ARGS__);     \
+            } else if (FlightRecorder::isActive()) {                                          \
+                BinaryLogger::recordOnly(courseLogFormatId_, __VA_ARGS__);                   \
+            }                                                                                 \
+        }                                                                                     \
+    } while (0)
+
+#define LOGF_DEBUG(...) LOGF_AT(LogLevel::DEBUG, __VA_ARGS__)
+#define LOGF_INFO(...) LOGF_AT(LogLevel::INFO, __VA_ARGS__)
+#define LOGF_WARNING(...) LOGF_AT(LogLevel::WARNING, __VA_ARGS__)
+#define LOGF_ERROR(...) LOGF_AT(LogLevel::ERROR, __VA_ARGS__)
+#define LOGF_CRITICAL(...) LOGF_AT(LogLevel::CRITICAL, __VA_ARGS__)
@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <memory>
@@ -23,13 +24,30 @@
 #include <functional>
 #include <unordered_map>
 
+#include "../../nlohmann/json.hpp"
+#include "StorageBackend.h"
+#include "DataManifest.h"
+
 class DataManager {
 public:
     static DataManager& getInstance();
 
-    std::string loadJsonFromFile(const std::string& filename);
+    static constexpr const char* LOCK_FILE = "data.lock"; // 数据目录的进程间写锁文件
+
+    // 以内存映射+SAX方式流式读取顶层为数组的数据文件，每解析完一条记录回调一次
+    // 内存占用以单条记录为上限；文件不存在或为空时返回false
+    bool forEachJsonRecord(const std::string& filename, const std::function<void(nlohmann::json&)>& handler);
+
+    // 以SAX方式逐条解析内存中顶层为数组的JSON文本，返回记录条数；格式错误时抛出FILE_CORRUPTED，source用于错误信息
+    static size_t parseJsonRecords(const char* data, size_t size, const std::function<void(nlohmann::json&)>& handler,
+                                   const std::string& source);
+
+    // 同上，从输入流边读边解析，不需要整个文本在内存中
+    static size_t parseJsonRecords(std::istream& input, const std::function<void(nlohmann::json&)>& handler,
+                                   const std::string& source);
 
-    bool saveJsonToFile(const std::string& filename, const std::string& jsonData);
+    // 从记录中移出字符串字段，避免复制；字段缺失或类型不符时抛出json异常
+    static std::string takeString(nlohmann::json& record, const char* key);
 
     bool fileExists(const std::string& filename) const;
 
@@ -41,6 +59,15 @@ public:
 
     const std::string& getDataDirectory() const;
 
+    // 设置数据存储后端，默认为JSON文件存储
+    void setStorageBackend(std::unique_ptr<StorageBackend> storage);
+
+    // 当前存储后端，各管理器通过它读写数据表
+    StorageBackend& storage();
+
+    // 数据目录清单，记录各表的写入代数
+    DataManifest& manifest();
+
 private:
     DataManager();
     
@@ -49,5 +76,7 @@ private:
     DataManager& operator=(const DataManager&) = delete;
 
     std::string dataDirectory_;    // 数据目录
+    std::unique_ptr<StorageBackend> storage_; // 存储后端
+    DataManifest manifest_;        // 各表的写入代数
     mutable std::mutex mutex_;     // 互斥锁（mutable表示可以修改）
 }; 
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "StorageBackend.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// 数据目录清单（manifest.json）：记录每张表的代数
+// 存储后端每次成功提交写入后递增对应表的代数；各管理器加载数据时记下读到的代数，
+// 磁盘上的代数与本进程已知的代数相同时说明数据未被其他写入者修改，重新加载可以跳过
+class DataManifest {
+public:
+    static constexpr const char* FILE_NAME = "manifest.json";
+
+    static constexpr uint64_t UNKNOWN = UINT64_MAX; // 尚未加载或写入过的表
+
+    // 绑定清单文件并将已知代数重置为UNKNOWN；文件不存在时代数视为0，在首次写入时创建
+    void open(const std::string& path);
+
+    // 读取磁盘上的代数；清单缺失或损坏时返回0
+    uint64_t onDisk(StorageTable table);
+
+    // 内存中的数据是否已经反映了磁盘上的代数generation
+    bool isCurrent(StorageTable table, uint64_t generation) const;
+
+    // 记录已加载到内存的代数
+    void acknowledge(StorageTable table, uint64_t generation);
+
+    // 写入提交后递增代数并写回清单，返回新的代数
+    // 只有写入前已知代数等于磁盘上的代数时才把新代数记为已知，否则已知代数保持不变，下次同步时重新加载
+    uint64_t bump(StorageTable table);
+
+private:
+    static size_t indexOf(StorageTable table);
+
+    std::array<uint64_t, 3> readFile() const;
+
+    void writeFile(const std::array<uint64_t, 3>& generations) const;
+
+    std::string path_;                  // 清单文件路径
+    std::array<uint64_t, 3> known_{};   // 本进程已知（写入或加载过）的代数
+    mutable std::mutex mutex_;          // 保护known_和清单文件的读-改-写
+};
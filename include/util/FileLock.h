@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+
+// 进程间建议性文件锁（flock）的RAII封装：构造时阻塞直到获得排他锁，析构时释放
+// 同一进程内的不同实例之间同样互斥。不支持flock的平台上为空操作
+class FileLock {
+public:
+    // 锁文件不存在时自动创建，打开失败时抛出FILE_ACCESS_DENIED
+    explicit FileLock(const std::string& path);
+
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+
+    FileLock& operator=(const FileLock&) = delete;
+
+private:
+    int fd_ = -1; // 锁文件描述符
+};
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "Logger.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 飞行记录器配置
+struct FlightRecorderOptions {
+    size_t recordsPerThread = 256;   // 每个线程保留的最近记录条数
+    bool installSignalHandlers = true; // 是否在致命信号时转储，并在SIGUSR2时按需转储
+};
+
+// 飞行记录器：在内存中为每个线程保留最近的若干条日志记录（包括低于当前日志级别的LOGF_*记录），
+// 出现严重错误、文件损坏或致命信号时把它们按时间顺序写入日志目录下的flight.<进程ID>.<秒>.binlog，
+// 用course_log_decode解码，格式与course_system.binlog相同。
+// 每个线程写自己的定长槽位环，记录时只有一次复制和一次原子写，不加锁也不分配内存；
+// 转储只使用预先分配的缓冲区和write()，可以在信号处理函数中执行
+class FlightRecorder {
+public:
+    static FlightRecorder& getInstance();
+
+    // 分配转储缓冲区、注册文本日志的格式并安装信号处理；只在首次调用时生效
+    bool enable(const std::string& logDir, const FlightRecorderOptions& options = FlightRecorderOptions());
+
+    static bool isActive() {
+        return active_.load(std::memory_order_relaxed);
+    }
+
+    // 记录一条已编码的二进制日志记录（格式见BinaryLogger），超出槽位的部分被截断
+    static void record(const char* record, size_t size);
+
+    // 记录一条文本日志；只复制进槽位，不分配内存
+    static void recordText(LogLevel level, std::string_view message);
+
+    // 立即转储，返回转储文件路径，未启用或失败时返回空字符串
+    std::string dump(const std::string& reason);
+
+    // 出错时转储：与上一次转储间隔不足MIN_FAILURE_INTERVAL_SECONDS时跳过，避免反复出错时写出大量文件
+    void dumpOnFailure(const std::string& reason);
+
+    static constexpr size_t SLOT_SIZE = 256;           // 每个槽位的字节数，即单条记录保留的最大长度
+    static constexpr size_t MAX_THREADS = 64;          // 同时记录的线程数上限，已退出线程的环被复用
+    static constexpr int MIN_FAILURE_INTERVAL_SECONDS = 10;
+
+private:
+    FlightRecorder() = default;
+
+    FlightRecorder(const FlightRecorder&) = delete;
+
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    class Ring;
+
+    // 当前线程的记录环，首次调用时领取；环已用完时返回nullptr
+    Ring* localRing();
+
+    // 写出转储文件并把路径写入path_；只使用异步信号安全的操作
+    bool writeDump(const char* reason, size_t reasonLength);
+
+    static void onSignal(int signal);
+
+    static inline std::atomic<bool> active_{false};
+
+    size_t recordsPerThread_ = 0;
+    Ring* rings_[MAX_THREADS] = {};             // 已创建的环，只增不减
+    std::atomic<size_t> ringCount_{0};
+    char* snapshot_ = nullptr;                  // 转储时复制各环内容的缓冲区
+    uint32_t* order_ = nullptr;                 // 转储时按时间排序的槽位下标
+    uint32_t textFormatIds_[5] = {};            // 文本日志各级别的格式ID
+    uint32_t reasonFormatId_ = 0;               // 转储原因的格式ID
+    char pathPrefix_[512] = {};                 // logDir + "/flight."
+    char path_[600] = {};                       // 最近一次转储的文件路径
+    std::atomic_flag dumping_ = ATOMIC_FLAG_INIT; // 同一时刻只进行一次转储
+    std::atomic<int64_t> lastDumpSeconds_{0};
+};
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// 格式化参数：构造时转换为文本，字符串参数只引用不复制
+// 数值写入内部缓冲区，其他类型经由operator<<转换，结果与原先用ostringstream格式化的一致
+class FormatArg {
+public:
+    FormatArg(const std::string& value) : data_(value.data()), size_(value.size()) {}
+
+    FormatArg(std::string_view value) : data_(value.data()), size_(value.size()) {}
+
+    FormatArg(const char* value) : FormatArg(std::string_view(value != nullptr ? value : "")) {}
+
+    template<typename T>
+    FormatArg(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            buffer_[0] = value ? '1' : '0';
+            size_ = 1;
+        } else if constexpr (std::is_same_v<T, char>) {
+            buffer_[0] = value;
+            size_ = 1;
+        } else if constexpr (std::is_integral_v<T>) {
+            size_ = static_cast<size_t>(std::to_chars(buffer_, buffer_ + sizeof(buffer_), value).ptr - buffer_);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            int length = std::snprintf(buffer_, sizeof(buffer_), "%g", static_cast<double>(value));
+            size_ = length > 0 ? static_cast<size_t>(length) : 0;
+        } else {
+            std::ostringstream oss;
+            oss << value;
+            owned_ = oss.str();
+            data_ = owned_.data();
+            size_ = owned_.size();
+        }
+        if (data_ == nullptr) {
+            data_ = buffer_;
+        }
+    }
+
+    // 引用自身的缓冲区，不可复制
+    FormatArg(const FormatArg&) = delete;
+
+    FormatArg& operator=(const FormatArg&) = delete;
+
+    std::string_view view() const {
+        return std::string_view(data_, size_);
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    char buffer_[32];
+    std::string owned_;
+};
+
+// 预先解析的格式模板：把"{0}", "{1}"...形式的格式字符串拆成原文片段和占位符序列，
+// 格式化时一次遍历追加到调用方的缓冲区，不再逐个参数复制、改写格式字符串
+class FormatTemplate {
+public:
+    FormatTemplate() = default;
+
+    explicit FormatTemplate(std::string_view format);
+
+    // 按模板把格式化结果追加到out；format为解析时的格式字符串，片段按偏移引用其中的原文
+    // 占位符序号超出参数个数时保留原样，多余的参数忽略
+    void appendTo(std::string& out, std::string_view format, const FormatArg* args, size_t count) const;
+
+private:
+    struct Segment {
+        uint32_t begin;   // 在格式字符串中的偏移
+        uint32_t length;  // 字节数
+        int32_t arg;      // 占位符序号，-1表示原文片段
+    };
+
+    std::vector<Segment> segments_;
+    size_t literalSize_ = 0; // 原文片段的总字节数，用于预留空间
+};
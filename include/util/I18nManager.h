@@ -16,6 +16,10 @@
  */
 #pragma once
 
+#include "I18nKeys.h" // 构建时由语言文件生成
+#include "FormatTemplate.h"
+
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <mutex>
@@ -37,9 +41,36 @@ public:
     Language getCurrentLanguage() const;
     
     std::string getText(const std::string& key) const;
+
+    // 按文本ID取文本：数组下标访问，不做字符串哈希；当前语言缺少该文本时返回键名
+    // 返回的引用在下一次切换语言前有效
+    const std::string& getText(TextId id) const {
+        return texts_[static_cast<size_t>(id)];
+    }
     
+    // 按键名格式化：每次调用时解析格式，供动态拼出的键使用
     template<typename... Args>
-    std::string getFormattedText(const std::string& key, Args... args) const;
+    std::string getFormattedText(const std::string& key, const Args&... args) const {
+        std::string text = getText(key);
+        std::string out;
+        appendFormatted(out, FormatTemplate(text), text, args...);
+        return out;
+    }
+
+    // 按文本ID格式化，把{0}, {1}...替换为对应参数；格式在加载语言文件时已解析
+    template<typename... Args>
+    std::string getFormattedText(TextId id, const Args&... args) const {
+        std::string out;
+        appendFormattedText(out, id, args...);
+        return out;
+    }
+
+    // 同上，结果追加到调用方的缓冲区，重复使用缓冲区时不再分配内存
+    template<typename... Args>
+    void appendFormattedText(std::string& out, TextId id, const Args&... args) const {
+        size_t index = static_cast<size_t>(id);
+        appendFormatted(out, templates_[index], texts_[index], args...);
+    }
     
     static std::string languageToString(Language language);
     
@@ -56,17 +87,21 @@ private:
     
     std::string getLanguageFilePath(Language language) const;
     
-    template<typename T>
-    std::string formatValue(const T& value) const;
-
-    std::string formatString(const std::string& format) const;
-    
-    template<typename T, typename... Args>
-    std::string formatString(const std::string& format, T value, Args... args) const;
+    template<typename... Args>
+    static void appendFormatted(std::string& out, const FormatTemplate& format, const std::string& text, const Args&... args) {
+        if constexpr (sizeof...(args) == 0) {
+            format.appendTo(out, text, nullptr, 0);
+        } else {
+            const FormatArg converted[] = {FormatArg(args)...};
+            format.appendTo(out, text, converted, sizeof...(args));
+        }
+    }
 
     std::string dataDir_;                                   // 数据目录
     Language currentLanguage_ = Language::CHINESE;          // 当前语言
-    std::unordered_map<std::string, std::string> textMap_;  // 文本映射表
+    std::unordered_map<std::string, std::string> textMap_;  // 文本映射表，供按键名查找
+    std::array<std::string, TEXT_ID_COUNT> texts_;          // 下标为TextId的文本
+    std::array<FormatTemplate, TEXT_ID_COUNT> templates_;   // texts_对应的已解析格式
     mutable std::mutex mutex_;                              // 互斥锁
     bool initialized_ = false;                              // 是否已初始化
 }; 
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "StorageBackend.h"
+#include "MappedFile.h"
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
+// JSON文件存储：每张表对应数据目录下的一个JSON数组文件
+// 单行修改需要重写整个文件，写入经由JsonStreamWriter逐条输出，内存占用与记录条数无关
+class JsonStorage : public StorageBackend {
+public:
+    // compact为true时每条记录紧凑输出为一行（约为缩进格式一半的字节数），否则缩进4个空格
+    explicit JsonStorage(bool compact = false) : compact_(compact) {}
+
+    const char* name() const override { return "json"; }
+
+    bool scan(StorageTable table, const RecordVisitor& visitor) override;
+
+    // 首次读取或文件变化后扫描一遍文件，建立主键到记录字节区间的索引，之后只解析目标记录
+    std::optional<nlohmann::json> fetch(StorageTable table, const nlohmann::json& key) override;
+
+    bool replaceAll(StorageTable table, RowVersions* versions,
+                    const std::function<void(const RecordSink&)>& producer) override;
+
+    // 持有数据目录锁，流式读取原文件，按主键替换或删除记录后写入新文件，新增记录追加在末尾
+    bool applyRows(StorageTable table, const std::vector<RowChange>& changes, std::vector<RowConflict>& conflicts) override;
+
+    // 由各JSON文件的大小和修改时间计算
+    uint64_t dataStamp() override;
+
+    // 持有数据目录锁映射三个数据文件和全部归档文件，之后的读取不再持锁
+    std::unique_ptr<StorageSnapshot> openSnapshot() override;
+
+    // 归档学期的记录保存在archive/<学期>/下与活动表同名的文件中，学期名中的特殊字符按%XX编码
+    std::vector<std::string> archivedTerms() override;
+
+    bool scanArchive(StorageTable table, const std::string& term, const RecordVisitor& visitor) override;
+
+    // 持有数据目录锁，保留归档文件中未被覆盖的记录后追加新记录
+    bool archiveRows(StorageTable table, const std::string& term, const std::vector<nlohmann::json>& records) override;
+
+    // 持有数据目录锁，先把全部文件写入临时文件，都写好后再依次重命名替换；
+    // 各文件分别原子替换，但同一进程内的读取和其他进程的写入在替换期间等待数据目录锁
+    bool replaceImage(const std::vector<TableImage>& images, bool withArchives) override;
+
+    static const char* fileName(StorageTable table);
+
+    // 学期term的归档文件相对数据目录的路径
+    static std::string archiveFile(StorageTable table, const std::string& term);
+
+    static constexpr const char* ARCHIVE_DIRECTORY = "archive"; // 数据目录下的归档子目录
+
+private:
+    // 一张表的记录偏移索引，对应建立时的文件映射
+    struct RecordIndex {
+        uint64_t fingerprint = 0;                                          // 文件大小和修改时间的指纹
+        MappedFile file;                                                   // 建立索引时映射的文件
+        std::unordered_map<std::string, std::pair<size_t, size_t>> spans;  // 主键 -> 记录的[偏移, 长度)
+    };
+
+    // 重新映射文件并建立索引，调用方需持有indexMutex_；文件格式不符无法建立时返回false，index保持不变
+    bool rebuildIndex(StorageTable table, RecordIndex& index, uint64_t fingerprint);
+
+    bool compact_;          // 是否紧凑输出
+    std::mutex writeMutex_; // 串行化读-改-写
+    std::mutex indexMutex_; // 保护indexes_；与writeMutex_无嵌套
+    std::array<RecordIndex, 3> indexes_; // 各表的记录偏移索引，首次fetch时建立
+};
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "../../nlohmann/json.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 写入选项
+struct JsonStreamOptions {
+    bool compact = false;  // 每条记录紧凑输出为一行，否则与dump(4)的格式完全一致
+    bool gzip = false;     // 以gzip格式压缩写入
+    bool digest = false;   // 计算未压缩内容的SHA-256
+};
+
+// 流式JSON数组写入器
+// 记录由nlohmann的序列化器直接写入固定大小的缓冲区，缓冲区满时写入文件描述符，
+// 保存时的内存占用与记录条数无关。内容先写入path.tmp，commit()时同步到磁盘并重命名；
+// 未提交即析构时删除临时文件，原文件保持不变
+class JsonStreamWriter {
+public:
+    // compact为true时每条记录紧凑输出为一行，否则与dump(4)的格式完全一致
+    JsonStreamWriter(const std::string& path, bool compact);
+
+    JsonStreamWriter(const std::string& path, const JsonStreamOptions& options);
+
+    ~JsonStreamWriter();
+
+    JsonStreamWriter(const JsonStreamWriter&) = delete;
+
+    JsonStreamWriter& operator=(const JsonStreamWriter&) = delete;
+
+    // 追加一条记录；写入失败时抛出SystemException
+    void write(const nlohmann::json& record);
+
+    // 结束数组并替换目标文件
+    void commit();
+
+    size_t recordCount() const { return recordCount_; }
+
+    // 写入文件的字节数（压缩时为压缩后的大小）
+    uint64_t bytesWritten() const;
+
+    // 未压缩内容的SHA-256（十六进制），仅在options.digest为true且commit()之后有效
+    const std::string& digestHex() const { return digest_; }
+
+private:
+    class FileOutput;
+
+    static constexpr unsigned int INDENT = 4; // 非紧凑模式的缩进空格数
+
+    std::string path_;                          // 目标文件
+    std::string tempPath_;                      // 临时文件
+    bool compact_;                              // 是否紧凑输出
+    std::shared_ptr<FileOutput> output_;        // 带缓冲的文件输出
+    std::unique_ptr<nlohmann::detail::serializer<nlohmann::json>> serializer_;
+    size_t recordCount_ = 0;                    // 已写入的记录数
+    bool committed_ = false;                    // 是否已提交
+    std::string digest_;                        // 提交时得到的内容摘要
+};
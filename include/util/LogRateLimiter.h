@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "BinaryLogger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// 调用处的采样计数：每n次执行记录第1次
+class LogSampler {
+public:
+    bool sample(uint64_t n) {
+        return n <= 1 || count_.fetch_add(1, std::memory_order_relaxed) % n == 0;
+    }
+
+private:
+    std::atomic<uint64_t> count_{0};
+};
+
+// 调用处的限流状态：每秒至多记录perSecond次，其余计入省略数，在下一次记录时一并报告
+// 时间窗口和窗口内的计数放在同一个原子变量中，多个线程同时记录时不会超出限额
+class LogRateLimiter {
+public:
+    // 本次是否记录；返回true时suppressed为此前省略的条数
+    bool allow(uint32_t perSecond, uint64_t& suppressed) {
+        auto second = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        uint64_t state = state_.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t next;
+            if (static_cast<uint32_t>(state >> 32) != second) {
+                next = (static_cast<uint64_t>(second) << 32) | 1; // 新的一秒
+            } else if (static_cast<uint32_t>(state) < perSecond) {
+                next = state + 1;
+            } else {
+                suppressed_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (state_.compare_exchange_weak(state, next, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> state_{0};       // 高32位为秒，低32位为该秒内已记录的条数
+    std::atomic<uint64_t> suppressed_{0};  // 尚未报告的省略条数
+};
+
+// 高频事件的日志宏：级别未启用时与LOG_*相同，不求值参数也不更新计数
+// LOG_EVERY_N(level, n, message)：每n次记录1次
+// LOG_RATE_LIMITED(level, perSecond, message)：每秒至多perSecond次，被省略的条数附在下一条记录的末尾
+// LOGF_EVERY_N、LOGF_RATE_LIMITED为对应的结构化版本，省略条数单独记一条
+// 重要事件（失败、安全相关、状态变化）应使用普通的LOG_*宏，保持完整记录
+#define LOG_EVERY_N(level, n, ...)                                                            \
+    do {                                                                                      \
+        if constexpr (static_cast<int>(level) >= COURSE_LOG_MIN_LEVEL) {                      \
+            if (Logger::getInstance().isEnabled(level)) {                                     \
+                static LogSampler courseLogSampler_;                                          \
+                if (courseLogSampler_.sample(n)) {                                            \
+                    Logger::getInstance().log(level, __VA_ARGS__);                            \
+                }                                                                             \
+            }                                                                                 \
+        }                                                                                     \
+    } while (0)
+
+#define LOG_RATE_LIMITED(level, perSecond, ...)                                               \
+    do {                                                                                      \
+        if constexpr (static_cast<int>(level) >= COURSE_LOG_MIN_LEVEL) {                      \
+            if (Logger::getInstance().isEnabled(level)) {                                     \
+                static LogRateLimiter courseLogLimiter_;                                      \
+                uint64_t courseLogSuppressed_ = 0;                                            \
+                if (courseLogLimiter_.allow(perSecond, courseLogSuppressed_)) {               \
+                    if (courseLogSuppressed_ == 0) {                                          \
+                        Logger::getInstance().log(level, __VA_ARGS__);                        \
+                    } else {                                                                  \
+                        Logger::getInstance().log(level, std::string(__VA_ARGS__)             \
+                            + "（此前被限流省略了 " + std::to_string(courseLogSuppressed_) + " 条同类日志）"); \
+                    }                                                                         \
+                }                                                                             \
+            }                                                                                 \
+        }                                                                                     \
+    } while (0)
+
+#define LOGF_EVERY_N(level, n, ...)                                                           \
+    do {                                                                                      \
+        if constexpr (static_cast<int>(level) >= COURSE_LOG_MIN_LEVEL) {                      \
+            if (Logger::getInstance().isEnabled(level)) {                                     \
+                static LogSampler courseLogSampler_;                                          \
+                if (courseLogSampler_.sample(n)) {                                            \
+                    LOGF_AT(level, __VA_ARGS__);                                              \
+                }                                                                             \
+            }                                                                                 \
+        }                                                                                     \
+    } while (0)
+
+#define LOGF_RATE_LIMITED(level, perSecond, ...)                                              \
+    do {                                                                                      \
+        if constexpr (static_cast<int>(level) >= COURSE_LOG_MIN_LEVEL) {                      \
+            if (Logger::getInstance().isEnabled(level)) {                                     \
+                static LogRateLimiter courseLogLimiter_;                                      \
+                uint64_t courseLogSuppressed_ = 0;                                            \
+                if (courseLogLimiter_.allow(perSecond, courseLogSuppressed_)) {               \
+                    LOGF_AT(level, __VA_ARGS__);                                              \
+                    if (courseLogSuppressed_ > 0) {                                           \
+                        LOGF_AT(level, "（上一条此前被限流省略了 {} 条同类日志）", courseLogSuppressed_); \
+                    }                                                                         \
+                }                                                                             \
+            }                                                                                 \
+        }                                                                                     \
+    } while (0)
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "AppendFile.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 日志轮转配置
+struct LogRotationOptions {
+    uint64_t maxBytes = 64ULL * 1024 * 1024; // 单个日志段的最大字节数，0表示不按大小轮转
+    bool daily = true;                       // 是否在每天零点（本地时间）后开始新的日志段
+    size_t keep = 14;                        // 保留的历史段数，更早的段被删除；0表示全部保留
+    bool compress = true;                    // 是否在后台把历史段压缩为.gz
+};
+
+// 日志文件轮转
+// 当前段达到大小上限或跨天时，在日志目录锁内把日志文件及其伴随文件（偏移索引）一起改名为
+// <主名>.<段起始时间>.<扩展名>，由调用方重新打开新文件；多个进程共用日志目录时只有一个进程改名，
+// 其余进程发现路径已指向新文件后直接重新打开。
+// 历史段的gzip压缩和超出保留数的删除在后台线程进行，不阻塞日志写入。
+// 改名后其他进程可能还会向旧段追加少量内容，因此段在改名COMPRESS_DELAY_SECONDS秒后才压缩；
+// 进程退出时未压缩的段在下次启动时补做
+class LogRotator {
+public:
+    // files[0]为日志文件（会被压缩），其余为与它一起轮转的伴随文件，均为directory下的文件名
+    LogRotator(std::string directory, std::vector<std::string> files, const LogRotationOptions& options);
+
+    ~LogRotator();
+
+    LogRotator(const LogRotator&) = delete;
+
+    LogRotator& operator=(const LogRotator&) = delete;
+
+    // 开始新的日志段：start为段的起始时间，用于命名和计算下一个零点
+    void beginSegment(std::time_t start);
+
+    // 当前段写到size字节时是否应轮转
+    bool due(uint64_t size, std::time_t now) const;
+
+    // 把当前日志文件（current为本进程打开的日志文件）和伴随文件改名为历史段。
+    // 返回true时调用方应重新打开全部文件；其他进程已完成轮转时不再改名，同样返回true
+    bool rotate(const AppendFile& current, std::time_t now);
+
+    // 文件名file在目录中的完整路径
+    std::string pathOf(const std::string& file) const;
+
+private:
+    static constexpr int COMPRESS_DELAY_SECONDS = 2; // 改名后等待其他进程切换到新文件的时间
+    static constexpr int RETRY_DELAY_SECONDS = 60;   // 改名失败后的重试间隔
+
+    // 历史段的文件名：file的主名.stamp.扩展名
+    static std::string segmentName(const std::string& file, const std::string& stamp);
+
+    // 历史段名中的段标识"YYYYMMDD-HHMMSS[-序号]"，不是file的历史段时返回空
+    static std::string segmentStamp(const std::string& file, const std::string& name);
+
+    // 目录中未压缩的历史日志段加入压缩队列
+    void queueUncompressed();
+
+    // 删除超出保留数的历史段
+    void applyRetention();
+
+    // 把日志段压缩为.gz并删除原文件
+    bool compress(const std::string& path);
+
+    // 后台压缩线程
+    void run();
+
+    std::string directory_;                  // 日志目录
+    std::vector<std::string> files_;         // 日志文件和伴随文件名
+    LogRotationOptions options_;
+    std::time_t segmentStart_ = 0;           // 当前段的起始时间
+    std::time_t nextMidnight_ = 0;           // 当前段之后的第一个零点
+    std::time_t retryAfter_ = 0;             // 改名失败后暂停轮转到该时间
+
+    // 压缩任务
+    struct Task {
+        std::string path;                    // 待压缩的历史段
+        std::chrono::steady_clock::time_point notBefore; // 最早的压缩时间
+    };
+
+    std::mutex mutex_;                       // 保护以下成员
+    std::condition_variable cv_;             // 唤醒压缩线程
+    std::deque<Task> tasks_;                 // 待压缩的历史段
+    bool stopping_ = false;                  // 是否请求压缩线程退出
+    std::thread worker_;                     // 压缩线程，首次有任务时启动
+};
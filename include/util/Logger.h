@@ -16,9 +16,20 @@
  */
 #pragma once
 
+#include "AppendFile.h"
+#include "LogRotator.h"
+#include "MpscRingBuffer.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <string>
 #include <mutex>
-#include <fstream>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
 enum class LogLevel {
     DEBUG,
@@ -28,11 +39,32 @@ enum class LogLevel {
     CRITICAL
 };
 
+// 异步模式下缓冲区满时的处理策略
+enum class LogOverflowPolicy {
+    BLOCK,          // 等待后台线程腾出空间，不丢日志
+    DROP,           // 直接丢弃新日志，只累计droppedCount()
+    COUNT           // 丢弃新日志，并在缓冲区恢复后写入一条丢弃条数的汇总
+};
+
+// 异步日志配置
+struct AsyncLogOptions {
+    size_t capacity = 8192;                               // 环形缓冲区容量（条）
+    LogOverflowPolicy overflow = LogOverflowPolicy::BLOCK; // 缓冲区满时的策略
+};
+
+// 日志记录器
+// 所有级别的日志只写入一个追加文件（course_system.log），每行带级别标记，可直接用grep按级别筛选；
+// WARNING及以上的记录另在对应级别的索引文件（Warn.idx、Error.idx、Critical.idx）中追加其在日志文件中的字节偏移，
+// 按级别查看（原先的Warn.log、Error.log等）由course_log_view根据索引生成，不再重复写入。
+// 日志文件达到大小上限或跨天时，连同索引文件一起轮转为带时间的历史段，后台压缩并按保留数清理（见LogRotator）。
+// 默认同步写入；startAsync()后各级别方法只格式化日志行并放入有界MPSC环形缓冲区，
+// 由后台线程成批写入日志文件，每批只刷新一次。critical()等待缓冲区写空后返回，析构时写出全部剩余日志
 class Logger {
 public:
     static Logger& getInstance();
     
-    bool initialize(const std::string& logDir, LogLevel logLevel);
+    bool initialize(const std::string& logDir, LogLevel logLevel,
+                    const LogRotationOptions& rotation = LogRotationOptions());
     
     void debug(const std::string& message);
     
@@ -46,11 +78,36 @@ public:
     
     void setLogLevel(LogLevel level);
 
+    // 级别level的日志是否会被记录；供日志宏在求值消息之前判断
+    bool isEnabled(LogLevel level) const {
+        return level >= logLevel_.load(std::memory_order_relaxed);
+    }
+
+    // 按级别分派到debug()、info()等
+    void log(LogLevel level, const std::string& message);
+
+    // 切换到异步写入，需在initialize()之后调用；已是异步模式时返回true
+    bool startAsync(const AsyncLogOptions& options = AsyncLogOptions());
+
+    // 停止后台线程并写出缓冲区中的全部日志，之后恢复同步写入
+    void stopAsync();
+
+    // 等待调用前提交的日志全部写入文件
+    void flush();
+
+    // 异步模式下因缓冲区满而丢弃的日志条数
+    uint64_t droppedCount() const;
+
     static std::string logLevelToString(LogLevel level);
 
 
     static LogLevel stringToLogLevel(const std::string& levelStr);
 
+    static constexpr const char* LOG_FILE = "course_system.log"; // 日志目录下的日志文件名
+
+    // 级别level的偏移索引文件名；DEBUG和INFO没有索引，返回nullptr
+    static const char* indexFileName(LogLevel level);
+
 private:
     Logger();
     
@@ -59,15 +116,83 @@ private:
     Logger& operator=(const Logger&) = delete;
     
     ~Logger();
+
+    // 已格式化的一条日志
+    struct Record {
+        LogLevel level = LogLevel::INFO;
+        std::string line;
+    };
+
+    // 同步写入或放入异步缓冲区
+    void dispatch(LogLevel level, std::string line);
+
+    // 追加到待写缓冲区，flushFiles()时一次写入日志文件；调用方需保证独占文件和缓冲区
+    void writeRecord(LogLevel level, const std::string& line);
+
+    // 写出待写缓冲区，再按实际写入位置为WARNING及以上的记录追加偏移索引
+    void flushFiles();
+
+    // 打开日志目录下的日志文件和索引文件，全部成功才替换当前文件
+    bool openFiles();
+
+    // 当前段达到大小上限或跨天时轮转，改名后重新打开文件；由持有文件的写入方调用，不阻塞生产者
+    void rotateIfDue(size_t incoming);
+
+    // 后台写入线程
+    void run();
+
+    // 写出缓冲区中的日志，返回条数；只由写入线程（或其停止后的调用方）调用
+    size_t drain();
     
     bool initialized_ = false;    // 是否已初始化
-    LogLevel logLevel_;           // 日志级别
+    std::atomic<LogLevel> logLevel_; // 日志级别
     std::mutex mutex_;            // 互斥锁
     
-    // 日志文件流
-    std::ofstream infoFile_;      // 信息日志文件流
-    std::ofstream warnFile_;      // 警告日志文件流
-    std::ofstream errorFile_;     // 错误日志文件流
-    std::ofstream criticalFile_;  // 严重错误日志文件流
-    std::ofstream debugFile_;     // 调试日志文件流
-}; 
\ No newline at end of file
+    // 日志文件
+    std::string logDir_;                                   // 日志目录
+    std::unique_ptr<LogRotator> rotator_;                  // 按大小和日期轮转日志段
+    std::unique_ptr<AppendFile> logFile_;                  // 所有级别共用的日志文件
+    std::array<std::unique_ptr<AppendFile>, 3> indexFiles_; // WARNING、ERROR、CRITICAL的偏移索引
+    std::string pending_;                                  // 尚未写入日志文件的日志行
+    std::vector<std::pair<LogLevel, size_t>> pendingIndex_; // 待写日志行中需要索引的记录：级别和相对偏移
+
+    // 异步模式
+    static constexpr size_t BATCH_SIZE = 256;   // 每批最多写入的条数，批末刷新文件
+    static constexpr int IDLE_WAIT_MS = 50;     // 缓冲区为空时写入线程的最长等待时间
+
+    std::atomic<bool> async_{false};            // 是否处于异步模式
+    std::unique_ptr<MpscRingBuffer<Record>> buffer_; // 待写入的日志
+    LogOverflowPolicy overflow_ = LogOverflowPolicy::BLOCK;
+    std::thread writer_;                        // 后台写入线程
+    std::mutex wakeMutex_;                      // 配合以下条件变量
+    std::condition_variable wakeCv_;            // 唤醒写入线程
+    std::condition_variable progressCv_;        // 写入线程每写完一批通知等待空间或flush的生产者
+    bool stopping_ = false;                     // 是否请求写入线程退出（受wakeMutex_保护）
+    std::atomic<uint64_t> enqueued_{0};         // 已放入缓冲区的条数
+    std::atomic<uint64_t> written_{0};          // 已写入文件的条数
+    std::atomic<uint64_t> dropped_{0};          // 丢弃的条数
+    uint64_t reportedDrops_ = 0;                // 已写入汇总的丢弃条数（仅写入线程）
+}; 
+
+// 编译期日志级别下限（LogLevel的序号），由CMake选项LOG_MIN_LEVEL设置；低于它的日志宏不生成任何代码
+#ifndef COURSE_LOG_MIN_LEVEL
+#define COURSE_LOG_MIN_LEVEL 0
+#endif
+
+// 日志宏：级别未启用时不求值消息参数，只有一次级别比较；低于编译期下限的级别整条语句被丢弃
+// 文本消息只有在级别启用时才进入飞行记录器，低于当前级别的上下文请使用结构化的LOGF_*记录
+#define LOG_AT(level, ...)                                                            \
+    do {                                                                              \
+        if constexpr (static_cast<int>(level) >= COURSE_LOG_MIN_LEVEL) {              \
+            Logger& courseLogger_ = Logger::getInstance();                            \
+            if (courseLogger_.isEnabled(level)) {                                     \
+                courseLogger_.log(level, __VA_ARGS__);                                \
+            }                                                                         \
+        }                                                                             \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LogLevel::WARNING, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LogLevel::ERROR, __VA_ARGS__)
+#define LOG_CRITICAL(...) LOG_AT(LogLevel::CRITICAL, __VA_ARGS__)
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// 只读内存映射文件（RAII）
+// POSIX平台使用mmap，其他平台退化为一次性读入内存
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+private:
+    void release();
+
+    const char* data_ = nullptr;  // 映射区域起始地址
+    size_t size_ = 0;             // 文件大小
+    bool mapped_ = false;         // 是否由mmap映射（否则data_指向buffer_）
+    std::string buffer_;          // 不支持mmap时的文件内容
+};
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// 有界多生产者单消费者环形缓冲区（无锁）
+// 每个槽位带序号：序号等于写入位置时槽位空闲，等于位置+1时已写入待读取。
+// 生产者以CAS竞争写入位置，消费者只有一个，读取位置无需原子操作
+template<typename T>
+class MpscRingBuffer {
+public:
+    // 容量向上取整为2的幂
+    explicit MpscRingBuffer(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_ = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // 缓冲区已满时返回false，value保持不变
+    bool tryPush(T& value) {
+        size_t position = head_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[position & mask_];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // 消费者尚未读走上一轮的记录
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::move(value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由消费者线程调用；没有可读记录时返回false
+    bool tryPop(T& value) {
+        Slot& slot = slots_[tail_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return false;
+        }
+        value = std::move(slot.value);
+        slot.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+
+    // 只能由消费者线程调用
+    bool readable() const {
+        return slots_[tail_ & mask_].sequence.load(std::memory_order_acquire) == tail_ + 1;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0}; // 下一个写入位置（生产者共享）
+    alignas(64) size_t tail_ = 0;             // 下一个读取位置（仅消费者）
+};
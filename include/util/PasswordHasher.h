@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// 密码哈希引擎：SHA-256(password + salt)
+// 复用线程局部的EVP摘要上下文
+class PasswordHasher {
+public:
+    static constexpr size_t DIGEST_SIZE = 32; // SHA-256摘要字节数
+
+    using Digest = std::array<unsigned char, DIGEST_SIZE>;
+
+    static Digest digest(std::string_view password, std::string_view salt);
+
+    static std::string hashHex(std::string_view password, std::string_view salt);
+
+    // 以二进制形式与存储的十六进制哈希进行常数时间比较
+    static bool verify(std::string_view password, std::string_view salt, std::string_view storedHash);
+
+    static std::string toHex(const Digest& digest);
+
+    static bool fromHex(std::string_view hex, Digest& digest);
+
+private:
+    PasswordHasher() = delete;
+};
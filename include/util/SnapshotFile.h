@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 二进制快照文件格式
+// [文件头][段表][段数据...]，每个段8字节对齐并带CRC32校验
+// 字符串统一放入字符串表，记录中以32位序号引用；记录为定长结构，按本机字节序存储
+enum class SnapshotSection : uint32_t {
+    STRING_INDEX = 1,     // 字符串索引（偏移+长度）
+    STRING_DATA = 2,      // 字符串内容
+    USERS = 3,            // 用户记录
+    COURSES = 4,          // 课程记录
+    COURSE_STUDENTS = 5,  // 课程已选学生（字符串引用）
+    ENROLLMENTS = 6       // 选课记录
+};
+
+class SnapshotWriter {
+public:
+    // 将字符串加入字符串表，相同内容只存一份
+    uint32_t intern(const std::string& value);
+
+    template<typename Record>
+    void addSection(SnapshotSection id, const std::vector<Record>& records) {
+        std::vector<char> payload(records.size() * sizeof(Record));
+        if (!records.empty()) {
+            std::memcpy(payload.data(), records.data(), payload.size());
+        }
+        addRawSection(id, sizeof(Record), records.size(), std::move(payload));
+    }
+
+    // 写入临时文件后重命名，sourceStamp记录生成快照时存储后端的数据版本戳
+    void writeToFile(const std::string& path, uint64_t sourceStamp);
+
+private:
+    struct Section {
+        SnapshotSection id;
+        uint32_t recordSize;
+        uint64_t recordCount;
+        std::vector<char> payload;
+    };
+
+    void addRawSection(SnapshotSection id, uint32_t recordSize, uint64_t recordCount, std::vector<char> payload);
+
+    std::vector<Section> sections_;
+    std::unordered_map<std::string, uint32_t> stringIds_; // 字符串 -> 序号
+    std::vector<std::string_view> strings_;               // 序号 -> 字符串（指向stringIds_中的键）
+};
+
+class SnapshotReader {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 3; // 2：记录中增加存储版本号；3：用户记录只含常驻字段
+
+    // 映射并校验快照文件，格式、版本或校验和不符时抛出FILE_CORRUPTED
+    explicit SnapshotReader(const std::string& path);
+
+    uint64_t sourceStamp() const { return sourceStamp_; }
+
+    std::string_view string(uint32_t ref) const;
+
+    std::string str(uint32_t ref) const { return std::string(string(ref)); }
+
+    size_t recordCount(SnapshotSection id) const;
+
+    // 复制出第index条定长记录（避免对映射内存做未对齐访问）
+    template<typename Record>
+    Record record(SnapshotSection id, size_t index) const {
+        Record result;
+        std::memcpy(&result, recordData(id, sizeof(Record), index), sizeof(Record));
+        return result;
+    }
+
+private:
+    struct SectionView {
+        const char* data = nullptr;
+        uint32_t recordSize = 0;
+        uint64_t recordCount = 0;
+    };
+
+    const char* recordData(SnapshotSection id, size_t recordSize, size_t index) const;
+
+    const SectionView& section(SnapshotSection id) const;
+
+    MappedFile file_;
+    uint64_t sourceStamp_ = 0;
+    std::unordered_map<uint32_t, SectionView> sections_;
+};
+
+namespace snapshot {
+
+// 计算一组数据文件的指纹（大小+修改时间），用于判断快照是否过期
+uint64_t sourceFingerprint(const std::vector<std::string>& paths);
+
+uint32_t crc32(const char* data, size_t length);
+
+} // namespace snapshot
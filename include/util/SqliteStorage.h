@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "StorageBackend.h"
+
+#include <array>
+#include <mutex>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+// 嵌入式SQLite存储：每张表以主键建表（WITHOUT ROWID），查询列单独建索引，完整记录以紧凑JSON存放在record列
+// 单行修改在事务内直接写入对应行，不重写整张表
+class SqliteStorage : public StorageBackend {
+public:
+    static constexpr const char* DEFAULT_FILE = "course_system.db"; // 数据目录下的默认文件名
+
+    // 打开（必要时创建）数据库并建表，失败时抛出FILE_ACCESS_DENIED
+    explicit SqliteStorage(const std::string& path);
+
+    ~SqliteStorage() override;
+
+    SqliteStorage(const SqliteStorage&) = delete;
+
+    SqliteStorage& operator=(const SqliteStorage&) = delete;
+
+    const char* name() const override { return "sqlite"; }
+
+    bool scan(StorageTable table, const RecordVisitor& visitor) override;
+
+    // 主键查询走WITHOUT ROWID表的B树
+    std::optional<nlohmann::json> fetch(StorageTable table, const nlohmann::json& key) override;
+
+    bool replaceAll(StorageTable table, RowVersions* versions,
+                    const std::function<void(const RecordSink&)>& producer) override;
+
+    bool applyRows(StorageTable table, const std::vector<RowChange>& changes, std::vector<RowConflict>& conflicts) override;
+
+    // 由建库时生成的实例ID和每次写事务递增的代数组成；检查点和WAL文件变化不影响
+    uint64_t dataStamp() override;
+
+    // 在独立的只读连接上开始读事务，利用WAL的快照隔离，读取期间写入照常提交
+    std::unique_ptr<StorageSnapshot> openSnapshot() override;
+
+    // 归档学期的记录存放在<表名>_archive表中，以(term, 主键)为主键
+    std::vector<std::string> archivedTerms() override;
+
+    bool scanArchive(StorageTable table, const std::string& term, const RecordVisitor& visitor) override;
+
+    bool archiveRows(StorageTable table, const std::string& term, const std::vector<nlohmann::json>& records) override;
+
+    // 在同一写事务中清空并写入全部内容，同时在meta表中记下初始化完成
+    bool replaceImage(const std::vector<TableImage>& images, bool withArchives) override;
+
+    // 是否已写入过完整的初始数据（replaceImage提交过）；新建或导入中途失败的数据库返回false，
+    // 调用方据此从JSON导入。没有该标记的旧版本数据库视为已初始化
+    bool isInitialized();
+
+private:
+    struct Statements {
+        sqlite3_stmt* upsert = nullptr;  // INSERT OR REPLACE
+        sqlite3_stmt* remove = nullptr;  // 按主键删除
+        sqlite3_stmt* scan = nullptr;    // 按主键顺序读取全部记录
+        sqlite3_stmt* find = nullptr;    // 按主键读取一条记录
+        sqlite3_stmt* clear = nullptr;   // 清空表
+        sqlite3_stmt* archiveUpsert = nullptr; // 写入归档行（仅课程和选课记录表）
+        sqlite3_stmt* archiveScan = nullptr;   // 读取某学期的全部归档行
+        sqlite3_stmt* archiveClear = nullptr;  // 删除某学期的全部归档行
+        sqlite3_stmt* archiveClearAll = nullptr; // 删除全部归档行
+    };
+
+    void exec(const char* sql);
+
+    void createSchema();
+
+    sqlite3_stmt* prepare(const std::string& sql);
+
+    Statements& statements(StorageTable table);
+
+    // 课程和选课记录表有归档表，用户表没有；无归档表时抛出OPERATION_FAILED
+    Statements& archiveStatements(StorageTable table);
+
+    // 以下函数要求调用方持有mutex_并处于事务中
+    void upsertRow(StorageTable table, const nlohmann::json& record);
+
+    void removeRow(StorageTable table, const nlohmann::json& key);
+
+    void upsertArchiveRow(StorageTable table, const std::string& term, const nlohmann::json& record);
+
+    // 按主键读取当前记录，行不存在时返回空
+    std::optional<nlohmann::json> findRow(StorageTable table, const nlohmann::json& key);
+
+    // 逐条读取表中的所有记录，返回记录数
+    size_t scanRows(StorageTable table, const RecordVisitor& visitor);
+
+    void check(int rc, const char* action) const;
+
+    // 在当前写事务中递增数据代数
+    void bumpGeneration();
+
+    int64_t readMeta(const char* key);
+
+    std::string path_;
+    sqlite3* db_ = nullptr;
+    bool created_ = false;
+    std::array<Statements, 3> statements_;
+    std::mutex mutex_; // 同一连接上的操作串行执行
+};
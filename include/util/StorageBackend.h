@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "../../nlohmann/json.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 数据表
+enum class StorageTable {
+    USERS,          // 用户（主键id）
+    COURSES,        // 课程（主键id）
+    ENROLLMENTS     // 选课记录（主键studentId+courseId）
+};
+
+// 存储后端类型
+enum class StorageKind {
+    JSON,           // 每张表一个JSON文件（默认）
+    SQLITE          // 嵌入式SQLite数据库文件
+};
+
+// 存储配置
+struct StorageOptions {
+    StorageKind kind = StorageKind::JSON;  // 存储后端类型
+    bool compactJson = false;              // JSON存储是否紧凑输出（每条记录一行）
+    size_t activeTerms = 2;                // 活动分区保留的最近学期数，更早的学期在启动时归档；0表示不归档
+};
+
+// 表的列定义：column为存储列名，field为记录中对应的JSON字段
+struct StorageColumn {
+    const char* column;
+    const char* field;
+    bool primaryKey;
+};
+
+// 记录的版本字段：每次按行写入时递增，缺失视为0
+constexpr const char* RECORD_VERSION_FIELD = "version";
+
+// 单行修改：record为空表示删除key对应的行
+struct RowChange {
+    nlohmann::json key;                      // 只包含主键字段的对象
+    std::optional<nlohmann::json> record;    // 新的完整记录
+    std::optional<uint64_t> expectedVersion; // 修改所基于的版本；与存储中的版本（行不存在时为0）不同则冲突，为空表示不检查
+};
+
+// 版本冲突的行
+struct RowConflict {
+    nlohmann::json key;                      // 只包含主键字段的对象
+    std::optional<nlohmann::json> current;   // 存储中的当前记录，行不存在时为空
+};
+
+// 表中各行的版本：主键对象的dump() -> 版本
+using RowVersions = std::unordered_map<std::string, uint64_t>;
+
+// 一张表（活动分区或某学期的归档分区）的完整内容，由producer逐条产生记录
+struct TableImage {
+    StorageTable table;
+    std::string term;  // 为空表示活动分区，否则为该学期的归档分区（仅COURSES和ENROLLMENTS）
+    std::function<void(const std::function<void(const nlohmann::json&)>&)> producer;
+};
+
+// 存储内容的只读时间点视图：打开后其他连接或进程的写入不影响读到的内容，也不会被它阻塞
+class StorageSnapshot {
+public:
+    virtual ~StorageSnapshot() = default;
+
+    // 逐条读取视图中表的全部记录；表为空或不存在时返回false
+    virtual bool scan(StorageTable table, const std::function<void(nlohmann::json&)>& visitor) = 0;
+
+    // 视图中已归档的学期，按名称升序
+    virtual std::vector<std::string> archivedTerms() = 0;
+
+    // 逐条读取视图中学期term的归档记录（仅COURSES和ENROLLMENTS）；没有记录时返回false
+    virtual bool scanArchive(StorageTable table, const std::string& term,
+                             const std::function<void(nlohmann::json&)>& visitor) = 0;
+};
+
+// 存储后端接口
+// 记录统一以JSON对象表示，主键和索引列由storageColumns()描述
+class StorageBackend {
+public:
+    using RecordVisitor = std::function<void(nlohmann::json&)>;
+    using RecordSink = std::function<void(const nlohmann::json&)>;
+
+    virtual ~StorageBackend() = default;
+
+    virtual const char* name() const = 0;
+
+    // 逐条读取表中的所有记录；表为空或不存在时返回false
+    virtual bool scan(StorageTable table, const RecordVisitor& visitor) = 0;
+
+    // 按主键读取一条记录，行不存在时返回空；不得在replaceAll的producer中调用
+    virtual std::optional<nlohmann::json> fetch(StorageTable table, const nlohmann::json& key) = 0;
+
+    // 用producer逐条产生的记录整体替换表内容。versions非空时带版本检查：存储中每行的版本须与其中记下的
+    // 一致（未记下的行视为0），否则不写入并返回false；内容有变化的行写入版本+1，未变化的保留原版本，
+    // 成功后versions更新为写入的各行版本。versions为空时记录按原样写入
+    virtual bool replaceAll(StorageTable table, RowVersions* versions,
+                            const std::function<void(const RecordSink&)>& producer) = 0;
+
+    // 在一个事务中应用一批单行修改；版本冲突的行不写入，追加到conflicts
+    // 读-改-写期间持有数据目录的进程间锁，多个进程只会互相合并而不会覆盖对方的行
+    virtual bool applyRows(StorageTable table, const std::vector<RowChange>& changes, std::vector<RowConflict>& conflicts) = 0;
+
+    // 数据版本戳：存储内容变化后随之改变，用于判断二进制快照是否过期
+    virtual uint64_t dataStamp() = 0;
+
+    // 打开三张表（含归档分区）在同一时间点的只读视图，用于在线备份；只在获取视图时短暂排斥写入
+    virtual std::unique_ptr<StorageSnapshot> openSnapshot() = 0;
+
+    // 学期归档：课程和选课记录按学期分区，以上接口只操作活动分区；
+    // 已归档学期的记录各自独立存放，只在查询历史时按需读取，不影响启动和保存的开销
+
+    // 已归档的学期，按名称升序
+    virtual std::vector<std::string> archivedTerms() = 0;
+
+    // 逐条读取学期term的归档记录（仅COURSES和ENROLLMENTS）；没有记录时返回false
+    virtual bool scanArchive(StorageTable table, const std::string& term, const RecordVisitor& visitor) = 0;
+
+    // 将记录写入学期term的归档分区，与已归档记录主键相同的被覆盖；不修改活动分区
+    virtual bool archiveRows(StorageTable table, const std::string& term, const std::vector<nlohmann::json>& records) = 0;
+
+    // 以images整体替换存储内容（导入和恢复使用）：全部内容写好后一次提交，producer抛出异常时存储保持不变。
+    // 未列出的活动表被清空；withArchives为true时未列出的归档分区被删除，否则只替换列出的归档分区。
+    // 持有数据目录的进程间锁，期间其他进程的写入等待
+    virtual bool replaceImage(const std::vector<TableImage>& images, bool withArchives) = 0;
+
+    // 返回空表示无法合并，放弃本行的修改
+    using MergeFunction = std::function<std::optional<RowChange>(const RowChange& local, const RowConflict& conflict)>;
+
+    // 带版本检查地写入：有记录的修改写入版本expectedVersion+1；冲突的行由merge根据存储中的当前记录
+    // 生成合并后的修改再重试，最多MAX_MERGE_ATTEMPTS轮。最终写入的修改（含新版本号）追加到written，
+    // merge拒绝的行不写入，其冲突追加到rejected；有被拒绝的行时返回false
+    bool applyRowsMerging(StorageTable table, std::vector<RowChange> changes, const MergeFunction& merge,
+                          std::vector<RowChange>& written, std::vector<RowConflict>& rejected);
+
+    bool upsert(StorageTable table, const nlohmann::json& record);
+
+    bool remove(StorageTable table, const nlohmann::json& key);
+
+protected:
+    // 供replaceAll实现版本检查：stored为存储中的当前记录（主键对象的dump() -> 记录）
+    static bool versionsMatch(StorageTable table, const std::unordered_map<std::string, nlohmann::json>& stored,
+                              const RowVersions& versions);
+
+    // 为要写入的record确定版本：与存储中的记录相同则沿用其版本，否则为记下的版本+1；结果记入written
+    static nlohmann::json withReplacedVersion(StorageTable table, const nlohmann::json& record,
+                                              const std::unordered_map<std::string, nlohmann::json>& stored,
+                                              const RowVersions& versions, RowVersions& written);
+
+private:
+    static constexpr int MAX_MERGE_ATTEMPTS = 5;
+};
+
+const char* storageTableName(StorageTable table);
+
+const std::vector<StorageColumn>& storageColumns(StorageTable table);
+
+// 从完整记录中提取主键对象
+nlohmann::json storageRowKey(StorageTable table, const nlohmann::json& record);
+
+// 记录的版本号，缺失时为0
+uint64_t recordVersion(const nlohmann::json& record);
@@ -15,6 +15,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "../include/system/CourseSystem.h"
+#include "../include/system/BackupService.h"
+#include "../include/util/BinaryLogger.h"
 #include "../include/util/Logger.h"
 #include <iostream>
 #include <string>
@@ -36,7 +38,7 @@ std::string getDataDir() {
     // 确保目录存在
     try {
         if (!fs::exists(absolutePath)) {
-            Logger::getInstance().critical("数据目录不存在: " + absolutePath.string());
+            LOG_CRITICAL("数据目录不存在: " + absolutePath.string());
             throw std::runtime_error("数据目录不存在: " + absolutePath.string());
         }
     } catch (const std::exception& e) {
@@ -67,7 +69,108 @@ std::string getLogDir() {
     return absolutePath.string();
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // --snapshot：加载数据后生成二进制快照并退出
+    // --storage=sqlite：使用SQLite数据库存储（默认--storage=json）
+    // --compact-json：JSON存储每条记录紧凑输出为一行
+    // --active-terms=N：只保留最近N个学期在活动分区（默认2），0表示不归档
+    // --backup=DIR [--compress]：在线备份当前存储到DIR并退出，运行中的其他实例不受影响
+    // --verify-backup=DIR：校验DIR中的备份并退出
+    // --restore=DIR：校验DIR中的备份，通过后替换当前存储的内容并退出
+    // --log-mode=async|sync：日志由后台线程成批写入（默认）或在调用线程同步写入
+    // --log-level=DEBUG|INFO|WARNING|ERROR|CRITICAL：运行时日志级别（默认INFO）
+    // --log-overflow=block|drop|count：异步日志（含二进制日志）缓冲区满时等待（默认）、丢弃或丢弃并记录丢弃条数
+    // --log-max-size=MB：日志段达到该大小后轮转（默认64），0表示不按大小轮转
+    // --log-daily=on|off：是否每天零点后轮转（默认on）
+    // --log-keep=N：保留的历史日志段数（默认14），0表示全部保留
+    // --log-compress=on|off：是否在后台把历史日志段压缩为.gz（默认on）
+    // --log-format=text|binary：结构化日志（LOGF_*）写入文本日志（默认）或二进制日志，后者用course_log_decode查看
+    // --flight-records=N：飞行记录器为每个线程保留的最近日志条数（默认256），0表示关闭；
+    //     严重错误、文件损坏、致命信号或收到SIGUSR2时转储到日志目录下的flight.<进程ID>.<秒>.binlog
+    bool snapshotOnly = false;
+    bool compressBackup = false;
+    std::string backupDir;
+    std::string verifyDir;
+    std::string restoreDir;
+    bool asyncLog = true;
+    bool binaryLog = false;
+    LogLevel logLevel = LogLevel::INFO;
+    AsyncLogOptions logOptions;
+    LogRotationOptions rotation;
+    FlightRecorderOptions flight;
+    StorageOptions storage;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--snapshot") {
+            snapshotOnly = true;
+        } else if (arg == "--storage=sqlite") {
+            storage.kind = StorageKind::SQLITE;
+        } else if (arg == "--storage=json") {
+            storage.kind = StorageKind::JSON;
+        } else if (arg == "--compact-json") {
+            storage.compactJson = true;
+        } else if (arg.rfind("--backup=", 0) == 0) {
+            backupDir = arg.substr(std::string("--backup=").size());
+        } else if (arg == "--compress") {
+            compressBackup = true;
+        } else if (arg.rfind("--verify-backup=", 0) == 0) {
+            verifyDir = arg.substr(std::string("--verify-backup=").size());
+        } else if (arg.rfind("--restore=", 0) == 0) {
+            restoreDir = arg.substr(std::string("--restore=").size());
+        } else if (arg == "--log-mode=async") {
+            asyncLog = true;
+        } else if (arg == "--log-mode=sync") {
+            asyncLog = false;
+        } else if (arg.rfind("--log-level=", 0) == 0) {
+            std::string level = arg.substr(std::string("--log-level=").size());
+            if (Logger::logLevelToString(Logger::stringToLogLevel(level)) != level) {
+                std::cerr << "无效的日志级别: " << arg << std::endl;
+                return 1;
+            }
+            logLevel = Logger::stringToLogLevel(level);
+        } else if (arg.rfind("--log-max-size=", 0) == 0 || arg.rfind("--log-keep=", 0) == 0 ||
+                   arg.rfind("--flight-records=", 0) == 0) {
+            size_t value;
+            try {
+                value = std::stoul(arg.substr(arg.find('=') + 1));
+            } catch (const std::exception&) {
+                std::cerr << "无效的数值: " << arg << std::endl;
+                return 1;
+            }
+            if (arg.rfind("--log-keep=", 0) == 0) {
+                rotation.keep = value;
+            } else if (arg.rfind("--flight-records=", 0) == 0) {
+                flight.recordsPerThread = value;
+            } else {
+                rotation.maxBytes = static_cast<uint64_t>(value) * 1024 * 1024;
+            }
+        } else if (arg == "--log-daily=on" || arg == "--log-daily=off") {
+            rotation.daily = arg == "--log-daily=on";
+        } else if (arg == "--log-compress=on" || arg == "--log-compress=off") {
+            rotation.compress = arg == "--log-compress=on";
+        } else if (arg == "--log-format=text") {
+            binaryLog = false;
+        } else if (arg == "--log-format=binary") {
+            binaryLog = true;
+        } else if (arg == "--log-overflow=block") {
+            logOptions.overflow = LogOverflowPolicy::BLOCK;
+        } else if (arg == "--log-overflow=drop") {
+            logOptions.overflow = LogOverflowPolicy::DROP;
+        } else if (arg == "--log-overflow=count") {
+            logOptions.overflow = LogOverflowPolicy::COUNT;
+        } else if (arg.rfind("--active-terms=", 0) == 0) {
+            try {
+                storage.activeTerms = std::stoul(arg.substr(std::string("--active-terms=").size()));
+            } catch (const std::exception&) {
+                std::cerr << "无效的学期数: " << arg << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "未知参数: " << arg << std::endl;
+            return 1;
+        }
+    }
+    
     // 获取数据目录和日志目录
     std::string dataDir = getDataDir();
     std::string logDir = getLogDir();
@@ -92,12 +195,24 @@ int main() {
     // 初始化系统日志
     Logger& logger = Logger::getInstance();
     try {
-        if (!logger.initialize(logDir, LogLevel::DEBUG)) { //此处根据实际使用需求过滤不同的日志等级
+        if (!logger.initialize(logDir, logLevel, rotation)) {
             std::cerr << "日志系统初始化失败！继续执行但日志功能可能不可用" << std::endl;
         } else {
-            logger.info("日志系统初始化成功");
-            logger.info("数据目录: " + dataDir);
-            logger.info("日志目录: " + logDir);
+            if (flight.recordsPerThread > 0 && !FlightRecorder::getInstance().enable(logDir, flight)) {
+                std::cerr << "启用飞行记录器失败" << std::endl;
+            }
+            LOG_INFO("日志系统初始化成功");
+            LOG_INFO("数据目录: " + dataDir);
+            LOG_INFO("日志目录: " + logDir);
+            if (asyncLog && !logger.startAsync(logOptions)) {
+                std::cerr << "启动异步日志失败，改为同步写入" << std::endl;
+            }
+            BinaryLogOptions binaryOptions;
+            binaryOptions.overflow = logOptions.overflow;
+            binaryOptions.rotation = rotation;
+            if (binaryLog && !BinaryLogger::getInstance().open(logDir, binaryOptions)) {
+                std::cerr << "打开二进制日志失败，改为写入文本日志" << std::endl;
+            }
         }
     } catch (const std::exception& e) {
         std::cerr << "初始化日志系统时异常: " << e.what() << std::endl;
@@ -107,13 +222,37 @@ int main() {
     // 获取CourseSystem单例
     CourseSystem& system = CourseSystem::getInstance();
     
+    // 备份相关命令只需打开存储，不加载数据
+    if (!verifyDir.empty()) {
+        std::vector<std::string> problems = BackupService::verify(verifyDir);
+        for (const auto& problem : problems) {
+            std::cerr << problem << std::endl;
+        }
+        std::cout << (problems.empty() ? "备份完整" : "备份校验失败") << std::endl;
+        return problems.empty() ? 0 : 1;
+    }
+    if (!backupDir.empty() || !restoreDir.empty()) {
+        if (!system.openStorage(dataDir, storage)) {
+            std::cerr << "打开数据存储失败" << std::endl;
+            return 1;
+        }
+        if (!backupDir.empty()) {
+            bool written = BackupService::backup(backupDir, compressBackup);
+            std::cout << (written ? "备份已完成: " : "备份失败: ") << backupDir << std::endl;
+            return written ? 0 : 1;
+        }
+        bool restored = BackupService::restore(restoreDir);
+        std::cout << (restored ? "已从备份恢复: " : "恢复失败，详见日志: ") << restoreDir << std::endl;
+        return restored ? 0 : 1;
+    }
+    
     // 初始化系统
     try {
-        bool initSuccess = system.initialize(dataDir);
+        bool initSuccess = system.initialize(dataDir, storage);
         if (!initSuccess) {
             std::cerr << "系统初始化失败" << std::endl;
             if (logger.initialize(logDir, LogLevel::CRITICAL)) { // 确保日志系统正常运行
-                logger.critical("系统初始化失败");
+                LOG_CRITICAL("系统初始化失败");
             }
             // 暂停以便查看错误信息
             std::cout << "按回车键退出...";
@@ -121,13 +260,19 @@ int main() {
             return 1;
         }
         
+        if (snapshotOnly) {
+            bool written = system.writeSnapshot();
+            std::cout << (written ? "数据快照已生成" : "数据快照生成失败") << std::endl;
+            return written ? 0 : 1;
+        }
+        
         // 运行系统主循环
         return system.run();
     } catch (const std::exception& e) {
         std::cerr << "系统发生严重错误: " << e.what() << std::endl;
         try {
             if (logger.initialize(logDir, LogLevel::CRITICAL)) {
-                logger.critical("系统崩溃: " + std::string(e.what()));
+                LOG_CRITICAL("系统崩溃: " + std::string(e.what()));
             }
         } catch (...) {}    // 忽略日志错误
         // 暂停以便查看错误信息
@@ -16,17 +16,63 @@
  */
 #include "../../include/manager/CourseManager.h"
 #include "../../include/util/DataManager.h"
+#include "../../include/util/SnapshotFile.h"
 #include "../../include/system/LockGuard.h"
+#include "../../include/system/PersistenceService.h"
 #include "../../include/system/SystemException.h"
+#include "../../include/util/LogRateLimiter.h"
 #include "../../include/util/Logger.h"
 
 #include "../../nlohmann/json.hpp"
 #include <algorithm>
+#include <set>
 #include <vector>
 #include <stdexcept>
 
 using json = nlohmann::json;
 
+namespace {
+
+// 快照中的定长课程记录，已选学生存放在COURSE_STUDENTS段的[enrolledBegin, enrolledBegin+enrolledCount)区间
+struct CourseRecord {
+    double credit;
+    uint64_t version;     // 记录版本
+    uint32_t id;
+    uint32_t name;
+    uint32_t type;        // CourseType
+    int32_t hours;
+    uint32_t semester;
+    uint32_t teacherId;
+    int32_t maxCapacity;
+    uint32_t enrolledBegin;
+    uint32_t enrolledCount;
+    uint32_t reserved;
+};
+
+bool sameCourse(const Course& a, const Course& b) {
+    return a.getName() == b.getName() &&
+           a.getType() == b.getType() &&
+           a.getCredit() == b.getCredit() &&
+           a.getHours() == b.getHours() &&
+           a.getSemester() == b.getSemester() &&
+           a.getTeacherId() == b.getTeacherId() &&
+           a.getMaxCapacity() == b.getMaxCapacity() &&
+           a.getEnrolledStudents() == b.getEnrolledStudents();
+}
+
+std::unordered_set<std::string> studentsOf(const json& courseJson) {
+    std::unordered_set<std::string> students;
+    auto enrolled = courseJson.find("enrolledStudents");
+    if (enrolled != courseJson.end() && enrolled->is_array()) {
+        for (const auto& studentId : *enrolled) {
+            students.insert(studentId.get<std::string>());
+        }
+    }
+    return students;
+}
+
+} // namespace
+
 CourseManager& CourseManager::getInstance() {
     static CourseManager instance;  // Meyer's单例模式
     return instance;
@@ -34,7 +80,7 @@ CourseManager& CourseManager::getInstance() {
 
 bool CourseManager::addCourse(std::unique_ptr<Course> course) {
     if (!course) {
-        Logger::getInstance().error("尝试添加空课程对象");
+        LOG_ERROR("尝试添加空课程对象");
         return false;
     }
     
@@ -45,18 +91,18 @@ bool CourseManager::addCourse(std::unique_ptr<Course> course) {
     
     const std::string& courseId = course->getId();
     if (courses_.find(courseId) != courses_.end()) {
-        Logger::getInstance().warning("添加课程失败：课程ID " + courseId + " 已存在");
+        LOG_WARNING("添加课程失败：课程ID " + courseId + " 已存在");
         return false;
     }
     
     //注：对智能指针使用移动语义，而不是对course对象使用移动语义
     courses_[courseId] = std::move(course);
-    if(saveData(true)){ // 传入true表示已获取锁
-        Logger::getInstance().info("成功添加课程: " + courseId);
+    if(PersistenceService::getInstance().markDirty(DataSet::COURSES, courseId) || saveData(true)){ // 服务未运行时同步保存，已持有锁
+        LOGF_INFO("成功添加课程: {}", courseId);
         return true;
     }
     else{
-        Logger::getInstance().error("添加课程失败：保存数据失败");
+        LOG_ERROR("添加课程失败：保存数据失败");
         return false;
     }
     return true;
@@ -70,22 +116,22 @@ bool CourseManager::removeCourse(const std::string& courseId) {
     
     auto it = courses_.find(courseId);
     if (it == courses_.end()) {
-        Logger::getInstance().warning("移除课程失败：课程ID " + courseId + " 不存在");
+        LOG_WARNING("移除课程失败：课程ID " + courseId + " 不存在");
         return false;
     }
     
     courses_.erase(it);
-    if(saveData(true)){ // 传入true表示已获取锁
-        Logger::getInstance().info("成功移除课程: " + courseId);
+    if(PersistenceService::getInstance().markDirty(DataSet::COURSES, courseId) || saveData(true)){ // 服务未运行时同步保存，已持有锁
+        LOGF_INFO("成功移除课程: {}", courseId);
         return true;
     }
     else{
-        Logger::getInstance().error("移除课程失败：保存数据失败");
+        LOG_ERROR("移除课程失败：保存数据失败");
         return false;
     }
 }
 
-Course* CourseManager::getCourse(const std::string& courseId) {
+std::shared_ptr<const Course> CourseManager::getCourse(const std::string& courseId) {
     LockGuard lock(mutex_, 5000); // 设置5秒超时
     if (!lock.isLocked()) {
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
@@ -96,7 +142,7 @@ Course* CourseManager::getCourse(const std::string& courseId) {
         return nullptr;
     }
     
-    return it->second.get();
+    return it->second;
 }
 
 bool CourseManager::updateCourseInfo(const Course& course) {
@@ -107,28 +153,61 @@ bool CourseManager::updateCourseInfo(const Course& course) {
     
     auto it = courses_.find(course.getId());
     if (it == courses_.end()) {
-        Logger::getInstance().warning("更新课程信息失败：课程ID " + course.getId() + " 不存在");
+        LOG_WARNING("更新课程信息失败：课程ID " + course.getId() + " 不存在");
         return false;
     }
     
-    Course* existingCourse = it->second.get();
+    // 已选学生以当前课程为准，其余字段取自course
+    auto updated = std::make_shared<Course>(*it->second);
+    updated->setName(course.getName());
+    updated->setType(course.getType());
+    updated->setCredit(course.getCredit());
+    updated->setHours(course.getHours());
+    updated->setSemester(course.getSemester());
+    updated->setTeacherId(course.getTeacherId());
+    updated->setMaxCapacity(course.getMaxCapacity());
+    it->second = std::move(updated);
     
-    existingCourse->setName(course.getName());
-    existingCourse->setType(course.getType());
-    existingCourse->setCredit(course.getCredit());
-    existingCourse->setHours(course.getHours());
-    existingCourse->setSemester(course.getSemester());
-    existingCourse->setTeacherId(course.getTeacherId());
-    existingCourse->setMaxCapacity(course.getMaxCapacity());
-    
-    if(saveData(true)){ // 传入true表示已获取锁
-        Logger::getInstance().info("成功更新课程信息: " + course.getId());
+    if(PersistenceService::getInstance().markDirty(DataSet::COURSES, course.getId()) || saveData(true)){ // 服务未运行时同步保存，已持有锁
+        LOGF_INFO("成功更新课程信息: {}", course.getId());
         return true;
     }
     else{
-        Logger::getInstance().error("更新课程信息失败：保存数据失败");
+        LOG_ERROR("更新课程信息失败：保存数据失败");
+        return false;
+    }
+}
+
+bool CourseManager::addStudent(const std::string& courseId, const std::string& studentId) {
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+    }
+    
+    auto it = courses_.find(courseId);
+    if (it == courses_.end() || it->second->hasStudent(studentId)) {
+        return false;
+    }
+    auto updated = std::make_shared<Course>(*it->second);
+    updated->addStudent(studentId);
+    it->second = std::move(updated);
+    return true;
+}
+
+bool CourseManager::removeStudent(const std::string& courseId, const std::string& studentId) {
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+    }
+    
+    auto it = courses_.find(courseId);
+    if (it == courses_.end() || !it->second->hasStudent(studentId)) {
         return false;
     }
+    auto updated = std::make_shared<Course>(*it->second);
+    updated->removeStudent(studentId);
+    it->second = std::move(updated);
+    return true;
 }
 
 std::vector<std::string> CourseManager::getAllCourseIds() const {
@@ -211,63 +290,53 @@ bool CourseManager::hasCourse(const std::string& courseId) const {
 
 bool CourseManager::loadData() {
     try {
+        // 重新读盘前先写出后台尚未落盘的修改，避免读到旧文件
+        PersistenceService::getInstance().flush();
+        
         LockGuard lock(mutex_, 5000); // 设置5秒超时
         if (!lock.isLocked()) {
             throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
         }
         
         DataManager& dataManager = DataManager::getInstance();
-        std::string jsonStr = dataManager.loadJsonFromFile("courses.json");
-        
-        if (jsonStr.empty()) {
-            Logger::getInstance().warning("课程数据文件为空或不存在");
-            return false;
+        DataManifest& manifest = dataManager.manifest();
+        uint64_t generation = manifest.onDisk(StorageTable::COURSES);
+        if (manifest.isCurrent(StorageTable::COURSES, generation)) {
+            // 上次加载后的写入都来自本进程，内存中的数据已是最新
+            LOG_RATE_LIMITED(LogLevel::DEBUG, 10, "课程数据未变化（代数 " + std::to_string(generation) + "），跳过重新加载");
+            return true;
         }
         
-        json coursesJson = json::parse(jsonStr);
-        courses_.clear();
+        std::unordered_map<std::string, std::shared_ptr<const Course>> courses;
+        std::unordered_map<std::string, StoredCourse> bases;
         
-        //遍历json数组
-        for (const auto& courseJson : coursesJson) {
-            std::string id = courseJson["id"];
-            std::string name = courseJson["name"];
-            std::string typeStr = courseJson["type"];
-            double credit = courseJson["credit"];
-            int hours = courseJson["hours"];
-            std::string semester = courseJson["semester"];
-            std::string teacherId = courseJson["teacherId"];
-            int maxCapacity = courseJson["maxCapacity"];
-            
-            CourseType type;
-            if (typeStr == "REQUIRED") {
-                type = CourseType::REQUIRED;
-            } else if (typeStr == "ELECTIVE") {
-                type = CourseType::ELECTIVE;
-            } else {
-                Logger::getInstance().warning("未知的课程类型：" + typeStr);
-                type = CourseType::ELECTIVE; // 默认为选修课
-            }
-            
-            auto course = std::make_unique<Course>(
-                id, name, type, credit, hours, semester, teacherId, maxCapacity);
-            
-            // 加载已选学生
-            if (courseJson.contains("enrolledStudents") && courseJson["enrolledStudents"].is_array()) {
-                for (const auto& studentId : courseJson["enrolledStudents"]) {
-                    course->addStudent(studentId);
-                }
-            }
-            
-            courses_[id] = std::move(course);
+        // 流式解析，逐条构建课程对象，不生成整个文件的DOM
+        bool loaded = dataManager.storage().scan(StorageTable::COURSES, [&](json& courseJson) {
+            uint64_t version = recordVersion(courseJson);
+            auto course = fromJson(courseJson);
+            std::string id = course->getId();
+            bases[id] = {version, course->getEnrolledStudents()};
+            courses[std::move(id)] = std::move(course);
+        });
+        
+        if (!loaded) {
+            LOG_WARNING("课程数据文件为空或不存在");
+            return false;
         }
         
-        Logger::getInstance().info("成功加载课程数据，共 " + std::to_string(courses_.size()) + " 个课程");
+        courses_ = std::move(courses);
+        bases_ = std::move(bases);
+        manifest.acknowledge(StorageTable::COURSES, generation);
+        
+        LOG_INFO("成功加载课程数据，共 " + std::to_string(courses_.size()) + " 个课程");
         return true;
+    } catch (const SystemException&) {
+        throw; // 文件损坏、锁超时等系统异常保留原类型
     } catch (const json::exception& e) {
-        Logger::getInstance().error("解析课程数据JSON失败：" + std::string(e.what()));
+        LOG_ERROR("解析课程数据JSON失败：" + std::string(e.what()));
         throw SystemException(ErrorType::DATA_INVALID, "解析课程数据失败：" + std::string(e.what()));
     } catch (const std::exception& e) {
-        Logger::getInstance().error("加载课程数据失败：" + std::string(e.what()));
+        LOG_ERROR("加载课程数据失败：" + std::string(e.what()));
         throw SystemException(ErrorType::OPERATION_FAILED, "加载课程数据失败：" + std::string(e.what()));
     }
 }
@@ -282,61 +351,405 @@ bool CourseManager::saveData(bool alreadyLocked) {
             }
         }
         
-        json coursesJson = json::array(); //创建空的json数组
-        
-        for (const auto& pair : courses_) {
-            const Course* course = pair.second.get();
-            json courseJson;
-            
-            courseJson["id"] = course->getId();
-            courseJson["name"] = course->getName();
-            
-            switch (course->getType()) {
-                case CourseType::REQUIRED:
-                    courseJson["type"] = "REQUIRED";
-                    break;
-                case CourseType::ELECTIVE:
-                    courseJson["type"] = "ELECTIVE";
-                    break;
-                default:
-                    courseJson["type"] = "ELECTIVE"; // 默认为选修课
-                    break;
-            }
-            
-            courseJson["credit"] = course->getCredit();
-            courseJson["hours"] = course->getHours();
-            courseJson["semester"] = course->getSemester();
-            courseJson["teacherId"] = course->getTeacherId();
-            courseJson["maxCapacity"] = course->getMaxCapacity();
-            
-            // 保存已选学生
-            json enrolledStudents = json::array();
-            // 遍历vector容器
-            for (const auto& studentId : course->getEnrolledStudents()) {
-                enrolledStudents.push_back(studentId);
-            }
-            courseJson["enrolledStudents"] = enrolledStudents;
-            
-            coursesJson.push_back(courseJson);
+        // 整体替换同样检查版本：其他进程修改过的课程不被覆盖，本次保存失败
+        RowVersions rowVersions;
+        for (const auto& [courseId, base] : bases_) {
+            rowVersions[json{{"id", courseId}}.dump()] = base.version;
         }
         
-        //将内存中的JSON对象序列化为文本形式的JSON字符串
-        //使用4个空格的缩进格式化输出
-        std::string jsonStr = coursesJson.dump(4); 
-        
-        DataManager& dataManager = DataManager::getInstance();
-        bool result = dataManager.saveJsonToFile("courses.json", jsonStr);
+        bool result = DataManager::getInstance().storage().replaceAll(StorageTable::COURSES, &rowVersions,
+            [&](const StorageBackend::RecordSink& sink) {
+                for (const auto& pair : courses_) {
+                    sink(toJson(*pair.second));
+                }
+            });
         
         if (result) {
-            Logger::getInstance().info("成功保存课程数据，共 " + std::to_string(courses_.size()) + " 个课程");
+            bases_.clear();
+            for (const auto& pair : courses_) {
+                bases_[pair.first] = {rowVersions[json{{"id", pair.first}}.dump()], pair.second->getEnrolledStudents()};
+            }
+            LOG_RATE_LIMITED(LogLevel::INFO, 10, "成功保存课程数据，共 " + std::to_string(courses_.size()) + " 个课程");
         } 
 
         return result;
+    } catch (const SystemException&) {
+        throw;
     } catch (const json::exception& e) {
-        Logger::getInstance().error("生成课程数据JSON失败：" + std::string(e.what()));
+        LOG_ERROR("生成课程数据JSON失败：" + std::string(e.what()));
         throw SystemException(ErrorType::DATA_INVALID, "生成课程数据失败：" + std::string(e.what()));
     } catch (const std::exception& e) {
-        Logger::getInstance().error("保存课程数据失败：" + std::string(e.what()));
+        LOG_ERROR("保存课程数据失败：" + std::string(e.what()));
         throw SystemException(ErrorType::OPERATION_FAILED, "保存课程数据失败：" + std::string(e.what()));
     }
 }
+
+bool CourseManager::saveRows(const std::vector<std::string>& courseIds) {
+    std::vector<RowChange> changes;
+    std::unordered_map<std::string, std::unordered_set<std::string>> baseStudents; // 合并基线：上次同步时的已选学生
+    {
+        LockGuard lock(mutex_, 5000);
+        if (!lock.isLocked()) {
+            throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+        }
+        
+        for (const auto& courseId : courseIds) {
+            auto it = courses_.find(courseId);
+            auto base = bases_.find(courseId);
+            uint64_t version = 0;
+            if (base != bases_.end()) {
+                version = base->second.version;
+                baseStudents[courseId] = base->second.students;
+            }
+            changes.push_back({json{{"id", courseId}},
+                               it != courses_.end() ? std::make_optional<json>(toJson(*it->second)) : std::nullopt,
+                               version});
+        }
+    }
+    
+    // 冲突时在存储的当前名单上重放本进程相对基线的选课和退课，其余字段以本进程为准；
+    // 删除或对方已删除的课程以本进程为准。重放选课后超出容量的课程放弃本进程的修改
+    std::unordered_map<std::string, std::unordered_set<std::string>> originalBase = baseStudents;
+    std::unordered_map<std::string, std::unordered_set<std::string>> remoteStudents; // 最后一次冲突时存储中的名单
+    auto merge = [&](const RowChange& local, const RowConflict& conflict) -> std::optional<RowChange> {
+        if (!local.record || !conflict.current) {
+            return RowChange{local.key, local.record, std::nullopt};
+        }
+        const std::string& courseId = local.key.at("id").get_ref<const std::string&>();
+        std::unordered_set<std::string>& base = baseStudents[courseId];
+        std::unordered_set<std::string> localSet = studentsOf(*local.record);
+        std::unordered_set<std::string> remoteSet = studentsOf(*conflict.current);
+        
+        std::unordered_set<std::string> merged = remoteSet;
+        bool added = false;
+        for (const auto& studentId : localSet) {
+            if (base.count(studentId) == 0) {
+                added = merged.insert(studentId).second || added;
+            }
+        }
+        for (const auto& studentId : base) {
+            if (localSet.count(studentId) == 0) {
+                merged.erase(studentId);
+            }
+        }
+        
+        json record = *local.record;
+        if (added && merged.size() > record.at("maxCapacity").get<size_t>()) {
+            LOG_WARNING("课程 " + courseId + " 已被其他进程选满，放弃本进程的选课");
+            return std::nullopt;
+        }
+        record["enrolledStudents"] = json(std::vector<std::string>(merged.begin(), merged.end()));
+        
+        base = remoteSet; // 下一轮冲突以本次读到的名单为基线
+        remoteStudents[courseId] = std::move(remoteSet);
+        return RowChange{local.key, std::make_optional<json>(std::move(record)), std::nullopt};
+    };
+    
+    std::vector<RowChange> written;
+    std::vector<RowConflict> rejected;
+    bool result = DataManager::getInstance().storage().applyRowsMerging(StorageTable::COURSES, std::move(changes), merge,
+                                                                        written, rejected);
+    
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+    }
+    for (const auto& change : written) {
+        const std::string& courseId = change.key.at("id").get_ref<const std::string&>();
+        if (!change.record) {
+            bases_.erase(courseId);
+            continue;
+        }
+        bases_[courseId] = {recordVersion(*change.record), studentsOf(*change.record)};
+        
+        // 把其他进程的选课和退课应用到内存中的课程
+        auto remote = remoteStudents.find(courseId);
+        auto course = courses_.find(courseId);
+        if (remote == remoteStudents.end() || course == courses_.end()) {
+            continue;
+        }
+        const std::unordered_set<std::string>& original = originalBase[courseId];
+        auto updated = std::make_shared<Course>(*course->second);
+        for (const auto& studentId : remote->second) {
+            if (original.count(studentId) == 0) {
+                updated->addStudent(studentId);
+            }
+        }
+        for (const auto& studentId : original) {
+            if (remote->second.count(studentId) == 0) {
+                updated->removeStudent(studentId);
+            }
+        }
+        course->second = std::move(updated);
+    }
+    
+    // 被拒绝的课程改用存储中的当前记录，选课方据此看到课程已满
+    for (const auto& conflict : rejected) {
+        const std::string& courseId = conflict.key.at("id").get_ref<const std::string&>();
+        json record = *conflict.current; // 只有双方都保留课程时才会拒绝
+        std::shared_ptr<const Course> stored = fromJson(record);
+        bases_[courseId] = {recordVersion(*conflict.current), stored->getEnrolledStudents()};
+        courses_[courseId] = std::move(stored);
+    }
+    if (result) {
+        LOGF_RATE_LIMITED(LogLevel::DEBUG, 10, "已写入 {} 行课程数据", written.size());
+    }
+    return result;
+}
+
+size_t CourseManager::syncFromStorage() {
+    DataManager& dataManager = DataManager::getInstance();
+    DataManifest& manifest = dataManager.manifest();
+    uint64_t generation = manifest.onDisk(StorageTable::COURSES);
+    if (manifest.isCurrent(StorageTable::COURSES, generation)) {
+        return 0;
+    }
+    
+    // 在锁外读取存储并构建对象，只在应用差异时持锁
+    std::unordered_map<std::string, std::shared_ptr<const Course>> stored;
+    std::unordered_map<std::string, uint64_t> storedVersions;
+    bool loaded = dataManager.storage().scan(StorageTable::COURSES, [&](json& courseJson) {
+        uint64_t version = recordVersion(courseJson);
+        auto course = fromJson(courseJson);
+        std::string id = course->getId();
+        storedVersions[id] = version;
+        stored[std::move(id)] = std::move(course);
+    });
+    if (!loaded) {
+        LOG_WARNING("课程数据文件为空或不存在，忽略本次同步");
+        return 0;
+    }
+    
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+    }
+    
+    PersistenceService& persistence = PersistenceService::getInstance();
+    size_t changed = 0;
+    for (auto& [courseId, course] : stored) {
+        if (persistence.isPending(DataSet::COURSES, courseId)) {
+            continue; // 本地修改尚未写盘，以内存为准
+        }
+        bases_[courseId] = {storedVersions[courseId], course->getEnrolledStudents()};
+        // 以新对象替换，不修改已发布的课程；已取得旧课程的调用方继续持有旧对象
+        auto it = courses_.find(courseId);
+        if (it == courses_.end()) {
+            courses_[courseId] = std::move(course);
+        } else if (!sameCourse(*it->second, *course)) {
+            it->second = std::move(course);
+        } else {
+            continue;
+        }
+        ++changed;
+    }
+    for (auto it = courses_.begin(); it != courses_.end();) {
+        if (stored.count(it->first) == 0 && !persistence.isPending(DataSet::COURSES, it->first)) {
+            bases_.erase(it->first);
+            it = courses_.erase(it);
+            ++changed;
+        } else {
+            ++it;
+        }
+    }
+    manifest.acknowledge(StorageTable::COURSES, generation);
+    
+    LOG_INFO("同步课程数据（代数 " + std::to_string(generation) + "），更新 " + std::to_string(changed) + " 个课程");
+    return changed;
+}
+
+std::vector<std::string> CourseManager::getSemesters() const {
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+    }
+    
+    std::set<std::string> semesters;
+    for (const auto& pair : courses_) {
+        semesters.insert(pair.second->getSemester());
+    }
+    return std::vector<std::string>(semesters.begin(), semesters.end());
+}
+
+std::vector<std::string> CourseManager::archiveSemester(const std::string& semester) {
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+    }
+    
+    std::vector<std::string> courseIds;
+    std::vector<json> records;
+    for (const auto& pair : courses_) {
+        if (pair.second->getSemester() != semester) {
+            continue;
+        }
+        json record = toJson(*pair.second);
+        auto base = bases_.find(pair.first);
+        record[RECORD_VERSION_FIELD] = base != bases_.end() ? base->second.version : 0;
+        records.push_back(std::move(record));
+        courseIds.push_back(pair.first);
+    }
+    if (courseIds.empty()) {
+        return courseIds;
+    }
+    
+    // 先写归档分区再删除活动分区中的行，中途失败时记录至多在两个分区中重复，下次归档时覆盖
+    DataManager::getInstance().storage().archiveRows(StorageTable::COURSES, semester, records);
+    
+    bool deferred = true;
+    for (const auto& courseId : courseIds) {
+        courses_.erase(courseId);
+        deferred = PersistenceService::getInstance().markDirty(DataSet::COURSES, courseId) && deferred;
+    }
+    if (!deferred) {
+        saveData(true); // 服务未运行时同步保存，已持有锁
+    }
+    
+    LOG_INFO("已归档学期 " + semester + " 的 " + std::to_string(courseIds.size()) + " 门课程");
+    return courseIds;
+}
+
+std::vector<std::unique_ptr<Course>> CourseManager::loadArchivedCourses(const std::string& semester) const {
+    std::vector<std::unique_ptr<Course>> courses;
+    DataManager::getInstance().storage().scanArchive(StorageTable::COURSES, semester, [&](json& courseJson) {
+        courses.push_back(fromJson(courseJson));
+    });
+    return courses;
+}
+
+std::unique_ptr<Course> CourseManager::fromJson(json& courseJson) {
+    std::string typeStr = DataManager::takeString(courseJson, "type");
+    
+    CourseType type;
+    if (typeStr == "REQUIRED") {
+        type = CourseType::REQUIRED;
+    } else if (typeStr == "ELECTIVE") {
+        type = CourseType::ELECTIVE;
+    } else {
+        LOG_WARNING("未知的课程类型：" + typeStr);
+        type = CourseType::ELECTIVE; // 默认为选修课
+    }
+    
+    auto course = std::make_unique<Course>(
+        DataManager::takeString(courseJson, "id"),
+        DataManager::takeString(courseJson, "name"),
+        type,
+        courseJson.at("credit").get<double>(),
+        courseJson.at("hours").get<int>(),
+        DataManager::takeString(courseJson, "semester"),
+        DataManager::takeString(courseJson, "teacherId"),
+        courseJson.at("maxCapacity").get<int>());
+    
+    // 加载已选学生
+    auto enrolled = courseJson.find("enrolledStudents");
+    if (enrolled != courseJson.end() && enrolled->is_array()) {
+        for (const auto& studentId : *enrolled) {
+            course->addStudent(studentId.get_ref<const std::string&>());
+        }
+    }
+    return course;
+}
+
+json CourseManager::toJson(const Course& course) {
+    json courseJson;
+    
+    courseJson["id"] = course.getId();
+    courseJson["name"] = course.getName();
+    courseJson["type"] = course.getType() == CourseType::REQUIRED ? "REQUIRED" : "ELECTIVE";
+    courseJson["credit"] = course.getCredit();
+    courseJson["hours"] = course.getHours();
+    courseJson["semester"] = course.getSemester();
+    courseJson["teacherId"] = course.getTeacherId();
+    courseJson["maxCapacity"] = course.getMaxCapacity();
+    
+    // 保存已选学生
+    json enrolledStudents = json::array();
+    for (const auto& studentId : course.getEnrolledStudents()) {
+        enrolledStudents.push_back(studentId);
+    }
+    courseJson["enrolledStudents"] = std::move(enrolledStudents);
+    
+    return courseJson;
+}
+
+void CourseManager::writeSnapshot(SnapshotWriter& writer) const {
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+    }
+
+    std::vector<CourseRecord> records;
+    std::vector<uint32_t> students;
+    records.reserve(courses_.size());
+    for (const auto& pair : courses_) {
+        const Course& course = *pair.second;
+        CourseRecord record{};
+        record.credit = course.getCredit();
+        auto base = bases_.find(pair.first);
+        record.version = base != bases_.end() ? base->second.version : 0;
+        record.id = writer.intern(course.getId());
+        record.name = writer.intern(course.getName());
+        record.type = static_cast<uint32_t>(course.getType());
+        record.hours = course.getHours();
+        record.semester = writer.intern(course.getSemester());
+        record.teacherId = writer.intern(course.getTeacherId());
+        record.maxCapacity = course.getMaxCapacity();
+        record.enrolledBegin = static_cast<uint32_t>(students.size());
+        for (const auto& studentId : course.getEnrolledStudents()) {
+            students.push_back(writer.intern(studentId));
+        }
+        record.enrolledCount = static_cast<uint32_t>(students.size()) - record.enrolledBegin;
+        records.push_back(record);
+    }
+
+    writer.addSection(SnapshotSection::COURSES, records);
+    writer.addSection(SnapshotSection::COURSE_STUDENTS, students);
+}
+
+bool CourseManager::loadSnapshot(const SnapshotReader& reader) {
+    DataManifest& manifest = DataManager::getInstance().manifest();
+    uint64_t generation = manifest.onDisk(StorageTable::COURSES);
+    size_t count = reader.recordCount(SnapshotSection::COURSES);
+    size_t studentCount = reader.recordCount(SnapshotSection::COURSE_STUDENTS);
+    std::unordered_map<std::string, std::shared_ptr<const Course>> courses;
+    std::unordered_map<std::string, StoredCourse> bases;
+    courses.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        CourseRecord record = reader.record<CourseRecord>(SnapshotSection::COURSES, i);
+        if (record.type > static_cast<uint32_t>(CourseType::ELECTIVE) ||
+            static_cast<size_t>(record.enrolledBegin) + record.enrolledCount > studentCount) {
+            throw SystemException(ErrorType::FILE_CORRUPTED, "快照中的课程记录无效：第 " + std::to_string(i) + " 条");
+        }
+
+        auto course = std::make_unique<Course>(
+            reader.str(record.id),
+            reader.str(record.name),
+            static_cast<CourseType>(record.type),
+            record.credit,
+            record.hours,
+            reader.str(record.semester),
+            reader.str(record.teacherId),
+            record.maxCapacity);
+
+        for (uint32_t k = 0; k < record.enrolledCount; ++k) {
+            uint32_t ref = reader.record<uint32_t>(SnapshotSection::COURSE_STUDENTS, record.enrolledBegin + k);
+            course->addStudent(reader.str(ref));
+        }
+
+        std::string id = course->getId();
+        bases[id] = {record.version, course->getEnrolledStudents()};
+        courses[std::move(id)] = std::move(course);
+    }
+
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取课程管理器锁超时");
+    }
+    courses_ = std::move(courses);
+    bases_ = std::move(bases);
+    manifest.acknowledge(StorageTable::COURSES, generation);
+
+    LOG_INFO("从快照加载课程数据，共 " + std::to_string(courses_.size()) + " 个课程");
+    return true;
+}
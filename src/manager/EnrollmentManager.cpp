@@ -18,17 +18,34 @@
 #include "../../include/manager/UserManager.h"
 #include "../../include/manager/CourseManager.h"
 #include "../../include/util/DataManager.h"
+#include "../../include/util/SnapshotFile.h"
 #include "../../include/system/LockGuard.h"
+#include "../../include/system/PersistenceService.h"
 #include "../../include/system/SystemException.h"
+#include "../../include/util/LogRateLimiter.h"
 #include "../../include/util/Logger.h"
 
 #include "../../nlohmann/json.hpp"
 #include <algorithm>
+#include <unordered_set>
 #include <stdexcept>
 #include <sstream>
 
 using json = nlohmann::json;
 
+namespace {
+
+// 快照中的定长选课记录
+struct EnrollmentRecord {
+    uint64_t version;     // 记录版本
+    uint32_t studentId;
+    uint32_t courseId;
+    uint32_t enrollmentTime;
+    uint32_t reserved;
+};
+
+} // namespace
+
 EnrollmentManager& EnrollmentManager::getInstance() {
     static EnrollmentManager instance;  // Meyer's单例模式
     return instance;
@@ -38,7 +55,7 @@ EnrollmentManager& EnrollmentManager::getInstance() {
 bool EnrollmentManager::enrollCourse(const std::string& studentId, const std::string& courseId) {
     // 检查参数
     if (studentId.empty() || courseId.empty()) {
-        Logger::getInstance().error("选课失败：学生ID或课程ID为空");
+        LOG_ERROR("选课失败：学生ID或课程ID为空");
         return false;
     }
     
@@ -46,29 +63,29 @@ bool EnrollmentManager::enrollCourse(const std::string& studentId, const std::st
     {
         // 验证学生存在
         UserManager& userManager = UserManager::getInstance();
-        Student* student = userManager.getStudent(studentId);
+        std::shared_ptr<Student> student = userManager.getStudent(studentId);
         if (!student) {
-            Logger::getInstance().warning("选课失败：学生ID " + studentId + " 不存在");
+            LOGF_WARNING("选课失败：学生ID {} 不存在", studentId);
             return false;
         }
         
         // 验证课程存在
         CourseManager& courseManager = CourseManager::getInstance();
-        Course* course = courseManager.getCourse(courseId);
+        std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
         if (!course) {
-            Logger::getInstance().warning("选课失败：课程ID " + courseId + " 不存在");
+            LOGF_WARNING("选课失败：课程ID {} 不存在", courseId);
             return false;
         }
         
         // 检查是否已选此课程
         if (isEnrolled(studentId, courseId)) {
-            Logger::getInstance().warning("选课失败：学生 " + studentId + " 已选课程 " + courseId);
+            LOGF_WARNING("选课失败：学生 {} 已选课程 {}", studentId, courseId);
             throw SystemException(ErrorType::ALREADY_ENROLLED, "学生已选择此课程");
         }
         
         // 检查课程是否已满
         if (course->isFull()) {
-            Logger::getInstance().warning("选课失败：课程 " + courseId + " 已满");
+            LOGF_WARNING("选课失败：课程 {} 已满", courseId);
             throw SystemException(ErrorType::COURSE_FULL, "课程已满");
         }
         
@@ -77,23 +94,39 @@ bool EnrollmentManager::enrollCourse(const std::string& studentId, const std::st
         bool enrollmentAdded = addEnrollment(std::move(enrollment));
         
         if (!enrollmentAdded) {
-            Logger::getInstance().error("选课失败：无法添加选课记录");
+            LOG_ERROR("选课失败：无法添加选课记录");
             return false;
         }
         
         // 更新课程的学生列表
-        bool studentAdded = course->addStudent(studentId);
+        bool studentAdded = courseManager.addStudent(courseId, studentId);
         if (!studentAdded) {
-            Logger::getInstance().error("选课失败：无法将学生添加到课程");
+            LOG_ERROR("选课失败：无法将学生添加到课程");
             return false;
         }
         
-        // 保存选课数据和课程数据，确保数据同步
-        saveData(true); // 传入true表示已获取锁
-        courseManager.saveData(true); // 传入true表示已获取锁
+        // 课程名单立即写入存储：其他进程同时选满该课程时写入被拒绝，撤销本次选课，
+        // 课程已刷新为存储中的名单，调用方可据此重试
+        PersistenceService& persistence = PersistenceService::getInstance();
+        if (!courseManager.saveRows({courseId})) {
+            std::shared_ptr<const Course> stored = courseManager.getCourse(courseId);
+            if (!stored || !stored->hasStudent(studentId)) {
+                removeEnrollment(studentId, courseId);
+                LOGF_WARNING("选课失败：课程 {} 已被其他用户选满", courseId);
+                throw SystemException(ErrorType::COURSE_FULL, "课程已满");
+            }
+            if (!persistence.markDirty(DataSet::COURSES, courseId)) { // 写入失败，稍后重试
+                courseManager.saveData();
+            }
+        }
+        
+        // 选课记录标记待写盘；服务未运行时同步保存（此处未持有锁，由saveData加锁）
+        if (!persistence.markDirty(DataSet::ENROLLMENTS, generateKey(studentId, courseId))) {
+            saveData();
+        }
         
         // 记录选课信息到日志
-        Logger::getInstance().info("选课成功：学生 " + studentId + " 选择课程 " + courseId);
+        LOGF_RATE_LIMITED(LogLevel::INFO, 20, "选课成功：学生 {} 选择课程 {}", studentId, courseId);
         return true;
 
     } catch (const SystemException& e) {
@@ -101,7 +134,7 @@ bool EnrollmentManager::enrollCourse(const std::string& studentId, const std::st
         throw;
     }
     catch (const std::exception& e) {
-        Logger::getInstance().error("选课失败：发生异常 - " + std::string(e.what()));
+        LOG_ERROR("选课失败：发生异常 - " + std::string(e.what()));
         throw SystemException(ErrorType::OPERATION_FAILED, "选课操作失败：" + std::string(e.what()));
     }
 }
@@ -109,57 +142,62 @@ bool EnrollmentManager::enrollCourse(const std::string& studentId, const std::st
 bool EnrollmentManager::dropCourse(const std::string& studentId, const std::string& courseId) {
     // 检查参数
     if (studentId.empty() || courseId.empty()) {
-        Logger::getInstance().error("退课失败：学生ID或课程ID为空");
+        LOG_ERROR("退课失败：学生ID或课程ID为空");
         return false;
     }
     
     try {
         // 验证选课记录存在
-        Enrollment* enrollment = getEnrollment(studentId, courseId);
+        std::shared_ptr<const Enrollment> enrollment = getEnrollment(studentId, courseId);
         if (!enrollment) {
-            Logger::getInstance().warning("退课失败：未找到学生 " + studentId + " 的课程 " + courseId + " 的选课记录");
+            LOGF_WARNING("退课失败：未找到学生 {} 的课程 {} 的选课记录", studentId, courseId);
             throw SystemException(ErrorType::NOT_ENROLLED, "未找到该选课记录");
         }
         
         // 验证课程存在
         CourseManager& courseManager = CourseManager::getInstance();
-        Course* course = courseManager.getCourse(courseId);
+        std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
         if (!course) {
-            Logger::getInstance().warning("退课失败：课程ID " + courseId + " 不存在");
+            LOG_WARNING("退课失败：课程ID " + courseId + " 不存在");
             return false;
         }
         
         // 从课程的学生列表中移除学生
-        bool removed = course->removeStudent(studentId);
+        bool removed = courseManager.removeStudent(courseId, studentId);
         if (!removed) {
-            Logger::getInstance().warning("退课警告：无法从课程 " + courseId + " 中移除学生 " + studentId);
+            LOGF_WARNING("退课警告：无法从课程 {} 中移除学生 {}", courseId, studentId);
             return false;
         }
         
         // 移除选课记录
         bool recordRemoved = removeEnrollment(studentId, courseId);
         if (!recordRemoved) {
-            Logger::getInstance().error("退课失败：无法删除选课记录");
+            LOG_ERROR("退课失败：无法删除选课记录");
             return false;
         }
         
-        // 保存选课数据和课程数据，确保数据同步
-        saveData(true); // 传入true表示已获取锁
-        courseManager.saveData(true); // 传入true表示已获取锁
+        // 选课数据和课程数据一起标记待写盘；服务未运行时同步保存（此处未持有锁，由各自的saveData加锁）
+        PersistenceService& persistence = PersistenceService::getInstance();
+        if (!persistence.markDirty(DataSet::ENROLLMENTS, generateKey(studentId, courseId))) {
+            saveData();
+        }
+        if (!persistence.markDirty(DataSet::COURSES, courseId)) {
+            courseManager.saveData();
+        }
         
         // 记录退课信息到日志
-        Logger::getInstance().info("退课成功：学生 " + studentId + " 退出课程 " + courseId);
+        LOGF_RATE_LIMITED(LogLevel::INFO, 20, "退课成功：学生 {} 退出课程 {}", studentId, courseId);
         return true;
     } catch (const SystemException& e) {
         // 已处理的系统异常，重新抛出
         throw;
     } catch (const std::exception& e) {
-        Logger::getInstance().error("退课失败：发生异常 - " + std::string(e.what()));
+        LOG_ERROR("退课失败：发生异常 - " + std::string(e.what()));
         throw SystemException(ErrorType::OPERATION_FAILED, "退课操作失败：" + std::string(e.what()));
     }
 }
 
-Enrollment* EnrollmentManager::getEnrollment(const std::string& studentId, const std::string& courseId) {
+std::shared_ptr<const Enrollment> EnrollmentManager::getEnrollment(const std::string& studentId, const std::string& courseId) {
     LockGuard lock(mutex_, 5000); // 设置5秒超时
     if (!lock.isLocked()) {
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
@@ -172,39 +210,37 @@ Enrollment* EnrollmentManager::getEnrollment(const std::string& studentId, const
         return nullptr;
     }
     
-    return it->second.get();
+    return it->second;
 }
 
-std::vector<Enrollment*> EnrollmentManager::getStudentEnrollments(const std::string& studentId) const {
+std::vector<std::shared_ptr<const Enrollment>> EnrollmentManager::getStudentEnrollments(const std::string& studentId) const {
     LockGuard lock(mutex_, 5000); // 设置5秒超时
     if (!lock.isLocked()) {
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
     }
     
-    std::vector<Enrollment*> result;
+    std::vector<std::shared_ptr<const Enrollment>> result;
     
     for (const auto& pair : enrollments_) {
-        Enrollment* enrollment = pair.second.get();
-        if (enrollment->getStudentId() == studentId) {
-            result.push_back(enrollment);
+        if (pair.second->getStudentId() == studentId) {
+            result.push_back(pair.second);
         }
     }
     
     return result;
 }
 
-std::vector<Enrollment*> EnrollmentManager::getCourseEnrollments(const std::string& courseId) const {
+std::vector<std::shared_ptr<const Enrollment>> EnrollmentManager::getCourseEnrollments(const std::string& courseId) const {
     LockGuard lock(mutex_, 5000); // 设置5秒超时
     if (!lock.isLocked()) {
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
     }
     
-    std::vector<Enrollment*> result;
+    std::vector<std::shared_ptr<const Enrollment>> result;
     
     for (const auto& pair : enrollments_) {
-        Enrollment* enrollment = pair.second.get();
-        if (enrollment->getCourseId() == courseId) {
-            result.push_back(enrollment);
+        if (pair.second->getCourseId() == courseId) {
+            result.push_back(pair.second);
         }
     }
     
@@ -223,7 +259,7 @@ bool EnrollmentManager::isEnrolled(const std::string& studentId, const std::stri
     return it != enrollments_.end();
 }
 
-std::vector<Enrollment*> EnrollmentManager::findEnrollments(
+std::vector<std::shared_ptr<const Enrollment>> EnrollmentManager::findEnrollments(
     const std::function<bool(const Enrollment&)>& predicate) const {
     
     LockGuard lock(mutex_, 5000); // 设置5秒超时
@@ -231,11 +267,11 @@ std::vector<Enrollment*> EnrollmentManager::findEnrollments(
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
     }
     
-    std::vector<Enrollment*> result;
+    std::vector<std::shared_ptr<const Enrollment>> result;
     
     for (const auto& pair : enrollments_) {
         if (predicate(*(pair.second))) {
-            result.push_back(pair.second.get());
+            result.push_back(pair.second);
         }
     }
     
@@ -254,7 +290,7 @@ bool EnrollmentManager::addEnrollment(std::unique_ptr<Enrollment> enrollment) {
     
     std::string key = generateKey(enrollment->getStudentId(), enrollment->getCourseId());
     if (enrollments_.find(key) != enrollments_.end()) {
-        Logger::getInstance().warning("添加选课记录失败：选课记录已存在");
+        LOG_WARNING("添加选课记录失败：选课记录已存在");
         return false;
     }
     
@@ -262,47 +298,64 @@ bool EnrollmentManager::addEnrollment(std::unique_ptr<Enrollment> enrollment) {
     return true;
 }
 
+uint64_t EnrollmentManager::versionOf(const std::string& key) const {
+    auto it = versions_.find(key);
+    return it != versions_.end() ? it->second : 0;
+}
+
 std::string EnrollmentManager::generateKey(const std::string& studentId, const std::string& courseId) {
     return studentId + ":" + courseId;
 }
 
 bool EnrollmentManager::loadData() {
     try {
+        // 重新读盘前先写出后台尚未落盘的修改，避免读到旧文件
+        PersistenceService::getInstance().flush();
+        
         LockGuard lock(mutex_, 5000); // 设置5秒超时
         if (!lock.isLocked()) {
             throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
         }
         
         DataManager& dataManager = DataManager::getInstance();
-        std::string jsonStr = dataManager.loadJsonFromFile("enrollment.json");
-        
-        if (jsonStr.empty()) {
-            Logger::getInstance().warning("选课数据文件为空或不存在");
-            return false;
+        DataManifest& manifest = dataManager.manifest();
+        uint64_t generation = manifest.onDisk(StorageTable::ENROLLMENTS);
+        if (manifest.isCurrent(StorageTable::ENROLLMENTS, generation)) {
+            // 上次加载后的写入都来自本进程，内存中的数据已是最新
+            LOG_RATE_LIMITED(LogLevel::DEBUG, 10, "选课数据未变化（代数 " + std::to_string(generation) + "），跳过重新加载");
+            return true;
         }
         
-        json enrollmentsJson = json::parse(jsonStr);
-        enrollments_.clear();
+        std::unordered_map<std::string, std::shared_ptr<const Enrollment>> enrollments;
+        std::unordered_map<std::string, uint64_t> versions;
         
-        for (const auto& enrollmentJson : enrollmentsJson) {
-            std::string studentId = enrollmentJson["studentId"];
-            std::string courseId = enrollmentJson["courseId"];
-            std::string enrollmentTime = enrollmentJson["enrollmentTime"];
-            
-            auto enrollment = std::make_unique<Enrollment>(studentId, courseId);
-            enrollment->setEnrollmentTime(enrollmentTime); // 设置时间，避免使用当前时间
-            
-            std::string key = generateKey(studentId, courseId);
-            enrollments_[key] = std::move(enrollment);
+        // 流式解析，逐条构建选课记录，不生成整个文件的DOM
+        bool loaded = dataManager.storage().scan(StorageTable::ENROLLMENTS, [&](json& enrollmentJson) {
+            uint64_t version = recordVersion(enrollmentJson);
+            auto enrollment = fromJson(enrollmentJson);
+            std::string key = generateKey(enrollment->getStudentId(), enrollment->getCourseId());
+            versions[key] = version;
+            enrollments[std::move(key)] = std::move(enrollment);
+        });
+        
+        if (!loaded) {
+            LOG_WARNING("选课数据文件为空或不存在");
+            return false;
         }
         
-        Logger::getInstance().info("成功加载选课数据，共 " + std::to_string(enrollments_.size()) + " 条记录");
+        enrollments_ = std::move(enrollments);
+        versions_ = std::move(versions);
+        manifest.acknowledge(StorageTable::ENROLLMENTS, generation);
+        
+        LOG_INFO("成功加载选课数据，共 " + std::to_string(enrollments_.size()) + " 条记录");
         return true;
+    } catch (const SystemException&) {
+        throw; // 文件损坏、锁超时等系统异常保留原类型
     } catch (const json::exception& e) {
-        Logger::getInstance().error("解析选课数据JSON失败：" + std::string(e.what()));
+        LOG_ERROR("解析选课数据JSON失败：" + std::string(e.what()));
         throw SystemException(ErrorType::DATA_INVALID, "解析选课数据失败：" + std::string(e.what()));
     } catch (const std::exception& e) {
-        Logger::getInstance().error("加载选课数据失败：" + std::string(e.what()));
+        LOG_ERROR("加载选课数据失败：" + std::string(e.what()));
         throw SystemException(ErrorType::OPERATION_FAILED, "加载选课数据失败：" + std::string(e.what()));
     }
 }
@@ -317,41 +370,234 @@ bool EnrollmentManager::saveData(bool alreadyLocked) {
             }
         }
         
-        json enrollmentsJson = json::array();
-        
-        for (const auto& pair : enrollments_) {
-            const Enrollment* enrollment = pair.second.get();
-            json enrollmentJson;
-            
-            enrollmentJson["studentId"] = enrollment->getStudentId();
-            enrollmentJson["courseId"] = enrollment->getCourseId();
-            enrollmentJson["enrollmentTime"] = enrollment->getEnrollmentTime();
-            
-            enrollmentsJson.push_back(enrollmentJson);
+        // 整体替换同样检查版本：其他进程修改过的记录不被覆盖，本次保存失败
+        RowVersions rowVersions;
+        for (const auto& [key, version] : versions_) {
+            size_t separator = key.find(':');
+            if (separator != std::string::npos) {
+                rowVersions[json{{"studentId", key.substr(0, separator)}, {"courseId", key.substr(separator + 1)}}.dump()] = version;
+            }
         }
         
-        std::string jsonStr = enrollmentsJson.dump(4); 
-        
-        DataManager& dataManager = DataManager::getInstance();
-        bool result = dataManager.saveJsonToFile("enrollment.json", jsonStr);
+        bool result = DataManager::getInstance().storage().replaceAll(StorageTable::ENROLLMENTS, &rowVersions,
+            [&](const StorageBackend::RecordSink& sink) {
+                for (const auto& pair : enrollments_) {
+                    sink(toJson(*pair.second));
+                }
+            });
         
         if (result) {
-            Logger::getInstance().info("成功保存选课数据，共 " + std::to_string(enrollments_.size()) + " 条记录");
+            versions_.clear();
+            for (const auto& [rowKey, version] : rowVersions) {
+                json key = json::parse(rowKey);
+                versions_[generateKey(key.at("studentId").get<std::string>(), key.at("courseId").get<std::string>())] = version;
+            }
+            LOG_RATE_LIMITED(LogLevel::INFO, 10, "成功保存选课数据，共 " + std::to_string(enrollments_.size()) + " 条记录");
         } 
 
         return result;
+    } catch (const SystemException&) {
+        throw;
     } catch (const json::exception& e) {
-        Logger::getInstance().error("生成选课数据JSON失败：" + std::string(e.what()));
+        LOG_ERROR("生成选课数据JSON失败：" + std::string(e.what()));
         throw SystemException(ErrorType::DATA_INVALID, "生成选课数据失败：" + std::string(e.what()));
     } catch (const std::exception& e) {
-        Logger::getInstance().error("保存选课数据失败：" + std::string(e.what()));
+        LOG_ERROR("保存选课数据失败：" + std::string(e.what()));
         throw SystemException(ErrorType::OPERATION_FAILED, "保存选课数据失败：" + std::string(e.what()));
     }
 }
 
+bool EnrollmentManager::saveRows(const std::vector<std::string>& keys) {
+    std::vector<RowChange> changes;
+    {
+        LockGuard lock(mutex_, 5000);
+        if (!lock.isLocked()) {
+            throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
+        }
+        
+        for (const auto& key : keys) {
+            auto it = enrollments_.find(key);
+            if (it != enrollments_.end()) {
+                json record = toJson(*it->second);
+                changes.push_back({storageRowKey(StorageTable::ENROLLMENTS, record), std::make_optional<json>(std::move(record)),
+                                   versionOf(key)});
+                continue;
+            }
+            
+            // 记录已删除：从generateKey生成的键中还原主键
+            size_t separator = key.find(':');
+            if (separator == std::string::npos) {
+                LOG_WARNING("无效的选课记录键：" + key);
+                continue;
+            }
+            changes.push_back({json{{"studentId", key.substr(0, separator)}, {"courseId", key.substr(separator + 1)}},
+                               std::nullopt, versionOf(key)});
+        }
+    }
+    
+    // 选课记录按学生和课程分行，冲突只发生在两个进程修改同一条记录时；放弃本进程的修改，以存储为准
+    std::vector<RowChange> written;
+    std::vector<RowConflict> rejected;
+    bool result = DataManager::getInstance().storage().applyRowsMerging(StorageTable::ENROLLMENTS, std::move(changes),
+        [](const RowChange&, const RowConflict&) {
+            return std::optional<RowChange>();
+        }, written, rejected);
+    
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
+    }
+    for (const auto& change : written) {
+        std::string key = generateKey(change.key.at("studentId").get<std::string>(), change.key.at("courseId").get<std::string>());
+        if (change.record) {
+            versions_[key] = recordVersion(*change.record);
+        } else {
+            versions_.erase(key);
+        }
+    }
+    for (const auto& conflict : rejected) {
+        std::string key = generateKey(conflict.key.at("studentId").get<std::string>(), conflict.key.at("courseId").get<std::string>());
+        LOG_WARNING("选课记录 " + key + " 已被其他进程修改，本进程的修改未保存");
+        if (!conflict.current) {
+            enrollments_.erase(key);
+            versions_.erase(key);
+            continue;
+        }
+        json record = *conflict.current;
+        versions_[key] = recordVersion(record);
+        enrollments_[key] = fromJson(record);
+    }
+    if (result) {
+        LOGF_RATE_LIMITED(LogLevel::DEBUG, 10, "已写入 {} 行选课数据", written.size());
+    }
+    return result;
+}
+
+size_t EnrollmentManager::syncFromStorage() {
+    DataManager& dataManager = DataManager::getInstance();
+    DataManifest& manifest = dataManager.manifest();
+    uint64_t generation = manifest.onDisk(StorageTable::ENROLLMENTS);
+    if (manifest.isCurrent(StorageTable::ENROLLMENTS, generation)) {
+        return 0;
+    }
+    
+    // 在锁外读取存储并构建对象，只在应用差异时持锁
+    std::unordered_map<std::string, std::shared_ptr<const Enrollment>> stored;
+    std::unordered_map<std::string, uint64_t> storedVersions;
+    bool loaded = dataManager.storage().scan(StorageTable::ENROLLMENTS, [&](json& enrollmentJson) {
+        uint64_t version = recordVersion(enrollmentJson);
+        auto enrollment = fromJson(enrollmentJson);
+        std::string key = generateKey(enrollment->getStudentId(), enrollment->getCourseId());
+        storedVersions[key] = version;
+        stored[std::move(key)] = std::move(enrollment);
+    });
+    if (!loaded) {
+        LOG_WARNING("选课数据文件为空或不存在，忽略本次同步");
+        return 0;
+    }
+    
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
+    }
+    
+    PersistenceService& persistence = PersistenceService::getInstance();
+    size_t changed = 0;
+    for (auto& [key, enrollment] : stored) {
+        if (persistence.isPending(DataSet::ENROLLMENTS, key)) {
+            continue; // 本地修改尚未写盘，以内存为准
+        }
+        versions_[key] = storedVersions[key];
+        // 以新对象替换，不修改已发布的记录
+        auto it = enrollments_.find(key);
+        if (it == enrollments_.end()) {
+            enrollments_[key] = std::move(enrollment);
+        } else if (it->second->getEnrollmentTime() != enrollment->getEnrollmentTime()) {
+            it->second = std::move(enrollment);
+        } else {
+            continue;
+        }
+        ++changed;
+    }
+    for (auto it = enrollments_.begin(); it != enrollments_.end();) {
+        if (stored.count(it->first) == 0 && !persistence.isPending(DataSet::ENROLLMENTS, it->first)) {
+            versions_.erase(it->first);
+            it = enrollments_.erase(it);
+            ++changed;
+        } else {
+            ++it;
+        }
+    }
+    manifest.acknowledge(StorageTable::ENROLLMENTS, generation);
+    
+    LOG_INFO("同步选课数据（代数 " + std::to_string(generation) + "），更新 " + std::to_string(changed) + " 条记录");
+    return changed;
+}
+
+std::unique_ptr<Enrollment> EnrollmentManager::fromJson(json& enrollmentJson) {
+    return std::make_unique<Enrollment>(
+        DataManager::takeString(enrollmentJson, "studentId"),
+        DataManager::takeString(enrollmentJson, "courseId"),
+        DataManager::takeString(enrollmentJson, "enrollmentTime")); // 保留原选课时间
+}
+
+json EnrollmentManager::toJson(const Enrollment& enrollment) {
+    return json{
+        {"studentId", enrollment.getStudentId()},
+        {"courseId", enrollment.getCourseId()},
+        {"enrollmentTime", enrollment.getEnrollmentTime()}};
+}
+
+size_t EnrollmentManager::archiveCourses(const std::string& semester, const std::vector<std::string>& courseIds) {
+    std::unordered_set<std::string> archived(courseIds.begin(), courseIds.end());
+    
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
+    }
+    
+    std::vector<std::string> keys;
+    std::vector<json> records;
+    for (const auto& pair : enrollments_) {
+        if (archived.count(pair.second->getCourseId()) == 0) {
+            continue;
+        }
+        json record = toJson(*pair.second);
+        record[RECORD_VERSION_FIELD] = versionOf(pair.first);
+        records.push_back(std::move(record));
+        keys.push_back(pair.first);
+    }
+    if (keys.empty()) {
+        return 0;
+    }
+    
+    // 先写归档分区再删除活动分区中的行，中途失败时下次归档会覆盖重复的记录
+    DataManager::getInstance().storage().archiveRows(StorageTable::ENROLLMENTS, semester, records);
+    
+    bool deferred = true;
+    for (const auto& key : keys) {
+        enrollments_.erase(key);
+        deferred = PersistenceService::getInstance().markDirty(DataSet::ENROLLMENTS, key) && deferred;
+    }
+    if (!deferred) {
+        saveData(true); // 服务未运行时同步保存，已持有锁
+    }
+    
+    LOG_INFO("已归档学期 " + semester + " 的 " + std::to_string(keys.size()) + " 条选课记录");
+    return keys.size();
+}
+
+std::vector<std::unique_ptr<Enrollment>> EnrollmentManager::loadArchivedEnrollments(const std::string& semester) const {
+    std::vector<std::unique_ptr<Enrollment>> enrollments;
+    DataManager::getInstance().storage().scanArchive(StorageTable::ENROLLMENTS, semester, [&](json& enrollmentJson) {
+        enrollments.push_back(fromJson(enrollmentJson));
+    });
+    return enrollments;
+}
+
 bool EnrollmentManager::removeEnrollment(const std::string& studentId, const std::string& courseId) {
     if (studentId.empty() || courseId.empty()) {
-        Logger::getInstance().warning("移除选课记录失败：学生ID或课程ID为空");
+        LOG_WARNING("移除选课记录失败：学生ID或课程ID为空");
         return false;
     }
     
@@ -370,6 +616,59 @@ bool EnrollmentManager::removeEnrollment(const std::string& studentId, const std
     
     // 从哈希表中移除记录
     enrollments_.erase(it);
-    Logger::getInstance().info("成功移除选课记录：学生 " + studentId + " 和课程 " + courseId);
+    LOGF_INFO("成功移除选课记录：学生 {} 和课程 {}", studentId, courseId);
+    return true;
+}
+
+void EnrollmentManager::writeSnapshot(SnapshotWriter& writer) const {
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
+    }
+
+    std::vector<EnrollmentRecord> records;
+    records.reserve(enrollments_.size());
+    for (const auto& pair : enrollments_) {
+        const Enrollment& enrollment = *pair.second;
+        records.push_back({
+            versionOf(pair.first),
+            writer.intern(enrollment.getStudentId()),
+            writer.intern(enrollment.getCourseId()),
+            writer.intern(enrollment.getEnrollmentTime()),
+            0});
+    }
+
+    writer.addSection(SnapshotSection::ENROLLMENTS, records);
+}
+
+bool EnrollmentManager::loadSnapshot(const SnapshotReader& reader) {
+    DataManifest& manifest = DataManager::getInstance().manifest();
+    uint64_t generation = manifest.onDisk(StorageTable::ENROLLMENTS);
+    size_t count = reader.recordCount(SnapshotSection::ENROLLMENTS);
+    std::unordered_map<std::string, std::shared_ptr<const Enrollment>> enrollments;
+    std::unordered_map<std::string, uint64_t> versions;
+    enrollments.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        EnrollmentRecord record = reader.record<EnrollmentRecord>(SnapshotSection::ENROLLMENTS, i);
+        auto enrollment = std::make_unique<Enrollment>(
+            reader.str(record.studentId),
+            reader.str(record.courseId),
+            reader.str(record.enrollmentTime));
+
+        std::string key = generateKey(enrollment->getStudentId(), enrollment->getCourseId());
+        versions[key] = record.version;
+        enrollments[std::move(key)] = std::move(enrollment);
+    }
+
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取选课管理器锁超时");
+    }
+    enrollments_ = std::move(enrollments);
+    versions_ = std::move(versions);
+    manifest.acknowledge(StorageTable::ENROLLMENTS, generation);
+
+    LOG_INFO("从快照加载选课数据，共 " + std::to_string(enrollments_.size()) + " 条记录");
     return true;
 }
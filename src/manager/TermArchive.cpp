@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/manager/TermArchive.h"
+#include "../../include/manager/CourseManager.h"
+#include "../../include/manager/EnrollmentManager.h"
+#include "../../include/util/DataManager.h"
+#include "../../include/system/LockGuard.h"
+#include "../../include/system/SystemException.h"
+#include "../../include/util/Logger.h"
+
+const Course* ArchivedTerm::findCourse(const std::string& courseId) const {
+    for (const auto& course : courses) {
+        if (course->getId() == courseId) {
+            return course.get();
+        }
+    }
+    return nullptr;
+}
+
+TermArchive& TermArchive::getInstance() {
+    static TermArchive instance; // Meyer's单例模式
+    return instance;
+}
+
+size_t TermArchive::archiveOldTerms(size_t activeTerms) {
+    if (activeTerms == 0) {
+        return 0;
+    }
+
+    CourseManager& courseManager = CourseManager::getInstance();
+    EnrollmentManager& enrollmentManager = EnrollmentManager::getInstance();
+    std::vector<std::string> semesters = courseManager.getSemesters();
+    if (semesters.size() <= activeTerms) {
+        return 0;
+    }
+
+    size_t archived = 0;
+    for (size_t i = 0; i + activeTerms < semesters.size(); ++i) {
+        const std::string& semester = semesters[i];
+        if (semester.empty()) {
+            continue; // 没有学期的课程始终留在活动分区
+        }
+        // 先归档选课记录，课程行最后删除，中途失败时下次启动仍能找到该学期的全部记录
+        std::vector<std::string> courseIds = courseManager.findCourses([&](const Course& course) {
+            return course.getSemester() == semester;
+        });
+        enrollmentManager.archiveCourses(semester, courseIds);
+        courseManager.archiveSemester(semester);
+        ++archived;
+    }
+
+    if (archived > 0) {
+        LockGuard lock(mutex_, 5000);
+        if (!lock.isLocked()) {
+            throw SystemException(ErrorType::LOCK_TIMEOUT, "获取学期归档锁超时");
+        }
+        loaded_.clear(); // 归档分区已变化
+        LOG_INFO("已将 " + std::to_string(archived) + " 个学期移入归档分区，保留最近 "
+            + std::to_string(activeTerms) + " 个学期");
+    }
+    return archived;
+}
+
+std::vector<std::string> TermArchive::terms() const {
+    return DataManager::getInstance().storage().archivedTerms();
+}
+
+std::shared_ptr<const ArchivedTerm> TermArchive::load(const std::string& semester) {
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取学期归档锁超时");
+    }
+
+    auto it = loaded_.find(semester);
+    if (it != loaded_.end()) {
+        return it->second;
+    }
+
+    auto term = std::make_shared<ArchivedTerm>();
+    term->semester = semester;
+    term->courses = CourseManager::getInstance().loadArchivedCourses(semester);
+    term->enrollments = EnrollmentManager::getInstance().loadArchivedEnrollments(semester);
+    LOG_INFO("加载归档学期 " + semester + "：" + std::to_string(term->courses.size()) + " 门课程，"
+        + std::to_string(term->enrollments.size()) + " 条选课记录");
+
+    loaded_[semester] = term;
+    return term;
+}
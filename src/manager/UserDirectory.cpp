@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/manager/UserDirectory.h"
+
+#include <functional>
+#include <utility>
+
+namespace {
+
+// 所有空分桶共享同一个对象
+const std::shared_ptr<const UserDirectory::Bucket>& emptyBucket() {
+    static const std::shared_ptr<const UserDirectory::Bucket> bucket =
+        std::make_shared<const UserDirectory::Bucket>();
+    return bucket;
+}
+
+} // namespace
+
+UserDirectory::UserDirectory() {
+    buckets_.fill(emptyBucket());
+}
+
+std::shared_ptr<const UserDirectory> UserDirectory::build(std::vector<std::shared_ptr<User>> users, uint64_t version) {
+    std::array<Bucket, BUCKET_COUNT> buckets;
+    for (auto& user : users) {
+        std::string id = user->getId();
+        buckets[bucketIndex(id)][id] = std::move(user);
+    }
+
+    auto directory = std::make_shared<UserDirectory>();
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        if (!buckets[i].empty()) {
+            directory->size_ += buckets[i].size();
+            directory->buckets_[i] = std::make_shared<const Bucket>(std::move(buckets[i]));
+        }
+    }
+    directory->version_ = version;
+    return directory;
+}
+
+std::shared_ptr<const UserDirectory> UserDirectory::with(std::shared_ptr<User> user) const {
+    std::string id = user->getId();
+    size_t index = bucketIndex(id);
+
+    // 只复制目标分桶，其余分桶共享
+    auto bucket = std::make_shared<Bucket>(*buckets_[index]);
+    bool inserted = bucket->insert_or_assign(id, std::move(user)).second;
+
+    auto directory = std::make_shared<UserDirectory>(*this);
+    directory->buckets_[index] = std::move(bucket);
+    directory->size_ = size_ + (inserted ? 1 : 0);
+    directory->version_ = version_ + 1;
+    return directory;
+}
+
+std::shared_ptr<const UserDirectory> UserDirectory::without(const std::string& userId) const {
+    size_t index = bucketIndex(userId);
+    if (buckets_[index]->find(userId) == buckets_[index]->end()) {
+        return nullptr;
+    }
+
+    auto bucket = std::make_shared<Bucket>(*buckets_[index]);
+    bucket->erase(userId);
+
+    auto directory = std::make_shared<UserDirectory>(*this);
+    directory->buckets_[index] = bucket->empty() ? emptyBucket() : std::move(bucket);
+    directory->size_ = size_ - 1;
+    directory->version_ = version_ + 1;
+    return directory;
+}
+
+std::shared_ptr<User> UserDirectory::find(const std::string& userId) const {
+    const Bucket& bucket = *buckets_[bucketIndex(userId)];
+    auto it = bucket.find(userId);
+    return it == bucket.end() ? nullptr : it->second;
+}
+
+bool UserDirectory::contains(const std::string& userId) const {
+    const Bucket& bucket = *buckets_[bucketIndex(userId)];
+    return bucket.find(userId) != bucket.end();
+}
+
+std::shared_ptr<Student> UserDirectory::findStudent(const std::string& studentId) const {
+    std::shared_ptr<User> user = find(studentId);
+    if (!user || user->getType() != UserType::STUDENT) {
+        return nullptr;
+    }
+    return std::static_pointer_cast<Student>(user);
+}
+
+std::shared_ptr<Teacher> UserDirectory::findTeacher(const std::string& teacherId) const {
+    std::shared_ptr<User> user = find(teacherId);
+    if (!user || user->getType() != UserType::TEACHER) {
+        return nullptr;
+    }
+    return std::static_pointer_cast<Teacher>(user);
+}
+
+std::shared_ptr<Admin> UserDirectory::findAdmin(const std::string& adminId) const {
+    std::shared_ptr<User> user = find(adminId);
+    if (!user || user->getType() != UserType::ADMIN) {
+        return nullptr;
+    }
+    return std::static_pointer_cast<Admin>(user);
+}
+
+std::vector<std::string> UserDirectory::idsOfType(UserType type) const {
+    std::vector<std::string> ids;
+    forEach([&](const User& user) {
+        if (user.getType() == type) {
+            ids.push_back(user.getId());
+        }
+    });
+    return ids;
+}
+
+size_t UserDirectory::bucketIndex(const std::string& userId) {
+    return std::hash<std::string>{}(userId) % BUCKET_COUNT;
+}
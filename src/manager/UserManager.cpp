@@ -16,25 +16,55 @@
  */
 #include "../../include/manager/UserManager.h"
 #include "../../include/util/DataManager.h"
+#include "../../include/util/SnapshotFile.h"
 #include "../../include/system/LockGuard.h"
+#include "../../include/system/PersistenceService.h"
 #include "../../include/system/SystemException.h"
+#include "../../include/util/LogRateLimiter.h"
 #include "../../include/util/Logger.h"
 
 #include "../../nlohmann/json.hpp"
 #include <algorithm>
+#include <utility>
 #include <vector>
 #include <stdexcept>
 
 using json = nlohmann::json;
 
+namespace {
+
+// 快照中的定长用户记录，字符串字段为字符串表序号；只含常驻字段，资料按需从存储读取
+struct UserRecord {
+    uint64_t version;     // 存储中的记录版本
+    uint32_t type;        // UserType
+    uint32_t id;
+    uint32_t password;
+    uint32_t salt;
+    uint32_t reserved;
+};
+
+} // namespace
+
 UserManager& UserManager::getInstance() {
     static UserManager instance;
     return instance;
 }
 
+UserManager::UserManager()
+    : profileCache_([](const std::string& userId) -> std::shared_ptr<const UserProfile> {
+          std::optional<json> record = DataManager::getInstance().storage().fetch(StorageTable::USERS, json{{"id", userId}});
+          return record ? profileFromJson(*record) : nullptr;
+      }) {
+    User::setProfileLoader(&profileCache_);
+}
+
+UserManager::~UserManager() {
+    User::setProfileLoader(nullptr);
+}
+
 bool UserManager::addStudent(std::unique_ptr<Student> student) {
     if (!student) {
-        Logger::getInstance().error("尝试添加空学生对象");
+        LOG_ERROR("尝试添加空学生对象");
         return false;
     }
     //release返回unique_ptr的指针，并释放unique_ptr
@@ -43,7 +73,7 @@ bool UserManager::addStudent(std::unique_ptr<Student> student) {
 
 bool UserManager::addTeacher(std::unique_ptr<Teacher> teacher) {
     if (!teacher) {
-        Logger::getInstance().error("尝试添加空教师对象");
+        LOG_ERROR("尝试添加空教师对象");
         return false;
     }
     
@@ -52,7 +82,7 @@ bool UserManager::addTeacher(std::unique_ptr<Teacher> teacher) {
 
 bool UserManager::addAdmin(std::unique_ptr<Admin> admin) {
     if (!admin) {
-        Logger::getInstance().error("尝试添加空管理员对象");
+        LOG_ERROR("尝试添加空管理员对象");
         return false;
     }
     
@@ -69,22 +99,24 @@ bool UserManager::addUser(std::unique_ptr<User> user) {
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
     }
     
-    const std::string& userId = user->getId();
-    if (users_.find(userId) != users_.end()) {
-        Logger::getInstance().warning("添加用户失败：用户ID " + userId + " 已存在");
+    std::string userId = user->getId();
+    std::shared_ptr<const UserDirectory> current = snapshot();
+    if (current->contains(userId)) {
+        LOG_WARNING("添加用户失败：用户ID " + userId + " 已存在");
         return false;
     }
     
-    users_[userId] = std::move(user);
+    // 生成新版本目录，只复制用户所在的分桶
+    publish(current->with(std::shared_ptr<User>(std::move(user))));
     
-    // 立即保存数据，传入true表示已获取锁
-    bool saveResult = saveData(true);
+    // 标记待写盘，服务未运行时立即保存（已持有锁）
+    bool saveResult = PersistenceService::getInstance().markDirty(DataSet::USERS, userId) || saveData(true);
     if (!saveResult) {
-        Logger::getInstance().error("添加用户后保存数据失败");
+        LOG_ERROR("添加用户后保存数据失败");
         return false;
     }
 
-     Logger::getInstance().info("成功添加用户: " + userId);
+     LOG_INFO("成功添加用户: " + userId);
     return true;
 }
 
@@ -94,348 +126,531 @@ bool UserManager::removeUser(const std::string& userId) {
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
     }
     
-    auto it = users_.find(userId);
-    if (it == users_.end()) {
-        Logger::getInstance().warning("移除用户失败：用户ID " + userId + " 不存在");
+    std::shared_ptr<const UserDirectory> next = snapshot()->without(userId);
+    if (!next) {
+        LOG_WARNING("移除用户失败：用户ID " + userId + " 不存在");
         return false;
     }
     
-    users_.erase(it);
+    // 旧快照的持有者仍可安全访问被移除的用户对象
+    publish(std::move(next));
         
-    // 立即保存数据，传入true表示已获取锁
-    bool saveResult = saveData(true);
+    // 标记待写盘，服务未运行时立即保存（已持有锁）
+    bool saveResult = PersistenceService::getInstance().markDirty(DataSet::USERS, userId) || saveData(true);
     if (!saveResult) {
-        Logger::getInstance().warning("移除用户后保存数据失败");
+        LOG_WARNING("移除用户后保存数据失败");
         return false;
     }
 
-    Logger::getInstance().info("成功移除用户: " + userId);
+    LOG_INFO("成功移除用户: " + userId);
     return true;
 }
 
-User* UserManager::getUser(const std::string& userId) {
-    LockGuard lock(mutex_, 5000); // 设置5秒超时
-    if (!lock.isLocked()) {
-        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
-    }
-    
-    auto it = users_.find(userId);
-    if (it == users_.end()) {
-        return nullptr;
-    }
-    
-    //get原始指针
-    return it->second.get();
+std::shared_ptr<User> UserManager::getUser(const std::string& userId) {
+    // 从已发布的快照中查找，不需要获取锁
+    return snapshot()->find(userId);
 }
 
-Student* UserManager::getStudent(const std::string& studentId) {
-    User* user = getUser(studentId);
-    if (!user || user->getType() != UserType::STUDENT) {
-        return nullptr;
-    }
-    
-    return dynamic_cast<Student*>(user);
+std::shared_ptr<Student> UserManager::getStudent(const std::string& studentId) {
+    return snapshot()->findStudent(studentId);
 }
 
-Teacher* UserManager::getTeacher(const std::string& teacherId) {
-    User* user = getUser(teacherId);
-    if (!user || user->getType() != UserType::TEACHER) {
-        return nullptr;
-    }
-    
-    return dynamic_cast<Teacher*>(user);
+std::shared_ptr<Teacher> UserManager::getTeacher(const std::string& teacherId) {
+    return snapshot()->findTeacher(teacherId);
 }
 
-Admin* UserManager::getAdmin(const std::string& adminId) {
-    User* user = getUser(adminId);
-    if (!user || user->getType() != UserType::ADMIN) {
-        return nullptr;
-    }
-    
-    return dynamic_cast<Admin*>(user);
+std::shared_ptr<Admin> UserManager::getAdmin(const std::string& adminId) {
+    return snapshot()->findAdmin(adminId);
 }
 
-User* UserManager::authenticate(const std::string& userId, const std::string& password) {
-    LockGuard lock(mutex_, 5000); // 设置5秒超时
-    if (!lock.isLocked()) {
-        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
-    }
-    
-    auto it = users_.find(userId);
-    if (it == users_.end()) {
-        Logger::getInstance().warning("认证失败：用户ID " + userId + " 不存在");
+std::shared_ptr<User> UserManager::authenticate(const std::string& userId, const std::string& password, const std::string& source) {
+    // 限流检查在加锁和哈希之前完成，被拒绝的请求几乎不消耗CPU，也不写日志
+    if (loginThrottle_.retryDelayMs(userId, source) > 0) {
         return nullptr;
     }
     
-    User* user = it->second.get();
-    if (!user->verifyPassword(password)) {
-        Logger::getInstance().warning("认证失败：用户 " + userId + " 密码错误");
+    // 查找用户和哈希计算都不持有锁，失败的登录不会拖慢其他用户操作
+    std::shared_ptr<User> user = snapshot()->find(userId);
+    if (!user || !user->verifyPassword(password)) {
+        int64_t delay = loginThrottle_.recordFailure(userId, source);
+        if (delay > 0) {
+            LOGF_WARNING("认证失败次数过多：用户 {}（来源 {}）需等待 {} 毫秒后重试", userId, source, delay);
+        } else if (!user) {
+            LOGF_WARNING("认证失败：用户ID {} 不存在", userId);
+        } else {
+            LOGF_WARNING("认证失败：用户 {} 密码错误", userId);
+        }
         return nullptr;
     }
     
-    Logger::getInstance().info("用户 " + userId + " 认证成功");
+    loginThrottle_.recordSuccess(userId);
+    LOGF_INFO("用户 {} 认证成功", userId);
     return user;
 }
 
-std::vector<std::string> UserManager::getAllStudentIds() const {
-    LockGuard lock(mutex_, 5000); // 设置5秒超时
-    if (!lock.isLocked()) {
-        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
-    }
-    
-    std::vector<std::string> studentIds;
-    for (const auto& pair : users_) {
-        if (pair.second->getType() == UserType::STUDENT) {
-            studentIds.push_back(pair.first);
-        }
+int UserManager::getLoginRetrySeconds(const std::string& userId, const std::string& source) const {
+    int64_t delay = loginThrottle_.retryDelayMs(userId, source);
+    if (delay <= 0) {
+        return 0;
     }
-    
-    return studentIds;
+    return static_cast<int>((delay + 999) / 1000);
+}
+
+std::vector<std::string> UserManager::getAllStudentIds() const {
+    return snapshot()->idsOfType(UserType::STUDENT);
 }
 
 std::vector<std::string> UserManager::getAllTeacherIds() const {
-    LockGuard lock(mutex_, 5000); // 设置5秒超时
-    if (!lock.isLocked()) {
-        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
-    }
-    
-    std::vector<std::string> teacherIds;
-    for (const auto& pair : users_) {
-        if (pair.second->getType() == UserType::TEACHER) {
-            teacherIds.push_back(pair.first);
-        }
-    }
-    
-    return teacherIds;
+    return snapshot()->idsOfType(UserType::TEACHER);
 }
 
 std::vector<std::string> UserManager::getAllAdminIds() const {
-    LockGuard lock(mutex_, 5000); // 设置5秒超时
-    if (!lock.isLocked()) {
-        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
-    }
-    
-    std::vector<std::string> adminIds;
-    for (const auto& pair : users_) {
-        if (pair.second->getType() == UserType::ADMIN) {
-            adminIds.push_back(pair.first);
-        }
-    }
-    
-    return adminIds;
+    return snapshot()->idsOfType(UserType::ADMIN);
 }
 
 bool UserManager::loadData() {
     try {
+        // 重新读盘前先写出后台尚未落盘的修改，避免读到旧文件
+        PersistenceService::getInstance().flush();
+        
         LockGuard lock(mutex_, 5000); // 设置5秒超时
         if (!lock.isLocked()) {
             throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
         }
         
         DataManager& dataManager = DataManager::getInstance(); // 获取单例
-        std::string jsonStr = dataManager.loadJsonFromFile("users.json");
-        
-        if (jsonStr.empty()) {
-            Logger::getInstance().warning("用户数据文件为空或不存在");
-            return false;
+        DataManifest& manifest = dataManager.manifest();
+        uint64_t generation = manifest.onDisk(StorageTable::USERS);
+        if (manifest.isCurrent(StorageTable::USERS, generation)) {
+            // 上次加载后的写入都来自本进程，内存中的数据已是最新
+            LOG_RATE_LIMITED(LogLevel::DEBUG, 10, "用户数据未变化（代数 " + std::to_string(generation) + "），跳过重新加载");
+            return true;
         }
         
-        json usersJson = json::parse(jsonStr);
-        users_.clear();
+        std::vector<std::shared_ptr<User>> users;
+        std::unordered_map<std::string, uint64_t> versions;
         
-        for (const auto& userJson : usersJson) {
-            std::string id = userJson["id"];
-            std::string name = userJson["name"];
-            std::string password = userJson["password"];
-            std::string salt = userJson["salt"];
-            std::string typeStr = userJson["type"];
-            
-            std::unique_ptr<User> user;
-            
-            if (typeStr == "STUDENT") {
-                auto student = std::make_unique<Student>();
-                student->setGender(userJson["gender"]);
-                student->setAge(userJson["age"]);
-                student->setDepartment(userJson["department"]);
-                student->setClassInfo(userJson["classInfo"]);
-                student->setContact(userJson["contact"]);
-                user = std::move(student);
-            } else if (typeStr == "TEACHER") {
-                auto teacher = std::make_unique<Teacher>();
-                teacher->setDepartment(userJson["department"]);
-                teacher->setTitle(userJson["title"]);
-                teacher->setContact(userJson["contact"]);
-                user = std::move(teacher);
-            } else if (typeStr == "ADMIN") {
-                user = std::make_unique<Admin>();
-            } else {
-                Logger::getInstance().warning("未知的用户类型：" + typeStr);
-                continue;
+        // 流式解析，逐条构建用户对象，不生成整个文件的DOM
+        bool loaded = dataManager.storage().scan(StorageTable::USERS, [&](json& userJson) {
+            uint64_t version = recordVersion(userJson);
+            std::unique_ptr<User> user = fromJson(userJson);
+            if (user) {
+                versions[user->getId()] = version;
+                users.push_back(std::move(user));
             }
-            
-            // 设置通用属性
-            user->id_ = id;
-            user->name_ = name;
-            user->password_ = password;
-            user->salt_ = salt;
-            
-            users_[id] = std::move(user);
+        });
+        
+        if (!loaded) {
+            LOG_WARNING("用户数据文件为空或不存在");
+            return false;
         }
         
-        Logger::getInstance().info("成功加载用户数据，共 " + std::to_string(users_.size()) + " 个用户");
+        // 一次性构建并发布新目录
+        publish(UserDirectory::build(std::move(users), snapshot()->version() + 1));
+        versions_ = std::move(versions);
+        manifest.acknowledge(StorageTable::USERS, generation);
+        
+        LOG_INFO("成功加载用户数据，共 " + std::to_string(snapshot()->size()) + " 个用户");
         return true;
+    } catch (const SystemException&) {
+        throw; // 文件损坏、锁超时等系统异常保留原类型
     } catch (const json::exception& e) {
-        Logger::getInstance().error("解析用户数据JSON失败：" + std::string(e.what()));
+        LOG_ERROR("解析用户数据JSON失败：" + std::string(e.what()));
         throw SystemException(ErrorType::DATA_INVALID, "解析用户数据失败：" + std::string(e.what()));
     } catch (const std::exception& e) {
-        Logger::getInstance().error("加载用户数据失败：" + std::string(e.what()));
+        LOG_ERROR("加载用户数据失败：" + std::string(e.what()));
         throw SystemException(ErrorType::OPERATION_FAILED, "加载用户数据失败：" + std::string(e.what()));
     }
 }
 
 bool UserManager::saveData(bool alreadyLocked) {
     try {
-        json usersJson = json::array();
-        std::string jsonStr;
-        {
-            // 指向锁的智能指针，实现条件性锁定和作用域控制
-            std::unique_ptr<LockGuard> lockPtr;
-            if (!alreadyLocked) {
-                // 在堆上创建锁
-                lockPtr = std::make_unique<LockGuard>(mutex_, 5000);
-                if (!lockPtr->isLocked()) {
-                    throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
-                }
+        // 指向锁的智能指针，实现条件性锁定和作用域控制
+        std::unique_ptr<LockGuard> lockPtr;
+        if (!alreadyLocked) {
+            // 在堆上创建锁
+            lockPtr = std::make_unique<LockGuard>(mutex_, 5000);
+            if (!lockPtr->isLocked()) {
+                throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
             }
-
-            for (const auto& pair : users_) {
-                const User* user = pair.second.get();
-                json userJson;
-                
-                // 通用属性
-                userJson["id"] = user->getId();
-                userJson["name"] = user->getName();
-                userJson["password"] = user->password_;
-                userJson["salt"] = user->salt_;
-                
-                switch (user->getType()) {
-                    case UserType::STUDENT: {
-                        const Student* student = static_cast<const Student*>(user);
-                        userJson["type"] = "STUDENT";
-                        userJson["gender"] = student->getGender();
-                        userJson["age"] = student->getAge();
-                        userJson["department"] = student->getDepartment();
-                        userJson["classInfo"] = student->getClassInfo();
-                        userJson["contact"] = student->getContact();
-                        break;
-                    }
-                    case UserType::TEACHER: {
-                        const Teacher* teacher = static_cast<const Teacher*>(user);
-                        userJson["type"] = "TEACHER";
-                        userJson["department"] = teacher->getDepartment();
-                        userJson["title"] = teacher->getTitle();
-                        userJson["contact"] = teacher->getContact();
-                        break;
-                    }
-                    case UserType::ADMIN:
-                        userJson["type"] = "ADMIN";
-                        break;
-                    default:
-                        Logger::getInstance().warning("未知的用户类型：" + std::to_string(static_cast<int>(user->getType())));
-                        continue;
-                }
-                
-                usersJson.push_back(userJson);
+        }
+        
+        // 未常驻的资料需从存储按需读取，而存储后端在replaceAll期间不能再读，先在锁内生成全部记录
+        std::vector<json> records;
+        records.reserve(snapshot()->size());
+        snapshot()->forEach([&](const User& user) {
+            json userJson = toJson(user);
+            if (!userJson.is_null()) {
+                userJson[RECORD_VERSION_FIELD] = versionOf(user.getId());
+                records.push_back(std::move(userJson));
             }
-            
-            jsonStr = usersJson.dump(4); // 格式化JSON，缩进4个空格
-        } // 如果创建了锁，锁会在这里释放
+        });
+        
+        // 整体替换同样检查版本：其他进程修改过的用户不被覆盖，本次保存失败
+        RowVersions rowVersions;
+        for (const auto& [userId, version] : versions_) {
+            rowVersions[json{{"id", userId}}.dump()] = version;
+        }
         
-        // 第二阶段：在锁释放后保存数据到文件
-        DataManager& dataManager = DataManager::getInstance();
-        bool result = dataManager.saveJsonToFile("users.json", jsonStr);
+        size_t count = records.size();
+        bool result = DataManager::getInstance().storage().replaceAll(StorageTable::USERS, &rowVersions,
+            [&](const StorageBackend::RecordSink& sink) {
+                for (const auto& record : records) {
+                    sink(record);
+                }
+            });
         
         if (result) {
-            Logger::getInstance().info("成功保存用户数据，共 " + std::to_string(usersJson.size()) + " 个用户");
+            versions_.clear();
+            for (const auto& [key, version] : rowVersions) {
+                versions_[json::parse(key).at("id").get<std::string>()] = version;
+            }
+            LOG_RATE_LIMITED(LogLevel::INFO, 10, "成功保存用户数据，共 " + std::to_string(count) + " 个用户");
         } else {
-            Logger::getInstance().error("保存用户数据失败");
+            LOG_ERROR("保存用户数据失败");
         }
         
         return result;
+    } catch (const SystemException&) {
+        throw;
     } catch (const json::exception& e) {
-        Logger::getInstance().error("生成用户数据JSON失败：" + std::string(e.what()));
+        LOG_ERROR("生成用户数据JSON失败：" + std::string(e.what()));
         throw SystemException(ErrorType::DATA_INVALID, "生成用户数据失败：" + std::string(e.what()));
     } catch (const std::exception& e) {
-        Logger::getInstance().error("保存用户数据失败：" + std::string(e.what()));
+        LOG_ERROR("保存用户数据失败：" + std::string(e.what()));
         throw SystemException(ErrorType::OPERATION_FAILED, "保存用户数据失败：" + std::string(e.what()));
     }
 }
 
+bool UserManager::saveRows(const std::vector<std::string>& userIds) {
+    std::vector<RowChange> changes;
+    std::vector<std::pair<std::shared_ptr<User>, std::shared_ptr<const UserProfile>>> residents;
+    {
+        LockGuard lock(mutex_, 5000);
+        if (!lock.isLocked()) {
+            throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
+        }
+        
+        // 用户仍存在则写入最新记录，否则删除对应行；记下写出的常驻资料，写盘后交回缓存
+        std::shared_ptr<const UserDirectory> directory = snapshot();
+        for (const auto& userId : userIds) {
+            std::shared_ptr<User> user = directory->find(userId);
+            if (!user) {
+                changes.push_back({json{{"id", userId}}, std::nullopt, versionOf(userId)});
+                continue;
+            }
+            bool resident = user->hasResidentProfile();
+            std::shared_ptr<const UserProfile> profile = user->loadProfile();
+            if (!profile) {
+                // 写入空资料会清空存储中的字段，保留脏标记稍后重试
+                throw SystemException(ErrorType::DATA_NOT_FOUND, "无法读取用户资料：" + userId);
+            }
+            if (resident) {
+                residents.emplace_back(user, profile);
+            }
+            changes.push_back({json{{"id", userId}}, std::make_optional<json>(toJson(*user, *profile)), versionOf(userId)});
+        }
+    }
+    
+    // 用户资料按行独立，冲突只发生在两个进程修改同一用户时；无法判断以哪一方为准，放弃本进程的修改
+    std::vector<RowChange> written;
+    std::vector<RowConflict> rejected;
+    bool result = DataManager::getInstance().storage().applyRowsMerging(StorageTable::USERS, std::move(changes),
+        [](const RowChange&, const RowConflict&) {
+            return std::optional<RowChange>();
+        }, written, rejected);
+    
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
+    }
+    for (const auto& change : written) {
+        std::string userId = change.key.at("id").get<std::string>();
+        if (change.record) {
+            versions_[userId] = recordVersion(*change.record);
+        } else {
+            versions_.erase(userId);
+        }
+    }
+    if (!rejected.empty()) {
+        adoptStored(rejected);
+    }
+    if (result) {
+        // 已落盘且期间未再修改（用户对象未被替换）的资料不必常驻，移入LRU缓存
+        std::shared_ptr<const UserDirectory> current = snapshot();
+        for (const auto& [user, profile] : residents) {
+            if (current->find(user->getId()) == user && user->releaseProfile(profile)) {
+                profileCache_.put(user->getId(), profile);
+            }
+        }
+        LOGF_RATE_LIMITED(LogLevel::DEBUG, 10, "已写入 {} 行用户数据", written.size());
+    }
+    return result;
+}
+
+void UserManager::adoptStored(const std::vector<RowConflict>& conflicts) {
+    // 以存储中的当前记录替换被拒绝的本地修改，调用方据此看到其他进程的修改后重试
+    std::shared_ptr<const UserDirectory> current = snapshot();
+    std::shared_ptr<const UserDirectory> next = current;
+    for (const auto& conflict : conflicts) {
+        std::string userId = conflict.key.at("id").get<std::string>();
+        LOG_WARNING("用户 " + userId + " 已被其他进程修改，本进程的修改未保存");
+        profileCache_.invalidate(userId);
+        if (!conflict.current) {
+            versions_.erase(userId);
+            if (auto reduced = next->without(userId)) {
+                next = std::move(reduced);
+            }
+            continue;
+        }
+        json userJson = *conflict.current;
+        versions_[userId] = recordVersion(userJson);
+        if (std::unique_ptr<User> user = fromJson(userJson)) {
+            next = next->with(std::shared_ptr<User>(std::move(user)));
+        }
+    }
+    if (next != current) {
+        publish(std::move(next));
+    }
+}
+
+uint64_t UserManager::versionOf(const std::string& userId) const {
+    auto it = versions_.find(userId);
+    return it != versions_.end() ? it->second : 0;
+}
+
+size_t UserManager::syncFromStorage() {
+    DataManager& dataManager = DataManager::getInstance();
+    DataManifest& manifest = dataManager.manifest();
+    uint64_t generation = manifest.onDisk(StorageTable::USERS);
+    if (manifest.isCurrent(StorageTable::USERS, generation)) {
+        return 0;
+    }
+    
+    // 在锁外读取存储并构建对象，只在应用差异时持锁
+    std::unordered_map<std::string, std::unique_ptr<User>> stored;
+    std::unordered_map<std::string, uint64_t> storedVersions;
+    bool loaded = dataManager.storage().scan(StorageTable::USERS, [&](json& userJson) {
+        uint64_t version = recordVersion(userJson);
+        std::unique_ptr<User> user = fromJson(userJson);
+        if (user) {
+            std::string id = user->getId();
+            storedVersions[id] = version;
+            stored[std::move(id)] = std::move(user);
+        }
+    });
+    if (!loaded) {
+        LOG_WARNING("用户数据文件为空或不存在，忽略本次同步");
+        return 0;
+    }
+    
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
+    }
+    
+    PersistenceService& persistence = PersistenceService::getInstance();
+    std::shared_ptr<const UserDirectory> current = snapshot();
+    std::shared_ptr<const UserDirectory> next = current;
+    size_t changed = 0;
+    for (auto& [userId, user] : stored) {
+        if (persistence.isPending(DataSet::USERS, userId)) {
+            continue; // 本地修改尚未写盘，以内存为准
+        }
+        versions_[userId] = storedVersions[userId];
+        std::shared_ptr<User> existing = next->find(userId);
+        if (existing && existing->getType() == user->getType() && existing->password_ == user->password_
+            && existing->salt_ == user->salt_ && !existing->hasResidentProfile()) {
+            continue; // 资料不常驻，清空缓存后下次访问即读到存储中的最新内容
+        }
+        // 以新对象替换，已发布的用户对象不做修改；持有旧对象的调用方不受影响
+        next = next->with(std::shared_ptr<User>(std::move(user)));
+        ++changed;
+    }
+    std::vector<std::string> removed;
+    current->forEach([&](const User& user) {
+        if (stored.count(user.getId()) == 0 && !persistence.isPending(DataSet::USERS, user.getId())) {
+            removed.push_back(user.getId());
+        }
+    });
+    for (const auto& userId : removed) {
+        versions_.erase(userId);
+        if (auto reduced = next->without(userId)) {
+            next = std::move(reduced);
+            ++changed;
+        }
+    }
+    
+    profileCache_.clear();
+    
+    // 有用户被添加、替换或删除时发布新版本
+    if (next != current) {
+        publish(std::move(next));
+    }
+    manifest.acknowledge(StorageTable::USERS, generation);
+    
+    LOG_INFO("同步用户数据（代数 " + std::to_string(generation) + "），更新 " + std::to_string(changed) + " 个用户");
+    return changed;
+}
+
+std::unique_ptr<User> UserManager::fromJson(json& userJson) {
+    std::string typeStr = DataManager::takeString(userJson, "type");
+    std::unique_ptr<User> user;
+    
+    // 只构建ID和登录凭据，资料在首次访问时经由profileCache_读取
+    if (typeStr == "STUDENT") {
+        user = std::make_unique<Student>();
+    } else if (typeStr == "TEACHER") {
+        user = std::make_unique<Teacher>();
+    } else if (typeStr == "ADMIN") {
+        user = std::make_unique<Admin>();
+    } else {
+        LOG_WARNING("未知的用户类型：" + typeStr);
+        return nullptr;
+    }
+    
+    // 设置通用属性
+    user->id_ = DataManager::takeString(userJson, "id");
+    user->password_ = DataManager::takeString(userJson, "password");
+    user->salt_ = DataManager::takeString(userJson, "salt");
+    return user;
+}
+
+std::shared_ptr<const UserProfile> UserManager::profileFromJson(const json& userJson) {
+    auto profile = std::make_shared<UserProfile>();
+    profile->name = userJson.at("name").get<std::string>();
+    
+    const std::string& typeStr = userJson.at("type").get_ref<const std::string&>();
+    if (typeStr == "STUDENT") {
+        profile->gender = userJson.at("gender").get<std::string>();
+        profile->age = userJson.at("age").get<int>();
+        profile->department = userJson.at("department").get<std::string>();
+        profile->classInfo = userJson.at("classInfo").get<std::string>();
+        profile->contact = userJson.at("contact").get<std::string>();
+    } else if (typeStr == "TEACHER") {
+        profile->department = userJson.at("department").get<std::string>();
+        profile->title = userJson.at("title").get<std::string>();
+        profile->contact = userJson.at("contact").get<std::string>();
+    }
+    return profile;
+}
+
+json UserManager::toJson(const User& user) {
+    std::shared_ptr<const UserProfile> profile = user.loadProfile();
+    if (!profile) {
+        throw SystemException(ErrorType::DATA_NOT_FOUND, "无法读取用户资料：" + user.getId());
+    }
+    return toJson(user, *profile);
+}
+
+json UserManager::toJson(const User& user, const UserProfile& profile) {
+    json userJson;
+    
+    // 通用属性
+    userJson["id"] = user.getId();
+    userJson["name"] = profile.name;
+    userJson["password"] = user.password_;
+    userJson["salt"] = user.salt_;
+    
+    switch (user.getType()) {
+        case UserType::STUDENT:
+            userJson["type"] = "STUDENT";
+            userJson["gender"] = profile.gender;
+            userJson["age"] = profile.age;
+            userJson["department"] = profile.department;
+            userJson["classInfo"] = profile.classInfo;
+            userJson["contact"] = profile.contact;
+            break;
+        case UserType::TEACHER:
+            userJson["type"] = "TEACHER";
+            userJson["department"] = profile.department;
+            userJson["title"] = profile.title;
+            userJson["contact"] = profile.contact;
+            break;
+        case UserType::ADMIN:
+            userJson["type"] = "ADMIN";
+            break;
+        default:
+            LOG_WARNING("未知的用户类型：" + std::to_string(static_cast<int>(user.getType())));
+            return json();
+    }
+    
+    return userJson;
+}
+
 bool UserManager::updateUserInfo(const User& user) {
     LockGuard lock(mutex_, 5000); // 设置5秒超时
     if (!lock.isLocked()) {
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
     }
 
-    auto it = users_.find(user.getId());
-    if (it == users_.end()) {
-        Logger::getInstance().warning("更新用户信息失败：用户ID " + user.getId() + " 不存在");
+    std::shared_ptr<const UserDirectory> current = snapshot();
+    std::shared_ptr<User> existingUser = current->find(user.getId());
+    if (!existingUser) {
+        LOG_WARNING("更新用户信息失败：用户ID " + user.getId() + " 不存在");
         return false;
     }
+    if (existingUser->getType() != user.getType()) {
+        LOG_WARNING("更新用户信息失败：用户 " + user.getId() + " 的类型不匹配");
+        return false;
+    }
+    
+    // 新资料由user的各字段组成，读不到user的资料时各字段为空，不能据此修改
+    if (!user.loadProfile()) {
+        LOG_WARNING("更新用户信息失败：无法读取用户 " + user.getId() + " 的资料");
+        return false;
+    }
+    
+    // 已发布的用户对象可能正被无锁读取，在副本上修改后发布新版本目录
+    std::shared_ptr<User> updated = existingUser->clone();
     
     // 根据用户类型，执行不同的更新操作
     switch (user.getType()) {
         case UserType::STUDENT: {
-            Student* existingStudent = dynamic_cast<Student*>(it->second.get());
-            const Student& student = dynamic_cast<const Student&>(user);
+            Student* updatedStudent = static_cast<Student*>(updated.get());
+            const Student& student = static_cast<const Student&>(user);
             
-            existingStudent->setName(student.getName());
-            existingStudent->setGender(student.getGender());
-            existingStudent->setAge(student.getAge());
-            existingStudent->setDepartment(student.getDepartment());
-            existingStudent->setClassInfo(student.getClassInfo());
-            existingStudent->setContact(student.getContact());
+            updatedStudent->setName(student.getName());
+            updatedStudent->setGender(student.getGender());
+            updatedStudent->setAge(student.getAge());
+            updatedStudent->setDepartment(student.getDepartment());
+            updatedStudent->setClassInfo(student.getClassInfo());
+            updatedStudent->setContact(student.getContact());
             break;
         }
         case UserType::TEACHER: {
-            Teacher* existingTeacher = dynamic_cast<Teacher*>(it->second.get());
-            const Teacher& teacher = dynamic_cast<const Teacher&>(user);
+            Teacher* updatedTeacher = static_cast<Teacher*>(updated.get());
+            const Teacher& teacher = static_cast<const Teacher&>(user);
             
-            existingTeacher->setName(teacher.getName());
-            existingTeacher->setDepartment(teacher.getDepartment());
-            existingTeacher->setTitle(teacher.getTitle());
-            existingTeacher->setContact(teacher.getContact());
+            updatedTeacher->setName(teacher.getName());
+            updatedTeacher->setDepartment(teacher.getDepartment());
+            updatedTeacher->setTitle(teacher.getTitle());
+            updatedTeacher->setContact(teacher.getContact());
             break;
         }
         case UserType::ADMIN: {
-            Admin* existingAdmin = dynamic_cast<Admin*>(it->second.get());
-            const Admin& admin = dynamic_cast<const Admin&>(user);
-            
-            existingAdmin->setName(admin.getName());
+            updated->setName(user.getName());
             break;
         }
         default:
-            Logger::getInstance().warning("未知的用户类型：" + std::to_string(static_cast<int>(user.getType())));
+            LOG_WARNING("未知的用户类型：" + std::to_string(static_cast<int>(user.getType())));
             return false;
     }
     
-    // 立即保存数据，传入true表示已获取锁
-    bool saveResult = saveData(true);
+    publish(current->with(std::move(updated)));
+    
+    // 标记待写盘，服务未运行时立即保存（已持有锁）
+    bool saveResult = PersistenceService::getInstance().markDirty(DataSet::USERS, user.getId()) || saveData(true);
     if (!saveResult) {
-        Logger::getInstance().warning("更新用户信息后保存数据失败");
+        LOG_WARNING("更新用户信息后保存数据失败");
     }
-    Logger::getInstance().info("成功更新用户信息: " + user.getId());
+    LOG_INFO("成功更新用户信息: " + user.getId());
     
     return true;
 }
 
 bool UserManager::hasUser(const std::string& userId) const {
-    LockGuard lock(mutex_, 5000);
-    if (!lock.isLocked()) {
-        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
-    }
-    
-    return users_.find(userId) != users_.end();
+    return snapshot()->contains(userId);
 }
 
 bool UserManager::changeUserPassword(const std::string& userId, const std::string& oldPassword, const std::string& newPassword) {
@@ -445,48 +660,119 @@ bool UserManager::changeUserPassword(const std::string& userId, const std::strin
             throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
         }
         
-        auto it = users_.find(userId);
-        if (it == users_.end()) {
-            Logger::getInstance().warning("修改密码失败：用户ID " + userId + " 不存在");
+        std::shared_ptr<const UserDirectory> current = snapshot();
+        std::shared_ptr<User> user = current->find(userId);
+        if (!user) {
+            LOG_WARNING("修改密码失败：用户ID " + userId + " 不存在");
             return false;
         }
         
-        User* user = it->second.get();
-        
         if (!user->verifyPassword(oldPassword)) {
-            Logger::getInstance().warning("修改密码失败：用户 " + userId + " 原密码验证失败");
+            LOG_WARNING("修改密码失败：用户 " + userId + " 原密码验证失败");
             return false;
         }
         
-        user->setPassword(newPassword);
+        // 登录验证无锁读取凭据，新凭据写在副本上并随新版本目录一起发布
+        std::shared_ptr<User> updated = user->clone();
+        updated->setPassword(newPassword);
+        publish(current->with(std::move(updated)));
         
-        // 立即保存数据，传入true表示已获取锁
-        bool saveResult = saveData(true);
+        // 标记待写盘，服务未运行时立即保存（已持有锁）
+        bool saveResult = PersistenceService::getInstance().markDirty(DataSet::USERS, userId) || saveData(true);
         if (!saveResult) {
-            Logger::getInstance().warning("修改密码后保存数据失败");
+            LOG_WARNING("修改密码后保存数据失败");
             return false;
         }
 
-        Logger::getInstance().info("用户 " + userId + " 密码修改成功");
+        LOG_INFO("用户 " + userId + " 密码修改成功");
         return true;
     } catch (const std::exception& e) {
-        Logger::getInstance().error("修改密码出现异常: " + std::string(e.what()));
+        LOG_ERROR("修改密码出现异常: " + std::string(e.what()));
         return false;
     }
 }
 
 std::vector<std::string> UserManager::findUsers(const std::function<bool(const User&)>& predicate) const {
-    LockGuard lock(mutex_, 5000); // 设置5秒超时
+    std::vector<std::string> result;
+    snapshot()->forEach([&](const User& user) {
+        if (predicate(user)) {
+            result.push_back(user.getId());
+        }
+    });
+    
+    return result;
+}
+
+std::shared_ptr<const UserDirectory> UserManager::snapshot() const {
+    return std::atomic_load(&directory_);
+}
+
+void UserManager::publish(std::shared_ptr<const UserDirectory> directory) {
+    std::atomic_store(&directory_, std::move(directory));
+}
+
+void UserManager::writeSnapshot(SnapshotWriter& writer) const {
+    LockGuard lock(mutex_, 5000); // 读取versions_需持锁，目录本身取自同一时刻的快照
     if (!lock.isLocked()) {
         throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
     }
-    
-    std::vector<std::string> result;
-    for (const auto& pair : users_) {
-        if (predicate(*(pair.second))) {
-            result.push_back(pair.first);
+
+    std::vector<UserRecord> records;
+    records.reserve(snapshot()->size());
+    snapshot()->forEach([&](const User& user) {
+        UserRecord record{};
+        record.version = versionOf(user.getId());
+        record.type = static_cast<uint32_t>(user.getType());
+        record.id = writer.intern(user.getId());
+        record.password = writer.intern(user.password_);
+        record.salt = writer.intern(user.salt_);
+        records.push_back(record);
+    });
+
+    writer.addSection(SnapshotSection::USERS, records);
+}
+
+bool UserManager::loadSnapshot(const SnapshotReader& reader) {
+    DataManifest& manifest = DataManager::getInstance().manifest();
+    uint64_t generation = manifest.onDisk(StorageTable::USERS);
+    size_t count = reader.recordCount(SnapshotSection::USERS);
+    std::vector<std::shared_ptr<User>> users;
+    std::unordered_map<std::string, uint64_t> versions;
+    users.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        UserRecord record = reader.record<UserRecord>(SnapshotSection::USERS, i);
+        std::shared_ptr<User> user;
+
+        switch (static_cast<UserType>(record.type)) {
+            case UserType::STUDENT:
+                user = std::make_shared<Student>();
+                break;
+            case UserType::TEACHER:
+                user = std::make_shared<Teacher>();
+                break;
+            case UserType::ADMIN:
+                user = std::make_shared<Admin>();
+                break;
+            default:
+                throw SystemException(ErrorType::FILE_CORRUPTED, "快照中存在未知的用户类型：" + std::to_string(record.type));
         }
+
+        user->id_ = reader.str(record.id);
+        user->password_ = reader.str(record.password);
+        user->salt_ = reader.str(record.salt);
+        versions[user->id_] = record.version;
+        users.push_back(std::move(user));
     }
-    
-    return result;
+
+    LockGuard lock(mutex_, 5000);
+    if (!lock.isLocked()) {
+        throw SystemException(ErrorType::LOCK_TIMEOUT, "获取用户管理器锁超时");
+    }
+    publish(UserDirectory::build(std::move(users), snapshot()->version() + 1));
+    versions_ = std::move(versions);
+    manifest.acknowledge(StorageTable::USERS, generation);
+
+    LOG_INFO("从快照加载用户数据，共 " + std::to_string(snapshot()->size()) + " 个用户");
+    return true;
 }
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/manager/UserProfileCache.h"
+
+UserProfileCache::UserProfileCache(Fetch fetch, size_t capacity)
+    : fetch_(std::move(fetch)), capacity_(capacity > 0 ? capacity : 1) {
+}
+
+std::shared_ptr<const UserProfile> UserProfileCache::acquire(const User& user) {
+    const std::string& userId = user.getId();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(userId);
+        if (it != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second;
+        }
+        ++misses_;
+    }
+
+    // 读取存储时不持锁，其他用户的命中不受影响；并发读取同一用户时以后插入的为准
+    std::shared_ptr<const UserProfile> profile = fetch_(userId);
+    if (profile) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        insert(userId, profile);
+    }
+    return profile;
+}
+
+void UserProfileCache::put(const std::string& userId, std::shared_ptr<const UserProfile> profile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert(userId, std::move(profile));
+}
+
+void UserProfileCache::invalidate(const std::string& userId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(userId);
+    if (it != index_.end()) {
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+}
+
+void UserProfileCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
+
+size_t UserProfileCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t UserProfileCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void UserProfileCache::insert(const std::string& userId, std::shared_ptr<const UserProfile> profile) {
+    auto it = index_.find(userId);
+    if (it != index_.end()) {
+        it->second->second = std::move(profile);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+    entries_.emplace_front(userId, std::move(profile));
+    index_[userId] = entries_.begin();
+    if (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+}
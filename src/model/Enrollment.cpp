@@ -26,6 +26,12 @@ Enrollment::Enrollment(std::string studentId, std::string courseId)
       enrollmentTime_(getCurrentTimeString()) {
 }
 
+Enrollment::Enrollment(std::string studentId, std::string courseId, std::string enrollmentTime)
+    : studentId_(std::move(studentId)),
+      courseId_(std::move(courseId)),
+      enrollmentTime_(std::move(enrollmentTime)) {
+}
+
 Enrollment::Enrollment(Enrollment&& other) noexcept
     : studentId_(std::move(other.studentId_)),
       courseId_(std::move(other.courseId_)),
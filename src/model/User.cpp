@@ -16,25 +16,25 @@
  */
 #include "../../include/model/User.h"
 #include "../../include/system/SystemException.h"
+#include "../../include/util/BinaryLogger.h"
 #include "../../include/util/Logger.h"
+#include "../../include/util/PasswordHasher.h"
 
-// OpenSSL库头文件
-#include <openssl/sha.h>
-#include <openssl/rand.h>
-#include <openssl/evp.h>
-#include <openssl/opensslv.h> // 用于版本检查
-
-#include <sstream>
-#include <iomanip>
 #include <random>
 #include <algorithm>
 #include <utility>
 #include <functional> 
 #include <iostream>
 
+UserProfileLoader* User::profileLoader_ = nullptr;
+
 // User 类实现
 User::User(std::string id, std::string name, std::string password)
-    : id_(std::move(id)), name_(std::move(name)) {
+    : id_(std::move(id)) {
+    auto profile = std::make_shared<UserProfile>();
+    profile->name = std::move(name);
+    profile_ = std::move(profile);
+
     // 对特定用户进行特殊处理
     if (id_ == "admin001" || id_ == "teacher001" || id_ == "student001") {
         // 特殊用户处理 - 使用不带盐值的纯密码哈希
@@ -50,51 +50,95 @@ User::User(std::string id, std::string name, std::string password)
 
 User::User(User&& other) noexcept
     : id_(std::move(other.id_)),
-      name_(std::move(other.name_)),
       password_(std::move(other.password_)),
-      salt_(std::move(other.salt_)) {
+      salt_(std::move(other.salt_)),
+      profile_(std::atomic_exchange(&other.profile_, std::shared_ptr<const UserProfile>())) {
 }
 
 User& User::operator=(User&& other) noexcept {
     if (this != &other) {
         id_ = std::move(other.id_);
-        name_ = std::move(other.name_);
         password_ = std::move(other.password_);
         salt_ = std::move(other.salt_);
+        // 目录中的用户可能正被无锁读取，资料指针原子替换
+        std::atomic_store(&profile_, std::atomic_exchange(&other.profile_, std::shared_ptr<const UserProfile>()));
     }
     return *this;
 }
 
+void User::setName(std::string name) {
+    updateProfile([&name](UserProfile& profile) { profile.name = std::move(name); });
+}
+
+bool User::hasResidentProfile() const {
+    return std::atomic_load(&profile_) != nullptr;
+}
+
+void User::setProfileLoader(UserProfileLoader* loader) {
+    profileLoader_ = loader;
+}
+
+std::shared_ptr<const UserProfile> User::profile() const {
+    if (std::shared_ptr<const UserProfile> loaded = loadProfile()) {
+        return loaded;
+    }
+    static const std::shared_ptr<const UserProfile> empty = std::make_shared<const UserProfile>();
+    return empty;
+}
+
+std::shared_ptr<const UserProfile> User::loadProfile() const {
+    if (std::shared_ptr<const UserProfile> resident = std::atomic_load(&profile_)) {
+        return resident;
+    }
+    return profileLoader_ ? profileLoader_->acquire(*this) : nullptr;
+}
+
+void User::updateProfile(const std::function<void(UserProfile&)>& update) {
+    // 在空资料上修改再写盘会清空其余字段，读取失败时拒绝修改
+    std::shared_ptr<const UserProfile> current = loadProfile();
+    if (!current) {
+        LOG_ERROR("读取用户 " + id_ + " 的资料失败，拒绝修改");
+        throw SystemException(ErrorType::DATA_NOT_FOUND, "无法读取用户资料：" + id_);
+    }
+    auto next = std::make_shared<UserProfile>(*current);
+    update(*next);
+    std::atomic_store(&profile_, std::shared_ptr<const UserProfile>(std::move(next)));
+}
+
+void User::setProfile(std::shared_ptr<const UserProfile> profile) {
+    std::atomic_store(&profile_, std::move(profile));
+}
+
+bool User::releaseProfile(std::shared_ptr<const UserProfile> expected) {
+    return expected && std::atomic_compare_exchange_strong(&profile_, &expected, std::shared_ptr<const UserProfile>());
+}
+
+void User::copyFrom(const User& other) {
+    id_ = other.id_;
+    password_ = other.password_;
+    salt_ = other.salt_;
+    profile_ = std::atomic_load(&other.profile_); // 资料不可变，新旧对象可共享
+}
+
 bool User::verifyPassword(const std::string& password) const {
     // 方法1：针对特殊账户的验证逻辑
     if (id_ == "admin001" || id_ == "teacher001" || id_ == "student001") {
         // 如果是特殊账户且盐值为空（未修改过密码），使用纯哈希值比较
         if (salt_.empty()) {
-            Logger::getInstance().debug("特殊账户处理：使用纯哈希验证（无盐值）");
-            // 计算纯哈希值并与存储的哈希值比较
-            std::string pureHash = generatePasswordHash(password, "");
-            Logger::getInstance().debug("输入密码的纯哈希: " + pureHash);
-            Logger::getInstance().debug("存储的哈希: " + password_);
-            bool directMatch = (password_ == pureHash);
-            Logger::getInstance().debug("纯哈希匹配: " + std::string(directMatch ? "是" : "否"));
+            LOG_DEBUG("特殊账户处理：使用纯哈希验证（无盐值）");
+            bool directMatch = PasswordHasher::verify(password, "", password_);
+            LOGF_DEBUG("纯哈希匹配: {}", directMatch ? "是" : "否");
             return directMatch;
         }
         // 如果特殊账户已修改过密码（有盐值），使用标准方法验证
-        Logger::getInstance().debug("特殊账户处理：已修改过密码，使用盐值验证");
+        LOG_DEBUG("特殊账户处理：已修改过密码，使用盐值验证");
     }
     
-    // 方法2：密码和盐值拼接后哈希（标准方法）
-    std::string combinedHash = generatePasswordHash(password, salt_);
+    // 方法2：密码和盐值拼接后哈希（标准方法），以二进制形式比较
+    LOGF_DEBUG("验证密码：{}", id_);
+    bool combinedMatch = PasswordHasher::verify(password, salt_, password_);
     
-    Logger::getInstance().debug("验证密码：" + id_);
-    Logger::getInstance().debug("盐值: " + salt_);
-    Logger::getInstance().debug("密码+盐值哈希: " + combinedHash);
-    Logger::getInstance().debug("存储的哈希: " + password_);
-    
-    // 判断是否匹配
-    bool combinedMatch = (password_ == combinedHash);
-    
-    Logger::getInstance().debug("哈希匹配: " + std::string(combinedMatch ? "是" : "否"));
+    LOGF_DEBUG("哈希匹配: {}", combinedMatch ? "是" : "否");
     
     return combinedMatch;
 }
@@ -106,51 +150,8 @@ void User::setPassword(std::string password) {
 }
 
 std::string User::generatePasswordHash(const std::string& password, const std::string& salt) {
-    // 将密码和盐值拼接
-    std::string combined = password + salt;
-    
-    // OpenSSL实现 - 使用EVP API
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    
-    #if OPENSSL_VERSION_NUMBER >= 0x30000000L
-    // 使用OpenSSL 3.0推荐的EVP接口
-    EVP_MD_CTX *mdctx = EVP_MD_CTX_new();
-    if (mdctx == NULL) {
-        throw SystemException(ErrorType::OPERATION_FAILED, "OpenSSL错误：无法创建EVP_MD_CTX");
-    }
-    
-    if (EVP_DigestInit_ex(mdctx, EVP_sha256(), NULL) != 1) {
-        EVP_MD_CTX_free(mdctx);
-        throw SystemException(ErrorType::OPERATION_FAILED, "OpenSSL错误：无法初始化摘要");
-    }
-    
-    if (EVP_DigestUpdate(mdctx, combined.c_str(), combined.length()) != 1) {
-        EVP_MD_CTX_free(mdctx);
-        throw SystemException(ErrorType::OPERATION_FAILED, "OpenSSL错误：无法更新摘要");
-    }
-    
-    unsigned int hash_len = SHA256_DIGEST_LENGTH;
-    if (EVP_DigestFinal_ex(mdctx, hash, &hash_len) != 1) {
-        EVP_MD_CTX_free(mdctx);
-        throw SystemException(ErrorType::OPERATION_FAILED, "OpenSSL错误：无法完成摘要");
-    }
-    
-    EVP_MD_CTX_free(mdctx);
-    #else
-    // 旧版OpenSSL使用SHA256接口
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, combined.c_str(), combined.length());
-    SHA256_Final(hash, &sha256);
-    #endif
-    
-    // 将哈希转换为十六进制字符串
-    std::stringstream ss;
-    for (unsigned char i : hash) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(i);
-    }
-    
-    return ss.str();
+    // 复用线程局部的摘要上下文，直接对password和salt分段计算，无需拼接
+    return PasswordHasher::hashHex(password, salt);
 }
 
 std::string User::generateSalt() {
@@ -178,62 +179,69 @@ std::string User::generateSalt() {
 Student::Student(std::string id, std::string name, std::string password,
                  std::string gender, int age, std::string department,
                  std::string classInfo, std::string contact)
-    : User(std::move(id), std::move(name), std::move(password)),
-      gender_(std::move(gender)),
-      age_(age),
-      department_(std::move(department)),
-      classInfo_(std::move(classInfo)),
-      contact_(std::move(contact)) {
+    : User(std::move(id), std::move(name), std::move(password)) {
+    updateProfile([&](UserProfile& profile) {
+        profile.gender = std::move(gender);
+        profile.age = age;
+        profile.department = std::move(department);
+        profile.classInfo = std::move(classInfo);
+        profile.contact = std::move(contact);
+    });
 }
 
-Student::Student(Student&& other) noexcept
-    : User(std::move(other)),
-      gender_(std::move(other.gender_)),
-      age_(other.age_),
-      department_(std::move(other.department_)),
-      classInfo_(std::move(other.classInfo_)),
-      contact_(std::move(other.contact_)) {
-    other.age_ = 0;
+std::unique_ptr<User> Student::clone() const {
+    auto copy = std::make_unique<Student>();
+    copy->copyFrom(*this);
+    return copy;
 }
 
-Student& Student::operator=(Student&& other) noexcept {
-    if (this != &other) {
-        User::operator=(std::move(other));
-        gender_ = std::move(other.gender_);
-        age_ = other.age_;
-        department_ = std::move(other.department_);
-        classInfo_ = std::move(other.classInfo_);
-        contact_ = std::move(other.contact_);
-        
-        other.age_ = 0;
-    }
-    return *this;
+void Student::setGender(std::string gender) {
+    updateProfile([&gender](UserProfile& profile) { profile.gender = std::move(gender); });
+}
+
+void Student::setAge(int age) {
+    updateProfile([age](UserProfile& profile) { profile.age = age; });
+}
+
+void Student::setDepartment(std::string department) {
+    updateProfile([&department](UserProfile& profile) { profile.department = std::move(department); });
+}
+
+void Student::setClassInfo(std::string classInfo) {
+    updateProfile([&classInfo](UserProfile& profile) { profile.classInfo = std::move(classInfo); });
+}
+
+void Student::setContact(std::string contact) {
+    updateProfile([&contact](UserProfile& profile) { profile.contact = std::move(contact); });
 }
 
 // Teacher 类实现
 Teacher::Teacher(std::string id, std::string name, std::string password,
                  std::string department, std::string title, std::string contact)
-    : User(std::move(id), std::move(name), std::move(password)),
-      department_(std::move(department)),
-      title_(std::move(title)),
-      contact_(std::move(contact)) {
+    : User(std::move(id), std::move(name), std::move(password)) {
+    updateProfile([&](UserProfile& profile) {
+        profile.department = std::move(department);
+        profile.title = std::move(title);
+        profile.contact = std::move(contact);
+    });
 }
 
-Teacher::Teacher(Teacher&& other) noexcept
-    : User(std::move(other)),
-      department_(std::move(other.department_)),
-      title_(std::move(other.title_)),
-      contact_(std::move(other.contact_)) {
+std::unique_ptr<User> Teacher::clone() const {
+    auto copy = std::make_unique<Teacher>();
+    copy->copyFrom(*this);
+    return copy;
 }
 
-Teacher& Teacher::operator=(Teacher&& other) noexcept {
-    if (this != &other) {
-        User::operator=(std::move(other));
-        department_ = std::move(other.department_);
-        title_ = std::move(other.title_);
-        contact_ = std::move(other.contact_);
-    }
-    return *this;
+void Teacher::setDepartment(std::string department) {
+    updateProfile([&department](UserProfile& profile) { profile.department = std::move(department); });
+}
+
+void Teacher::setTitle(std::string title) {
+    updateProfile([&title](UserProfile& profile) { profile.title = std::move(title); });
+}
+
+void Teacher::setContact(std::string contact) {
+    updateProfile([&contact](UserProfile& profile) { profile.contact = std::move(contact); });
 }
 
 // Admin 类实现
@@ -241,11 +249,8 @@ Admin::Admin(std::string id, std::string name, std::string password)
     : User(std::move(id), std::move(name), std::move(password)) {
 }
 
-Admin::Admin(Admin&& other) noexcept
-    : User(std::move(other)) {
+std::unique_ptr<User> Admin::clone() const {
+    auto copy = std::make_unique<Admin>();
+    copy->copyFrom(*this);
+    return copy;
 }
-
-Admin& Admin::operator=(Admin&& other) noexcept {
-    User::operator=(std::move(other));
-    return *this;
-} 
\ No newline at end of file
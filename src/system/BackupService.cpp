@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/system/BackupService.h"
+#include "../../include/system/SystemException.h"
+#include "../../include/util/DataManager.h"
+#include "../../include/util/JsonStorage.h"
+#include "../../include/util/JsonStreamWriter.h"
+#include "../../include/util/Logger.h"
+
+#include "../../nlohmann/json.hpp"
+#include <openssl/evp.h>
+#include <zlib.h>
+
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <istream>
+#include <sstream>
+#include <streambuf>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+
+constexpr StorageTable ALL_TABLES[] = {StorageTable::USERS, StorageTable::COURSES, StorageTable::ENROLLMENTS};
+constexpr StorageTable ARCHIVE_TABLES[] = {StorageTable::COURSES, StorageTable::ENROLLMENTS};
+
+// 逐块解压读取备份文件，同时计算未压缩内容的SHA-256；gzread对未压缩的文件同样适用
+class BackupFileBuffer : public std::streambuf {
+public:
+    explicit BackupFileBuffer(const std::string& path) : path_(path) {
+        file_ = gzopen(path.c_str(), "rb");
+        if (file_ == nullptr) {
+            throw SystemException(ErrorType::FILE_NOT_FOUND, "无法打开备份文件: " + path);
+        }
+        digest_ = EVP_MD_CTX_new();
+        if (digest_ == nullptr || EVP_DigestInit_ex(digest_, EVP_sha256(), nullptr) != 1) {
+            EVP_MD_CTX_free(digest_);
+            gzclose(file_);
+            throw SystemException(ErrorType::OPERATION_FAILED, "计算SHA-256失败");
+        }
+    }
+
+    ~BackupFileBuffer() override {
+        EVP_MD_CTX_free(digest_);
+        gzclose(file_);
+    }
+
+    BackupFileBuffer(const BackupFileBuffer&) = delete;
+    BackupFileBuffer& operator=(const BackupFileBuffer&) = delete;
+
+    // 读完剩余内容，返回全部内容的SHA-256
+    std::string digestHex() {
+        while (underflow() != traits_type::eof()) {
+            setg(buffer_, egptr(), egptr());
+        }
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        if (EVP_DigestFinal_ex(digest_, digest, &length) != 1) {
+            throw SystemException(ErrorType::OPERATION_FAILED, "计算SHA-256失败");
+        }
+        static const char HEX[] = "0123456789abcdef";
+        std::string hex;
+        for (unsigned int i = 0; i < length; ++i) {
+            hex.push_back(HEX[digest[i] >> 4]);
+            hex.push_back(HEX[digest[i] & 0x0F]);
+        }
+        return hex;
+    }
+
+protected:
+    int_type underflow() override {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        int n = gzread(file_, buffer_, sizeof(buffer_));
+        if (n < 0) {
+            int error = Z_OK;
+            throw SystemException(ErrorType::FILE_CORRUPTED, "读取备份文件失败: " + path_ + " - " + gzerror(file_, &error));
+        }
+        if (n == 0) {
+            return traits_type::eof();
+        }
+        EVP_DigestUpdate(digest_, buffer_, static_cast<size_t>(n));
+        setg(buffer_, buffer_, buffer_ + n);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    std::string path_;
+    gzFile file_ = nullptr;
+    EVP_MD_CTX* digest_ = nullptr;
+    char buffer_[64 * 1024];
+};
+
+json readManifest(const std::string& sourceDir) {
+    fs::path path = fs::path(sourceDir) / BackupService::MANIFEST_FILE;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw SystemException(ErrorType::FILE_NOT_FOUND, "备份清单不存在，备份不完整: " + path.string());
+    }
+    json manifest = json::parse(file, nullptr, false);
+    if (manifest.is_discarded() || !manifest.is_object()) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "备份清单格式错误: " + path.string());
+    }
+    int format = manifest.value("format", 0);
+    if (format < 1 || format > BackupService::FORMAT_VERSION) {
+        throw SystemException(ErrorType::DATA_INVALID, "不支持的备份格式版本: " + path.string());
+    }
+    return manifest;
+}
+
+// 清单中表table的条目，缺失时抛出DATA_INVALID
+const json& tableEntry(const json& manifest, StorageTable table) {
+    auto tables = manifest.find("tables");
+    if (tables == manifest.end() || !tables->contains(storageTableName(table))) {
+        throw SystemException(ErrorType::DATA_INVALID, std::string("备份清单中缺少数据表: ") + storageTableName(table));
+    }
+    return (*tables)[storageTableName(table)];
+}
+
+// 依次访问清单中的全部文件条目：三张活动表，以及各归档学期的课程和选课记录（格式版本1的备份没有归档）
+void forEachEntry(const json& manifest, const std::function<void(StorageTable, const std::string&, const json&)>& visit) {
+    for (StorageTable table : ALL_TABLES) {
+        visit(table, std::string(), tableEntry(manifest, table));
+    }
+    auto archives = manifest.find("archives");
+    if (archives == manifest.end()) {
+        return;
+    }
+    for (const auto& [term, tables] : archives->items()) {
+        for (StorageTable table : ARCHIVE_TABLES) {
+            if (!tables.contains(storageTableName(table))) {
+                throw SystemException(ErrorType::DATA_INVALID, "备份清单中缺少学期 " + term + " 的归档数据表: "
+                    + storageTableName(table));
+            }
+            visit(table, term, tables[storageTableName(table)]);
+        }
+    }
+}
+
+// 流式读取一张表的备份文件，逐条交给handler，读完后核对记录数和校验和；不一致时抛出FILE_CORRUPTED。
+// 核对在全部记录交出之后进行，调用方须能整体撤销已处理的记录
+size_t readVerified(const std::string& sourceDir, const json& entry, const std::function<void(json&)>& handler) {
+    std::string path = (fs::path(sourceDir) / entry.at("file").get<std::string>()).string();
+    BackupFileBuffer buffer(path);
+    std::istream input(&buffer);
+    size_t count = input.peek() == std::char_traits<char>::eof() ? 0 : DataManager::parseJsonRecords(input, handler, path);
+    if (buffer.digestHex() != entry.at("sha256").get<std::string>()) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "备份文件校验和不匹配: " + path);
+    }
+    if (count != entry.at("records").get<size_t>()) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "备份文件记录数不匹配: " + path);
+    }
+    return count;
+}
+
+// 把一张表的记录流式写入targetDir下的file，返回清单条目
+json writeTable(const std::string& targetDir, const std::string& file, bool compress,
+                const std::function<void(const std::function<void(json&)>&)>& scan) {
+    fs::path path = fs::path(targetDir) / file;
+    fs::create_directories(path.parent_path());
+    JsonStreamWriter writer(path.string(), JsonStreamOptions{true, compress, true});
+    scan([&writer](json& record) {
+        writer.write(record);
+    });
+    writer.commit();
+    return {
+        {"file", file},
+        {"records", writer.recordCount()},
+        {"bytes", writer.bytesWritten()},
+        {"sha256", writer.digestHex()}
+    };
+}
+
+std::string currentTime() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm local{};
+    localtime_r(&now, &local);
+    std::ostringstream ss;
+    ss << std::put_time(&local, "%Y-%m-%d %H:%M:%S");
+    return ss.str();
+}
+
+} // namespace
+
+bool BackupService::backup(const std::string& targetDir, bool compress) {
+    try {
+        fs::create_directories(targetDir);
+        // 先删除旧清单，中途失败的目录不会被当作完整的备份
+        fs::path manifestPath = fs::path(targetDir) / MANIFEST_FILE;
+        fs::remove(manifestPath);
+
+        StorageBackend& storage = DataManager::getInstance().storage();
+        std::unique_ptr<StorageSnapshot> snapshot = storage.openSnapshot();
+        LOG_INFO("开始在线备份到: " + targetDir + (compress ? "（gzip压缩）" : ""));
+
+        std::string suffix = compress ? ".gz" : "";
+        json tables = json::object();
+        for (StorageTable table : ALL_TABLES) {
+            json entry = writeTable(targetDir, JsonStorage::fileName(table) + suffix, compress,
+                [&](const std::function<void(json&)>& sink) { snapshot->scan(table, sink); });
+            LOG_INFO("已备份" + std::string(storageTableName(table)) + "：" + std::to_string(entry.at("records").get<size_t>())
+                + " 条记录，" + std::to_string(entry.at("bytes").get<size_t>()) + " 字节");
+            tables[storageTableName(table)] = std::move(entry);
+        }
+
+        // 归档分区与活动表取自同一视图，按JsonStorage的目录结构存放
+        json archives = json::object();
+        for (const auto& term : snapshot->archivedTerms()) {
+            json termTables = json::object();
+            for (StorageTable table : ARCHIVE_TABLES) {
+                termTables[storageTableName(table)] = writeTable(targetDir, JsonStorage::archiveFile(table, term) + suffix,
+                    compress, [&](const std::function<void(json&)>& sink) { snapshot->scanArchive(table, term, sink); });
+            }
+            archives[term] = std::move(termTables);
+        }
+        if (!archives.empty()) {
+            LOG_INFO("已备份 " + std::to_string(archives.size()) + " 个归档学期");
+        }
+        snapshot.reset(); // 尽早结束读事务
+
+        json manifest = {
+            {"format", FORMAT_VERSION},
+            {"createdAt", currentTime()},
+            {"storage", storage.name()},
+            {"compressed", compress},
+            {"tables", std::move(tables)},
+            {"archives", std::move(archives)}
+        };
+        fs::path tempPath = manifestPath.string() + ".tmp";
+        {
+            std::ofstream file(tempPath);
+            file << manifest.dump(4) << std::endl;
+            if (!file.good()) {
+                throw SystemException(ErrorType::FILE_ACCESS_DENIED, "写入备份清单失败: " + tempPath.string());
+            }
+        }
+        fs::rename(tempPath, manifestPath);
+
+        LOG_INFO("在线备份完成: " + targetDir);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("在线备份失败: " + std::string(e.what()));
+        return false;
+    }
+}
+
+std::vector<std::string> BackupService::verify(const std::string& sourceDir) {
+    std::vector<std::string> problems;
+    json manifest;
+    try {
+        manifest = readManifest(sourceDir);
+    } catch (const std::exception& e) {
+        problems.push_back(e.what());
+        return problems;
+    }
+    try {
+        forEachEntry(manifest, [&](StorageTable, const std::string&, const json& entry) {
+            try {
+                readVerified(sourceDir, entry, [](json&) {});
+            } catch (const std::exception& e) {
+                problems.push_back(e.what());
+            }
+        });
+    } catch (const std::exception& e) {
+        problems.push_back(e.what());
+    }
+    return problems;
+}
+
+bool BackupService::restore(const std::string& sourceDir) {
+    // 全部表校验通过才开始写入，损坏的备份不会覆盖现有数据
+    std::vector<std::string> problems = verify(sourceDir);
+    if (!problems.empty()) {
+        for (const auto& problem : problems) {
+            LOG_ERROR("备份校验失败: " + problem);
+        }
+        return false;
+    }
+
+    try {
+        json manifest = readManifest(sourceDir);
+
+        // 全部表（含归档分区）写入暂存后一次提交，期间持有数据目录锁，其他进程看不到部分恢复的内容。
+        // 写入时再次流式校验（校验后文件可能被替换），任一文件不符则整体放弃，存储保持不变
+        std::vector<TableImage> images;
+        forEachEntry(manifest, [&](StorageTable table, const std::string& term, const json& entry) {
+            images.push_back({table, term, [&sourceDir, &entry](const StorageBackend::RecordSink& sink) {
+                readVerified(sourceDir, entry, [&sink](json& record) {
+                    sink(record);
+                });
+            }});
+        });
+        bool withArchives = manifest.contains("archives"); // 格式版本1的备份没有归档，保留现有归档
+        if (!DataManager::getInstance().storage().replaceImage(images, withArchives)) {
+            LOG_ERROR("从备份恢复失败: 写入存储失败");
+            return false;
+        }
+
+        for (StorageTable table : ALL_TABLES) {
+            LOG_INFO("已恢复" + std::string(storageTableName(table)) + "："
+                + std::to_string(tableEntry(manifest, table).at("records").get<size_t>()) + " 条记录");
+        }
+        LOG_INFO("从备份恢复完成: " + sourceDir + "（备份时间 " + manifest.value("createdAt", std::string()) + "）");
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("从备份恢复失败: " + std::string(e.what()));
+        return false;
+    }
+}
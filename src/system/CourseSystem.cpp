@@ -16,17 +16,67 @@
  */
 #include "../../include/system/CourseSystem.h"
 #include "../../include/util/DataManager.h"
+#include "../../include/util/SnapshotFile.h"
+#include "../../include/util/JsonStorage.h"
+#include "../../include/util/SqliteStorage.h"
 #include "../../include/system/SystemException.h"
+#include "../../include/system/PersistenceService.h"
+#include "../../include/system/DataWatcher.h"
 #include "../../include/util/InputValidator.h"
 #include "../../include/manager/UserManager.h"
 #include "../../include/manager/CourseManager.h"
 #include "../../include/manager/EnrollmentManager.h"
+#include "../../include/manager/TermArchive.h"
 
 #include <iostream>
 #include <string>
 #include <limits>
 #include <thread>
 #include <chrono>
+#include <cstdlib>
+#include <future>
+#include <algorithm>
+
+namespace {
+
+// 登录来源：通过SSH登录的终端使用客户端地址，本地终端统一记为console
+std::string getLoginSource() {
+    const char* sshClient = std::getenv("SSH_CLIENT");
+    if (sshClient && *sshClient) {
+        std::string client(sshClient);
+        return client.substr(0, client.find(' '));
+    }
+    return "console";
+}
+
+const char* const SNAPSHOT_FILE = "data.snapshot"; // 二进制快照文件名
+
+// 尚未初始化的SQLite数据库从现有JSON文件导入初始数据（含归档学期），全部表在一个事务中写入
+void importFromJson(SqliteStorage& target) {
+    JsonStorage source;
+    std::vector<TableImage> images;
+    for (StorageTable table : {StorageTable::USERS, StorageTable::COURSES, StorageTable::ENROLLMENTS}) {
+        images.push_back({table, std::string(), [&source, table](const StorageBackend::RecordSink& sink) {
+            source.scan(table, [&sink](nlohmann::json& record) { sink(record); });
+        }});
+    }
+    for (const auto& term : source.archivedTerms()) {
+        for (StorageTable table : {StorageTable::COURSES, StorageTable::ENROLLMENTS}) {
+            images.push_back({table, term, [&source, table, term](const StorageBackend::RecordSink& sink) {
+                source.scanArchive(table, term, [&sink](nlohmann::json& record) { sink(record); });
+            }});
+        }
+    }
+    target.replaceImage(images, true);
+    
+    // 导入的写入不来自内存中的数据，随后的loadData不能因代数一致而跳过
+    for (StorageTable table : {StorageTable::USERS, StorageTable::COURSES, StorageTable::ENROLLMENTS}) {
+        DataManager::getInstance().manifest().acknowledge(table, DataManifest::UNKNOWN);
+    }
+    LOG_INFO(std::string("已从JSON文件导入数据到") + target.name() + "存储");
+}
+
+} // namespace
 
 CourseSystem& CourseSystem::getInstance() {
     static CourseSystem instance; // Meyer's单例模式
@@ -39,13 +89,12 @@ CourseSystem::CourseSystem()
       currentUser_(nullptr) {
 }
 
-bool CourseSystem::initialize(const std::string& dataDir) {
+bool CourseSystem::openStorage(const std::string& dataDir, const StorageOptions& storage) {
     try {
-        
         // 初始化国际化管理器
         I18nManager& i18n = I18nManager::getInstance();
         if (!i18n.initialize(dataDir)) {
-            Logger::getInstance().critical("初始化国际化系统失败");
+            LOG_CRITICAL("初始化国际化系统失败");
             return false;
         }
   
@@ -53,51 +102,89 @@ bool CourseSystem::initialize(const std::string& dataDir) {
         DataManager& dataManager = DataManager::getInstance();
         dataManager.setDataDirectory(dataDir);
         
+        if (storage.kind == StorageKind::SQLITE) {
+            auto sqlite = std::make_unique<SqliteStorage>(dataManager.getDataFilePath(SqliteStorage::DEFAULT_FILE));
+            if (!sqlite->isInitialized()) {
+                importFromJson(*sqlite);
+            }
+            dataManager.setStorageBackend(std::move(sqlite));
+        } else if (storage.compactJson) {
+            dataManager.setStorageBackend(std::make_unique<JsonStorage>(true));
+        }
+        return true;
+    } catch (const std::exception& e) {
+        LOG_CRITICAL("打开数据存储时发生异常: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool CourseSystem::initialize(const std::string& dataDir, const StorageOptions& storage) {
+    try {
+        if (!openStorage(dataDir, storage)) {
+            return false;
+        }
+        DataManager& dataManager = DataManager::getInstance();
+        
         try {
-            // 加载用户数据
-            UserManager& userManager = UserManager::getInstance();
-            bool userDataLoaded = userManager.loadData();
-            
-            if (!userDataLoaded) {
-                Logger::getInstance().warning("用户数据加载失败");
+            // 优先从二进制快照加载，快照缺失、过期或损坏时回退到存储后端
+            if (!loadFromSnapshot()) {
+                // 三个数据文件互不依赖，各自在独立线程中读取和解析，启动耗时接近最慢的单个文件
+                std::future<bool> userDataLoaded = std::async(std::launch::async, [] {
+                    return UserManager::getInstance().loadData();
+                });
+                std::future<bool> courseDataLoaded = std::async(std::launch::async, [] {
+                    return CourseManager::getInstance().loadData();
+                });
+                std::future<bool> enrollmentDataLoaded = std::async(std::launch::async, [] {
+                    return EnrollmentManager::getInstance().loadData();
+                });
+                
+                // get()会重新抛出加载线程中的异常；其余future析构时等待对应线程结束
+                if (!userDataLoaded.get()) {
+                    LOG_WARNING("用户数据加载失败");
+                }
+                
+                if (!courseDataLoaded.get()) {
+                    LOG_WARNING("课程数据加载失败");
+                }
+                
+                if (!enrollmentDataLoaded.get()) {
+                    LOG_WARNING("选课数据加载失败");
+                }
             }
             
-            // 加载课程数据
-            CourseManager& courseManager = CourseManager::getInstance();
-            bool courseDateLoaded = courseManager.loadData();
+            // 并行加载时各管理器无法互相校验，全部加载完成后统一检查引用关系
+            verifyReferences();
             
-            if (!courseDateLoaded) {
-                Logger::getInstance().warning("课程数据加载失败");
-            }
+            // 此后的修改由后台线程写盘
+            PersistenceService::getInstance().start();
             
-            // 加载选课数据
-            EnrollmentManager& enrollmentManager = EnrollmentManager::getInstance();
-            bool enrollmentDataLoaded = enrollmentManager.loadData();
+            // 较早学期移入归档分区，启动和保存只处理活动学期，开销不随历史学期增长
+            TermArchive::getInstance().archiveOldTerms(storage.activeTerms);
             
-            if (!enrollmentDataLoaded) {
-                Logger::getInstance().warning("选课数据加载失败");
-            }
+            // 其他进程写入数据目录后增量同步到内存
+            DataWatcher::getInstance().start(dataManager.getDataDirectory());
             
             initialized_ = true;
             
-            Logger::getInstance().info("系统初始化成功");
+            LOG_INFO("系统初始化成功");
             return true;
         } catch (const std::exception& e) {
-            Logger::getInstance().error("初始化CourseSystem时发生异常: " + std::string(e.what()));
+            LOG_ERROR("初始化CourseSystem时发生异常: " + std::string(e.what()));
             return false;
         }
     } catch (const std::exception& e) {
-        Logger::getInstance().critical("初始化CourseSystem时发生严重异常: " + std::string(e.what()));
+        LOG_CRITICAL("初始化CourseSystem时发生严重异常: " + std::string(e.what()));
         return false;
     } catch (...) {
-        Logger::getInstance().critical("初始化CourseSystem时发生未知异常");
+        LOG_CRITICAL("初始化CourseSystem时发生未知异常");
         return false;
     }
 }
 
 int CourseSystem::run() {
     if (!initialized_) {
-        Logger::getInstance().critical("系统未初始化");
+        LOG_CRITICAL("系统未初始化");
         return -1;
     }
     
@@ -156,7 +243,7 @@ int CourseSystem::run() {
                 return -1;
         }
         if (!result) {
-            Logger::getInstance().critical("语言设置失败");
+            LOG_CRITICAL("语言设置失败");
             return -1;
         }
         
@@ -179,24 +266,24 @@ int CourseSystem::run() {
                             showStudentMenu();
                             break;
                         default:
-                            Logger::getInstance().error("未知的用户类型");
+                            LOG_ERROR("未知的用户类型");
                             logout();
                             break;
                     }
                 }
             } catch (const SystemException& e) {
                 // 处理系统异常
-                Logger::getInstance().error("系统异常: " + e.getFormattedMessage());
-                std::cout << getText("system_error") << ": " << e.getFormattedMessage() << std::endl;
+                LOG_ERROR("系统异常: " + e.getFormattedMessage());
+                std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.getFormattedMessage() << std::endl;
                 std::this_thread::sleep_for(std::chrono::seconds(2));
             } catch (const std::exception& e) {
                 // 处理标准异常
-                Logger::getInstance().error("标准异常: " + std::string(e.what()));
-                std::cout << getText("system_error") << ": " << e.what() << std::endl;
+                LOG_ERROR("标准异常: " + std::string(e.what()));
+                std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.what() << std::endl;
                 std::this_thread::sleep_for(std::chrono::seconds(2));
             } catch (...) {
                 // 处理未知异常
-                Logger::getInstance().error("发生未知异常");
+                LOG_ERROR("发生未知异常");
                 std::cout << "系统发生未知异常，请重试" << std::endl;
                 std::this_thread::sleep_for(std::chrono::seconds(2));
             }
@@ -204,11 +291,11 @@ int CourseSystem::run() {
         return 0;
     }
     catch (const std::exception& e) {
-        Logger::getInstance().error("运行时异常: " + std::string(e.what()));
+        LOG_ERROR("运行时异常: " + std::string(e.what()));
         return -1;
     }
     catch (...) {
-        Logger::getInstance().error("未知异常");
+        LOG_ERROR("未知异常");
         return -1;
     }
 }
@@ -217,40 +304,120 @@ void CourseSystem::shutdown() {
     if (running_) {
         // 保存所有数据
         try {
-            UserManager::getInstance().saveData(false);
-            CourseManager::getInstance().saveData();
-            EnrollmentManager::getInstance().saveData();
+            // 先停止监视，再停止后台持久化线程并写出所有未落盘的修改
+            DataWatcher::getInstance().stop();
+            PersistenceService::getInstance().stop();
             
-            Logger::getInstance().info("系统数据已保存");
+            LOG_INFO("系统数据已保存");
+            writeSnapshot(); // 保存后数据版本戳已变化，同步刷新快照
         } catch (const std::exception& e) {
-            Logger::getInstance().error("保存数据失败: " + std::string(e.what()));
+            LOG_ERROR("保存数据失败: " + std::string(e.what()));
         }
         
         running_ = false;
-        Logger::getInstance().info("系统已关闭");
+        LOG_INFO("系统已关闭");
     }
 }
 
+bool CourseSystem::writeSnapshot() {
+    std::string path = DataManager::getInstance().getDataFilePath(SNAPSHOT_FILE);
+    try {
+        uint64_t stamp = DataManager::getInstance().storage().dataStamp();
+        
+        SnapshotWriter writer;
+        UserManager::getInstance().writeSnapshot(writer);
+        CourseManager::getInstance().writeSnapshot(writer);
+        EnrollmentManager::getInstance().writeSnapshot(writer);
+        writer.writeToFile(path, stamp);
+        
+        LOG_INFO("已写入数据快照: " + path);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("写入数据快照失败: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool CourseSystem::loadFromSnapshot() {
+    std::string path = DataManager::getInstance().getDataFilePath(SNAPSHOT_FILE);
+    if (!DataManager::getInstance().fileExists(path)) {
+        return false;
+    }
+    
+    try {
+        SnapshotReader reader(path);
+        if (reader.sourceStamp() != DataManager::getInstance().storage().dataStamp()) {
+            LOG_INFO("数据快照已过期，改为从存储后端加载");
+            return false;
+        }
+        
+        UserManager::getInstance().loadSnapshot(reader);
+        CourseManager::getInstance().loadSnapshot(reader);
+        EnrollmentManager::getInstance().loadSnapshot(reader);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_WARNING("数据快照不可用，改为从存储后端加载: " + std::string(e.what()));
+        return false;
+    }
+}
+
+size_t CourseSystem::verifyReferences() const {
+    std::shared_ptr<const UserDirectory> directory = UserManager::getInstance().snapshot();
+    CourseManager& courseManager = CourseManager::getInstance();
+    size_t problems = 0;
+    
+    // 课程的授课教师必须存在
+    for (const auto& courseId : courseManager.getAllCourseIds()) {
+        std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
+        if (course && !course->getTeacherId().empty() && !directory->findTeacher(course->getTeacherId())) {
+            LOG_WARNING("数据完整性：课程 " + courseId + " 的授课教师 " + course->getTeacherId() + " 不存在");
+            ++problems;
+        }
+    }
+    
+    // 选课记录引用的学生和课程必须存在
+    for (const auto& enrollment : EnrollmentManager::getInstance().findEnrollments(
+             [](const Enrollment&) { return true; })) {
+        if (!directory->findStudent(enrollment->getStudentId())) {
+            LOG_WARNING("数据完整性：选课记录引用了不存在的学生 " + enrollment->getStudentId() +
+                           "（课程 " + enrollment->getCourseId() + "）");
+            ++problems;
+        }
+        if (!courseManager.hasCourse(enrollment->getCourseId())) {
+            LOG_WARNING("数据完整性：选课记录引用了不存在的课程 " + enrollment->getCourseId() +
+                           "（学生 " + enrollment->getStudentId() + "）");
+            ++problems;
+        }
+    }
+    
+    if (problems > 0) {
+        LOG_WARNING("数据完整性检查发现 " + std::to_string(problems) + " 处无效引用");
+    } else {
+        LOG_INFO("数据完整性检查通过");
+    }
+    return problems;
+}
+
 bool CourseSystem::login(const std::string& userId, const std::string& password) {
     if (currentUser_) {
         logout(); // 先注销当前用户
     }
     
-    User* user = UserManager::getInstance().authenticate(userId, password);
+    std::shared_ptr<User> user = UserManager::getInstance().authenticate(userId, password, getLoginSource());
     
     if (user) {
         currentUser_ = user;
-        Logger::getInstance().info("用户 " + userId + " 登录成功");
+        LOG_INFO("用户 " + userId + " 登录成功");
         return true;
     } else {
-        Logger::getInstance().warning("用户 " + userId + " 登录失败");
+        LOG_WARNING("用户 " + userId + " 登录失败");
         return false;
     }
 }
 
 void CourseSystem::logout() {
     if (currentUser_) {
-        Logger::getInstance().info("用户 " + currentUser_->getId() + " 已注销");
+        LOG_INFO("用户 " + currentUser_->getId() + " 已注销");
         currentUser_ = nullptr;
     }
 }
@@ -264,8 +431,18 @@ std::string CourseSystem::getFormattedText(const std::string& key, Args... args)
     return I18nManager::getInstance().getFormattedText(key, args...);
 }
 
+const std::string& CourseSystem::getText(TextId id) const {
+    return I18nManager::getInstance().getText(id);
+}
+
+template<typename... Args>
+std::string CourseSystem::getFormattedText(TextId id, Args... args) const {
+    return I18nManager::getInstance().getFormattedText(id, args...);
+}
+
 // 显式实例化常用的模板函
 template std::string CourseSystem::getFormattedText(const std::string& key, int) const;
+template std::string CourseSystem::getFormattedText(TextId id, int) const;
 
 void CourseSystem::showWelcome() const {
     std::cout << "================================================" << std::endl;
@@ -284,14 +461,14 @@ void CourseSystem::showMainMenu() {
         }
         
         std::cout << "================================================" << std::endl;
-        std::cout << "            " << getText("main_menu_title") << "            " << std::endl;
+        std::cout << "            " << getText(TextId::MAIN_MENU_TITLE) << "            " << std::endl;
         std::cout << "================================================" << std::endl;
     
                                             
         // 显示菜单选项
-        std::cout << "1. " << getText("login") << std::endl;
-        std::cout << "2. " << getText("switch_language") << std::endl;
-        std::cout << "3. " << getText("exit") << std::endl;
+        std::cout << "1. " << getText(TextId::LOGIN) << std::endl;
+        std::cout << "2. " << getText(TextId::SWITCH_LANGUAGE) << std::endl;
+        std::cout << "3. " << getText(TextId::EXIT) << std::endl;
     
         // 获取用户输入
         int choice = 0;
@@ -306,7 +483,7 @@ void CourseSystem::showMainMenu() {
             attempts++;
             
             if (input.empty()) {
-                std::cout << getText("input_cannot_be_empty") << std::endl;
+                std::cout << getText(TextId::INPUT_CANNOT_BE_EMPTY) << std::endl;
                 continue;
             }
             
@@ -314,10 +491,10 @@ void CourseSystem::showMainMenu() {
                 choice = std::stoi(input);
                 break;
             } else {
-                std::cout << getText("invalid_input") << std::endl;
+                std::cout << getText(TextId::INVALID_INPUT) << std::endl;
             }    
             if (attempts >= MAX_ATTEMPTS) {
-                std::cout << getText("too_many_attempts") << std::endl;
+                std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                 choice = 3; // 默认选择退出
                 break;
             }
@@ -327,23 +504,28 @@ void CourseSystem::showMainMenu() {
             // 登录
             std::string userId, password;
             
-            std::cout << getText("enter_user_id") << ": ";
+            std::cout << getText(TextId::ENTER_USER_ID) << ": ";
             std::getline(std::cin, userId);
             
-            std::cout << getText("enter_password") << ": ";
+            std::cout << getText(TextId::ENTER_PASSWORD) << ": ";
             std::getline(std::cin, password);
             
             try {
                 if (login(userId, password)) {
-                    std::cout << getText("login_success") << std::endl;
+                    std::cout << getText(TextId::LOGIN_SUCCESS) << std::endl;
                 } else {
-                    std::cout << getText("login_failed") << std::endl;
+                    int retrySeconds = UserManager::getInstance().getLoginRetrySeconds(userId, getLoginSource());
+                    if (retrySeconds > 0) {
+                        std::cout << getFormattedText(TextId::LOGIN_THROTTLED, retrySeconds) << std::endl;
+                    } else {
+                        std::cout << getText(TextId::LOGIN_FAILED) << std::endl;
+                    }
                     // 安全性考虑，防止暴力破解
                     std::this_thread::sleep_for(std::chrono::seconds(1)); 
                 }
             } catch (const std::exception& e) {
-                Logger::getInstance().error(std::string("登陆时遇到系统错误") + ": " + e.what());
-                std::cout << getText("login_system_error") << std::endl;
+                LOG_ERROR(std::string("登陆时遇到系统错误") + ": " + e.what());
+                std::cout << getText(TextId::LOGIN_SYSTEM_ERROR) << std::endl;
                 // 安全性考虑，防止暴力破解
                 std::this_thread::sleep_for(std::chrono::seconds(1));
             }
@@ -352,25 +534,25 @@ void CourseSystem::showMainMenu() {
             showLanguageMenu();
         } else {
             // 退出
-            std::cout << getText("exiting_system") << std::endl;
+            std::cout << getText(TextId::EXITING_SYSTEM) << std::endl;
             shutdown();
         }
     } catch (const std::exception& e) {
-        Logger::getInstance().error(std::string("主菜单中发生异常") + ": " + e.what());
-        std::cout << getText("system_error_retry") << std::endl;
+        LOG_ERROR(std::string("主菜单中发生异常") + ": " + e.what());
+        std::cout << getText(TextId::SYSTEM_ERROR_RETRY) << std::endl;
     } catch (...) {
-        Logger::getInstance().error("主菜单中发生未知异常");
-        std::cout << getText("unknown_system_error") << std::endl;
+        LOG_ERROR("主菜单中发生未知异常");
+        std::cout << getText(TextId::UNKNOWN_SYSTEM_ERROR) << std::endl;
     }
 }
 
 void CourseSystem::showLanguageMenu() {
     std::cout << "================================================" << std::endl;
-    std::cout << "            " << getText("language_menu_title") << "            " << std::endl;
+    std::cout << "            " << getText(TextId::LANGUAGE_MENU_TITLE) << "            " << std::endl;
     std::cout << "================================================" << std::endl;
     
     // 显示当前语言，languageToString 是 I18nManager 的静态成员函数
-    std::cout << getText("current_language") << ": " << 
+    std::cout << getText(TextId::CURRENT_LANGUAGE) << ": " << 
     I18nManager::languageToString(I18nManager::getInstance().getCurrentLanguage()) << std::endl;
     
     // 显示可用的语言选项
@@ -391,7 +573,7 @@ void CourseSystem::showLanguageMenu() {
         attempts++;
         
         if (input.empty()) {
-            std::cout << getText("input_cannot_be_empty") << std::endl;
+            std::cout << getText(TextId::INPUT_CANNOT_BE_EMPTY) << std::endl;
             continue;
         }
         
@@ -399,10 +581,10 @@ void CourseSystem::showLanguageMenu() {
             choice = std::stoi(input);
             break;
         } else {
-            std::cout << getText("invalid_input") << std::endl;
+            std::cout << getText(TextId::INVALID_INPUT) << std::endl;
         }
         if (attempts >= MAX_ATTEMPTS) {
-            std::cout << getText("too_many_attempts") << std::endl;
+            std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
             choice = 3;
             break;
         }
@@ -415,17 +597,17 @@ void CourseSystem::showLanguageMenu() {
         // 切换到中文
         result = I18nManager::getInstance().setLanguage(Language::CHINESE);
         if (result) {
-            std::cout << getText("language_switched_chinese") << std::endl;
+            std::cout << getText(TextId::LANGUAGE_SWITCHED_CHINESE) << std::endl;
         } else {
-            std::cout << getText("language_switch_failed") << std::endl;
+            std::cout << getText(TextId::LANGUAGE_SWITCH_FAILED) << std::endl;
         }
     } else if (choice == 2) {
         // 切换到英文
         result = I18nManager::getInstance().setLanguage(Language::ENGLISH);
         if (result) {
-            std::cout << getText("language_switched_english") << std::endl;
+            std::cout << getText(TextId::LANGUAGE_SWITCHED_ENGLISH) << std::endl;
         } else {
-            std::cout << getText("language_switch_failed") << std::endl;
+            std::cout << getText(TextId::LANGUAGE_SWITCH_FAILED) << std::endl;
         }
     }
     
@@ -435,14 +617,14 @@ void CourseSystem::showLanguageMenu() {
 
 void CourseSystem::showAdminMenu() {
     
-    std::cout << "========= " << getText("admin_menu") << " =========" << std::endl;
-    std::cout << "1. " << getText("user_management") << std::endl;
-    std::cout << "2. " << getText("course_management") << std::endl;
-    std::cout << "3. " << getText("query_enrollment_records") << std::endl;
-    std::cout << "4. " << getText("modify_password") << std::endl;
-    std::cout << "5. " << getText("modify_account_info") << std::endl;
-    std::cout << "6. " << getText("logout") << std::endl;
-    std::cout << "7. " << getText("exit") << std::endl;
+    std::cout << "========= " << getText(TextId::ADMIN_MENU) << " =========" << std::endl;
+    std::cout << "1. " << getText(TextId::USER_MANAGEMENT) << std::endl;
+    std::cout << "2. " << getText(TextId::COURSE_MANAGEMENT) << std::endl;
+    std::cout << "3. " << getText(TextId::QUERY_ENROLLMENT_RECORDS) << std::endl;
+    std::cout << "4. " << getText(TextId::MODIFY_PASSWORD) << std::endl;
+    std::cout << "5. " << getText(TextId::MODIFY_ACCOUNT_INFO) << std::endl;
+    std::cout << "6. " << getText(TextId::LOGOUT) << std::endl;
+    std::cout << "7. " << getText(TextId::EXIT) << std::endl;
     std::cout << "==============================" << std::endl;
     
     int choice = 0;
@@ -451,7 +633,7 @@ void CourseSystem::showAdminMenu() {
     std::getline(std::cin, input);
     
     if (!InputValidator::validateChoice(input, 1, 7, choice)) {
-        std::cout << getText("invalid_input") << std::endl;
+        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
         return;
     }
     
@@ -477,35 +659,35 @@ void CourseSystem::showAdminMenu() {
                 handleUserInfoModification(); // 处理修改用户信息
                 break;
             default:
-                std::cout << getText("invalid_choice") << std::endl;
+                std::cout << getText(TextId::INVALID_CHOICE) << std::endl;
                 break;
         }
     } catch (const SystemException& e) {
         // 处理系统异常
-        Logger::getInstance().error("处理管理员菜单选择时发生异常: " + e.getFormattedMessage());
-        std::cout << getText("system_error") << ": " << e.getFormattedMessage() << std::endl;
+        LOG_ERROR("处理管理员菜单选择时发生异常: " + e.getFormattedMessage());
+        std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.getFormattedMessage() << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     } catch (const std::exception& e) {
         // 处理标准异常
-        Logger::getInstance().error("处理管理员菜单选择时发生标准异常: " + std::string(e.what()));
-        std::cout << getText("system_error") << ": " << e.what() << std::endl;
+        LOG_ERROR("处理管理员菜单选择时发生标准异常: " + std::string(e.what()));
+        std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.what() << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     } catch (...) {
         // 处理未知异常
-        Logger::getInstance().error("处理管理员菜单选择时发生未知异常");
-        std::cout << getText("system_error") << std::endl;
+        LOG_ERROR("处理管理员菜单选择时发生未知异常");
+        std::cout << getText(TextId::SYSTEM_ERROR) << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }
 }
 
 void CourseSystem::showTeacherMenu() {
-    std::cout << getText("teacher_menu_title") << std::endl;
-    std::cout << "1. " << getText("view_courses") << std::endl;
-    std::cout << "2. " << getText("view_students") << std::endl;
-    std::cout << "3. " << getText("change_password") << std::endl;
-    std::cout << "4. " << getText("modify_user_info") << std::endl;
-    std::cout << "5. " << getText("logout") << std::endl;
-    std::cout << "6. " << getText("exit") << std::endl;
+    std::cout << getText(TextId::TEACHER_MENU_TITLE) << std::endl;
+    std::cout << "1. " << getText(TextId::VIEW_COURSES) << std::endl;
+    std::cout << "2. " << getText(TextId::VIEW_STUDENTS) << std::endl;
+    std::cout << "3. " << getText(TextId::CHANGE_PASSWORD) << std::endl;
+    std::cout << "4. " << getText(TextId::MODIFY_USER_INFO) << std::endl;
+    std::cout << "5. " << getText(TextId::LOGOUT) << std::endl;
+    std::cout << "6. " << getText(TextId::EXIT) << std::endl;
     
     int choice = 0;
     std::string input;
@@ -514,7 +696,7 @@ void CourseSystem::showTeacherMenu() {
         std::getline(std::cin, input);
         
         if (!InputValidator::validateChoice(input, 1, 6, choice)) {
-            std::cout << getText("invalid_input") << std::endl;
+            std::cout << getText(TextId::INVALID_INPUT) << std::endl;
         }
     } while (choice < 1 || choice > 6);
     
@@ -531,30 +713,30 @@ void CourseSystem::showTeacherMenu() {
             shutdown();
         }
     } catch(const SystemException& e) {
-        Logger::getInstance().error("处理教师菜单选择时发生异常: " + e.getFormattedMessage());
-        std::cout << getText("system_error") << ": " << e.getFormattedMessage() << std::endl;
+        LOG_ERROR("处理教师菜单选择时发生异常: " + e.getFormattedMessage());
+        std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.getFormattedMessage() << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     } catch(const std::exception& e) {
-        Logger::getInstance().error("处理教师菜单选择时发生标准异常: " + std::string(e.what()));
-        std::cout << getText("system_error") << ": " << e.what() << std::endl;
+        LOG_ERROR("处理教师菜单选择时发生标准异常: " + std::string(e.what()));
+        std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.what() << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     } catch(...) {
-        Logger::getInstance().error("处理教师菜单选择时发生未知异常");
-        std::cout << getText("system_error") << std::endl;
+        LOG_ERROR("处理教师菜单选择时发生未知异常");
+        std::cout << getText(TextId::SYSTEM_ERROR) << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }
 }
 
 void CourseSystem::showStudentMenu() {
-    std::cout << getText("student_menu_title") << std::endl;
-    std::cout << "1. " << getText("query_courses") << std::endl;
-    std::cout << "2. " << getText("select_course") << std::endl;
-    std::cout << "3. " << getText("drop_course") << std::endl;
-    std::cout << "4. " << getText("view_selected_courses") << std::endl;
-    std::cout << "5. " << getText("change_password") << std::endl;
-    std::cout << "6. " << getText("modify_user_info") << std::endl;
-    std::cout << "7. " << getText("logout") << std::endl;
-    std::cout << "8. " << getText("exit") << std::endl;
+    std::cout << getText(TextId::STUDENT_MENU_TITLE) << std::endl;
+    std::cout << "1. " << getText(TextId::QUERY_COURSES) << std::endl;
+    std::cout << "2. " << getText(TextId::SELECT_COURSE) << std::endl;
+    std::cout << "3. " << getText(TextId::DROP_COURSE) << std::endl;
+    std::cout << "4. " << getText(TextId::VIEW_SELECTED_COURSES) << std::endl;
+    std::cout << "5. " << getText(TextId::CHANGE_PASSWORD) << std::endl;
+    std::cout << "6. " << getText(TextId::MODIFY_USER_INFO) << std::endl;
+    std::cout << "7. " << getText(TextId::LOGOUT) << std::endl;
+    std::cout << "8. " << getText(TextId::EXIT) << std::endl;
     
     int choice = 0;
     std::string input;
@@ -563,7 +745,7 @@ void CourseSystem::showStudentMenu() {
         std::getline(std::cin, input);
         
         if (!InputValidator::validateChoice(input, 1, 8, choice)) {
-            std::cout << getText("invalid_input") << std::endl;
+            std::cout << getText(TextId::INVALID_INPUT) << std::endl;
         }
     } while (choice < 1 || choice > 8);
     try{
@@ -579,16 +761,16 @@ void CourseSystem::showStudentMenu() {
             shutdown();
         }
     }catch(const SystemException& e){
-        Logger::getInstance().error("处理学生菜单选择时发生异常: " + e.getFormattedMessage());
-        std::cout << getText("system_error") << ": " << e.getFormattedMessage() << std::endl;
+        LOG_ERROR("处理学生菜单选择时发生异常: " + e.getFormattedMessage());
+        std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.getFormattedMessage() << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }catch(const std::exception& e){
-        Logger::getInstance().error("处理学生菜单选择时发生标准异常: " + std::string(e.what()));
-        std::cout << getText("system_error") << ": " << e.what() << std::endl;
+        LOG_ERROR("处理学生菜单选择时发生标准异常: " + std::string(e.what()));
+        std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.what() << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }catch(...){
-        Logger::getInstance().error("处理学生菜单选择时发生未知异常");
-        std::cout << getText("system_error") << std::endl;
+        LOG_ERROR("处理学生菜单选择时发生未知异常");
+        std::cout << getText(TextId::SYSTEM_ERROR) << std::endl;
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }
 }
@@ -599,13 +781,13 @@ void CourseSystem::handleAdminFunctions(int choice) {
     
     switch (choice) {
         case 1: { // 用户管理
-            std::cout << getText("user_management_function") << std::endl;
+            std::cout << getText(TextId::USER_MANAGEMENT_FUNCTION) << std::endl;
             bool subMenuRunning = true;
             while (subMenuRunning && running_) {
-                std::cout << "1. " << getText("add_user") << std::endl;
-                std::cout << "2. " << getText("delete_user") << std::endl;
-                std::cout << "3. " << getText("query_user") << std::endl;
-                std::cout << "4. " << getText("return_to_parent_menu") << std::endl;
+                std::cout << "1. " << getText(TextId::ADD_USER) << std::endl;
+                std::cout << "2. " << getText(TextId::DELETE_USER) << std::endl;
+                std::cout << "3. " << getText(TextId::QUERY_USER) << std::endl;
+                std::cout << "4. " << getText(TextId::RETURN_TO_PARENT_MENU) << std::endl;
                 
                 int subChoice = 0;
                 std::string input;
@@ -613,7 +795,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                 std::getline(std::cin, input);
                 
                 if (!InputValidator::validateChoice(input, 1, 4, subChoice)) {
-                    std::cout << getText("invalid_input") << std::endl;
+                    std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                     continue;
                 }
                 
@@ -623,10 +805,10 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         UserManager& userManager = UserManager::getInstance();
                         
                         // 选择用户类型
-                        std::cout << getText("select_user_type") << "：" << std::endl;
-                        std::cout << "1. " << getText("student_type") << std::endl;
-                        std::cout << "2. " << getText("teacher_type") << std::endl;
-                        std::cout << "3. " << getText("admin_type") << std::endl;
+                        std::cout << getText(TextId::SELECT_USER_TYPE) << "：" << std::endl;
+                        std::cout << "1. " << getText(TextId::STUDENT_TYPE) << std::endl;
+                        std::cout << "2. " << getText(TextId::TEACHER_TYPE) << std::endl;
+                        std::cout << "3. " << getText(TextId::ADMIN_TYPE) << std::endl;
                         
                         int userType;
                         std::string userTypeInput;
@@ -635,74 +817,74 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         std::getline(std::cin, userTypeInput);
                         
                         if (!InputValidator::validateChoice(userTypeInput, 1, 3, userType)) {
-                            std::cout << getText("invalid_user_type") << std::endl;
+                            std::cout << getText(TextId::INVALID_USER_TYPE) << std::endl;
                             break;
                         }
                         
                         // 添加通用用户信息
                         std::string userId, name, password, gender;
                         
-                        std::cout << getText("enter_user_id_prompt") << "：";
+                        std::cout << getText(TextId::ENTER_USER_ID_PROMPT) << "：";
                         std::getline(std::cin, userId);
                         
                         // 添加用户ID非空验证
                         attempts = 0;
                         while (InputValidator::isEmptyInput(userId) && attempts < MAX_ATTEMPTS) {
                             attempts++;
-                            std::cout << getText("input_cannot_be_empty") << std::endl;
-                            std::cout << getText("enter_user_id_prompt") << "：";
+                            std::cout << getText(TextId::INPUT_CANNOT_BE_EMPTY) << std::endl;
+                            std::cout << getText(TextId::ENTER_USER_ID_PROMPT) << "：";
                             std::getline(std::cin, userId);
                             
                             if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(userId)) {
-                                std::cout << getText("too_many_attempts") << std::endl;
+                                std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                 break;
                             }
                         }
                         
                         // 检查用户ID是否已存在
                         if (userManager.getUser(userId) != nullptr) {
-                            std::cout << getText("user_id_exists") << std::endl;
+                            std::cout << getText(TextId::USER_ID_EXISTS) << std::endl;
                             break;
                         }
                         
-                        std::cout << getText("enter_username") << "：";
+                        std::cout << getText(TextId::ENTER_USERNAME) << "：";
                         std::getline(std::cin, name);
                         
                         // 添加用户名非空验证
                         attempts = 0;
                         while (InputValidator::isEmptyInput(name) && attempts < MAX_ATTEMPTS) {
                             attempts++;
-                            std::cout << getText("username_cannot_be_empty") << std::endl;
-                            std::cout << getText("enter_username") << "：";
+                            std::cout << getText(TextId::USERNAME_CANNOT_BE_EMPTY) << std::endl;
+                            std::cout << getText(TextId::ENTER_USERNAME) << "：";
                             std::getline(std::cin, name);
                                 
                             if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(name)) {
-                                std::cout << getText("too_many_attempts") << std::endl;
+                                std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                 break;
                             }
                         }
                         
-                        std::cout << getText("enter_user_password") << "：";
+                        std::cout << getText(TextId::ENTER_USER_PASSWORD) << "：";
                         std::getline(std::cin, password);
                         
                         // 添加密码非空验证
                         attempts = 0;
                         while (InputValidator::isEmptyInput(password) && attempts < MAX_ATTEMPTS) {
                             attempts++;
-                                std::cout << getText("password_cannot_be_empty") << std::endl;
-                                std::cout << getText("enter_user_password") << "：";
+                                std::cout << getText(TextId::PASSWORD_CANNOT_BE_EMPTY) << std::endl;
+                                std::cout << getText(TextId::ENTER_USER_PASSWORD) << "：";
                                 std::getline(std::cin, password);
                                 
                             if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(password)) {
-                                std::cout << getText("too_many_attempts") << std::endl;
+                                std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                 break;
                             }
                         }
                         
                         // 性别选择菜单
-                        std::cout << getText("enter_user_gender") << "：" << std::endl;
-                        std::cout << "1. " << getText("gender_male") << std::endl;
-                        std::cout << "2. " << getText("gender_female") << std::endl;
+                        std::cout << getText(TextId::ENTER_USER_GENDER) << "：" << std::endl;
+                        std::cout << "1. " << getText(TextId::GENDER_MALE) << std::endl;
+                        std::cout << "2. " << getText(TextId::GENDER_FEMALE) << std::endl;
                         
                         int genderChoice;
                         std::string genderInput;
@@ -717,9 +899,9 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 gender = (genderChoice == 1) ? "male" : "female";
                                 break;
                             } else {
-                                std::cout << getText("invalid_choice") << std::endl;
+                                std::cout << getText(TextId::INVALID_CHOICE) << std::endl;
                                 if (genderAttempts >= MAX_ATTEMPTS) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
                             }
@@ -729,7 +911,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         if (userType == 1) {  // 学生
                             std::string age, department, classInfo, email;
                             
-                            std::cout << getText("enter_student_age") << "：";
+                            std::cout << getText(TextId::ENTER_STUDENT_AGE) << "：";
                             
                             int ageValue = 0;
                             int ageAttempts = 0;
@@ -741,59 +923,59 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 if (InputValidator::validateInteger(age, 15, 80, ageValue)) {
                                     break;
                                 } else {
-                                    std::cout << getText("invalid_age") << std::endl;
+                                    std::cout << getText(TextId::INVALID_AGE) << std::endl;
                                     if (ageAttempts >= MAX_ATTEMPTS) {
-                                        std::cout << getText("too_many_attempts") << std::endl;
+                                        std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                         break;
                                     }
-                                    std::cout << getText("enter_student_age") << "：";
+                                    std::cout << getText(TextId::ENTER_STUDENT_AGE) << "：";
                                 }
                             }
                            
-                            std::cout << getText("enter_department") << "：";
+                            std::cout << getText(TextId::ENTER_DEPARTMENT) << "：";
                             std::getline(std::cin, department);
                             
                             attempts = 0;
                             while (InputValidator::isEmptyInput(department) && attempts < MAX_ATTEMPTS) {
                                 attempts++;
-                                std::cout << getText("department_cannot_be_empty") << std::endl;
-                                std::cout << getText("enter_department") << "：";
+                                std::cout << getText(TextId::DEPARTMENT_CANNOT_BE_EMPTY) << std::endl;
+                                std::cout << getText(TextId::ENTER_DEPARTMENT) << "：";
                                 std::getline(std::cin, department);
                                     
                                 if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(department)) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
                             }
                            
-                            std::cout << getText("enter_class_info") << "：";
+                            std::cout << getText(TextId::ENTER_CLASS_INFO) << "：";
                             std::getline(std::cin, classInfo);
                             
                             attempts = 0;
                             while (InputValidator::isEmptyInput(classInfo) && attempts < MAX_ATTEMPTS) {
                                 attempts++;
-                                std::cout << getText("class_info_cannot_be_empty") << std::endl;
-                                std::cout << getText("enter_class_info") << "：";
+                                std::cout << getText(TextId::CLASS_INFO_CANNOT_BE_EMPTY) << std::endl;
+                                std::cout << getText(TextId::ENTER_CLASS_INFO) << "：";
                                 std::getline(std::cin, classInfo);
                                     
                                 if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(classInfo)) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
                             }
                            
-                            std::cout << getText("enter_email") << "：";
+                            std::cout << getText(TextId::ENTER_EMAIL) << "：";
                             std::getline(std::cin, email);
                             
                             attempts = 0;
                             while (InputValidator::isEmptyInput(email) && attempts < MAX_ATTEMPTS) {
                                 attempts++;
-                                    std::cout << getText("input_cannot_be_empty") << std::endl;
-                                    std::cout << getText("enter_email") << "：";
+                                    std::cout << getText(TextId::INPUT_CANNOT_BE_EMPTY) << std::endl;
+                                    std::cout << getText(TextId::ENTER_EMAIL) << "：";
                                     std::getline(std::cin, email);
                                     
                                 if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(email)) {
-                                        std::cout << getText("too_many_attempts") << std::endl;
+                                        std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                         break;
                                     }
                             }
@@ -807,59 +989,59 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             
                             // 添加学生
                             if (userManager.addStudent(std::move(student))) {
-                                std::cout << getText("add_student_success") << std::endl;
+                                std::cout << getText(TextId::ADD_STUDENT_SUCCESS) << std::endl;
                             } else {
-                                std::cout << getText("add_student_failed") << std::endl;
+                                std::cout << getText(TextId::ADD_STUDENT_FAILED) << std::endl;
                             }
                             
                         } else if (userType == 2) {  // 教师
                             std::string title, department, email;
                             
-                            std::cout << getText("enter_teacher_title") << "：";
+                            std::cout << getText(TextId::ENTER_TEACHER_TITLE) << "：";
                             std::getline(std::cin, title);
                             
                             attempts = 0;
                             while (InputValidator::isEmptyInput(title) && attempts < MAX_ATTEMPTS) {
                                 attempts++;
-                                std::cout << getText("input_cannot_be_empty") << std::endl;
-                                std::cout << getText("enter_teacher_title") << "：";
+                                std::cout << getText(TextId::INPUT_CANNOT_BE_EMPTY) << std::endl;
+                                std::cout << getText(TextId::ENTER_TEACHER_TITLE) << "：";
                                 std::getline(std::cin, title);
                                     
                                 if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(title)) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
                             }
                             
-                            std::cout << getText("enter_teacher_department") << "：";
+                            std::cout << getText(TextId::ENTER_TEACHER_DEPARTMENT) << "：";
                             std::getline(std::cin, department);
                             
                             // 添加院系非空验证
                             attempts = 0;
                             while (InputValidator::isEmptyInput(department) && attempts < MAX_ATTEMPTS) {
                                 attempts++;
-                                std::cout << getText("department_cannot_be_empty") << std::endl;
-                                std::cout << getText("enter_teacher_department") << "：";
+                                std::cout << getText(TextId::DEPARTMENT_CANNOT_BE_EMPTY) << std::endl;
+                                std::cout << getText(TextId::ENTER_TEACHER_DEPARTMENT) << "：";
                                 std::getline(std::cin, department);
                                     
                                 if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(department)) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
                             }
                             
-                            std::cout << getText("enter_email") << "：";
+                            std::cout << getText(TextId::ENTER_EMAIL) << "：";
                             std::getline(std::cin, email);
                            
                             attempts = 0;
                             while (InputValidator::isEmptyInput(email) && attempts < MAX_ATTEMPTS) {
                                 attempts++;
-                                std::cout << getText("input_cannot_be_empty") << std::endl;
-                                std::cout << getText("enter_email") << "：";
+                                std::cout << getText(TextId::INPUT_CANNOT_BE_EMPTY) << std::endl;
+                                std::cout << getText(TextId::ENTER_EMAIL) << "：";
                                 std::getline(std::cin, email);
                                     
                                 if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(email)) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
                             }
@@ -871,9 +1053,9 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             
                             // 添加教师
                             if (userManager.addTeacher(std::move(teacher))) {
-                                std::cout << getText("add_teacher_success") << std::endl;
+                                std::cout << getText(TextId::ADD_TEACHER_SUCCESS) << std::endl;
                             } else {
-                                std::cout << getText("add_teacher_failed") << std::endl;
+                                std::cout << getText(TextId::ADD_TEACHER_FAILED) << std::endl;
                             }
                             
                         } else {  // 管理员
@@ -884,9 +1066,9 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             
                             // 添加管理员
                             if (userManager.addAdmin(std::move(admin))) {
-                                std::cout << getText("add_admin_success") << std::endl;
+                                std::cout << getText(TextId::ADD_ADMIN_SUCCESS) << std::endl;
                             } else {
-                                std::cout << getText("add_admin_failed") << std::endl;
+                                std::cout << getText(TextId::ADD_ADMIN_FAILED) << std::endl;
                             }
                         }
                         break;
@@ -901,20 +1083,21 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         std::vector<std::string> teacherIds = userManager.getAllTeacherIds();
                         std::vector<std::string> adminIds = userManager.getAllAdminIds();
                         
-                        std::cout << getText("user_list") << "：" << std::endl;
+                        std::cout << getText(TextId::USER_LIST) << "：" << std::endl;
                         std::cout << "--------------------------------" << std::endl;
                         
                         // 显示学生列表
                         if (!studentIds.empty()) {
-                            std::cout << getText("student_list") << "：" << std::endl;
+                            std::cout << getText(TextId::STUDENT_LIST) << "：" << std::endl;
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getText("user_id") << "\t" << getText("user_name") << "\t" 
-                                      << getText("age") << "\t" << getText("gender") << "\t"
-                                      << getText("department") << "\t" << getText("class") << "\t"
-                                      << getText("enter_email") << std::endl;
+                            std::cout << getText(TextId::USER_ID) << "\t" << getText(TextId::USER_NAME) << "\t" 
+                                      << getText(TextId::AGE) << "\t" << getText(TextId::GENDER) << "\t"
+                                      << getText(TextId::DEPARTMENT) << "\t" << getText(TextId::CLASS) << "\t"
+                                      << getText(TextId::ENTER_EMAIL) << std::endl;
                             
+                            std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
                             for (const std::string& studentId : studentIds) {
-                                Student* student = userManager.getStudent(studentId);
+                                std::shared_ptr<Student> student = directory->findStudent(studentId);
                                 if (student) {
                                     std::cout << student->getId() << "\t"
                                               << student->getName() << "\t"
@@ -930,14 +1113,15 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         
                         // 显示教师列表
                         if (!teacherIds.empty()) {
-                            std::cout << getText("teacher_list") << "：" << std::endl;
+                            std::cout << getText(TextId::TEACHER_LIST) << "：" << std::endl;
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getText("user_id") << "\t" << getText("user_name") << "\t" 
-                                      << getText("title") << "\t" << getText("department") << "\t"
-                                      << getText("enter_email") << std::endl;
+                            std::cout << getText(TextId::USER_ID) << "\t" << getText(TextId::USER_NAME) << "\t" 
+                                      << getText(TextId::TITLE) << "\t" << getText(TextId::DEPARTMENT) << "\t"
+                                      << getText(TextId::ENTER_EMAIL) << std::endl;
                             
+                            std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
                             for (const std::string& teacherId : teacherIds) {
-                                Teacher* teacher = userManager.getTeacher(teacherId);
+                                std::shared_ptr<Teacher> teacher = directory->findTeacher(teacherId);
                                 if (teacher) {
                                     std::cout << teacher->getId() << "\t"
                                               << teacher->getName() << "\t"
@@ -951,17 +1135,18 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         
                         // 显示管理员列表
                         if (!adminIds.empty()) {
-                            std::cout << getText("admin_list") << "：" << std::endl;
+                            std::cout << getText(TextId::ADMIN_LIST) << "：" << std::endl;
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getText("user_id") << "\t" << getText("user_name") << "\t" 
-                                      << getText("role") << std::endl;
+                            std::cout << getText(TextId::USER_ID) << "\t" << getText(TextId::USER_NAME) << "\t" 
+                                      << getText(TextId::ROLE) << std::endl;
                             
+                            std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
                             for (const std::string& adminId : adminIds) {
-                                Admin* admin = userManager.getAdmin(adminId);
+                                std::shared_ptr<Admin> admin = directory->findAdmin(adminId);
                                 if (admin) {
                                     std::cout << admin->getId() << "\t"
                                               << admin->getName() << "\t"
-                                              << getText("admin") << std::endl;
+                                              << getText(TextId::ADMIN) << std::endl;
                                 }
                             }
                             std::cout << "--------------------------------" << std::endl;
@@ -969,35 +1154,35 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         
                         // 获取用户ID
                         std::string userId;
-                        std::cout << getText("enter_delete_user_id") << "：";
+                        std::cout << getText(TextId::ENTER_DELETE_USER_ID) << "：";
                         std::getline(std::cin, userId);
                         
                         // 检查用户是否存在
-                        User* user = userManager.getUser(userId);
+                        std::shared_ptr<User> user = userManager.getUser(userId);
                         if (!user) {
-                            std::cout << getText("user_id_not_exists") << std::endl;
+                            std::cout << getText(TextId::USER_ID_NOT_EXISTS) << std::endl;
                             break;
                         }
                         
                         // 检查当前用户是否为管理员且尝试删除自己
                         if (currentUser_ && currentUser_->getType() == UserType::ADMIN && currentUser_->getId() == userId) {
-                            std::cout << getText("cannot_delete_self") << std::endl;
+                            std::cout << getText(TextId::CANNOT_DELETE_SELF) << std::endl;
                             break;
                         }
                         
                         // 确认删除
                         std::string confirm;
-                        std::cout << getText("confirm_delete_user") << " \"" << user->getName() << "\" " << getText("confirm_delete_prompt") << " ";
+                        std::cout << getText(TextId::CONFIRM_DELETE_USER) << " \"" << user->getName() << "\" " << getText(TextId::CONFIRM_DELETE_PROMPT) << " ";
                         std::getline(std::cin, confirm);
                         
                         if (confirm == "y" || confirm == "Y") {
                             if (userManager.removeUser(userId)) {
-                                std::cout << getText("delete_user_success") << std::endl;
+                                std::cout << getText(TextId::DELETE_USER_SUCCESS) << std::endl;
                             } else {
-                                std::cout << getText("delete_user_failed") << std::endl;
+                                std::cout << getText(TextId::DELETE_USER_FAILED) << std::endl;
                             }
                         } else {
-                            std::cout << getText("cancel_delete") << std::endl;
+                            std::cout << getText(TextId::CANCEL_DELETE) << std::endl;
                         }
                         break;
                     }
@@ -1007,12 +1192,12 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         UserManager& userManager = UserManager::getInstance();
                         
                         // 显示查询选项
-                        std::cout << getText("select_query_method") << "：" << std::endl;
-                        std::cout << "1. " << getText("query_by_user_id") << std::endl;
-                        std::cout << "2. " << getText("view_all_students") << std::endl;
-                        std::cout << "3. " << getText("view_all_teachers") << std::endl;
-                        std::cout << "4. " << getText("view_all_admins") << std::endl;
-                        std::cout << "5. " << getText("return") << std::endl;
+                        std::cout << getText(TextId::SELECT_QUERY_METHOD) << "：" << std::endl;
+                        std::cout << "1. " << getText(TextId::QUERY_BY_USER_ID) << std::endl;
+                        std::cout << "2. " << getText(TextId::VIEW_ALL_STUDENTS) << std::endl;
+                        std::cout << "3. " << getText(TextId::VIEW_ALL_TEACHERS) << std::endl;
+                        std::cout << "4. " << getText(TextId::VIEW_ALL_ADMINS) << std::endl;
+                        std::cout << "5. " << getText(TextId::RETURN) << std::endl;
                         
                         int queryChoice = 0;
                         std::string queryInput;
@@ -1020,56 +1205,56 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         std::getline(std::cin, queryInput);
                         
                         if (!InputValidator::validateChoice(queryInput, 1, 5, queryChoice)) {
-                            std::cout << getText("invalid_choice") << std::endl;
+                            std::cout << getText(TextId::INVALID_CHOICE) << std::endl;
                             break;
                         }
                         
                         if (queryChoice == 1) {  // 按用户ID查询
                             std::string userId;
-                            std::cout << getText("enter_user_id") << "：";
+                            std::cout << getText(TextId::ENTER_USER_ID) << "：";
                             std::getline(std::cin, userId);
                             
-                            User* user = userManager.getUser(userId);
+                            std::shared_ptr<User> user = userManager.getUser(userId);
                             if (!user) {
-                                std::cout << getText("user_id_not_exists") << std::endl;
+                                std::cout << getText(TextId::USER_ID_NOT_EXISTS) << std::endl;
                                 break;
                             }
                             
                             // 显示用户信息
-                            std::cout << getText("user_info") << "：" << std::endl;
+                            std::cout << getText(TextId::USER_INFO) << "：" << std::endl;
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getText("user_id") << ": " << user->getId() << std::endl;
-                            std::cout << getText("user_name") << ": " << user->getName() << std::endl;
-                            std::cout << getText("user_type") << ": ";
+                            std::cout << getText(TextId::USER_ID) << ": " << user->getId() << std::endl;
+                            std::cout << getText(TextId::USER_NAME) << ": " << user->getName() << std::endl;
+                            std::cout << getText(TextId::USER_TYPE) << ": ";
                             switch (user->getType()) {
                                 case UserType::STUDENT:
-                                    std::cout << getText("student");
+                                    std::cout << getText(TextId::STUDENT);
                                     break;
                                 case UserType::TEACHER:
-                                    std::cout << getText("teacher");
+                                    std::cout << getText(TextId::TEACHER);
                                     break;
                                 case UserType::ADMIN:
-                                    std::cout << getText("admin");
+                                    std::cout << getText(TextId::ADMIN);
                                     break;
                                 default:
-                                    std::cout << getText("unknown_type");
+                                    std::cout << getText(TextId::UNKNOWN_TYPE);
                                     break;
                             }
                             std::cout << std::endl;
                             
                             // 根据用户类型显示不同的信息
                             if (user->getType() == UserType::STUDENT) {
-                                Student* student = dynamic_cast<Student*>(user);
-                                std::cout << getText("age") << ": " << student->getAge() << std::endl;
-                                std::cout << getText("gender") << ": " << student->getGender() << std::endl;
-                                std::cout << getText("department") << ": " << student->getDepartment() << std::endl;
-                                std::cout << getText("class") << ": " << student->getClassInfo() << std::endl;
-                                std::cout << getText("email_address") << ": " << student->getContact() << std::endl;
+                                Student* student = dynamic_cast<Student*>(user.get());
+                                std::cout << getText(TextId::AGE) << ": " << student->getAge() << std::endl;
+                                std::cout << getText(TextId::GENDER) << ": " << student->getGender() << std::endl;
+                                std::cout << getText(TextId::DEPARTMENT) << ": " << student->getDepartment() << std::endl;
+                                std::cout << getText(TextId::CLASS) << ": " << student->getClassInfo() << std::endl;
+                                std::cout << getText(TextId::EMAIL_ADDRESS) << ": " << student->getContact() << std::endl;
                             } else if (user->getType() == UserType::TEACHER) {
-                                Teacher* teacher = dynamic_cast<Teacher*>(user);
-                                std::cout << getText("title") << ": " << teacher->getTitle() << std::endl;
-                                std::cout << getText("department") << ": " << teacher->getDepartment() << std::endl;
-                                std::cout << getText("email_address") << ": " << teacher->getContact() << std::endl;
+                                Teacher* teacher = dynamic_cast<Teacher*>(user.get());
+                                std::cout << getText(TextId::TITLE) << ": " << teacher->getTitle() << std::endl;
+                                std::cout << getText(TextId::DEPARTMENT) << ": " << teacher->getDepartment() << std::endl;
+                                std::cout << getText(TextId::EMAIL_ADDRESS) << ": " << teacher->getContact() << std::endl;
                             } else if (user->getType() == UserType::ADMIN) {
                                 // Admin类没有额外属性需要显示
                             }
@@ -1079,19 +1264,20 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             std::vector<std::string> studentIds = userManager.getAllStudentIds();
                             
                             if (studentIds.empty()) {
-                                std::cout << getText("no_students") << std::endl;
+                                std::cout << getText(TextId::NO_STUDENTS) << std::endl;
                                 break;
                             }
                             
-                            std::cout << getText("student_list") << "：" << std::endl;
+                            std::cout << getText(TextId::STUDENT_LIST) << "：" << std::endl;
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getText("user_id") << "\t" << getText("user_name") << "\t" 
-                                      << getText("age") << "\t" << getText("gender") << "\t"
-                                      << getText("department") << "\t" << getText("class") << "\t"
-                                      << getText("email_address") << std::endl;
+                            std::cout << getText(TextId::USER_ID) << "\t" << getText(TextId::USER_NAME) << "\t" 
+                                      << getText(TextId::AGE) << "\t" << getText(TextId::GENDER) << "\t"
+                                      << getText(TextId::DEPARTMENT) << "\t" << getText(TextId::CLASS) << "\t"
+                                      << getText(TextId::EMAIL_ADDRESS) << std::endl;
                             
+                            std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
                             for (const std::string& studentId : studentIds) {
-                                Student* student = userManager.getStudent(studentId);
+                                std::shared_ptr<Student> student = directory->findStudent(studentId);
                                 if (student) {
                                     std::cout << student->getId() << "\t"
                                               << student->getName() << "\t"
@@ -1103,24 +1289,25 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 }
                             }
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getFormattedText("student_count_total", static_cast<int>(studentIds.size())) << std::endl;
+                            std::cout << getFormattedText(TextId::STUDENT_COUNT_TOTAL, static_cast<int>(studentIds.size())) << std::endl;
                             
                         } else if (queryChoice == 3) {  // 查看所有教师
                             std::vector<std::string> teacherIds = userManager.getAllTeacherIds();
                             
                             if (teacherIds.empty()) {
-                                std::cout << getText("no_teachers") << std::endl;
+                                std::cout << getText(TextId::NO_TEACHERS) << std::endl;
                                 break;
                             }
                             
-                            std::cout << getText("teacher_list") << "：" << std::endl;
+                            std::cout << getText(TextId::TEACHER_LIST) << "：" << std::endl;
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getText("user_id") << "\t" << getText("user_name") << "\t" 
-                                      << getText("title") << "\t" << getText("department") << "\t"
-                                      << getText("email_address") << std::endl;
+                            std::cout << getText(TextId::USER_ID) << "\t" << getText(TextId::USER_NAME) << "\t" 
+                                      << getText(TextId::TITLE) << "\t" << getText(TextId::DEPARTMENT) << "\t"
+                                      << getText(TextId::EMAIL_ADDRESS) << std::endl;
                             
+                            std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
                             for (const std::string& teacherId : teacherIds) {
-                                Teacher* teacher = userManager.getTeacher(teacherId);
+                                std::shared_ptr<Teacher> teacher = directory->findTeacher(teacherId);
                                 if (teacher) {
                                     std::cout << teacher->getId() << "\t"
                                               << teacher->getName() << "\t"
@@ -1130,31 +1317,32 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 }
                             }
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getFormattedText("teacher_count_total", static_cast<int>(teacherIds.size())) << std::endl;
+                            std::cout << getFormattedText(TextId::TEACHER_COUNT_TOTAL, static_cast<int>(teacherIds.size())) << std::endl;
                             
                         } else if (queryChoice == 4) {  // 查看所有管理员
                             std::vector<std::string> adminIds = userManager.getAllAdminIds();
                             
                             if (adminIds.empty()) {
-                                std::cout << getText("no_admins") << std::endl;
+                                std::cout << getText(TextId::NO_ADMINS) << std::endl;
                                 break;
                             }
                             
-                            std::cout << getText("admin_list") << "：" << std::endl;
+                            std::cout << getText(TextId::ADMIN_LIST) << "：" << std::endl;
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getText("user_id") << "\t" << getText("user_name") << "\t" 
-                                      << getText("role") << std::endl;
+                            std::cout << getText(TextId::USER_ID) << "\t" << getText(TextId::USER_NAME) << "\t" 
+                                      << getText(TextId::ROLE) << std::endl;
                             
+                            std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
                             for (const std::string& adminId : adminIds) {
-                                Admin* admin = userManager.getAdmin(adminId);
+                                std::shared_ptr<Admin> admin = directory->findAdmin(adminId);
                                 if (admin) {
                                     std::cout << admin->getId() << "\t"
                                               << admin->getName() << "\t"
-                                              << getText("admin") << std::endl;
+                                              << getText(TextId::ADMIN) << std::endl;
                                 }
                             }
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getFormattedText("admin_count_total", static_cast<int>(adminIds.size())) << std::endl;
+                            std::cout << getFormattedText(TextId::ADMIN_COUNT_TOTAL, static_cast<int>(adminIds.size())) << std::endl;
                         }
                         break;
                     }
@@ -1165,7 +1353,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                 }
                 
                 if (subMenuRunning && subChoice != 4) {
-                    std::cout << getText("press_enter_to_continue") << std::endl;
+                    std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << std::endl;
                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                 }
             }
@@ -1173,16 +1361,16 @@ void CourseSystem::handleAdminFunctions(int choice) {
         }
             
         case 2: { // 课程管理
-            std::cout << getText("course_management_function") << std::endl;
+            std::cout << getText(TextId::COURSE_MANAGEMENT_FUNCTION) << std::endl;
             
             // 实现更完整的课程管理功能
             bool subMenuRunning = true;
             while (subMenuRunning && running_) {
-                std::cout << "1. " << getText("add_course") << std::endl;
-                std::cout << "2. " << getText("delete_course") << std::endl;
-                std::cout << "3. " << getText("modify_course") << std::endl;
-                std::cout << "4. " << getText("query_course") << std::endl;
-                std::cout << "5. " << getText("return_to_parent_menu") << std::endl;
+                std::cout << "1. " << getText(TextId::ADD_COURSE) << std::endl;
+                std::cout << "2. " << getText(TextId::DELETE_COURSE) << std::endl;
+                std::cout << "3. " << getText(TextId::MODIFY_COURSE) << std::endl;
+                std::cout << "4. " << getText(TextId::QUERY_COURSE) << std::endl;
+                std::cout << "5. " << getText(TextId::RETURN_TO_PARENT_MENU) << std::endl;
                 
                 int subChoice = 0;
                 std::string input;
@@ -1190,7 +1378,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                 std::getline(std::cin, input);
                 
                 if (!InputValidator::validateChoice(input, 1, 5, subChoice)) {
-                    std::cout << getText("invalid_input") << std::endl;
+                    std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                     continue;
                 }
                 
@@ -1208,50 +1396,50 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         // 添加课程信息
                         std::string courseId, name, typeStr, creditStr, hoursStr, semester, teacherId, maxCapacityStr;
                         
-                        std::cout << getText("enter_course_id") << "：";
+                        std::cout << getText(TextId::ENTER_COURSE_ID) << "：";
                         std::getline(std::cin, courseId);
                         
                         // 添加课程ID非空验证
                         int attempts = 0;
                         while (InputValidator::isEmptyInput(courseId) && attempts < MAX_ATTEMPTS) {
                             attempts++;
-                            std::cout << getText("input_cannot_be_empty") << std::endl;
-                            std::cout << getText("enter_course_id") << "：";
+                            std::cout << getText(TextId::INPUT_CANNOT_BE_EMPTY) << std::endl;
+                            std::cout << getText(TextId::ENTER_COURSE_ID) << "：";
                             std::getline(std::cin, courseId);
                                 
                             if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(courseId)) {
-                                std::cout << getText("too_many_attempts") << std::endl;
+                                std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                 break;
                             }
                         }
                         
                         // 检查课程ID是否已存在
                         if (courseManager.hasCourse(courseId)) {
-                            std::cout << getText("course_id_exists") << std::endl;
+                            std::cout << getText(TextId::COURSE_ID_EXISTS) << std::endl;
                             continue;
                         }
                         
-                        std::cout << getText("enter_course_name") << "：";
+                        std::cout << getText(TextId::ENTER_COURSE_NAME) << "：";
                         std::getline(std::cin, name);
                         
                         // 添加课程名称非空验证
                         attempts = 0;
                         while (InputValidator::isEmptyInput(name) && attempts < MAX_ATTEMPTS) {
                             attempts++;
-                            std::cout << getText("course_name_cannot_be_empty") << std::endl;
-                            std::cout << getText("enter_course_name") << "：";
+                            std::cout << getText(TextId::COURSE_NAME_CANNOT_BE_EMPTY) << std::endl;
+                            std::cout << getText(TextId::ENTER_COURSE_NAME) << "：";
                             std::getline(std::cin, name);
                                 
                             if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(name)) {
-                                std::cout << getText("too_many_attempts") << std::endl;
+                                std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                 break;
                             }
                         }
                         
                         // 选择课程类型
-                        std::cout << getText("select_course_type") << "：" << std::endl;
-                        std::cout << "1. " << getText("required_course") << std::endl;
-                        std::cout << "2. " << getText("elective_course") << std::endl;
+                        std::cout << getText(TextId::SELECT_COURSE_TYPE) << "：" << std::endl;
+                        std::cout << "1. " << getText(TextId::REQUIRED_COURSE) << std::endl;
+                        std::cout << "2. " << getText(TextId::ELECTIVE_COURSE) << std::endl;
                         
                         int typeChoice = 0;
                         std::string typeInput;
@@ -1265,9 +1453,9 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             if (InputValidator::validateChoice(typeInput, 1, 2, typeChoice)) {
                                 break;
                             } else {
-                                std::cout << getText("invalid_course_type") << std::endl;
+                                std::cout << getText(TextId::INVALID_COURSE_TYPE) << std::endl;
                                 if (typeAttempts >= MAX_ATTEMPTS) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
                             }
@@ -1286,7 +1474,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 break;
                         }
                         
-                        std::cout << getText("enter_credit") << "：";
+                        std::cout << getText(TextId::ENTER_CREDIT) << "：";
                         
                         double credit = 0.0;
                         int creditAttempts = 0;
@@ -1298,16 +1486,16 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             if (InputValidator::validateDouble(creditStr, 0.0, 10.0, credit)) {
                                 break;
                             } else {
-                                std::cout << getText("invalid_credit") << std::endl;
+                                std::cout << getText(TextId::INVALID_CREDIT) << std::endl;
                                 if (creditAttempts >= MAX_ATTEMPTS) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
-                                std::cout << getText("enter_credit") << "：";
+                                std::cout << getText(TextId::ENTER_CREDIT) << "：";
                             }
                         }
                         
-                        std::cout << getText("enter_hours") << "：";
+                        std::cout << getText(TextId::ENTER_HOURS) << "：";
                         std::getline(std::cin, hoursStr);
                         
                         int hours = 0;
@@ -1317,29 +1505,29 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             if (InputValidator::validateInteger(hoursStr, 0, 200, hours)) {
                                 break;
                             } else {
-                                std::cout << getText("invalid_hours") << std::endl;
+                                std::cout << getText(TextId::INVALID_HOURS) << std::endl;
                                 if (hoursAttempts >= MAX_ATTEMPTS) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
-                                std::cout << getText("enter_hours") << "：";
+                                std::cout << getText(TextId::ENTER_HOURS) << "：";
                                 std::getline(std::cin, hoursStr);
                             }
                         }
                         
-                        std::cout << getText("enter_semester") << "：";
+                        std::cout << getText(TextId::ENTER_SEMESTER) << "：";
                         std::getline(std::cin, semester);
                         
                         // 添加学期非空验证
                         attempts = 0;
                         while (InputValidator::isEmptyInput(semester) && attempts < MAX_ATTEMPTS) {
                             attempts++;
-                            std::cout << getText("semester_cannot_be_empty") << std::endl;
-                            std::cout << getText("enter_semester") << "：";
+                            std::cout << getText(TextId::SEMESTER_CANNOT_BE_EMPTY) << std::endl;
+                            std::cout << getText(TextId::ENTER_SEMESTER) << "：";
                             std::getline(std::cin, semester);
                             
                             if (attempts >= MAX_ATTEMPTS && InputValidator::isEmptyInput(semester)) {
-                                std::cout << getText("too_many_attempts") << std::endl;
+                                std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                 break;
                             }
                         }
@@ -1350,17 +1538,18 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         std::vector<std::string> teacherIds = userManager.getAllTeacherIds();
                         
                         if (teacherIds.empty()) {
-                            std::cout << getText("no_teachers") << std::endl;
+                            std::cout << getText(TextId::NO_TEACHERS) << std::endl;
                             continue;
                         }
                         
-                        std::cout << getText("available_teachers") << "：" << std::endl;
+                        std::cout << getText(TextId::AVAILABLE_TEACHERS) << "：" << std::endl;
                         std::cout << "--------------------------------" << std::endl;
-                        std::cout << getText("teacher_id") << "\t" 
-                                  << getText("teacher_name") << std::endl;
+                        std::cout << getText(TextId::TEACHER_ID) << "\t" 
+                                  << getText(TextId::TEACHER_NAME) << std::endl;
                         
+                        std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
                         for (const std::string& id : teacherIds) {
-                            Teacher* teacher = userManager.getTeacher(id);
+                            std::shared_ptr<Teacher> teacher = directory->findTeacher(id);
                             if (teacher) {
                                 std::cout << teacher->getId() << "\t"
                                           << teacher->getName() << std::endl;
@@ -1368,7 +1557,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         }
                         std::cout << "--------------------------------" << std::endl;
                         
-                        std::cout << getText("enter_teacher_id") << "：";
+                        std::cout << getText(TextId::ENTER_TEACHER_ID) << "：";
                         
                         int teacherAttempts = 0;
                         
@@ -1379,16 +1568,16 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             if (userManager.getTeacher(teacherId)) {
                                 break;
                             } else {
-                                std::cout << getText("teacher_id_not_exists") << std::endl;
+                                std::cout << getText(TextId::TEACHER_ID_NOT_EXISTS) << std::endl;
                                 if (teacherAttempts >= MAX_ATTEMPTS) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
-                                std::cout << getText("enter_teacher_id") << "：";
+                                std::cout << getText(TextId::ENTER_TEACHER_ID) << "：";
                             }
                         }
                         
-                        std::cout << getText("enter_max_capacity") << "：";
+                        std::cout << getText(TextId::ENTER_MAX_CAPACITY) << "：";
                         
                         int maxCapacity = 0;
                         int maxCapacityAttempts = 0;
@@ -1400,12 +1589,12 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             if (InputValidator::validateInteger(maxCapacityStr, 1, 1000, maxCapacity)) {
                                 break;
                             } else {
-                                std::cout << getText("invalid_max_capacity") << std::endl;
+                                std::cout << getText(TextId::INVALID_MAX_CAPACITY) << std::endl;
                                 if (maxCapacityAttempts >= MAX_ATTEMPTS) {
-                                    std::cout << getText("too_many_attempts") << std::endl;
+                                    std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                                     break;
                                 }
-                                std::cout << getText("enter_max_capacity") << "：";
+                                std::cout << getText(TextId::ENTER_MAX_CAPACITY) << "：";
                             }
                         }
                         
@@ -1418,9 +1607,9 @@ void CourseSystem::handleAdminFunctions(int choice) {
                             
                             // 添加课程
                         if (courseManager.addCourse(std::move(course))) {
-                            std::cout << getText("add_course_success") << std::endl;
+                            std::cout << getText(TextId::ADD_COURSE_SUCCESS) << std::endl;
                         } else {
-                            std::cout << getText("add_course_failed") << std::endl;
+                            std::cout << getText(TextId::ADD_COURSE_FAILED) << std::endl;
                         }
                         break;
                     }
@@ -1433,18 +1622,18 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         std::vector<std::string> allCourseIds = courseManager.getAllCourseIds();
                         
                         if (allCourseIds.empty()) {
-                            std::cout << getText("no_courses") << std::endl;
+                            std::cout << getText(TextId::NO_COURSES) << std::endl;
                             continue;
                         }
                         
-                        std::cout << getText("all_courses") << "：" << std::endl;
+                        std::cout << getText(TextId::ALL_COURSES) << "：" << std::endl;
                         std::cout << "--------------------------------" << std::endl;
-                        std::cout << getText("course_id") << "\t" 
-                                << getText("course_name") << "\t" 
-                                << getText("course_type") << std::endl;
+                        std::cout << getText(TextId::COURSE_ID) << "\t" 
+                                << getText(TextId::COURSE_NAME) << "\t" 
+                                << getText(TextId::COURSE_TYPE) << std::endl;
                         
                         for (const std::string& id : allCourseIds) {
-                            Course* course = courseManager.getCourse(id);
+                            std::shared_ptr<const Course> course = courseManager.getCourse(id);
                             if (course) {
                                 std::cout << course->getId() << "\t"
                                         << course->getName() << "\t"
@@ -1455,51 +1644,51 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         
                         // 获取课程ID
                         std::string courseId;
-                        std::cout << getText("enter_delete_course_id") << "：";
+                        std::cout << getText(TextId::ENTER_DELETE_COURSE_ID) << "：";
                         std::getline(std::cin, courseId);
                         
                         // 检查课程是否存在
-                        Course* course = courseManager.getCourse(courseId);
+                        std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                         if (!course) {
-                            std::cout << getText("course_id_not_exists") << std::endl;
+                            std::cout << getText(TextId::COURSE_ID_NOT_EXISTS) << std::endl;
                             continue;
                         }
                         
                         // 显示课程信息
-                        std::cout << getText("course_to_delete") << "：" << std::endl;
-                        std::cout << getText("course_id") << ": " << course->getId() << std::endl;
-                        std::cout << getText("course_name") << ": " << course->getName() << std::endl;
-                        std::cout << getText("course_type") << ": " << course->getTypeString() << std::endl;
-                        std::cout << getText("credit") << ": " << course->getCredit() << std::endl;
-                        std::cout << getText("current_enrollment") << ": " << course->getCurrentEnrollment() << "/" << course->getMaxCapacity() << std::endl;
+                        std::cout << getText(TextId::COURSE_TO_DELETE) << "：" << std::endl;
+                        std::cout << getText(TextId::COURSE_ID) << ": " << course->getId() << std::endl;
+                        std::cout << getText(TextId::COURSE_NAME) << ": " << course->getName() << std::endl;
+                        std::cout << getText(TextId::COURSE_TYPE) << ": " << course->getTypeString() << std::endl;
+                        std::cout << getText(TextId::CREDIT) << ": " << course->getCredit() << std::endl;
+                        std::cout << getText(TextId::CURRENT_ENROLLMENT) << ": " << course->getCurrentEnrollment() << "/" << course->getMaxCapacity() << std::endl;
                         
                         // 检查课程是否已有学生选修
                         if (course->getCurrentEnrollment() > 0) {
-                            std::cout << getText("course_has_students") << std::endl;
+                            std::cout << getText(TextId::COURSE_HAS_STUDENTS) << std::endl;
                         }
                         
                         // 确认删除
                         std::string confirm;
-                        std::cout << getText("confirm_delete_course") << " \"" << course->getName() << "\" " << getText("confirm_delete_prompt") << " ";
+                        std::cout << getText(TextId::CONFIRM_DELETE_COURSE) << " \"" << course->getName() << "\" " << getText(TextId::CONFIRM_DELETE_PROMPT) << " ";
                         std::getline(std::cin, confirm);
                         
                         if (confirm == "y" || confirm == "Y") {
                             // 获取选修该课程的学生列表
-                            std::vector<Enrollment*> enrollments = enrollmentManager.getCourseEnrollments(courseId);
+                            std::vector<std::shared_ptr<const Enrollment>> enrollments = enrollmentManager.getCourseEnrollments(courseId);
                             
                             // 先处理选课记录
-                            for (Enrollment* enrollment : enrollments) {
+                            for (const auto& enrollment : enrollments) {
                                 enrollmentManager.dropCourse(enrollment->getStudentId(), courseId);
                             }
                             
                             // 删除课程
                             if (courseManager.removeCourse(courseId)) {
-                                std::cout << getText("delete_course_success") << std::endl;
+                                std::cout << getText(TextId::DELETE_COURSE_SUCCESS) << std::endl;
                             } else {
-                                std::cout << getText("delete_course_failed") << std::endl;
+                                std::cout << getText(TextId::DELETE_COURSE_FAILED) << std::endl;
                             }
                         } else {
-                            std::cout << getText("cancel_delete") << std::endl;
+                            std::cout << getText(TextId::CANCEL_DELETE) << std::endl;
                         }
                         break;
                     }
@@ -1511,18 +1700,18 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         std::vector<std::string> allCourseIds = courseManager.getAllCourseIds();
                         
                         if (allCourseIds.empty()) {
-                            std::cout << getText("no_courses") << std::endl;
+                            std::cout << getText(TextId::NO_COURSES) << std::endl;
                             break;
                         }
                         
                         std::cout << "所有课程：" << std::endl;
                         std::cout << "--------------------------------" << std::endl;
-                        std::cout << getText("course_id") << "\t" 
-                                  << getText("course_name") << "\t" 
-                                  << getText("course_type") << std::endl;
+                        std::cout << getText(TextId::COURSE_ID) << "\t" 
+                                  << getText(TextId::COURSE_NAME) << "\t" 
+                                  << getText(TextId::COURSE_TYPE) << std::endl;
                         
                         for (const std::string& id : allCourseIds) {
-                            Course* course = courseManager.getCourse(id);
+                            std::shared_ptr<const Course> course = courseManager.getCourse(id);
                             if (course) {
                                 std::cout << course->getId() << "\t"
                                           << course->getName() << "\t"
@@ -1533,38 +1722,38 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         
                         // 获取课程ID
                         std::string courseId;
-                        std::cout << getText("enter_modify_course_id") << "：";
+                        std::cout << getText(TextId::ENTER_MODIFY_COURSE_ID) << "：";
                         std::getline(std::cin, courseId);
                         
                         // 检查课程是否存在
-                        Course* course = courseManager.getCourse(courseId);
+                        std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                         if (!course) {
-                            std::cout << getText("course_id_not_exists") << std::endl;
+                            std::cout << getText(TextId::COURSE_ID_NOT_EXISTS) << std::endl;
                             break;
                         }
                         
                         // 显示当前课程信息
-                        std::cout << getText("current_course_info") << "：" << std::endl;
-                        std::cout << getText("course_id") << ": " << course->getId() << std::endl;
-                        std::cout << getText("course_name") << ": " << course->getName() << std::endl;
-                        std::cout << getText("course_type") << ": " << course->getTypeString() << std::endl;
-                        std::cout << getText("credit") << ": " << course->getCredit() << std::endl;
-                        std::cout << getText("hours") << ": " << course->getHours() << std::endl;
-                        std::cout << getText("semester") << ": " << course->getSemester() << std::endl;
-                        std::cout << getText("teacher_id") << ": " << course->getTeacherId() << std::endl;
-                        std::cout << getText("max_capacity") << ": " << course->getMaxCapacity() << std::endl;
-                        std::cout << getText("current_enrollment") << ": " << course->getCurrentEnrollment() << "/" << course->getMaxCapacity() << std::endl;
+                        std::cout << getText(TextId::CURRENT_COURSE_INFO) << "：" << std::endl;
+                        std::cout << getText(TextId::COURSE_ID) << ": " << course->getId() << std::endl;
+                        std::cout << getText(TextId::COURSE_NAME) << ": " << course->getName() << std::endl;
+                        std::cout << getText(TextId::COURSE_TYPE) << ": " << course->getTypeString() << std::endl;
+                        std::cout << getText(TextId::CREDIT) << ": " << course->getCredit() << std::endl;
+                        std::cout << getText(TextId::HOURS) << ": " << course->getHours() << std::endl;
+                        std::cout << getText(TextId::SEMESTER) << ": " << course->getSemester() << std::endl;
+                        std::cout << getText(TextId::TEACHER_ID) << ": " << course->getTeacherId() << std::endl;
+                        std::cout << getText(TextId::MAX_CAPACITY) << ": " << course->getMaxCapacity() << std::endl;
+                        std::cout << getText(TextId::CURRENT_ENROLLMENT) << ": " << course->getCurrentEnrollment() << "/" << course->getMaxCapacity() << std::endl;
                         
                         // 显示修改选项
-                        std::cout << getText("select_modify_course_content") << "：" << std::endl;
-                        std::cout << "1. " << getText("modify_course_name") << std::endl;
-                        std::cout << "2. " << getText("modify_course_type") << std::endl;
-                        std::cout << "3. " << getText("modify_course_credit") << std::endl;
-                        std::cout << "4. " << getText("modify_course_hours") << std::endl;
-                        std::cout << "5. " << getText("modify_course_semester") << std::endl;
-                        std::cout << "6. " << getText("modify_teacher_id") << std::endl;
-                        std::cout << "7. " << getText("modify_max_capacity") << std::endl;
-                        std::cout << "8. " << getText("return") << std::endl;
+                        std::cout << getText(TextId::SELECT_MODIFY_COURSE_CONTENT) << "：" << std::endl;
+                        std::cout << "1. " << getText(TextId::MODIFY_COURSE_NAME) << std::endl;
+                        std::cout << "2. " << getText(TextId::MODIFY_COURSE_TYPE) << std::endl;
+                        std::cout << "3. " << getText(TextId::MODIFY_COURSE_CREDIT) << std::endl;
+                        std::cout << "4. " << getText(TextId::MODIFY_COURSE_HOURS) << std::endl;
+                        std::cout << "5. " << getText(TextId::MODIFY_COURSE_SEMESTER) << std::endl;
+                        std::cout << "6. " << getText(TextId::MODIFY_TEACHER_ID) << std::endl;
+                        std::cout << "7. " << getText(TextId::MODIFY_MAX_CAPACITY) << std::endl;
+                        std::cout << "8. " << getText(TextId::RETURN) << std::endl;
                         
                         int modifyChoice;
                         std::string modifyInput;
@@ -1572,28 +1761,29 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         std::getline(std::cin, modifyInput);
                         
                         if (!InputValidator::validateChoice(modifyInput, 1, 8, modifyChoice)) {
-                            std::cout << getText("invalid_choice") << std::endl;
+                            std::cout << getText(TextId::INVALID_CHOICE) << std::endl;
                             break;
                         }
                         
-                        // 处理不同的修改选项
+                        // 处理不同的修改选项：已发布的课程可能正被其他线程读取，在副本上修改
+                        Course edited(*course);
                         switch (modifyChoice) {
                             case 1: { // 修改课程名称
                                 std::string newName;
-                                std::cout << getText("enter_new_course_name") << "：";
+                                std::cout << getText(TextId::ENTER_NEW_COURSE_NAME) << "：";
                                 std::getline(std::cin, newName);
                                 if (newName.empty()) {
-                                    std::cout << getText("course_name_cannot_be_empty") << std::endl;
+                                    std::cout << getText(TextId::COURSE_NAME_CANNOT_BE_EMPTY) << std::endl;
                                     break;
                                 }
-                                course->setName(newName);
-                                std::cout << getText("course_name_modify_success") << std::endl;
+                                edited.setName(newName);
+                                std::cout << getText(TextId::COURSE_NAME_MODIFY_SUCCESS) << std::endl;
                                 break;
                             }
                             case 2: { // 修改课程类型
-                                std::cout << getText("select_new_course_type") << "：" << std::endl;
-                                std::cout << "1. " << getText("required_course") << std::endl;
-                                std::cout << "2. " << getText("elective_course") << std::endl;
+                                std::cout << getText(TextId::SELECT_NEW_COURSE_TYPE) << "：" << std::endl;
+                                std::cout << "1. " << getText(TextId::REQUIRED_COURSE) << std::endl;
+                                std::cout << "2. " << getText(TextId::ELECTIVE_COURSE) << std::endl;
                                 
                                 int typeChoice = 0;
                                 std::string typeInput;
@@ -1601,7 +1791,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 std::getline(std::cin, typeInput);
                                 
                                 if (!InputValidator::validateChoice(typeInput, 1, 2, typeChoice)) {
-                                    std::cout << getText("invalid_course_type") << std::endl;
+                                    std::cout << getText(TextId::INVALID_COURSE_TYPE) << std::endl;
                                     break;
                                 }
                                 
@@ -1618,50 +1808,50 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                         break;
                                 }
                                 
-                                course->setType(type);
-                                std::cout << getText("course_type_modify_success") << std::endl;
+                                edited.setType(type);
+                                std::cout << getText(TextId::COURSE_TYPE_MODIFY_SUCCESS) << std::endl;
                                 break;
                             }
                             case 3: { // 修改课程学分
                                 std::string creditStr;
-                                std::cout << getText("enter_new_credit") << "：";
+                                std::cout << getText(TextId::ENTER_NEW_CREDIT) << "：";
                                 std::getline(std::cin, creditStr);
                                 
                                 double credit = 0.0;
                                 if (!InputValidator::validateDouble(creditStr, 0.0, 10.0, credit)) {
-                                    std::cout << getText("invalid_credit") << std::endl;
+                                    std::cout << getText(TextId::INVALID_CREDIT) << std::endl;
                                     break;
                                 }
                                 
-                                course->setCredit(credit);
-                                std::cout << getText("course_credit_modify_success") << std::endl;
+                                edited.setCredit(credit);
+                                std::cout << getText(TextId::COURSE_CREDIT_MODIFY_SUCCESS) << std::endl;
                                 break;
                             }
                             case 4: { // 修改课程学时
                                 std::string hoursStr;
-                                std::cout << getText("enter_new_hours") << "：";
+                                std::cout << getText(TextId::ENTER_NEW_HOURS) << "：";
                                 std::getline(std::cin, hoursStr);
                                 
                                 int hours = 0;
                                 if (!InputValidator::validateInteger(hoursStr, 0, 200, hours)) {
-                                    std::cout << getText("invalid_hours") << std::endl;
+                                    std::cout << getText(TextId::INVALID_HOURS) << std::endl;
                                     break;
                                 }
                                 
-                                course->setHours(hours);
-                                std::cout << getText("course_hours_modify_success") << std::endl;
+                                edited.setHours(hours);
+                                std::cout << getText(TextId::COURSE_HOURS_MODIFY_SUCCESS) << std::endl;
                                 break;
                             }
                             case 5: { // 修改课程学期
                                 std::string newSemester;
-                                std::cout << getText("enter_new_semester") << "：";
+                                std::cout << getText(TextId::ENTER_NEW_SEMESTER) << "：";
                                 std::getline(std::cin, newSemester);
                                 if (newSemester.empty()) {
-                                    std::cout << getText("invalid_input") << std::endl;
+                                    std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                                     break;
                                 }
-                                course->setSemester(newSemester);
-                                std::cout << getText("course_semester_modify_success") << std::endl;
+                                edited.setSemester(newSemester);
+                                std::cout << getText(TextId::COURSE_SEMESTER_MODIFY_SUCCESS) << std::endl;
                                 break;
                             }
                             case 6: { // 修改教师ID
@@ -1670,17 +1860,18 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 std::vector<std::string> teacherIds = userManager.getAllTeacherIds();
                                 
                                 if (teacherIds.empty()) {
-                                    std::cout << getText("no_teachers") << std::endl;
+                                    std::cout << getText(TextId::NO_TEACHERS) << std::endl;
                                     break;
                                 }
                                 
-                                std::cout << getText("available_teachers") << "：" << std::endl;
+                                std::cout << getText(TextId::AVAILABLE_TEACHERS) << "：" << std::endl;
                                 std::cout << "--------------------------------" << std::endl;
-                                std::cout << getText("teacher_id") << "\t" 
-                                          << getText("teacher_name") << std::endl;
+                                std::cout << getText(TextId::TEACHER_ID) << "\t" 
+                                          << getText(TextId::TEACHER_NAME) << std::endl;
                                 
+                                std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
                                 for (const std::string& id : teacherIds) {
-                                    Teacher* teacher = userManager.getTeacher(id);
+                                    std::shared_ptr<Teacher> teacher = directory->findTeacher(id);
                                     if (teacher) {
                                         std::cout << teacher->getId() << "\t"
                                                   << teacher->getName() << std::endl;
@@ -1689,47 +1880,47 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 std::cout << "--------------------------------" << std::endl;
                                 
                                 std::string newTeacherId;
-                                std::cout << getText("enter_new_teacher_id") << "：";
+                                std::cout << getText(TextId::ENTER_NEW_TEACHER_ID) << "：";
                                 std::getline(std::cin, newTeacherId);
                                 
                                 // 验证教师ID是否存在
                                 if (!userManager.getTeacher(newTeacherId)) {
-                                    std::cout << getText("teacher_id_not_exists") << std::endl;
+                                    std::cout << getText(TextId::TEACHER_ID_NOT_EXISTS) << std::endl;
                                     break;
                                 }
                                 
-                                course->setTeacherId(newTeacherId);
-                                std::cout << getText("teacher_id_modify_success") << std::endl;
+                                edited.setTeacherId(newTeacherId);
+                                std::cout << getText(TextId::TEACHER_ID_MODIFY_SUCCESS) << std::endl;
                                 break;
                             }
                             case 7: { // 修改最大容量
                                 std::string maxCapacityStr;
-                                std::cout << getText("enter_new_max_capacity") << "：";
+                                std::cout << getText(TextId::ENTER_NEW_MAX_CAPACITY) << "：";
                                 std::getline(std::cin, maxCapacityStr);
                                 
                                 int maxCapacity = 0;
                                 if (!InputValidator::validateInteger(maxCapacityStr, 1, 1000, maxCapacity)) {
-                                    std::cout << getText("invalid_max_capacity") << std::endl;
+                                    std::cout << getText(TextId::INVALID_MAX_CAPACITY) << std::endl;
                                     break;
                                 }
                                 
                                 // 检查当前选课人数是否超过新的最大容量
                                 if (course->getCurrentEnrollment() > maxCapacity) {
-                                    std::cout << getText("capacity_lt_enrollment") << std::endl;
+                                    std::cout << getText(TextId::CAPACITY_LT_ENROLLMENT) << std::endl;
                                     break;
                                 }
                                 
-                                course->setMaxCapacity(maxCapacity);
-                                std::cout << getText("max_capacity_modify_success") << std::endl;
+                                edited.setMaxCapacity(maxCapacity);
+                                std::cout << getText(TextId::MAX_CAPACITY_MODIFY_SUCCESS) << std::endl;
                                 break;
                             }
                             case 8: // 返回
                                 break;
                         }
                         
-                        // 保存数据
+                        // 保存数据：以修改后的副本替换课程，同时标记待写盘
                         if (modifyChoice >= 1 && modifyChoice <= 7) {
-                            courseManager.saveData();
+                            courseManager.updateCourseInfo(edited);
                         }
                         break;
                     }
@@ -1738,13 +1929,13 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         CourseManager& courseManager = CourseManager::getInstance();
                         
                         // 显示查询选项
-                        std::cout << getText("select_query_method") << "：" << std::endl;
-                        std::cout << "1. " << getText("view_all_courses") << std::endl;
-                        std::cout << "2. " << getText("query_by_course_id") << std::endl;
-                        std::cout << "3. " << getText("query_by_course_name") << std::endl;
-                        std::cout << "4. " << getText("query_by_teacher") << std::endl;
-                        std::cout << "5. " << getText("query_by_course_type") << std::endl;
-                        std::cout << "6. " << getText("return") << std::endl;
+                        std::cout << getText(TextId::SELECT_QUERY_METHOD) << "：" << std::endl;
+                        std::cout << "1. " << getText(TextId::VIEW_ALL_COURSES) << std::endl;
+                        std::cout << "2. " << getText(TextId::QUERY_BY_COURSE_ID) << std::endl;
+                        std::cout << "3. " << getText(TextId::QUERY_BY_COURSE_NAME) << std::endl;
+                        std::cout << "4. " << getText(TextId::QUERY_BY_TEACHER) << std::endl;
+                        std::cout << "5. " << getText(TextId::QUERY_BY_COURSE_TYPE) << std::endl;
+                        std::cout << "6. " << getText(TextId::RETURN) << std::endl;
                         
                         int queryChoice = 0;
                         std::string queryInput;
@@ -1752,7 +1943,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         std::getline(std::cin, queryInput);
                         
                         if (!InputValidator::validateChoice(queryInput, 1, 6, queryChoice)) {
-                            std::cout << getText("invalid_choice") << std::endl;
+                            std::cout << getText(TextId::INVALID_CHOICE) << std::endl;
                             break;
                         }
                         
@@ -1763,7 +1954,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 courseIds = courseManager.getAllCourseIds();
                                 break;
                             case 2: { // 按课程ID查询
-                                std::cout << getText("enter_course_id") << "：";
+                                std::cout << getText(TextId::ENTER_COURSE_ID) << "：";
                                 std::string courseId;
                                 std::getline(std::cin, courseId);
                                 
@@ -1773,7 +1964,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 break;
                             }
                             case 3: { // 按课程名称查询
-                                std::cout << getText("enter_course_name") << "：";
+                                std::cout << getText(TextId::ENTER_COURSE_NAME) << "：";
                                 std::string courseName;
                                 std::getline(std::cin, courseName);
                                 //lambda表达式,返回值为bool类型，findcourses的形参为谓词，find为标准库中string的成员函数
@@ -1785,7 +1976,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 break;
                             }
                             case 4: { // 按教师查询
-                                std::cout << getText("enter_teacher_id") << "：";
+                                std::cout << getText(TextId::ENTER_TEACHER_ID) << "：";
                                 std::string teacherId;
                                 std::getline(std::cin, teacherId);
                                 
@@ -1795,9 +1986,9 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 break;
                             }
                             case 5: { // 按课程类型查询
-                                std::cout << getText("select_course_type") << "：" << std::endl;
-                                std::cout << "1. " << getText("required_course") << std::endl;
-                                std::cout << "2. " << getText("elective_course") << std::endl;
+                                std::cout << getText(TextId::SELECT_COURSE_TYPE) << "：" << std::endl;
+                                std::cout << "1. " << getText(TextId::REQUIRED_COURSE) << std::endl;
+                                std::cout << "2. " << getText(TextId::ELECTIVE_COURSE) << std::endl;
                                 
                                 int typeChoice;
                                 std::string typeInput;
@@ -1805,7 +1996,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 std::getline(std::cin, typeInput);
                                 
                                 if (!InputValidator::validateChoice(typeInput, 1, 2, typeChoice)) {
-                                    std::cout << getText("invalid_course_type") << std::endl;
+                                    std::cout << getText(TextId::INVALID_COURSE_TYPE) << std::endl;
                                     break;
                                 }
                                 
@@ -1834,20 +2025,20 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         // 显示查询结果
                         if (queryChoice != 6) {
                             if (courseIds.empty()) {
-                                std::cout << getText("no_courses") << std::endl;
+                                std::cout << getText(TextId::NO_COURSES) << std::endl;
                             } else {
-                                std::cout << getText("query_result") << "：" << std::endl;
+                                std::cout << getText(TextId::QUERY_RESULT) << "：" << std::endl;
                                 std::cout << "--------------------------------" << std::endl;
-                                std::cout << getText("course_id") << "\t" 
-                                  << getText("course_name") << "\t" 
-                                  << getText("course_type") << "\t"
-                                  << getText("credit") << "\t"
-                                  << getText("hours") << "\t"
-                                  << getText("teacher_id") << "\t"
-                                  << getText("current_enrollment") << "/" << getText("max_capacity") << std::endl;
+                                std::cout << getText(TextId::COURSE_ID) << "\t" 
+                                  << getText(TextId::COURSE_NAME) << "\t" 
+                                  << getText(TextId::COURSE_TYPE) << "\t"
+                                  << getText(TextId::CREDIT) << "\t"
+                                  << getText(TextId::HOURS) << "\t"
+                                  << getText(TextId::TEACHER_ID) << "\t"
+                                  << getText(TextId::CURRENT_ENROLLMENT) << "/" << getText(TextId::MAX_CAPACITY) << std::endl;
                                 
                                 for (const std::string& courseId : courseIds) {
-                                    Course* course = courseManager.getCourse(courseId);
+                                    std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                                     if (course) {
                                         std::cout << course->getId() << "\t"
                                                 << course->getName() << "\t"
@@ -1860,10 +2051,10 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                     }
                                 }
                                                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getFormattedText("course_count_total", static_cast<int>(courseIds.size())) << std::endl;
+                            std::cout << getFormattedText(TextId::COURSE_COUNT_TOTAL, static_cast<int>(courseIds.size())) << std::endl;
                             }
                             
-                            std::cout << getText("press_enter_to_continue") << std::endl;
+                            std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << std::endl;
                             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                         }
                         break;
@@ -1872,7 +2063,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         subMenuRunning = false;
                         break;
                     default:
-                        std::cout << getText("invalid_choice") << std::endl;
+                        std::cout << getText(TextId::INVALID_CHOICE) << std::endl;
                         break;
                 }
             }
@@ -1880,7 +2071,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
         }
             
         case 3: { // 选课查询
-            std::cout << getText("enrollment_query_function") << std::endl;
+            std::cout << getText(TextId::ENROLLMENT_QUERY_FUNCTION) << std::endl;
             
             // 获取选课管理器和课程管理器
             EnrollmentManager& enrollmentManager = EnrollmentManager::getInstance();
@@ -1888,9 +2079,9 @@ void CourseSystem::handleAdminFunctions(int choice) {
             
             bool subMenuRunning = true;
             while (subMenuRunning && running_) {
-                std::cout << "1. " << getText("query_by_student") << std::endl;
-                std::cout << "2. " << getText("query_by_course") << std::endl;
-                std::cout << "3. " << getText("return_to_parent_menu") << std::endl;
+                std::cout << "1. " << getText(TextId::QUERY_BY_STUDENT) << std::endl;
+                std::cout << "2. " << getText(TextId::QUERY_BY_COURSE) << std::endl;
+                std::cout << "3. " << getText(TextId::RETURN_TO_PARENT_MENU) << std::endl;
                 
                 int subChoice;
                 std::string input;
@@ -1898,40 +2089,40 @@ void CourseSystem::handleAdminFunctions(int choice) {
                 std::getline(std::cin, input);
                 
                 if (!InputValidator::validateChoice(input, 1, 3, subChoice)) {
-                    std::cout << getText("invalid_input") << std::endl;
+                    std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                     continue;
                 }
                 
                 switch (subChoice) {
                     case 1: { // 按学生查询
                         std::string studentId;
-                        std::cout << getText("enter_user_id_prompt") << "：";
+                        std::cout << getText(TextId::ENTER_USER_ID_PROMPT) << "：";
                         std::getline(std::cin, studentId);
                         
                         // 先验证学生ID是否存在
                         UserManager& userManager = UserManager::getInstance();
-                        Student* student = userManager.getStudent(studentId);
+                        std::shared_ptr<Student> student = userManager.getStudent(studentId);
                         
                         if (!student) {
-                            std::cout << getText("user_id_not_exists") << std::endl;
+                            std::cout << getText(TextId::USER_ID_NOT_EXISTS) << std::endl;
                         } else {
                             // 获取学生的所有选课记录
-                            std::vector<Enrollment*> enrollments = enrollmentManager.getStudentEnrollments(studentId);
+                            std::vector<std::shared_ptr<const Enrollment>> enrollments = enrollmentManager.getStudentEnrollments(studentId);
                             
                             if (enrollments.empty()) {
-                                std::cout << getText("no_selected_courses") << std::endl;
+                                std::cout << getText(TextId::NO_SELECTED_COURSES) << std::endl;
                             } else {
-                                std::cout << getFormattedText("student_selected_courses", studentId) << std::endl;
+                                std::cout << getFormattedText(TextId::STUDENT_SELECTED_COURSES, studentId) << std::endl;
                                 std::cout << "--------------------------------" << std::endl;
-                                std::cout << getText("course_id") << "\t" 
-                                          << getText("course_name") << "\t" 
-                                          << getText("credit") << "\t" 
-                                          << getText("teacher_id") << "\t"
-                                          << getText("enrollment_time") << std::endl;
+                                std::cout << getText(TextId::COURSE_ID) << "\t" 
+                                          << getText(TextId::COURSE_NAME) << "\t" 
+                                          << getText(TextId::CREDIT) << "\t" 
+                                          << getText(TextId::TEACHER_ID) << "\t"
+                                          << getText(TextId::ENROLLMENT_TIME) << std::endl;
                                 
-                                for (Enrollment* enrollment : enrollments) {
+                                for (const auto& enrollment : enrollments) {
                                     std::string courseId = enrollment->getCourseId();
-                                    Course* course = courseManager.getCourse(courseId);
+                                    std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                                     
                                     if (course) {
                                         std::cout << course->getId() << "\t"
@@ -1942,17 +2133,17 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                     }
                                 }
                                 std::cout << "--------------------------------" << std::endl;
-                                std::cout << getFormattedText("selected_courses_count", static_cast<int>(enrollments.size())) << std::endl;
+                                std::cout << getFormattedText(TextId::SELECTED_COURSES_COUNT, static_cast<int>(enrollments.size())) << std::endl;
                             }
                         }
                         
-                        std::cout << getText("press_enter_to_continue") << std::endl;
+                        std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << std::endl;
                         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                         break;
                     }
                     case 2: { // 按课程查询
                         std::string courseId;
-                        std::cout << getText("enter_course_id") << "：";
+                        std::cout << getText(TextId::ENTER_COURSE_ID) << "：";
                         std::getline(std::cin, courseId);
                         
                         // 获取该课程的所有选课记录
@@ -1960,26 +2151,27 @@ void CourseSystem::handleAdminFunctions(int choice) {
                         
                         // 先检查课程是否存在
                         if (!courseManager.hasCourse(courseId)) {
-                            std::cout << getText("course_not_exists") << std::endl;
+                            std::cout << getText(TextId::COURSE_NOT_EXISTS) << std::endl;
                             break;
                         }
                         
-                        std::vector<Enrollment*> enrollments = enrollmentManager.getCourseEnrollments(courseId);
+                        std::vector<std::shared_ptr<const Enrollment>> enrollments = enrollmentManager.getCourseEnrollments(courseId);
                         
                         if (enrollments.empty()) {
-                            std::cout << getText("no_course_students") << std::endl;
+                            std::cout << getText(TextId::NO_COURSE_STUDENTS) << std::endl;
                         } else {
-                            std::cout << getFormattedText("course_students", courseId) << std::endl;
+                            std::cout << getFormattedText(TextId::COURSE_STUDENTS, courseId) << std::endl;
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getText("user_id") << "\t" 
-                                          << getText("user_name") << "\t" 
-                                          << getText("class") << "\t" 
-                                          << getText("department") << std::endl;
+                            std::cout << getText(TextId::USER_ID) << "\t" 
+                                          << getText(TextId::USER_NAME) << "\t" 
+                                          << getText(TextId::CLASS) << "\t" 
+                                          << getText(TextId::DEPARTMENT) << std::endl;
                             
                             UserManager& userManager = UserManager::getInstance();
-                            for (Enrollment* enrollment : enrollments) {
+                            std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
+                            for (const auto& enrollment : enrollments) {
                                 std::string studentId = enrollment->getStudentId();
-                                Student* student = dynamic_cast<Student*>(userManager.getStudent(studentId));
+                                std::shared_ptr<Student> student = directory->findStudent(studentId);
                                 
                                 if (student) {
                                     std::cout << student->getId() << "\t"
@@ -1989,10 +2181,10 @@ void CourseSystem::handleAdminFunctions(int choice) {
                                 }
                             }
                             std::cout << "--------------------------------" << std::endl;
-                            std::cout << getFormattedText("enrolled_student_count", static_cast<int>(enrollments.size())) << std::endl;
+                            std::cout << getFormattedText(TextId::ENROLLED_STUDENT_COUNT, static_cast<int>(enrollments.size())) << std::endl;
                         }
                         
-                        std::cout << getText("press_enter_to_continue") << std::endl;
+                        std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << std::endl;
                         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                         break;
                     }
@@ -2011,7 +2203,7 @@ void CourseSystem::handleAdminFunctions(int choice) {
 void CourseSystem::handleStudentFunctions(int choice) {
     switch (choice) {
         case 1: { // 查询课程
-            std::cout << getText("query_courses_function") << std::endl;
+            std::cout << getText(TextId::QUERY_COURSES_FUNCTION) << std::endl;
             
             // 获取课程管理器
             CourseManager& courseManager = CourseManager::getInstance();
@@ -2019,11 +2211,11 @@ void CourseSystem::handleStudentFunctions(int choice) {
             // 显示查询选项
             bool subMenuRunning = true;
             while (subMenuRunning && running_) {
-                std::cout << "1. " << getText("view_all_courses") << std::endl;
-                std::cout << "2. " << getText("query_by_course_id") << std::endl;
-                std::cout << "3. " << getText("query_by_course_name") << std::endl;
-                std::cout << "4. " << getText("query_by_teacher") << std::endl;
-                std::cout << "5. " << getText("return_to_parent_menu") << std::endl;
+                std::cout << "1. " << getText(TextId::VIEW_ALL_COURSES) << std::endl;
+                std::cout << "2. " << getText(TextId::QUERY_BY_COURSE_ID) << std::endl;
+                std::cout << "3. " << getText(TextId::QUERY_BY_COURSE_NAME) << std::endl;
+                std::cout << "4. " << getText(TextId::QUERY_BY_TEACHER) << std::endl;
+                std::cout << "5. " << getText(TextId::RETURN_TO_PARENT_MENU) << std::endl;
                 
                 int subChoice = 0;
                 std::string input;
@@ -2031,7 +2223,7 @@ void CourseSystem::handleStudentFunctions(int choice) {
                 std::getline(std::cin, input);
                 
                 if (!InputValidator::validateChoice(input, 1, 5, subChoice)) {
-                    std::cout << getText("invalid_input") << std::endl;
+                    std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                     continue;
                 }
                 
@@ -2042,7 +2234,7 @@ void CourseSystem::handleStudentFunctions(int choice) {
                         courseIds = courseManager.getAllCourseIds();
                         break;
                     case 2: { // 按课程ID查询
-                        std::cout << getText("enter_course_id") << "：";
+                        std::cout << getText(TextId::ENTER_COURSE_ID) << "：";
                         std::string courseId;
                         std::getline(std::cin, courseId);
                         
@@ -2052,7 +2244,7 @@ void CourseSystem::handleStudentFunctions(int choice) {
                         break;
                     }
                     case 3: { // 按课程名称查询
-                        std::cout << getText("enter_course_name") << "：";
+                        std::cout << getText(TextId::ENTER_COURSE_NAME) << "：";
                         std::string courseName;
                         std::getline(std::cin, courseName);
                         
@@ -2064,7 +2256,7 @@ void CourseSystem::handleStudentFunctions(int choice) {
                         break;
                     }
                     case 4: { // 按教师查询
-                        std::cout << getText("enter_teacher_id") << "：";
+                        std::cout << getText(TextId::ENTER_TEACHER_ID) << "：";
                         std::string teacherId;
                         std::getline(std::cin, teacherId);
                         
@@ -2080,19 +2272,19 @@ void CourseSystem::handleStudentFunctions(int choice) {
                 
                 // 显示查询结果
                 if (courseIds.empty()) {
-                    std::cout << getText("no_courses") << std::endl;
+                    std::cout << getText(TextId::NO_COURSES) << std::endl;
                 } else {
-                    std::cout << getText("query_result") << "：" << std::endl;
+                    std::cout << getText(TextId::QUERY_RESULT) << "：" << std::endl;
                     std::cout << "--------------------------------" << std::endl;
-                    std::cout << getText("course_id") << "\t" 
-                          << getText("course_name") << "\t" 
-                          << getText("credit") << "\t" 
-                          << getText("hours") << "\t"
-                          << getText("teacher_id") << "\t"
-                          << getText("current_enrollment") << "/" << getText("max_capacity") << std::endl;
+                    std::cout << getText(TextId::COURSE_ID) << "\t" 
+                          << getText(TextId::COURSE_NAME) << "\t" 
+                          << getText(TextId::CREDIT) << "\t" 
+                          << getText(TextId::HOURS) << "\t"
+                          << getText(TextId::TEACHER_ID) << "\t"
+                          << getText(TextId::CURRENT_ENROLLMENT) << "/" << getText(TextId::MAX_CAPACITY) << std::endl;
                     
                     for (const std::string& courseId : courseIds) {
-                        Course* course = courseManager.getCourse(courseId);
+                        std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                         if (course) {
                             std::cout << course->getId() << "\t"
                                       << course->getName() << "\t"
@@ -2106,14 +2298,14 @@ void CourseSystem::handleStudentFunctions(int choice) {
                     std::cout << "--------------------------------" << std::endl;
                 }
                 
-                std::cout << getText("press_enter_to_continue") << std::endl;
+                std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << std::endl;
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             }
             break;
         }
             
         case 2: { // 选择课程
-            std::cout << getText("select_course_function") << std::endl;
+            std::cout << getText(TextId::SELECT_COURSE_FUNCTION) << std::endl;
             
             std::string studentId = currentUser_->getId();
             
@@ -2125,26 +2317,26 @@ void CourseSystem::handleStudentFunctions(int choice) {
             std::vector<std::string> allCourseIds = courseManager.getAllCourseIds();
             
             if (allCourseIds.empty()) {
-                std::cout << getText("no_courses") << std::endl;
+                std::cout << getText(TextId::NO_COURSES) << std::endl;
             } else {
-                std::cout << getText("available_courses") << "：" << std::endl;
+                std::cout << getText(TextId::AVAILABLE_COURSES) << "：" << std::endl;
                 std::cout << "--------------------------------" << std::endl;
-                std::cout << getText("course_id") << "\t" 
-                          << getText("course_name") << "\t" 
-                          << getText("credit") << "\t" 
-                          << getText("teacher_id") << "\t"
-                          << getText("current_enrollment") << "/"
-                          << getText("max_capacity") << std::endl;
+                std::cout << getText(TextId::COURSE_ID) << "\t" 
+                          << getText(TextId::COURSE_NAME) << "\t" 
+                          << getText(TextId::CREDIT) << "\t" 
+                          << getText(TextId::TEACHER_ID) << "\t"
+                          << getText(TextId::CURRENT_ENROLLMENT) << "/"
+                          << getText(TextId::MAX_CAPACITY) << std::endl;
                 
                 // 获取学生当前已选课程列表，用于显示时标记
-                std::vector<Enrollment*> studentEnrollments = enrollmentManager.getStudentEnrollments(studentId);
+                std::vector<std::shared_ptr<const Enrollment>> studentEnrollments = enrollmentManager.getStudentEnrollments(studentId);
                 std::vector<std::string> enrolledCourseIds;
                 for (const auto& enrollment : studentEnrollments) {
                     enrolledCourseIds.push_back(enrollment->getCourseId());
                 }
                 
                 for (const std::string& courseId : allCourseIds) {
-                    Course* course = courseManager.getCourse(courseId);
+                    std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                     if (course) {
                         bool alreadyEnrolled = std::find(enrolledCourseIds.begin(), enrolledCourseIds.end(), courseId) != enrolledCourseIds.end();
                         
@@ -2157,7 +2349,7 @@ void CourseSystem::handleStudentFunctions(int choice) {
                                   
                         // 标记已选课程
                         if (alreadyEnrolled) {
-                            std::cout << " (" << getText("already_selected") << ")";
+                            std::cout << " (" << getText(TextId::ALREADY_SELECTED) << ")";
                         }
                         std::cout << std::endl;
                     }
@@ -2165,48 +2357,45 @@ void CourseSystem::handleStudentFunctions(int choice) {
                 std::cout << "--------------------------------" << std::endl;
                 
                 // 获取课程ID
-                std::cout << getText("select_by_course_id") << ": ";
+                std::cout << getText(TextId::SELECT_BY_COURSE_ID) << ": ";
                 std::string courseId;
                 std::getline(std::cin, courseId);
                 
                 // 验证课程ID存在
                 if (!courseManager.hasCourse(courseId)) {
-                    std::cout << getText("course_not_found") << std::endl;
+                    std::cout << getText(TextId::COURSE_NOT_FOUND) << std::endl;
                 } else {
                     // 尝试选课
                     try {
                         if (enrollmentManager.enrollCourse(studentId, courseId)) {
-                            std::cout << getText("operation_success") << std::endl;
-                            
-                            // 更新课程数据以确保人数正确显示
-                            courseManager.loadData();
+                            std::cout << getText(TextId::OPERATION_SUCCESS) << std::endl;
                             
                             // 显示选课成功后的课程信息
-                            Course* course = courseManager.getCourse(courseId);
+                            std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                             if (course) {
-                                std::cout << getText("course") << " " << course->getName() << " " 
-                                          << getText("current_enrollment") << ": " 
+                                std::cout << getText(TextId::COURSE) << " " << course->getName() << " " 
+                                          << getText(TextId::CURRENT_ENROLLMENT) << ": " 
                                           << course->getCurrentEnrollment() << "/" 
                                           << course->getMaxCapacity() << std::endl;
                             }
                         } else {
-                            std::cout << getText("operation_failed") << std::endl;
+                            std::cout << getText(TextId::OPERATION_FAILED) << std::endl;
                         }
                     } catch (const SystemException& e) {
-                        std::cout << getText("operation_failed") << ": " << e.what() << std::endl;
+                        std::cout << getText(TextId::OPERATION_FAILED) << ": " << e.what() << std::endl;
                     } catch (const std::exception& e) {
-                        std::cout << getText("system_error") << ": " << e.what() << std::endl;
+                        std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.what() << std::endl;
                     }
                 }
             }
             
-            std::cout << getText("press_enter_to_continue") << "..." << std::endl;
+            std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << "..." << std::endl;
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             break;
         }
             
         case 3: { // 退选课程
-            std::cout << getText("drop_course_function") << std::endl;
+            std::cout << getText(TextId::DROP_COURSE_FUNCTION) << std::endl;
             
             std::string studentId = currentUser_->getId();
             
@@ -2215,22 +2404,22 @@ void CourseSystem::handleStudentFunctions(int choice) {
             CourseManager& courseManager = CourseManager::getInstance();
             
             // 获取学生的所有选课记录
-            std::vector<Enrollment*> enrollments = enrollmentManager.getStudentEnrollments(studentId);
+            std::vector<std::shared_ptr<const Enrollment>> enrollments = enrollmentManager.getStudentEnrollments(studentId);
             
             if (enrollments.empty()) {
-                std::cout << getText("no_selected_courses") << std::endl;
+                std::cout << getText(TextId::NO_SELECTED_COURSES) << std::endl;
             } else {
-                std::cout << getText("view_selected_courses") << "：" << std::endl;
+                std::cout << getText(TextId::VIEW_SELECTED_COURSES) << "：" << std::endl;
                 std::cout << "--------------------------------" << std::endl;
-                std::cout << getText("course_id") << "\t" 
-                          << getText("course_name") << "\t" 
-                          << getText("credit") << "\t" 
-                          << getText("teacher_id") << "\t"
-                          << getText("enrollment_time") << std::endl;
+                std::cout << getText(TextId::COURSE_ID) << "\t" 
+                          << getText(TextId::COURSE_NAME) << "\t" 
+                          << getText(TextId::CREDIT) << "\t" 
+                          << getText(TextId::TEACHER_ID) << "\t"
+                          << getText(TextId::ENROLLMENT_TIME) << std::endl;
                 
-                for (Enrollment* enrollment : enrollments) {
+                for (const auto& enrollment : enrollments) {
                     std::string courseId = enrollment->getCourseId();
-                    Course* course = courseManager.getCourse(courseId);
+                    std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                     
                     if (course) {
                         std::cout << course->getId() << "\t"
@@ -2243,13 +2432,13 @@ void CourseSystem::handleStudentFunctions(int choice) {
                 std::cout << "--------------------------------" << std::endl;
                 
                 // 获取要退选的课程ID
-                std::cout << getText("enter_drop_course_id") << ": ";
+                std::cout << getText(TextId::ENTER_DROP_COURSE_ID) << ": ";
                 std::string courseId;
                 std::getline(std::cin, courseId);
                 
                 // 检查是否已选该课程，同时获取课程对象确认存在性
                 bool hasEnrolled = false;
-                Course* courseToDrop = nullptr;
+                std::shared_ptr<const Course> courseToDrop;
                 CourseManager& courseManager = CourseManager::getInstance();
                 
                 for (const auto& enrollment : enrollments) {
@@ -2261,33 +2450,30 @@ void CourseSystem::handleStudentFunctions(int choice) {
                 }
                 
                 if (!hasEnrolled || !courseToDrop) {
-                    std::cout << getText("not_enrolled_course") << std::endl;
+                    std::cout << getText(TextId::NOT_ENROLLED_COURSE) << std::endl;
                 } else {
                     // 尝试退课
                     try {
                         if (enrollmentManager.dropCourse(studentId, courseId)) {
-                            std::cout << getText("operation_success") << std::endl;
-                            
-                            // 更新课程数据以确保人数正确显示
-                            courseManager.loadData();
+                            std::cout << getText(TextId::OPERATION_SUCCESS) << std::endl;
                         } else {
-                            std::cout << getText("operation_failed") << std::endl;
+                            std::cout << getText(TextId::OPERATION_FAILED) << std::endl;
                         }
                     } catch (const SystemException& e) {
-                        std::cout << getText("operation_failed") << ": " << e.what() << std::endl;
+                        std::cout << getText(TextId::OPERATION_FAILED) << ": " << e.what() << std::endl;
                     } catch (const std::exception& e) {
-                        std::cout << getText("system_error") << ": " << e.what() << std::endl;
+                        std::cout << getText(TextId::SYSTEM_ERROR) << ": " << e.what() << std::endl;
                     }
                 }
             }
             
-            std::cout << getText("press_enter_to_continue") << "..." << std::endl;
+            std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << "..." << std::endl;
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             break;
         }
             
         case 4: { // 查看已选课程
-            std::cout << getText("view_selected_courses_function") << std::endl;
+            std::cout << getText(TextId::VIEW_SELECTED_COURSES_FUNCTION) << std::endl;
             
             std::string studentId = currentUser_->getId();
             
@@ -2296,22 +2482,22 @@ void CourseSystem::handleStudentFunctions(int choice) {
             CourseManager& courseManager = CourseManager::getInstance();
             
             // 获取学生的所有选课记录
-            std::vector<Enrollment*> enrollments = enrollmentManager.getStudentEnrollments(studentId);
+            std::vector<std::shared_ptr<const Enrollment>> enrollments = enrollmentManager.getStudentEnrollments(studentId);
             
             if (enrollments.empty()) {
-                std::cout << getText("no_selected_courses") << std::endl;
+                std::cout << getText(TextId::NO_SELECTED_COURSES) << std::endl;
             } else {
-                std::cout << getText("view_selected_courses") << "：" << std::endl;
+                std::cout << getText(TextId::VIEW_SELECTED_COURSES) << "：" << std::endl;
                 std::cout << "--------------------------------" << std::endl;
-                std::cout << getText("course_id") << "\t" 
-                          << getText("course_name") << "\t" 
-                          << getText("credit") << "\t" 
-                          << getText("teacher_id") << "\t"
-                          << getText("enrollment_time") << std::endl;
+                std::cout << getText(TextId::COURSE_ID) << "\t" 
+                          << getText(TextId::COURSE_NAME) << "\t" 
+                          << getText(TextId::CREDIT) << "\t" 
+                          << getText(TextId::TEACHER_ID) << "\t"
+                          << getText(TextId::ENROLLMENT_TIME) << std::endl;
                 
-                for (Enrollment* enrollment : enrollments) {
+                for (const auto& enrollment : enrollments) {
                     std::string courseId = enrollment->getCourseId();
-                    Course* course = courseManager.getCourse(courseId);
+                    std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                     
                     if (course) {
                         std::cout << course->getId() << "\t"
@@ -2322,10 +2508,56 @@ void CourseSystem::handleStudentFunctions(int choice) {
                     }
                 }
                 std::cout << "--------------------------------" << std::endl;
-                std::cout << getFormattedText("enrollment_count_total", static_cast<int>(enrollments.size())) << std::endl;
+                std::cout << getFormattedText(TextId::ENROLLMENT_COUNT_TOTAL, static_cast<int>(enrollments.size())) << std::endl;
             }
             
-            std::cout << getText("press_enter_to_continue") << "..." << std::endl;
+            // 历史学期的选课记录在归档分区中，选择学期后才加载
+            TermArchive& archive = TermArchive::getInstance();
+            std::vector<std::string> terms = archive.terms();
+            if (!terms.empty()) {
+                std::cout << getText(TextId::ARCHIVED_TERMS) << "：";
+                for (size_t i = 0; i < terms.size(); ++i) {
+                    std::cout << (i > 0 ? ", " : "") << terms[i];
+                }
+                std::cout << std::endl;
+                std::cout << getText(TextId::ENTER_ARCHIVED_TERM) << "：";
+                std::string semester;
+                std::getline(std::cin, semester);
+                
+                if (!semester.empty()) {
+                    if (std::find(terms.begin(), terms.end(), semester) == terms.end()) {
+                        std::cout << getText(TextId::ARCHIVED_TERM_NOT_FOUND) << std::endl;
+                    } else {
+                        std::shared_ptr<const ArchivedTerm> term = archive.load(semester);
+                        int count = 0;
+                        for (const auto& enrollment : term->enrollments) {
+                            if (enrollment->getStudentId() != studentId) {
+                                continue;
+                            }
+                            const Course* course = term->findCourse(enrollment->getCourseId());
+                            if (count++ == 0) {
+                                std::cout << getText(TextId::SEMESTER) << " " << semester << "：" << std::endl;
+                                std::cout << "--------------------------------" << std::endl;
+                            }
+                            std::cout << enrollment->getCourseId() << "\t";
+                            if (course) {
+                                std::cout << course->getName() << "\t"
+                                          << course->getCredit() << "\t"
+                                          << course->getTeacherId() << "\t";
+                            }
+                            std::cout << enrollment->getEnrollmentTime() << std::endl;
+                        }
+                        if (count == 0) {
+                            std::cout << getText(TextId::NO_ARCHIVED_ENROLLMENTS) << std::endl;
+                        } else {
+                            std::cout << "--------------------------------" << std::endl;
+                            std::cout << getFormattedText(TextId::ENROLLMENT_COUNT_TOTAL, count) << std::endl;
+                        }
+                    }
+                }
+            }
+            
+            std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << "..." << std::endl;
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             break;
         }
@@ -2340,25 +2572,25 @@ bool CourseSystem::changePassword(const std::string& userId, const std::string&
     try {
         // 权限检查：用户只能修改自己的密码
         if (currentUser_ == nullptr) {
-            Logger::getInstance().error("修改密码失败：用户未登录");
+            LOG_ERROR("修改密码失败：用户未登录");
             return false;
         }
         
         // 检查是否是用户修改自己的密码
         if (currentUser_->getId() != userId) {
-            Logger::getInstance().warning("用户 " + currentUser_->getId() + " 尝试修改其他用户 " + userId + " 的密码，权限不足");
+            LOG_WARNING("用户 " + currentUser_->getId() + " 尝试修改其他用户 " + userId + " 的密码，权限不足");
             return false;
         }
         
         // 检查新密码与确认密码是否一致
         if (newPassword != confirmPassword) {
-            Logger::getInstance().warning("用户 " + userId + " 修改密码失败：新密码与确认密码不一致");
+            LOG_WARNING("用户 " + userId + " 修改密码失败：新密码与确认密码不一致");
             return false;
         }
         
         // 密码有效性检查 - 密码长度必须大于等于6位
         if (newPassword.length() < 6) {
-            Logger::getInstance().warning("用户 " + userId + " 修改密码失败：新密码长度不足6位");
+            LOG_WARNING("用户 " + userId + " 修改密码失败：新密码长度不足6位");
             return false;
         }
         
@@ -2366,55 +2598,60 @@ bool CourseSystem::changePassword(const std::string& userId, const std::string&
         bool result = UserManager::getInstance().changeUserPassword(userId, oldPassword, newPassword);
         
         if (result) {
-            Logger::getInstance().info("用户 " + userId + " 密码修改成功");
+            currentUser_ = UserManager::getInstance().getUser(userId); // 换成带新凭据的用户对象
+            // 新密码必须落盘后再告知用户成功，否则崩溃后会恢复为旧密码
+            result = PersistenceService::getInstance().flush();
+            if (result) {
+                LOG_INFO("用户 " + userId + " 密码修改成功");
+            }
         }
         
         return result;
     } catch (const std::exception& e) {
-        Logger::getInstance().error("修改密码出现异常: " + std::string(e.what()));
+        LOG_ERROR("修改密码出现异常: " + std::string(e.what()));
         return false;
     } catch (...) {
-        Logger::getInstance().error("修改密码出现未知异常");
+        LOG_ERROR("修改密码出现未知异常");
         return false;
     }
 }
 
 void CourseSystem::handlePasswordChange() {
     if (!currentUser_) {
-        std::cout << getText("operation_failed") << ": " << getText("password_change_failed") << std::endl;
-        Logger::getInstance().error("修改密码失败：用户未登录");
+        std::cout << getText(TextId::OPERATION_FAILED) << ": " << getText(TextId::PASSWORD_CHANGE_FAILED) << std::endl;
+        LOG_ERROR("修改密码失败：用户未登录");
         return;
     }
     
     std::string userId = currentUser_->getId();
     std::string oldPassword, newPassword, confirmPassword;
     
-    std::cout << getText("change_password") << std::endl;
+    std::cout << getText(TextId::CHANGE_PASSWORD) << std::endl;
     std::cout << "--------------------------------" << std::endl;
     
-    std::cout << getText("old_password") << ": ";
+    std::cout << getText(TextId::OLD_PASSWORD) << ": ";
     std::getline(std::cin, oldPassword);
     
-    std::cout << getText("new_password") << "（" << getText("password_min_length") << "）: ";
+    std::cout << getText(TextId::NEW_PASSWORD) << "（" << getText(TextId::PASSWORD_MIN_LENGTH) << "）: ";
     std::getline(std::cin, newPassword);
     
-    std::cout << getText("confirm_password") << ": ";
+    std::cout << getText(TextId::CONFIRM_PASSWORD) << ": ";
     std::getline(std::cin, confirmPassword);
     
     if (changePassword(userId, oldPassword, newPassword, confirmPassword)) {
-        std::cout << getText("password_change_success") << std::endl;
+        std::cout << getText(TextId::PASSWORD_CHANGE_SUCCESS) << std::endl;
     } else {
-        std::cout << getText("password_change_failed") << std::endl;
+        std::cout << getText(TextId::PASSWORD_CHANGE_FAILED) << std::endl;
     }
     
-    std::cout << getText("press_enter_to_continue") << "..." << std::endl;
+    std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << "..." << std::endl;
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
 void CourseSystem::handleTeacherFunctions(int choice) {
     switch (choice) {
         case 1: { // 查看课程
-            std::cout << getText("view_courses_function") << std::endl;
+            std::cout << getText(TextId::VIEW_COURSES_FUNCTION) << std::endl;
             
             // 获取教师ID
             std::string teacherId = currentUser_->getId();
@@ -2429,19 +2666,19 @@ void CourseSystem::handleTeacherFunctions(int choice) {
             
             // 显示课程列表
             if (teacherCourseIds.empty()) {
-                std::cout << getText("no_teaching_courses") << std::endl;
+                std::cout << getText(TextId::NO_TEACHING_COURSES) << std::endl;
             } else {
-                std::cout << getText("your_courses") << "：" << std::endl;
+                std::cout << getText(TextId::YOUR_COURSES) << "：" << std::endl;
                 std::cout << "--------------------------------" << std::endl;
-                std::cout << getText("course_id") << "\t" 
-                          << getText("course_name") << "\t" 
-                          << getText("credit") << "\t" 
-                          << getText("hours") << "\t"
-                          << getText("semester") << "\t"
-                          << getText("current_enrollment") << "/" << getText("max_capacity") << std::endl;
+                std::cout << getText(TextId::COURSE_ID) << "\t" 
+                          << getText(TextId::COURSE_NAME) << "\t" 
+                          << getText(TextId::CREDIT) << "\t" 
+                          << getText(TextId::HOURS) << "\t"
+                          << getText(TextId::SEMESTER) << "\t"
+                          << getText(TextId::CURRENT_ENROLLMENT) << "/" << getText(TextId::MAX_CAPACITY) << std::endl;
                 
                 for (const std::string& courseId : teacherCourseIds) {
-                    Course* course = courseManager.getCourse(courseId);
+                    std::shared_ptr<const Course> course = courseManager.getCourse(courseId);
                     if (course) {
                         std::cout << course->getId() << "\t"
                                   << course->getName() << "\t"
@@ -2454,13 +2691,13 @@ void CourseSystem::handleTeacherFunctions(int choice) {
                 std::cout << "--------------------------------" << std::endl;
             }
             
-            std::cout << getText("press_enter_to_continue") << std::endl;
+            std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << std::endl;
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             break;
         }
             
         case 2: { // 查看学生
-            std::cout << getText("view_students_function") << std::endl;
+            std::cout << getText(TextId::VIEW_STUDENTS_FUNCTION) << std::endl;
             
             // 获取教师ID
             std::string teacherId = currentUser_->getId();
@@ -2476,12 +2713,12 @@ void CourseSystem::handleTeacherFunctions(int choice) {
             );
             
             if (teacherCourseIds.empty()) {
-                std::cout << getText("no_teaching_courses") << std::endl;
+                std::cout << getText(TextId::NO_TEACHING_COURSES) << std::endl;
             } else {
                 // 先列出所有课程
-                std::cout << getText("your_courses") << "：" << std::endl;
+                std::cout << getText(TextId::YOUR_COURSES) << "：" << std::endl;
                 for (std::size_t i = 0; i < teacherCourseIds.size(); ++i) {
-                    Course* course = courseManager.getCourse(teacherCourseIds[i]);
+                    std::shared_ptr<const Course> course = courseManager.getCourse(teacherCourseIds[i]);
                     if (course) {
                         std::cout << (i+1) << ". " << course->getId() << " - " << course->getName() << std::endl;
                     }
@@ -2494,15 +2731,15 @@ void CourseSystem::handleTeacherFunctions(int choice) {
                 const int MAX_ATTEMPTS = 3;
                 
                 while (attempts < MAX_ATTEMPTS) {
-                    std::cout << getFormattedText("select_course_to_view", static_cast<int>(teacherCourseIds.size())) << "：";
+                    std::cout << getFormattedText(TextId::SELECT_COURSE_TO_VIEW, static_cast<int>(teacherCourseIds.size())) << "：";
                     std::getline(std::cin, input);
                     attempts++;     
                     if (InputValidator::validateChoice(input, 1, teacherCourseIds.size(), courseIndex)) {
                         break;
                     } else {
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         if (attempts >= MAX_ATTEMPTS) {
-                            std::cout << getText("too_many_attempts") << std::endl;
+                            std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                             break;
                         }
                     }
@@ -2510,25 +2747,26 @@ void CourseSystem::handleTeacherFunctions(int choice) {
                 
                 // 获取选定的课程
                 std::string selectedCourseId = teacherCourseIds[courseIndex-1];
-                Course* selectedCourse = courseManager.getCourse(selectedCourseId);
+                std::shared_ptr<const Course> selectedCourse = courseManager.getCourse(selectedCourseId);
                 
                 if (selectedCourse) {
                     // 获取该课程的所有选课记录
-                    std::vector<Enrollment*> enrollments = enrollmentManager.getCourseEnrollments(selectedCourseId);
+                    std::vector<std::shared_ptr<const Enrollment>> enrollments = enrollmentManager.getCourseEnrollments(selectedCourseId);
                     
                     if (enrollments.empty()) {
-                        std::cout << getText("no_course_students") << std::endl;
+                        std::cout << getText(TextId::NO_COURSE_STUDENTS) << std::endl;
                     } else {
-                        std::cout << getFormattedText("course_students", selectedCourse->getName()) << std::endl;
+                        std::cout << getFormattedText(TextId::COURSE_STUDENTS, selectedCourse->getName()) << std::endl;
                         std::cout << "--------------------------------" << std::endl;
-                        std::cout << getText("user_id") << "\t" 
-                                  << getText("user_name") << "\t" 
-                                  << getText("class") << "\t" 
-                                  << getText("department") << "\t"
-                                  << getText("enrollment_time") << std::endl;
-                        for (Enrollment* enrollment : enrollments) {
+                        std::cout << getText(TextId::USER_ID) << "\t" 
+                                  << getText(TextId::USER_NAME) << "\t" 
+                                  << getText(TextId::CLASS) << "\t" 
+                                  << getText(TextId::DEPARTMENT) << "\t"
+                                  << getText(TextId::ENROLLMENT_TIME) << std::endl;
+                        std::shared_ptr<const UserDirectory> directory = userManager.snapshot();
+                        for (const auto& enrollment : enrollments) {
                             std::string studentId = enrollment->getStudentId();
-                            Student* student = static_cast<Student*>(userManager.getStudent(studentId));
+                            std::shared_ptr<Student> student = directory->findStudent(studentId);
                             
                             if (student) {
                                 std::cout << student->getId() << "\t"
@@ -2539,26 +2777,26 @@ void CourseSystem::handleTeacherFunctions(int choice) {
                             }
                         }
                         std::cout << "--------------------------------" << std::endl;
-                        std::cout << getFormattedText("enrolled_student_count", static_cast<int>(enrollments.size())) << std::endl;
+                        std::cout << getFormattedText(TextId::ENROLLED_STUDENT_COUNT, static_cast<int>(enrollments.size())) << std::endl;
                     }
                 }
             }
             
-            std::cout << getText("press_enter_to_continue") << std::endl;
+            std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << std::endl;
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             break;
         }
             
         default:
-            std::cout << getText("invalid_choice") << std::endl;
+            std::cout << getText(TextId::INVALID_CHOICE) << std::endl;
             break;
     }
 }
 
 void CourseSystem::handleUserInfoModification() {
     if (!currentUser_) {
-        std::cout << getText("operation_failed") << ": " << getText("not_logged_in") << std::endl;
-        Logger::getInstance().error("修改账户信息失败：用户未登录");
+        std::cout << getText(TextId::OPERATION_FAILED) << ": " << getText(TextId::NOT_LOGGED_IN) << std::endl;
+        LOG_ERROR("修改账户信息失败：用户未登录");
         return;
     }
     
@@ -2566,24 +2804,24 @@ void CourseSystem::handleUserInfoModification() {
     std::string userId = currentUser_->getId();
     UserType userType = currentUser_->getType();
     
-    std::cout << "========= " << getText("modify_user_info") << " =========" << std::endl;
-    std::cout << getText("current_user_info") << ":" << std::endl;
-    std::cout << getText("user_id") << ": " << userId << std::endl;
-    std::cout << getText("user_name") << ": " << currentUser_->getName() << std::endl;
+    std::cout << "========= " << getText(TextId::MODIFY_USER_INFO) << " =========" << std::endl;
+    std::cout << getText(TextId::CURRENT_USER_INFO) << ":" << std::endl;
+    std::cout << getText(TextId::USER_ID) << ": " << userId << std::endl;
+    std::cout << getText(TextId::USER_NAME) << ": " << currentUser_->getName() << std::endl;
     
     // 根据用户类型显示不同的信息
     if (userType == UserType::STUDENT) {
-        Student* student = dynamic_cast<Student*>(currentUser_);
-        std::cout << getText("gender") << ": " << student->getGender() << std::endl;
-        std::cout << getText("age") << ": " << student->getAge() << std::endl;
-        std::cout << getText("department") << ": " << student->getDepartment() << std::endl;
-        std::cout << getText("class") << ": " << student->getClassInfo() << std::endl;
-        std::cout << getText("contact") << ": " << student->getContact() << std::endl;
+        Student* student = dynamic_cast<Student*>(currentUser_.get());
+        std::cout << getText(TextId::GENDER) << ": " << student->getGender() << std::endl;
+        std::cout << getText(TextId::AGE) << ": " << student->getAge() << std::endl;
+        std::cout << getText(TextId::DEPARTMENT) << ": " << student->getDepartment() << std::endl;
+        std::cout << getText(TextId::CLASS) << ": " << student->getClassInfo() << std::endl;
+        std::cout << getText(TextId::CONTACT) << ": " << student->getContact() << std::endl;
     } else if (userType == UserType::TEACHER) {
-        Teacher* teacher = dynamic_cast<Teacher*>(currentUser_);
-        std::cout << getText("department") << ": " << teacher->getDepartment() << std::endl;
-        std::cout << getText("title") << ": " << teacher->getTitle() << std::endl;
-        std::cout << getText("contact") << ": " << teacher->getContact() << std::endl;
+        Teacher* teacher = dynamic_cast<Teacher*>(currentUser_.get());
+        std::cout << getText(TextId::DEPARTMENT) << ": " << teacher->getDepartment() << std::endl;
+        std::cout << getText(TextId::TITLE) << ": " << teacher->getTitle() << std::endl;
+        std::cout << getText(TextId::CONTACT) << ": " << teacher->getContact() << std::endl;
     } else if (userType == UserType::ADMIN) {
         // 管理员没有额外信息
     }
@@ -2591,26 +2829,26 @@ void CourseSystem::handleUserInfoModification() {
     std::cout << "-------------------------------" << std::endl;
     
     // 显示可修改的信息选项
-    std::cout << getText("select_modify_content") << ":" << std::endl;
-    std::cout << "1. " << getText("user_name") << std::endl;
+    std::cout << getText(TextId::SELECT_MODIFY_CONTENT) << ":" << std::endl;
+    std::cout << "1. " << getText(TextId::USER_NAME) << std::endl;
     
     int maxOption = 1;
     
     if (userType == UserType::STUDENT) {
-        std::cout << "2. " << getText("gender") << std::endl;
-        std::cout << "3. " << getText("age") << std::endl;
-        std::cout << "4. " << getText("department") << std::endl;
-        std::cout << "5. " << getText("class") << std::endl;
-        std::cout << "6. " << getText("contact") << std::endl;
+        std::cout << "2. " << getText(TextId::GENDER) << std::endl;
+        std::cout << "3. " << getText(TextId::AGE) << std::endl;
+        std::cout << "4. " << getText(TextId::DEPARTMENT) << std::endl;
+        std::cout << "5. " << getText(TextId::CLASS) << std::endl;
+        std::cout << "6. " << getText(TextId::CONTACT) << std::endl;
         maxOption = 6;
     } else if (userType == UserType::TEACHER) {
-        std::cout << "2. " << getText("department") << std::endl;
-        std::cout << "3. " << getText("title") << std::endl;
-        std::cout << "4. " << getText("contact") << std::endl;
+        std::cout << "2. " << getText(TextId::DEPARTMENT) << std::endl;
+        std::cout << "3. " << getText(TextId::TITLE) << std::endl;
+        std::cout << "4. " << getText(TextId::CONTACT) << std::endl;
         maxOption = 4;
     }
     
-    std::cout << (maxOption + 1) << ". " << getText("return") << std::endl;
+    std::cout << (maxOption + 1) << ". " << getText(TextId::RETURN) << std::endl;
     
     // 获取用户选择
     int choice = 0;
@@ -2626,9 +2864,9 @@ void CourseSystem::handleUserInfoModification() {
         if (InputValidator::validateChoice(input, 1, maxOption + 1, choice)) {
             break;
         } else {
-            std::cout << getText("invalid_input") << std::endl;
+            std::cout << getText(TextId::INVALID_INPUT) << std::endl;
             if (attempts >= MAX_ATTEMPTS) {
-                std::cout << getText("too_many_attempts") << std::endl;
+                std::cout << getText(TextId::TOO_MANY_ATTEMPTS) << std::endl;
                 break;
             }
         }
@@ -2639,79 +2877,80 @@ void CourseSystem::handleUserInfoModification() {
         return;
     }
     
-    // 修改信息
+    // 修改信息：当前用户对象已发布，可能正被其他线程读取，在副本上修改后交给UserManager发布
     std::string newValue;
     int newAge;
     bool updateSuccess = false;
+    std::unique_ptr<User> edited = currentUser_->clone();
     
     switch (userType) {
         case UserType::STUDENT: {
-            Student* student = dynamic_cast<Student*>(currentUser_);
+            Student* student = dynamic_cast<Student*>(edited.get());
             
             switch (choice) {
                 case 1: // 修改名字
-                    std::cout << getText("enter_username") << ": ";
+                    std::cout << getText(TextId::ENTER_USERNAME) << ": ";
                     std::getline(std::cin, newValue);
                     if (!newValue.empty()) {
                         student->setName(newValue);
                     }
                     else{
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         return;
                     }
                     break;
                 case 2: // 修改性别
-                    std::cout << getText("enter_user_gender") << " (1-" << getText("male") << " 2-" << getText("female") << "): ";
+                    std::cout << getText(TextId::ENTER_USER_GENDER) << " (1-" << getText(TextId::GENDER_MALE) << " 2-" << getText(TextId::GENDER_FEMALE) << "): ";
                     std::getline(std::cin, newValue);
                     if (newValue == "1") {
-                        student->setGender(getText("male"));
+                        student->setGender(getText(TextId::GENDER_MALE));
                     } else if (newValue == "2") {
-                        student->setGender(getText("female"));
+                        student->setGender(getText(TextId::GENDER_FEMALE));
                     } else {
-                        std::cout << getText("invalid_gender") << std::endl;
+                        std::cout << getText(TextId::INVALID_GENDER) << std::endl;
                         return;
                     }
                     break;
                 case 3: // 修改年龄
-                    std::cout << getText("enter_student_age") << ": ";
+                    std::cout << getText(TextId::ENTER_STUDENT_AGE) << ": ";
                     std::getline(std::cin, newValue);
                     if (InputValidator::validateInteger(newValue, 15, 80, newAge)) {
                         student->setAge(newAge);
                     } else {
-                        std::cout << getText("invalid_age") << std::endl;
+                        std::cout << getText(TextId::INVALID_AGE) << std::endl;
                         return;
                     }
                     break;
                 case 4: // 修改系别
-                    std::cout << getText("enter_department") << ": ";
+                    std::cout << getText(TextId::ENTER_DEPARTMENT) << ": ";
                     std::getline(std::cin, newValue);
                     if (!newValue.empty()) {
                         student->setDepartment(newValue);
                     }
                     else{
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         return;
                     }
                     break;
                 case 5: // 修改班级信息
-                    std::cout << getText("enter_class_info") << ": ";
+                    std::cout << getText(TextId::ENTER_CLASS_INFO) << ": ";
                     std::getline(std::cin, newValue);
                     if (!newValue.empty()) {
                         student->setClassInfo(newValue);
                     }
                     else{
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         return;
                     }
                     break;
                 case 6: // 修改联系方式
-                    std::cout << getText("enter_email") << ": ";
+                    std::cout << getText(TextId::ENTER_EMAIL) << ": ";
                     std::getline(std::cin, newValue);
                     if (!newValue.empty()) {
                         student->setContact(newValue);
                     }
                     else{
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         return;
                     }
                     break;
@@ -2722,50 +2961,50 @@ void CourseSystem::handleUserInfoModification() {
             break;
         }
         case UserType::TEACHER: {
-            Teacher* teacher = dynamic_cast<Teacher*>(currentUser_);
+            Teacher* teacher = dynamic_cast<Teacher*>(edited.get());
             
             switch (choice) {
                 case 1: // 修改名字
-                    std::cout << getText("enter_username") << ": ";
+                    std::cout << getText(TextId::ENTER_USERNAME) << ": ";
                     std::getline(std::cin, newValue);
                     if (!newValue.empty()) {
                         teacher->setName(newValue);
                     }
                     else{
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         return;
                     }
                     break;
                 case 2: // 修改系别
-                    std::cout << getText("enter_teacher_department") << ": ";
+                    std::cout << getText(TextId::ENTER_TEACHER_DEPARTMENT) << ": ";
                     std::getline(std::cin, newValue);
                     if (!newValue.empty()) {
                         teacher->setDepartment(newValue);
                     }
                     else{
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         return;
                     }
                     break;
                 case 3: // 修改职称
-                    std::cout << getText("enter_teacher_title") << ": ";
+                    std::cout << getText(TextId::ENTER_TEACHER_TITLE) << ": ";
                     std::getline(std::cin, newValue);
                     if (!newValue.empty()) {
                         teacher->setTitle(newValue);
                     }
                     else{
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         return;
                     }
                     break;
                 case 4: // 修改联系方式
-                    std::cout << getText("enter_email") << ": ";
+                    std::cout << getText(TextId::ENTER_EMAIL) << ": ";
                     std::getline(std::cin, newValue);
                     if (!newValue.empty()) {
                         teacher->setContact(newValue);
                     }
                     else{
-                        std::cout << getText("invalid_input") << std::endl;
+                        std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                         return;
                     }
                     break;
@@ -2776,16 +3015,16 @@ void CourseSystem::handleUserInfoModification() {
             break;
         }
         case UserType::ADMIN: {
-            Admin* admin = dynamic_cast<Admin*>(currentUser_);
+            Admin* admin = dynamic_cast<Admin*>(edited.get());
             
             if (choice == 1) { // 修改名字
-                std::cout << getText("enter_username") << ": ";
+                std::cout << getText(TextId::ENTER_USERNAME) << ": ";
                 std::getline(std::cin, newValue);
                 if (!newValue.empty()) {
                     admin->setName(newValue);
                 }
                 else{
-                    std::cout << getText("invalid_input") << std::endl;
+                    std::cout << getText(TextId::INVALID_INPUT) << std::endl;
                     return;
                 }
                 
@@ -2799,11 +3038,12 @@ void CourseSystem::handleUserInfoModification() {
     }
     
     if (updateSuccess) {
-        std::cout << getText("operation_success") << std::endl;
+        currentUser_ = UserManager::getInstance().getUser(userId); // 换成新发布的用户对象
+        std::cout << getText(TextId::OPERATION_SUCCESS) << std::endl;
     } else {
-        std::cout << getText("operation_failed") << std::endl;
+        std::cout << getText(TextId::OPERATION_FAILED) << std::endl;
     }
     
-    std::cout << getText("press_enter_to_continue") << std::endl;
+    std::cout << getText(TextId::PRESS_ENTER_TO_CONTINUE) << std::endl;
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/system/DataWatcher.h"
+#include "../../include/system/PersistenceService.h"
+#include "../../include/manager/UserManager.h"
+#include "../../include/manager/CourseManager.h"
+#include "../../include/manager/EnrollmentManager.h"
+#include "../../include/util/DataManifest.h"
+#include "../../include/util/JsonStorage.h"
+#include "../../include/util/Logger.h"
+
+#include <cstring>
+#include <exception>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define HAS_INOTIFY 1
+#else
+#define HAS_INOTIFY 0
+#endif
+
+namespace {
+
+constexpr uint32_t ALL_SETS = static_cast<uint32_t>(DataSet::USERS) |
+                              static_cast<uint32_t>(DataSet::COURSES) |
+                              static_cast<uint32_t>(DataSet::ENROLLMENTS);
+
+// 文件名对应的数据集；清单变化时检查全部数据集（SQLite存储只能通过清单感知修改）
+uint32_t setsForFile(const char* name) {
+    if (std::strcmp(name, JsonStorage::fileName(StorageTable::USERS)) == 0) {
+        return static_cast<uint32_t>(DataSet::USERS);
+    }
+    if (std::strcmp(name, JsonStorage::fileName(StorageTable::COURSES)) == 0) {
+        return static_cast<uint32_t>(DataSet::COURSES);
+    }
+    if (std::strcmp(name, JsonStorage::fileName(StorageTable::ENROLLMENTS)) == 0) {
+        return static_cast<uint32_t>(DataSet::ENROLLMENTS);
+    }
+    if (std::strcmp(name, DataManifest::FILE_NAME) == 0) {
+        return ALL_SETS;
+    }
+    return 0;
+}
+
+} // namespace
+
+DataWatcher& DataWatcher::getInstance() {
+    static DataWatcher instance;
+    return instance;
+}
+
+DataWatcher::~DataWatcher() {
+    stop();
+}
+
+bool DataWatcher::start(const std::string& dataDir) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return true;
+    }
+#if HAS_INOTIFY
+    inotifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        LOG_WARNING("初始化inotify失败: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    // 写入采用临时文件+重命名，监视重命名到位和直接写入完成两种事件
+    if (::inotify_add_watch(inotifyFd_, dataDir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        LOG_WARNING("监视数据目录失败: " + dataDir + " - " + std::strerror(errno));
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+        return false;
+    }
+
+    stopping_ = false;
+    running_ = true;
+    worker_ = std::thread(&DataWatcher::run, this);
+    LOG_INFO("开始监视数据目录: " + dataDir);
+    return true;
+#else
+    LOG_WARNING("当前平台不支持inotify，其他进程的修改需重启后生效: " + dataDir);
+    return false;
+#endif
+}
+
+void DataWatcher::stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+        return;
+    }
+    stopping_ = true;
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+#if HAS_INOTIFY
+    ::close(inotifyFd_);
+#endif
+    inotifyFd_ = -1;
+    running_ = false;
+    LOG_INFO("数据目录监视已停止");
+}
+
+bool DataWatcher::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void DataWatcher::run() {
+#if HAS_INOTIFY
+    uint32_t pending = 0;
+    while (!stopping_) {
+        pollfd pfd{inotifyFd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, pending != 0 ? DEBOUNCE_MS : POLL_TIMEOUT_MS);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("等待数据目录事件失败: " + std::string(std::strerror(errno)));
+            break;
+        }
+        if (ready > 0) {
+            pending |= readEvents();
+            continue; // 事件静默DEBOUNCE_MS后再同步
+        }
+        if (pending != 0) {
+            sync(pending);
+            pending = 0;
+        }
+    }
+#endif
+}
+
+uint32_t DataWatcher::readEvents() {
+    uint32_t sets = 0;
+#if HAS_INOTIFY
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t length = ::read(inotifyFd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break; // EAGAIN：事件已读完
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->mask & IN_Q_OVERFLOW) {
+                sets |= ALL_SETS; // 事件丢失，全部检查一遍
+            } else if (event->len > 0) {
+                sets |= setsForFile(event->name);
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+#endif
+    return sets;
+}
+
+void DataWatcher::sync(uint32_t sets) {
+    try {
+        // 同步期间不允许本进程写盘：尚未写盘的行由isPending()识别并保留，不会有写到一半的修改被覆盖
+        auto writes = PersistenceService::getInstance().holdWrites();
+
+        size_t changed = 0;
+        if (sets & static_cast<uint32_t>(DataSet::USERS)) {
+            changed += UserManager::getInstance().syncFromStorage();
+        }
+        if (sets & static_cast<uint32_t>(DataSet::COURSES)) {
+            changed += CourseManager::getInstance().syncFromStorage();
+        }
+        if (sets & static_cast<uint32_t>(DataSet::ENROLLMENTS)) {
+            changed += EnrollmentManager::getInstance().syncFromStorage();
+        }
+
+        if (changed > 0) {
+            LOG_INFO("已同步其他进程的修改，共 " + std::to_string(changed) + " 条记录");
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("同步其他进程的修改失败: " + std::string(e.what()));
+    }
+}
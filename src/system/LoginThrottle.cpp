@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/system/LoginThrottle.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+LoginThrottle::LoginThrottle() = default;
+
+int64_t LoginThrottle::retryDelayMs(const std::string& account, const std::string& source) const {
+    int64_t now = nowMs();
+    int64_t delay = 0;
+    
+    for (uint64_t key : {makeKey('A', account), makeKey('S', source)}) {
+        const Slot* slot = findSlot(key);
+        if (slot) {
+            delay = std::max(delay, slot->blockedUntilMs.load(std::memory_order_acquire) - now);
+        }
+    }
+    
+    return delay;
+}
+
+int64_t LoginThrottle::recordFailure(const std::string& account, const std::string& source) {
+    int64_t now = nowMs();
+    int64_t delay = 0;
+    
+    Slot* accountSlot = acquireSlot(makeKey('A', account), now);
+    delay = std::max(delay, recordInSlot(*accountSlot, now, ACCOUNT_THRESHOLD));
+    
+    Slot* sourceSlot = acquireSlot(makeKey('S', source), now);
+    delay = std::max(delay, recordInSlot(*sourceSlot, now, SOURCE_THRESHOLD));
+    
+    return delay;
+}
+
+void LoginThrottle::recordSuccess(const std::string& account) {
+    Slot* slot = findSlot(makeKey('A', account));
+    if (slot) {
+        resetSlot(*slot);
+    }
+}
+
+uint64_t LoginThrottle::makeKey(char kind, const std::string& value) {
+    // 账户和来源使用不同的前缀，避免同名键相互干扰
+    uint64_t hash = std::hash<std::string>{}(value) ^ (static_cast<uint64_t>(kind) * 0x9E3779B97F4A7C15ULL);
+    return hash == 0 ? 1 : hash;
+}
+
+int64_t LoginThrottle::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const LoginThrottle::Slot* LoginThrottle::findSlot(uint64_t key) const {
+    size_t start = static_cast<size_t>(key) & (TABLE_SIZE - 1);
+    for (size_t i = 0; i < MAX_PROBES; ++i) {
+        const Slot& slot = slots_[(start + i) & (TABLE_SIZE - 1)];
+        if (slot.key.load(std::memory_order_acquire) == key) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+LoginThrottle::Slot* LoginThrottle::findSlot(uint64_t key) {
+    return const_cast<Slot*>(static_cast<const LoginThrottle*>(this)->findSlot(key));
+}
+
+LoginThrottle::Slot* LoginThrottle::acquireSlot(uint64_t key, int64_t now) {
+    size_t start = static_cast<size_t>(key) & (TABLE_SIZE - 1);
+    Slot* oldest = nullptr;
+    
+    for (size_t i = 0; i < MAX_PROBES; ++i) {
+        Slot& slot = slots_[(start + i) & (TABLE_SIZE - 1)];
+        uint64_t current = slot.key.load(std::memory_order_acquire);
+        if (current == key) {
+            return &slot;
+        }
+        if (current == 0) {
+            // 抢占空槽，失败说明其他线程刚刚占用，若恰好是同一个键也可直接使用
+            if (slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel) || current == key) {
+                return &slot;
+            }
+        }
+        if (!oldest || slot.lastTouchMs.load(std::memory_order_relaxed) < oldest->lastTouchMs.load(std::memory_order_relaxed)) {
+            oldest = &slot;
+        }
+    }
+    
+    // 探测范围内没有空槽：淘汰最久未更新的槽位。仍处于限流期的槽位也可能被淘汰，
+    // 但只有在短时间内出现大量不同的失败键时才会发生，表大小保证了内存占用固定
+    uint64_t victimKey = oldest->key.load(std::memory_order_acquire);
+    if (oldest->key.compare_exchange_strong(victimKey, key, std::memory_order_acq_rel)) {
+        resetSlot(*oldest);
+    }
+    oldest->lastTouchMs.store(now, std::memory_order_relaxed);
+    return oldest;
+}
+
+uint32_t LoginThrottle::windowCount(const Slot& slot, int64_t now) {
+    int64_t epoch = now / BUCKET_MS;
+    uint32_t total = 0;
+    for (size_t i = 0; i < WINDOW_BUCKETS; ++i) {
+        if (slot.epochs[i].load(std::memory_order_acquire) > epoch - static_cast<int64_t>(WINDOW_BUCKETS)) {
+            total += slot.counts[i].load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+int64_t LoginThrottle::recordInSlot(Slot& slot, int64_t now, uint32_t threshold) {
+    int64_t epoch = now / BUCKET_MS;
+    size_t index = static_cast<size_t>(epoch % static_cast<int64_t>(WINDOW_BUCKETS));
+    
+    // 分桶过期时由抢到CAS的线程清零；与清零并发的计数可能丢失，限流只需要近似计数
+    int64_t bucketEpoch = slot.epochs[index].load(std::memory_order_acquire);
+    if (bucketEpoch != epoch && slot.epochs[index].compare_exchange_strong(bucketEpoch, epoch, std::memory_order_acq_rel)) {
+        slot.counts[index].store(0, std::memory_order_relaxed);
+    }
+    slot.counts[index].fetch_add(1, std::memory_order_relaxed);
+    slot.lastTouchMs.store(now, std::memory_order_relaxed);
+    
+    uint32_t failures = windowCount(slot, now);
+    if (failures <= threshold) {
+        return 0;
+    }
+    
+    // 超过阈值后每多失败一次，等待时长翻倍
+    uint32_t exponent = std::min<uint32_t>(failures - threshold - 1, 20);
+    int64_t delay = std::min(MAX_DELAY_MS, BASE_DELAY_MS << exponent);
+    int64_t until = now + delay;
+    
+    int64_t current = slot.blockedUntilMs.load(std::memory_order_acquire);
+    while (current < until && !slot.blockedUntilMs.compare_exchange_weak(current, until, std::memory_order_acq_rel)) {
+    }
+    return delay;
+}
+
+void LoginThrottle::resetSlot(Slot& slot) {
+    for (size_t i = 0; i < WINDOW_BUCKETS; ++i) {
+        slot.counts[i].store(0, std::memory_order_relaxed);
+        slot.epochs[i].store(0, std::memory_order_relaxed);
+    }
+    slot.blockedUntilMs.store(0, std::memory_order_release);
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/system/PersistenceService.h"
+#include "../../include/manager/UserManager.h"
+#include "../../include/manager/CourseManager.h"
+#include "../../include/manager/EnrollmentManager.h"
+#include "../../include/util/Logger.h"
+
+#include <chrono>
+#include <exception>
+
+PersistenceService& PersistenceService::getInstance() {
+    static PersistenceService instance;
+    return instance;
+}
+
+PersistenceService::~PersistenceService() {
+    stop();
+}
+
+void PersistenceService::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    stopping_ = false;
+    worker_ = std::thread(&PersistenceService::run, this);
+    LOG_INFO("后台持久化服务已启动");
+}
+
+void PersistenceService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        // 此后的markDirty返回false，由调用方同步保存，不会有修改遗漏
+        running_ = false;
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    flush();
+    LOG_INFO("后台持久化服务已停止");
+}
+
+bool PersistenceService::markDirty(DataSet set, const std::string& key) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        dirty_ |= static_cast<uint32_t>(set);
+        Pending& pending = pending_[indexOf(set)];
+        if (key.empty()) {
+            pending.all = true;
+        } else if (!pending.all) {
+            pending.keys.insert(key);
+        }
+    }
+    cv_.notify_one();
+    return true;
+}
+
+bool PersistenceService::flush() {
+    std::lock_guard<std::mutex> writeLock(writeMutex_); // 等待进行中的后台写入完成
+    return writePending();
+}
+
+bool PersistenceService::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+bool PersistenceService::isPending(DataSet set, const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if ((dirty_ & static_cast<uint32_t>(set)) == 0) {
+        return false;
+    }
+    const Pending& pending = pending_[indexOf(set)];
+    return pending.all || pending.keys.count(key) > 0;
+}
+
+std::unique_lock<std::mutex> PersistenceService::holdWrites() {
+    return std::unique_lock<std::mutex>(writeMutex_);
+}
+
+void PersistenceService::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return stopping_ || dirty_ != 0; });
+        if (stopping_) {
+            break;
+        }
+
+        // 合并窗口内的连续修改只写一次
+        cv_.wait_for(lock, std::chrono::milliseconds(MAX_STALENESS_MS), [this] { return stopping_; });
+        if (stopping_) {
+            break; // 剩余修改由stop()中的flush写出
+        }
+
+        lock.unlock();
+        bool success;
+        {
+            std::lock_guard<std::mutex> writeLock(writeMutex_);
+            success = writePending();
+        }
+        lock.lock();
+
+        if (!success) {
+            cv_.wait_for(lock, std::chrono::milliseconds(RETRY_DELAY_MS), [this] { return stopping_; });
+        }
+    }
+}
+
+bool PersistenceService::writePending() {
+    uint32_t dirty;
+    std::array<Pending, 3> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty = dirty_;
+        dirty_ = 0;
+        pending.swap(pending_);
+    }
+    if (dirty == 0) {
+        return true;
+    }
+
+    uint32_t failed = 0;
+    auto save = [&](DataSet set, bool (*saveAll)(), bool (*saveRows)(const std::vector<std::string>&)) {
+        uint32_t bit = static_cast<uint32_t>(set);
+        if ((dirty & bit) == 0) {
+            return;
+        }
+        const Pending& item = pending[indexOf(set)];
+        try {
+            // 只写被修改的行：读-改-写在数据目录锁内进行，不会覆盖其他进程写入的行
+            bool saved = item.all
+                ? saveAll()
+                : saveRows(std::vector<std::string>(item.keys.begin(), item.keys.end()));
+            if (!saved) {
+                failed |= bit;
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("后台保存数据失败: " + std::string(e.what()));
+            failed |= bit;
+        }
+    };
+
+    save(DataSet::USERS,
+         [] { return UserManager::getInstance().saveData(false); },
+         [](const std::vector<std::string>& keys) { return UserManager::getInstance().saveRows(keys); });
+    save(DataSet::COURSES,
+         [] { return CourseManager::getInstance().saveData(false); },
+         [](const std::vector<std::string>& keys) { return CourseManager::getInstance().saveRows(keys); });
+    save(DataSet::ENROLLMENTS,
+         [] { return EnrollmentManager::getInstance().saveData(false); },
+         [](const std::vector<std::string>& keys) { return EnrollmentManager::getInstance().saveRows(keys); });
+
+    if (failed != 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty_ |= failed; // 保留脏标记，稍后重试
+        for (DataSet set : {DataSet::USERS, DataSet::COURSES, DataSet::ENROLLMENTS}) {
+            if (failed & static_cast<uint32_t>(set)) {
+                Pending& retry = pending_[indexOf(set)];
+                const Pending& item = pending[indexOf(set)];
+                retry.all = retry.all || item.all;
+                if (!retry.all) {
+                    retry.keys.insert(item.keys.begin(), item.keys.end());
+                }
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+size_t PersistenceService::indexOf(DataSet set) {
+    switch (set) {
+        case DataSet::USERS:
+            return 0;
+        case DataSet::COURSES:
+            return 1;
+        case DataSet::ENROLLMENTS:
+            break;
+    }
+    return 2;
+}
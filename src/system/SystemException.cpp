@@ -16,9 +16,24 @@
  */
 #include "../../include/system/SystemException.h"
 
+#include <atomic>
+
+namespace {
+
+std::atomic<SystemException::Observer> observer{nullptr};
+
+} // namespace
+
 SystemException::SystemException(ErrorType type, const std::string& message)
     : std::runtime_error(message), // 调用基类构造函数，传入错误消息
       type_(type) {
+    if (Observer notify = observer.load(std::memory_order_acquire)) {
+        notify(*this);
+    }
+}
+
+void SystemException::setObserver(Observer newObserver) {
+    observer.store(newObserver, std::memory_order_release);
 }
 
 std::string SystemException::getTypeString() const {
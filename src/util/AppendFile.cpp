@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/AppendFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAS_POSIX_IO 1
+#else
+#include <cstdio>
+#define HAS_POSIX_IO 0
+#endif
+
+AppendFile::AppendFile(const std::string& path) {
+#if HAS_POSIX_IO
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#else
+    file_ = std::fopen(path.c_str(), "ab");
+#endif
+}
+
+AppendFile::~AppendFile() {
+#if HAS_POSIX_IO
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#else
+    if (file_ != nullptr) {
+        std::fclose(static_cast<std::FILE*>(file_));
+    }
+#endif
+}
+
+bool AppendFile::isOpen() const {
+#if HAS_POSIX_IO
+    return fd_ >= 0;
+#else
+    return file_ != nullptr;
+#endif
+}
+
+bool AppendFile::append(const char* data, size_t size, uint64_t& offset) {
+#if HAS_POSIX_IO
+    ssize_t n;
+    do {
+        n = ::write(fd_, data, size);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0 || static_cast<size_t>(n) != size) {
+        return false;
+    }
+    off_t end = ::lseek(fd_, 0, SEEK_CUR);
+    offset = static_cast<uint64_t>(end) - size;
+    return end >= 0;
+#else
+    std::FILE* file = static_cast<std::FILE*>(file_);
+    if (std::fwrite(data, 1, size, file) != size || std::fflush(file) != 0) {
+        return false;
+    }
+    offset = static_cast<uint64_t>(std::ftell(file)) - size;
+    return true;
+#endif
+}
+
+uint64_t AppendFile::size() const {
+#if HAS_POSIX_IO
+    struct stat info;
+    return ::fstat(fd_, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#else
+    std::FILE* file = static_cast<std::FILE*>(file_);
+    std::fseek(file, 0, SEEK_END);
+    long end = std::ftell(file);
+    return end > 0 ? static_cast<uint64_t>(end) : 0;
+#endif
+}
+
+std::time_t AppendFile::modified() const {
+#if HAS_POSIX_IO
+    struct stat info;
+    return ::fstat(fd_, &info) == 0 ? info.st_mtime : std::time(nullptr);
+#else
+    return std::time(nullptr);
+#endif
+}
+
+bool AppendFile::isFile(const std::string& path) const {
+#if HAS_POSIX_IO
+    struct stat opened;
+    struct stat named;
+    if (::fstat(fd_, &opened) != 0 || ::stat(path.c_str(), &named) != 0) {
+        return false;
+    }
+    return opened.st_dev == named.st_dev && opened.st_ino == named.st_ino;
+#else
+    (void)path;
+    return true; // 无法比较文件身份，视为未被轮转
+#endif
+}
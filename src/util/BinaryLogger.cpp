@@ -0,0 +1,497 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/BinaryLogger.h"
+
+#include <cstdio>
+#include <filesystem>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define CURRENT_PID() static_cast<uint32_t>(::getpid())
+#else
+#include <process.h>
+#define CURRENT_PID() static_cast<uint32_t>(::_getpid())
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::mutex& formatMutex() {
+    static std::mutex mutex; // 串行化注册，读取不加锁
+    return mutex;
+}
+
+// 定长的格式注册表：先填好条目再发布计数，读者按计数读取已发布的条目，
+// 不加锁也不会遇到扩容，飞行记录器在信号处理函数中也能读取
+LogFormat registeredFormats[BinaryLogger::MAX_FORMATS]; // 下标+1即格式ID
+std::atomic<uint32_t> registeredCount{0};
+
+template<typename T>
+void appendRaw(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendShortString(std::string& out, const char* text) {
+    size_t length = std::min<size_t>(std::strlen(text), UINT16_MAX);
+    appendRaw(out, static_cast<uint16_t>(length));
+    out.append(text, length);
+}
+
+bool isLittleEndian() {
+    uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+} // namespace
+
+// 单个线程的记录缓冲区：所属线程是唯一的生产者，写入线程是唯一的消费者
+// 记录整条写入后才发布写指针，消费者读到的总是完整记录
+class BinaryLogger::ThreadBuffer {
+public:
+    explicit ThreadBuffer(size_t capacity) {
+        capacity_ = 1024;
+        while (capacity_ < capacity) {
+            capacity_ <<= 1;
+        }
+        data_ = std::make_unique<char[]>(capacity_);
+    }
+
+    // 写入一条记录；halfFull表示本次写入使缓冲区越过半满
+    bool write(const char* record, size_t size, bool& halfFull) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        size_t used = static_cast<size_t>(head - tail);
+        if (capacity_ - used < size) {
+            return false;
+        }
+        halfFull = used <= capacity_ / 2 && used + size > capacity_ / 2;
+        size_t position = static_cast<size_t>(head & (capacity_ - 1));
+        size_t first = std::min(size, capacity_ - position);
+        std::memcpy(data_.get() + position, record, first);
+        std::memcpy(data_.get(), record + first, size - first);
+        head_.store(head + size, std::memory_order_release);
+        return true;
+    }
+
+    // 把已发布的全部记录追加到out
+    void readAll(std::string& out) {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (head == tail) {
+            return;
+        }
+        size_t size = static_cast<size_t>(head - tail);
+        size_t position = static_cast<size_t>(tail & (capacity_ - 1));
+        size_t first = std::min(size, capacity_ - position);
+        out.append(data_.get() + position, first);
+        out.append(data_.get(), size - first);
+        tail_.store(head, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+    }
+
+    // 所属线程已退出，写空后可回收
+    void retire() {
+        retired_.store(true, std::memory_order_release);
+    }
+
+    bool retired() const {
+        return retired_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::unique_ptr<char[]> data_;
+    size_t capacity_;                            // 2的幂
+    alignas(64) std::atomic<uint64_t> head_{0};  // 生产者写入的总字节数
+    alignas(64) std::atomic<uint64_t> tail_{0};  // 消费者取出的总字节数
+    std::atomic<bool> retired_{false};
+};
+
+BinaryLogger& BinaryLogger::getInstance() {
+    static BinaryLogger instance; // Meyer's单例模式
+    return instance;
+}
+
+BinaryLogger::BinaryLogger() {
+    dropFormatId_ = registerFormat(LogLevel::WARNING, "二进制日志缓冲区已满，丢弃了 {} 条日志", __FILE__, __LINE__);
+}
+
+BinaryLogger::~BinaryLogger() {
+    close();
+}
+
+bool BinaryLogger::open(const std::string& logDir, const BinaryLogOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (open_.load()) {
+        return true;
+    }
+    if (!isLittleEndian()) {
+        return false; // 记录按主机字节序复制，文件格式约定为小端序
+    }
+
+    try {
+        if (!fs::exists(logDir)) {
+            fs::create_directories(logDir);
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    logDir_ = logDir;
+    if (!openFile()) {
+        file_.reset();
+        return false;
+    }
+    // 已有日志文件时，当前段从它最后修改的时间算起，跨天后的首次写入即轮转
+    rotator_ = std::make_unique<LogRotator>(logDir, std::vector<std::string>{LOG_FILE}, options.rotation);
+    rotator_->beginSegment(file_->size() > 0 ? file_->modified() : std::time(nullptr));
+
+    threadBufferSize_.store(options.threadBufferSize);
+    overflow_ = options.overflow;
+    writtenFormats_ = 0; // 每次打开都重新写出格式定义，解码时不依赖文件中更早的内容
+    stopping_ = false;
+    writer_ = std::thread(&BinaryLogger::run, this);
+    open_.store(true, std::memory_order_release);
+    return true;
+}
+
+void BinaryLogger::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+        stopping_ = true;
+    }
+    wakeCv_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    // 关闭前已读到打开标志的线程可能在写入线程退出后才提交，在此补写
+    drain();
+    file_.reset();
+    rotator_.reset();
+}
+
+bool BinaryLogger::openFile() {
+    auto file = std::make_unique<AppendFile>(logDir_ + "/" + LOG_FILE);
+    if (!file->isOpen()) {
+        return false;
+    }
+    // 多个进程同时创建文件时可能各写一次文件头，解码时跳过批次之间重复的文件头
+    uint64_t ignored;
+    if (file->size() == 0 && !file->append(MAGIC, sizeof(MAGIC), ignored)) {
+        return false;
+    }
+    file_ = std::move(file);
+    return true;
+}
+
+void BinaryLogger::rotateIfDue(size_t incoming) {
+    if (!rotator_) {
+        return;
+    }
+    uint64_t size = file_->size();
+    std::time_t now = std::time(nullptr);
+    if (size <= sizeof(MAGIC) || !rotator_->due(size + incoming, now)) {
+        return;
+    }
+    // 改名失败时继续写原文件；重新打开失败时保留原文件描述符，内容写入已改名的段
+    if (rotator_->rotate(*file_, now) && openFile()) {
+        rotator_->beginSegment(now);
+        writtenFormats_ = 0;
+    }
+}
+
+void BinaryLogger::flush() {
+    if (!isOpen()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    uint64_t request = ++flushRequests_;
+    wakeCv_.notify_one();
+    while (flushedRequests_ < request && !stopping_) {
+        progressCv_.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS));
+    }
+}
+
+uint64_t BinaryLogger::droppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+uint32_t BinaryLogger::registerFormat(LogLevel level, const char* format, const char* file, int line) {
+    std::lock_guard<std::mutex> lock(formatMutex());
+    uint32_t count = registeredCount.load(std::memory_order_relaxed);
+    if (count >= MAX_FORMATS) {
+        return 0; // 调用处改为格式化后写入文本日志
+    }
+    registeredFormats[count] = LogFormat{level, format, file, line};
+    registeredCount.store(count + 1, std::memory_order_release);
+    return count + 1;
+}
+
+uint32_t BinaryLogger::formatCount() {
+    return registeredCount.load(std::memory_order_acquire);
+}
+
+const LogFormat& BinaryLogger::formatAt(uint32_t formatId) {
+    return registeredFormats[formatId - 1];
+}
+
+BinaryLogger::ThreadBuffer& BinaryLogger::localBuffer() {
+    // 线程退出时只做标记，缓冲区中剩余的记录仍由写入线程写出
+    struct Handle {
+        std::shared_ptr<ThreadBuffer> buffer;
+
+        ~Handle() {
+            if (buffer) {
+                buffer->retire();
+            }
+        }
+    };
+    thread_local Handle handle;
+
+    if (!handle.buffer) {
+        handle.buffer = std::make_shared<ThreadBuffer>(threadBufferSize_.load());
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        buffers_.push_back(handle.buffer);
+    }
+    return *handle.buffer;
+}
+
+bool BinaryLogger::commit(const char* record, size_t size) {
+    ThreadBuffer& buffer = localBuffer();
+    bool halfFull = false;
+    while (!buffer.write(record, size, halfFull)) {
+        if (overflow_ != LogOverflowPolicy::BLOCK || !isOpen()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // 等待写入线程取走一轮记录腾出空间
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        nudged_.store(true, std::memory_order_relaxed);
+        wakeCv_.notify_one();
+        progressCv_.wait_for(lock, std::chrono::milliseconds(1));
+    }
+    if (halfFull) {
+        // 写入量大时不等下一次轮询，每填满半个缓冲区唤醒一次写入线程
+        nudged_.store(true, std::memory_order_relaxed);
+        wakeCv_.notify_one();
+    }
+    return true;
+}
+
+void BinaryLogger::run() {
+    while (true) {
+        uint64_t request;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            request = flushRequests_;
+        }
+        nudged_.store(false, std::memory_order_relaxed);
+        drain();
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            flushedRequests_ = request;
+        }
+        progressCv_.notify_all();
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        if (stopping_) {
+            break; // 退出前的最后一次drain已取空各线程缓冲区
+        }
+        // 生产者一般不唤醒写入线程以免热路径上的系统调用，写入线程定期轮询
+        wakeCv_.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS), [this] {
+            return stopping_ || flushRequests_ != flushedRequests_ || nudged_.load(std::memory_order_relaxed);
+        });
+    }
+}
+
+uint16_t BinaryLogger::recordSize(size_t position) const {
+    uint16_t size;
+    std::memcpy(&size, batch_.data() + position, sizeof(size));
+    return size;
+}
+
+size_t BinaryLogger::drain() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+            return buffer->retired() && buffer->empty();
+        }), buffers_.end());
+        buffers = buffers_;
+    }
+
+    // 每个线程的记录本身按时间有序，逐个缓冲区取出后归并即得到全局时间顺序，同一时间戳保持线程内顺序
+    batch_.clear();
+    std::vector<std::pair<int64_t, size_t>> order; // 时间戳，记录在batch_中的偏移
+    size_t parsed = 0; // batch_中已解析的字节数
+    auto collect = [&] {
+        size_t runStart = order.size();
+        while (parsed + RECORD_HEADER_SIZE <= batch_.size()) {
+            uint16_t size = recordSize(parsed);
+            if (size < RECORD_HEADER_SIZE) {
+                break;
+            }
+            int64_t timestamp;
+            std::memcpy(&timestamp, batch_.data() + parsed + sizeof(uint16_t) + sizeof(uint32_t), sizeof(timestamp));
+            order.emplace_back(timestamp, parsed);
+            parsed += size;
+        }
+        parsed = batch_.size();
+        auto byTime = [](const auto& a, const auto& b) { return a.first < b.first; };
+        auto run = order.begin() + static_cast<std::ptrdiff_t>(runStart);
+        if (!std::is_sorted(run, order.end(), byTime)) {
+            std::stable_sort(run, order.end(), byTime); // 系统时间被回拨
+        }
+        std::inplace_merge(order.begin(), run, order.end(), byTime);
+    };
+    for (const auto& buffer : buffers) {
+        buffer->readAll(batch_);
+        collect();
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (overflow_ == LogOverflowPolicy::COUNT && dropped != reportedDrops_) {
+        char record[MAX_RECORD_SIZE];
+        RecordEncoder encoder(record, sizeof(record));
+        encoder.begin(dropFormatId_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        encoder.put(dropped - reportedDrops_);
+        batch_.append(record, encoder.finish());
+        reportedDrops_ = dropped;
+        collect();
+    }
+    if (order.empty() || !file_) {
+        return 0;
+    }
+    rotateIfDue(batch_.size());
+
+    output_.clear();
+    output_ += 'B';
+    appendRaw(output_, CURRENT_PID());
+    appendRaw(output_, static_cast<uint32_t>(0)); // 批次长度，稍后填写
+    size_t bodyStart = output_.size();
+
+    // 格式在记录提交前注册，取出记录之后读到的注册表一定包含它们引用的格式
+    size_t formatCount = BinaryLogger::formatCount();
+    for (size_t i = writtenFormats_; i < formatCount; ++i) {
+        const LogFormat& info = registeredFormats[i];
+        output_ += 'F';
+        appendRaw(output_, static_cast<uint32_t>(i + 1));
+        appendRaw(output_, static_cast<uint8_t>(info.level));
+        appendRaw(output_, static_cast<uint32_t>(info.line));
+        appendShortString(output_, info.file);
+        appendShortString(output_, info.format);
+    }
+
+    output_.reserve(output_.size() + batch_.size() + order.size());
+    for (const auto& item : order) {
+        output_ += 'R';
+        output_.append(batch_.data() + item.second, recordSize(item.second));
+    }
+
+    uint32_t bodyLength = static_cast<uint32_t>(output_.size() - bodyStart);
+    std::memcpy(&output_[bodyStart - sizeof(bodyLength)], &bodyLength, sizeof(bodyLength));
+
+    uint64_t ignored;
+    if (file_->append(output_.data(), output_.size(), ignored)) {
+        writtenFormats_ = formatCount;
+    }
+    return order.size();
+}
+
+std::string BinaryLogger::render(std::string_view format, const char* args, size_t size) {
+    std::string text;
+    text.reserve(format.size() + size);
+    size_t position = 0;
+    for (size_t i = 0; i < format.size(); ++i) {
+        if (format[i] != '{' || i + 1 >= format.size() || format[i + 1] != '}') {
+            text += format[i];
+            continue;
+        }
+        ++i;
+        if (position >= size) {
+            text += "{}";
+            continue;
+        }
+
+        auto type = static_cast<BinaryArgType>(args[position++]);
+        char number[32];
+        switch (type) {
+            case BinaryArgType::INT: {
+                int64_t value;
+                if (size - position < sizeof(value)) {
+                    position = size;
+                    break;
+                }
+                std::memcpy(&value, args + position, sizeof(value));
+                position += sizeof(value);
+                text += std::to_string(value);
+                break;
+            }
+            case BinaryArgType::UINT: {
+                uint64_t value;
+                if (size - position < sizeof(value)) {
+                    position = size;
+                    break;
+                }
+                std::memcpy(&value, args + position, sizeof(value));
+                position += sizeof(value);
+                text += std::to_string(value);
+                break;
+            }
+            case BinaryArgType::DOUBLE: {
+                double value;
+                if (size - position < sizeof(value)) {
+                    position = size;
+                    break;
+                }
+                std::memcpy(&value, args + position, sizeof(value));
+                position += sizeof(value);
+                std::snprintf(number, sizeof(number), "%g", value);
+                text += number;
+                break;
+            }
+            case BinaryArgType::STRING: {
+                uint16_t length;
+                if (size - position < sizeof(length)) {
+                    position = size;
+                    break;
+                }
+                std::memcpy(&length, args + position, sizeof(length));
+                position += sizeof(length);
+                length = static_cast<uint16_t>(std::min<size_t>(length, size - position));
+                text.append(args + position, length);
+                position += length;
+                break;
+            }
+            default:
+                position = size; // 无法识别的类型，其后的参数不再解析
+                text += "{?}";
+                break;
+        }
+    }
+    return text;
+}
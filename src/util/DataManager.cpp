@@ -17,14 +17,135 @@
 #include "../../include/util/DataManager.h"
 #include "../../include/system/SystemException.h"
 #include "../../include/system/LockGuard.h"
+#include "../../include/util/LogRateLimiter.h"
 #include "../../include/util/Logger.h"
+#include "../../include/util/MappedFile.h"
+#include "../../include/util/JsonStorage.h"
 
-#include <fstream>
 #include <filesystem>
 #include <stdexcept>
 #include <iostream>
 
 namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+
+// SAX处理器：只为顶层数组中的当前元素构建DOM，元素解析完成后立即交给回调并释放
+class RecordSaxHandler : public nlohmann::json_sax<json> {
+public:
+    explicit RecordSaxHandler(const std::function<void(json&)>& handler) : handler_(handler) {}
+
+    bool null() override { return value(nullptr); }
+    bool boolean(bool val) override { return value(val); }
+    bool number_integer(number_integer_t val) override { return value(val); }
+    bool number_unsigned(number_unsigned_t val) override { return value(val); }
+    bool number_float(number_float_t val, const string_t&) override { return value(val); }
+    bool string(string_t& val) override { return value(std::move(val)); }
+    bool binary(binary_t& val) override { return value(std::move(val)); }
+
+    bool start_object(std::size_t) override {
+        if (!inTopArray_) {
+            errorMessage_ = "数据文件顶层必须是数组";
+            return false;
+        }
+        return open(json::object());
+    }
+
+    bool key(string_t& val) override {
+        key_ = std::move(val);
+        return true;
+    }
+
+    bool end_object() override { return close(); }
+
+    bool start_array(std::size_t) override {
+        if (!inTopArray_) {
+            inTopArray_ = true;
+            return true;
+        }
+        return open(json::array());
+    }
+
+    bool end_array() override {
+        if (stack_.empty()) {
+            inTopArray_ = false; // 顶层数组结束
+            return true;
+        }
+        return close();
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        errorMessage_ = ex.what();
+        return false;
+    }
+
+    size_t recordCount() const { return recordCount_; }
+
+    const std::string& errorMessage() const { return errorMessage_; }
+
+private:
+    template<typename Value>
+    bool value(Value&& val) {
+        if (!inTopArray_) {
+            errorMessage_ = "数据文件顶层必须是数组";
+            return false;
+        }
+        if (stack_.empty()) {
+            // 顶层数组中的标量元素直接作为一条记录
+            json record(std::forward<Value>(val));
+            emit(record);
+            return true;
+        }
+        insert(json(std::forward<Value>(val)));
+        return true;
+    }
+
+    bool open(json container) {
+        if (stack_.empty()) {
+            record_ = std::move(container);
+            stack_.push_back(&record_);
+        } else {
+            stack_.push_back(insert(std::move(container)));
+        }
+        return true;
+    }
+
+    bool close() {
+        stack_.pop_back();
+        if (stack_.empty()) {
+            emit(record_);
+            record_ = json();
+        }
+        return true;
+    }
+
+    json* insert(json val) {
+        json* parent = stack_.back();
+        if (parent->is_object()) {
+            json& slot = (*parent)[key_];
+            slot = std::move(val);
+            return &slot;
+        }
+        parent->push_back(std::move(val));
+        return &parent->back();
+    }
+
+    void emit(json& record) {
+        handler_(record);
+        ++recordCount_;
+    }
+
+    const std::function<void(json&)>& handler_;
+    json record_;                 // 正在构建的记录
+    std::vector<json*> stack_;    // 记录内部的嵌套容器
+    std::string key_;             // 最近读到的对象键
+    bool inTopArray_ = false;     // 是否位于顶层数组内
+    size_t recordCount_ = 0;      // 已回调的记录数
+    std::string errorMessage_;    // 解析失败原因
+};
+
+} // namespace
 
 DataManager& DataManager::getInstance() {
     static DataManager instance; // Meyer's单例模式
@@ -34,104 +155,71 @@ DataManager& DataManager::getInstance() {
 DataManager::DataManager() {
     // 默认数据目录为当前目录下的data子目录
     dataDirectory_ = "./data";
+    storage_ = std::make_unique<JsonStorage>();
 }
 
-std::string DataManager::loadJsonFromFile(const std::string& filename) {
-    // 先不加锁，检查文件是否存在
+bool DataManager::forEachJsonRecord(const std::string& filename, const std::function<void(json&)>& handler) {
     std::string filePath = getDataFilePath(filename);
-    Logger::getInstance().debug("尝试从文件加载JSON: " + filePath);
-
-    if (!fileExists(filePath)) {
-        Logger::getInstance().warning("文件不存在: " + filePath);
-        return "";
-    }
+    LOG_RATE_LIMITED(LogLevel::DEBUG, 10, "尝试流式加载JSON: " + filePath);
     
-    try {
-        std::string jsonContent; // 存储文件内容
-        {
-            LockGuard lock(mutex_, 1000); 
-            if (!lock.isLocked()) {
-                Logger::getInstance().warning("获取数据管理器锁超时，尝试无锁读取");
-            }
-            
-            std::ifstream file(filePath);
-            if (!file.is_open()) {
-                Logger::getInstance().error("无法打开文件: " + filePath);
-                throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法打开文件: " + filePath);
-            }
-            
-            jsonContent = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
-        } 
-        
-        Logger::getInstance().debug("文件读取成功，内容大小: " + std::to_string(jsonContent.size()) + " 字节");
-        
-        Logger::getInstance().info("成功加载文件: " + filePath);
-        return jsonContent;
-    } catch (const SystemException&) {
-        throw; // 重新抛出系统异常
-    } catch (const std::exception& e) {
-        Logger::getInstance().error("加载文件失败: " + filePath + " - " + e.what());
-        throw SystemException(ErrorType::FILE_CORRUPTED, std::string("加载文件失败: ") + e.what());
+    if (!fileExists(filePath)) {
+        LOG_WARNING("文件不存在: " + filePath);
+        return false;
     }
-}
-
-bool DataManager::saveJsonToFile(const std::string& filename, const std::string& jsonData) {
     
-    // 使用getDataFilePath获取正确的文件路径
-    std::string filePathStr = getDataFilePath(filename);
-    std::string tempFilePath = filePathStr + ".tmp";
-    
-    // 确保目录存在
-    fs::path parentPath = fs::path(filePathStr).parent_path();
-    if (!parentPath.empty() && !fs::exists(parentPath)) {
-        try {
-            fs::create_directories(parentPath);
-        } catch (const std::exception& e) {
-            Logger::getInstance().error("创建目录失败: " + parentPath.string() + " - " + e.what());
-            throw SystemException(ErrorType::FILE_ACCESS_DENIED, std::string("创建目录失败: ") + e.what());
+    MappedFile file;
+    {
+        // 只在建立映射时持锁；保存采用临时文件+重命名，已映射的内容不会被改写
+        LockGuard lock(mutex_, 1000);
+        if (!lock.isLocked()) {
+            // 未持锁时可能映射到正在替换的文件，不能当作成功读取
+            LOG_ERROR("获取数据管理器锁超时，放弃读取: " + filePath);
+            throw SystemException(ErrorType::LOCK_TIMEOUT, "获取数据管理器锁超时: " + filePath);
         }
+        file = MappedFile(filePath);
     }
     
-    try {
-        // 先写入临时文件
-        std::ofstream file(tempFilePath);
-        if (!file.is_open()) {
-            Logger::getInstance().error("无法打开临时文件: " + tempFilePath);
-            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法打开临时文件: " + tempFilePath);
-        }
-        
-        file << jsonData;
-        file.close();
-        
-        // 重命名临时文件为目标文件
-        try {
-            if (fs::exists(filePathStr)) {
-                fs::remove(filePathStr);
-            }
-            fs::rename(tempFilePath, filePathStr);
-        } catch (const std::exception& e) {
-            Logger::getInstance().error(std::string("重命名临时文件失败: ") + e.what());
-            throw SystemException(ErrorType::FILE_ACCESS_DENIED, std::string("重命名临时文件失败: ") + e.what());
-        }
-        
-        Logger::getInstance().info("成功保存文件: " + filePathStr);
-        return true;
-    } catch (const SystemException&) {
-        throw; // 重新抛出系统异常
-    } catch (const std::exception& e) {
-        Logger::getInstance().error("保存文件失败: " + filePathStr + " - " + e.what());
-        throw SystemException(ErrorType::FILE_ACCESS_DENIED, std::string("保存文件失败: ") + e.what());
+    if (file.empty()) {
+        return false;
     }
     
-    return false; //（通常不会执行到这里）
+    size_t count = parseJsonRecords(file.data(), file.size(), handler, filePath);
+    
+    LOG_RATE_LIMITED(LogLevel::INFO, 10, "成功加载文件: " + filePath + "，共 " + std::to_string(count) + " 条记录");
+    return true;
+}
+
+size_t DataManager::parseJsonRecords(const char* data, size_t size, const std::function<void(json&)>& handler,
+                                     const std::string& source) {
+    RecordSaxHandler sax(handler);
+    bool parsed = json::sax_parse(data, data + size, &sax);
+    if (!parsed) {
+        LOG_ERROR("解析文件失败: " + source + " - " + sax.errorMessage());
+        throw SystemException(ErrorType::FILE_CORRUPTED, "解析文件失败: " + source + " - " + sax.errorMessage());
+    }
+    return sax.recordCount();
+}
+
+size_t DataManager::parseJsonRecords(std::istream& input, const std::function<void(json&)>& handler,
+                                     const std::string& source) {
+    RecordSaxHandler sax(handler);
+    bool parsed = json::sax_parse(input, &sax);
+    if (!parsed) {
+        LOG_ERROR("解析文件失败: " + source + " - " + sax.errorMessage());
+        throw SystemException(ErrorType::FILE_CORRUPTED, "解析文件失败: " + source + " - " + sax.errorMessage());
+    }
+    return sax.recordCount();
+}
+
+std::string DataManager::takeString(json& record, const char* key) {
+    return std::move(record.at(key).get_ref<std::string&>());
 }
 
 bool DataManager::fileExists(const std::string& filename) const {
     try {
         return fs::exists(filename);
     } catch (const std::exception& e) {
-        Logger::getInstance().warning("检查文件存在性失败: " + filename + " - " + e.what());
+        LOG_WARNING("检查文件存在性失败: " + filename + " - " + e.what());
         return false;
     }
 }
@@ -143,7 +231,7 @@ bool DataManager::createDirectory(const std::string& dirname) const {
         }
         return fs::create_directories(dirname);
     } catch (const std::exception& e) {
-        Logger::getInstance().error("创建目录失败: " + dirname + " - " + e.what());
+        LOG_ERROR("创建目录失败: " + dirname + " - " + e.what());
         return false;
     }
 }
@@ -166,10 +254,25 @@ void DataManager::setDataDirectory(const std::string& dataDir) {
     if (!createDirectory(dataDirectory_)) {
         throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法创建数据目录: " + dataDirectory_);
     }
+    manifest_.open((fs::path(dataDirectory_) / DataManifest::FILE_NAME).string());
     
-    Logger::getInstance().info("设置数据目录: " + dataDirectory_);
+    LOG_INFO("设置数据目录: " + dataDirectory_);
 }
 
 const std::string& DataManager::getDataDirectory() const {
     return dataDirectory_;
 }
+
+void DataManager::setStorageBackend(std::unique_ptr<StorageBackend> storage) {
+    // 只在初始化阶段、各管理器加载数据之前调用
+    storage_ = std::move(storage);
+    LOG_INFO(std::string("数据存储后端: ") + storage_->name());
+}
+
+StorageBackend& DataManager::storage() {
+    return *storage_;
+}
+
+DataManifest& DataManager::manifest() {
+    return manifest_;
+}
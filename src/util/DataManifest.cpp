@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/DataManifest.h"
+#include "../../include/util/Logger.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+
+constexpr StorageTable TABLES[] = {StorageTable::USERS, StorageTable::COURSES, StorageTable::ENROLLMENTS};
+
+} // namespace
+
+void DataManifest::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    known_.fill(UNKNOWN);
+}
+
+uint64_t DataManifest::onDisk(StorageTable table) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return readFile()[indexOf(table)];
+}
+
+bool DataManifest::isCurrent(StorageTable table, uint64_t generation) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return known_[indexOf(table)] == generation;
+}
+
+void DataManifest::acknowledge(StorageTable table, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    known_[indexOf(table)] = generation;
+}
+
+uint64_t DataManifest::bump(StorageTable table) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (path_.empty()) {
+        return 0;
+    }
+
+    std::array<uint64_t, 3> generations = readFile();
+    size_t index = indexOf(table);
+    // 写入前内存已反映磁盘上的代数时，本次写入后内存仍与磁盘一致，可以记下新代数；
+    // 否则其他进程在此之前写入过，其行尚未加载到内存，保持旧值让下次同步重新加载
+    bool current = known_[index] == generations[index];
+    if (known_[index] != UNKNOWN) {
+        generations[index] = std::max(generations[index], known_[index]);
+    }
+    ++generations[index];
+    if (current) {
+        known_[index] = generations[index];
+    }
+
+    try {
+        writeFile(generations);
+    } catch (const std::exception& e) {
+        // 清单只用于跳过重复加载，写入失败时下次加载按未知处理
+        LOG_WARNING("写入数据清单失败: " + path_ + " - " + e.what());
+        known_[index] = UNKNOWN;
+    }
+    return generations[index];
+}
+
+size_t DataManifest::indexOf(StorageTable table) {
+    return static_cast<size_t>(table);
+}
+
+std::array<uint64_t, 3> DataManifest::readFile() const {
+    std::array<uint64_t, 3> generations{};
+    std::ifstream file(path_);
+    if (!file.is_open()) {
+        return generations;
+    }
+
+    json manifest = json::parse(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), nullptr, false);
+    if (!manifest.is_object()) {
+        return generations; // 损坏的清单视为不存在
+    }
+    for (StorageTable table : TABLES) {
+        auto it = manifest.find(storageTableName(table));
+        if (it != manifest.end() && it->is_number_unsigned()) {
+            generations[indexOf(table)] = it->get<uint64_t>();
+        }
+    }
+    return generations;
+}
+
+void DataManifest::writeFile(const std::array<uint64_t, 3>& generations) const {
+    json manifest = json::object();
+    for (StorageTable table : TABLES) {
+        manifest[storageTableName(table)] = generations[indexOf(table)];
+    }
+
+    std::string tempPath = path_ + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("无法打开临时文件");
+        }
+        file << manifest.dump(4);
+        if (!file) {
+            throw std::runtime_error("写入临时文件失败");
+        }
+    }
+    fs::rename(tempPath, path_);
+}
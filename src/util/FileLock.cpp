@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/FileLock.h"
+#include "../../include/system/SystemException.h"
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#define HAS_FLOCK 1
+#else
+#define HAS_FLOCK 0
+#endif
+
+FileLock::FileLock(const std::string& path) {
+#if HAS_FLOCK
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法打开锁文件: " + path + " - " + std::strerror(errno));
+    }
+    while (::flock(fd_, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            std::string message = std::strerror(errno);
+            ::close(fd_);
+            throw SystemException(ErrorType::LOCK_FAILURE, "获取文件锁失败: " + path + " - " + message);
+        }
+    }
+#else
+    (void)path;
+#endif
+}
+
+FileLock::~FileLock() {
+#if HAS_FLOCK
+    if (fd_ >= 0) {
+        ::flock(fd_, LOCK_UN);
+        ::close(fd_);
+    }
+#endif
+}
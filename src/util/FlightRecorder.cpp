@@ -0,0 +1,531 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/FlightRecorder.h"
+#include "../../include/util/BinaryLogger.h"
+#include "../../include/system/SystemException.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#define FLIGHT_POSIX 1
+#else
+#include <cstdio>
+#include <process.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 转储文件的输出缓冲：攒满后一次write()，不分配内存
+class DumpWriter {
+public:
+    ~DumpWriter() {
+        close();
+    }
+
+    // 以独占方式创建文件，已存在时返回false
+    bool open(const char* path) {
+#ifdef FLIGHT_POSIX
+        fd_ = ::open(path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        return fd_ >= 0;
+#else
+        file_ = std::fopen(path, "wbx");
+        return file_ != nullptr;
+#endif
+    }
+
+    template<typename T>
+    void raw(T value) {
+        put(&value, sizeof(value));
+    }
+
+    void put(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            if (used_ == sizeof(buffer_)) {
+                flush();
+            }
+            size_t chunk = std::min(size, sizeof(buffer_) - used_);
+            std::memcpy(buffer_ + used_, bytes, chunk);
+            used_ += chunk;
+            bytes += chunk;
+            size -= chunk;
+        }
+    }
+
+    void shortString(const char* text) {
+        size_t length = std::min<size_t>(std::strlen(text), UINT16_MAX);
+        raw(static_cast<uint16_t>(length));
+        put(text, length);
+    }
+
+    // 写出缓冲区，返回此前的写入是否全部成功
+    bool close() {
+        flush();
+#ifdef FLIGHT_POSIX
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#else
+        if (file_ != nullptr) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+#endif
+        return ok_;
+    }
+
+private:
+    void flush() {
+        size_t written = 0;
+#ifdef FLIGHT_POSIX
+        while (fd_ >= 0 && written < used_) {
+            ssize_t result = ::write(fd_, buffer_ + written, used_ - written);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                ok_ = false;
+                break;
+            }
+            written += static_cast<size_t>(result);
+        }
+#else
+        if (file_ != nullptr && std::fwrite(buffer_, 1, used_, file_) != used_) {
+            ok_ = false;
+        }
+#endif
+        used_ = 0;
+    }
+
+#ifdef FLIGHT_POSIX
+    int fd_ = -1;
+#else
+    std::FILE* file_ = nullptr;
+#endif
+    char buffer_[4096];
+    size_t used_ = 0;
+    bool ok_ = true;
+};
+
+// 把十进制数写到text处，返回写入后的位置
+char* appendNumber(char* text, uint64_t value) {
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (count > 0) {
+        *text++ = digits[--count];
+    }
+    return text;
+}
+
+uint32_t currentPid() {
+#ifdef FLIGHT_POSIX
+    return static_cast<uint32_t>(::getpid());
+#else
+    return static_cast<uint32_t>(::_getpid());
+#endif
+}
+
+int64_t currentSeconds() {
+    return static_cast<int64_t>(std::time(nullptr));
+}
+
+int64_t recordTimestamp(const char* record) {
+    int64_t timestamp;
+    std::memcpy(&timestamp, record + sizeof(uint16_t) + sizeof(uint32_t), sizeof(timestamp));
+    return timestamp;
+}
+
+// order中的槽位号先按记录时间、再按槽位号排序（同一时刻的记录保持环内顺序）
+bool recordBefore(const char* records, uint32_t a, uint32_t b) {
+    int64_t ta = recordTimestamp(records + a * FlightRecorder::SLOT_SIZE);
+    int64_t tb = recordTimestamp(records + b * FlightRecorder::SLOT_SIZE);
+    return ta < tb || (ta == tb && a < b);
+}
+
+void siftDown(const char* records, uint32_t* order, size_t root, size_t count) {
+    while (2 * root + 1 < count) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < count && recordBefore(records, order[child], order[child + 1])) {
+            ++child;
+        }
+        if (!recordBefore(records, order[root], order[child])) {
+            return;
+        }
+        std::swap(order[root], order[child]);
+        root = child;
+    }
+}
+
+// 原地堆排序：不分配内存，可在信号处理函数中调用（std::stable_sort可能申请临时缓冲区）
+void sortByTime(const char* records, uint32_t* order, size_t count) {
+    for (size_t i = count / 2; i-- > 0;) {
+        siftDown(records, order, i, count);
+    }
+    for (size_t end = count; end > 1; --end) {
+        std::swap(order[0], order[end - 1]);
+        siftDown(records, order, 0, end - 1);
+    }
+}
+
+const char* signalName(int signal) {
+    switch (signal) {
+        case SIGSEGV: return "SIGSEGV";
+        case SIGFPE: return "SIGFPE";
+        case SIGILL: return "SIGILL";
+        case SIGABRT: return "SIGABRT";
+#ifdef FLIGHT_POSIX
+        case SIGBUS: return "SIGBUS";
+        case SIGUSR2: return "SIGUSR2";
+#endif
+        default: return "signal";
+    }
+}
+
+const int FATAL_SIGNALS[] = {
+    SIGSEGV, SIGFPE, SIGILL, SIGABRT,
+#ifdef FLIGHT_POSIX
+    SIGBUS,
+#endif
+};
+
+} // namespace
+
+// 单个线程最近的记录：定长槽位组成的环，next_为写入的总条数
+// 所属线程是唯一的写者；转储时复制各槽位，再根据复制后的next_丢弃期间可能被覆盖的槽位
+class FlightRecorder::Ring {
+public:
+    explicit Ring(size_t slots) : slots_(slots), data_(new char[slots * SLOT_SIZE]) {}
+
+    void write(const char* record, size_t size) {
+        uint64_t next = next_.load(std::memory_order_relaxed);
+        char* slot = data_.get() + (next % slots_) * SLOT_SIZE;
+        if (size > SLOT_SIZE) {
+            std::memcpy(slot, record, SLOT_SIZE);
+            uint16_t truncated = SLOT_SIZE; // 参数区被截断，解码时按剩余字节还原
+            std::memcpy(slot, &truncated, sizeof(truncated));
+        } else {
+            std::memcpy(slot, record, size);
+        }
+        next_.store(next + 1, std::memory_order_release);
+    }
+
+    // 按从旧到新的顺序把完整的槽位复制到out，返回条数
+    size_t snapshot(char* out) const {
+        uint64_t end = next_.load(std::memory_order_acquire);
+        // 最旧的槽位就是写者下一条要覆盖的位置，不复制
+        uint64_t begin = end >= slots_ ? end - slots_ + 1 : 0;
+        for (uint64_t i = begin; i < end; ++i) {
+            std::memcpy(out + (i - begin) * SLOT_SIZE, data_.get() + (i % slots_) * SLOT_SIZE, SLOT_SIZE);
+        }
+        uint64_t after = next_.load(std::memory_order_acquire);
+        uint64_t firstIntact = after >= slots_ ? after - slots_ + 1 : 0;
+        if (firstIntact <= begin) {
+            return static_cast<size_t>(end - begin);
+        }
+        if (firstIntact >= end) {
+            return 0;
+        }
+        size_t skipped = static_cast<size_t>(firstIntact - begin);
+        std::memmove(out, out + skipped * SLOT_SIZE, static_cast<size_t>(end - firstIntact) * SLOT_SIZE);
+        return static_cast<size_t>(end - firstIntact);
+    }
+
+    // 领取空闲的环
+    bool acquire() {
+        bool expected = false;
+        return inUse_.compare_exchange_strong(expected, true, std::memory_order_acquire);
+    }
+
+    // 所属线程已退出，环连同其中的记录留给新线程
+    void release() {
+        inUse_.store(false, std::memory_order_release);
+    }
+
+private:
+    size_t slots_;
+    std::unique_ptr<char[]> data_;
+    std::atomic<uint64_t> next_{0};
+    std::atomic<bool> inUse_{true};
+};
+
+FlightRecorder& FlightRecorder::getInstance() {
+    static FlightRecorder instance; // Meyer's单例模式
+    return instance;
+}
+
+bool FlightRecorder::enable(const std::string& logDir, const FlightRecorderOptions& options) {
+    static std::mutex enableMutex;
+    std::lock_guard<std::mutex> lock(enableMutex);
+    if (isActive()) {
+        return true;
+    }
+
+    std::string prefix = logDir + "/flight.";
+    if (prefix.size() >= sizeof(pathPrefix_)) {
+        return false;
+    }
+    try {
+        if (!fs::exists(logDir)) {
+            fs::create_directories(logDir);
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    std::memcpy(pathPrefix_, prefix.c_str(), prefix.size() + 1);
+
+    recordsPerThread_ = std::max<size_t>(options.recordsPerThread, 16);
+    // 只分配不写入，转储之前不占用物理内存
+    snapshot_ = new char[MAX_THREADS * recordsPerThread_ * SLOT_SIZE];
+    order_ = new uint32_t[MAX_THREADS * recordsPerThread_];
+
+    const char* file = __FILE__;
+    textFormatIds_[static_cast<int>(LogLevel::DEBUG)] = BinaryLogger::registerFormat(LogLevel::DEBUG, "{}", file, __LINE__);
+    textFormatIds_[static_cast<int>(LogLevel::INFO)] = BinaryLogger::registerFormat(LogLevel::INFO, "{}", file, __LINE__);
+    textFormatIds_[static_cast<int>(LogLevel::WARNING)] = BinaryLogger::registerFormat(LogLevel::WARNING, "{}", file, __LINE__);
+    textFormatIds_[static_cast<int>(LogLevel::ERROR)] = BinaryLogger::registerFormat(LogLevel::ERROR, "{}", file, __LINE__);
+    textFormatIds_[static_cast<int>(LogLevel::CRITICAL)] = BinaryLogger::registerFormat(LogLevel::CRITICAL, "{}", file, __LINE__);
+    reasonFormatId_ = BinaryLogger::registerFormat(LogLevel::WARNING, "飞行记录器转储：{}", file, __LINE__);
+
+    SystemException::setObserver([](const SystemException& exception) {
+        if (exception.getType() == ErrorType::FILE_CORRUPTED) {
+            getInstance().dumpOnFailure(exception.getFormattedMessage());
+        }
+    });
+
+    if (options.installSignalHandlers) {
+#ifdef FLIGHT_POSIX
+        // 栈溢出引起的SIGSEGV需要在备用栈上处理
+        static char alternateStack[64 * 1024];
+        stack_t stack{};
+        stack.ss_sp = alternateStack;
+        stack.ss_size = sizeof(alternateStack);
+        sigaltstack(&stack, nullptr);
+
+        struct sigaction action{};
+        action.sa_handler = &FlightRecorder::onSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESETHAND | SA_ONSTACK; // 处理一次后恢复默认动作
+        for (int signal : FATAL_SIGNALS) {
+            sigaction(signal, &action, nullptr);
+        }
+        action.sa_flags = SA_RESTART;
+        sigaction(SIGUSR2, &action, nullptr);
+#else
+        for (int signal : FATAL_SIGNALS) {
+            std::signal(signal, &FlightRecorder::onSignal);
+        }
+#endif
+    }
+
+    active_.store(true, std::memory_order_release);
+    return true;
+}
+
+FlightRecorder::Ring* FlightRecorder::localRing() {
+    struct Handle {
+        Ring* ring = nullptr;
+        bool exhausted = false; // 环已用完，本线程不再记录
+
+        ~Handle() {
+            if (ring != nullptr) {
+                ring->release();
+            }
+        }
+    };
+    thread_local Handle handle;
+    if (handle.ring != nullptr || handle.exhausted) {
+        return handle.ring;
+    }
+
+    size_t count = ringCount_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (rings_[i]->acquire()) {
+            handle.ring = rings_[i];
+            return handle.ring;
+        }
+    }
+
+    static std::mutex createMutex;
+    std::lock_guard<std::mutex> lock(createMutex);
+    count = ringCount_.load(std::memory_order_relaxed);
+    if (count == MAX_THREADS) {
+        handle.exhausted = true;
+        return nullptr;
+    }
+    // 环只增不减，转储时无需加锁即可遍历
+    rings_[count] = new Ring(recordsPerThread_);
+    ringCount_.store(count + 1, std::memory_order_release);
+    handle.ring = rings_[count];
+    return handle.ring;
+}
+
+void FlightRecorder::record(const char* record, size_t size) {
+    if (!isActive()) {
+        return;
+    }
+    if (Ring* ring = getInstance().localRing()) {
+        ring->write(record, size);
+    }
+}
+
+void FlightRecorder::recordText(LogLevel level, std::string_view message) {
+    if (!isActive()) {
+        return;
+    }
+    char record[SLOT_SIZE];
+    size_t size = BinaryLogger::encode(record, getInstance().textFormatIds_[static_cast<int>(level)], message);
+    FlightRecorder::record(record, size);
+}
+
+std::string FlightRecorder::dump(const std::string& reason) {
+    if (!writeDump(reason.data(), reason.size())) {
+        return "";
+    }
+    std::string path = path_;
+    Logger::getInstance().warning("飞行记录已转储到 " + path + "（" + reason + "）");
+    return path;
+}
+
+void FlightRecorder::dumpOnFailure(const std::string& reason) {
+    if (!isActive()) {
+        return;
+    }
+    int64_t now = currentSeconds();
+    int64_t last = lastDumpSeconds_.load(std::memory_order_relaxed);
+    if (now - last < MIN_FAILURE_INTERVAL_SECONDS ||
+        !lastDumpSeconds_.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+        return;
+    }
+    dump(reason);
+}
+
+bool FlightRecorder::writeDump(const char* reason, size_t reasonLength) {
+    if (!isActive() || dumping_.test_and_set(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // 复制各线程的环，记录线程可以继续写入
+    size_t total = 0;
+    size_t rings = ringCount_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < rings; ++i) {
+        total += rings_[i]->snapshot(snapshot_ + total * SLOT_SIZE);
+    }
+    size_t valid = 0;
+    for (size_t i = 0; i < total; ++i) {
+        uint16_t size;
+        std::memcpy(&size, snapshot_ + i * SLOT_SIZE, sizeof(size));
+        if (size >= BinaryLogger::RECORD_HEADER_SIZE && size <= SLOT_SIZE) {
+            order_[valid++] = static_cast<uint32_t>(i);
+        }
+    }
+    sortByTime(snapshot_, order_, valid);
+
+    char reasonRecord[SLOT_SIZE];
+    size_t reasonSize = BinaryLogger::encode(reasonRecord, reasonFormatId_, std::string_view(reason, reasonLength));
+
+    // 文件名：前缀 + 进程ID + "." + 秒 [+ "-序号"] + ".binlog"，同一秒内多次转储时追加序号
+    DumpWriter writer;
+    bool opened = false;
+    for (int attempt = 0; attempt < 10 && !opened; ++attempt) {
+        char* cursor = path_ + std::strlen(pathPrefix_);
+        std::memcpy(path_, pathPrefix_, static_cast<size_t>(cursor - path_));
+        cursor = appendNumber(cursor, currentPid());
+        *cursor++ = '.';
+        cursor = appendNumber(cursor, static_cast<uint64_t>(currentSeconds()));
+        if (attempt > 0) {
+            *cursor++ = '-';
+            cursor = appendNumber(cursor, static_cast<uint64_t>(attempt));
+        }
+        std::memcpy(cursor, ".binlog", sizeof(".binlog"));
+        opened = writer.open(path_);
+    }
+    if (!opened) {
+        dumping_.clear(std::memory_order_release);
+        return false;
+    }
+
+    // 与course_system.binlog相同的格式：文件头和一个包含全部格式定义与记录的批次
+    uint32_t formats = BinaryLogger::formatCount();
+    size_t bodyLength = 0;
+    for (uint32_t id = 1; id <= formats; ++id) {
+        const LogFormat& format = BinaryLogger::formatAt(id);
+        bodyLength += 1 + sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t) +
+                      sizeof(uint16_t) + std::min<size_t>(std::strlen(format.file), UINT16_MAX) +
+                      sizeof(uint16_t) + std::min<size_t>(std::strlen(format.format), UINT16_MAX);
+    }
+    for (size_t i = 0; i < valid; ++i) {
+        uint16_t size;
+        std::memcpy(&size, snapshot_ + order_[i] * SLOT_SIZE, sizeof(size));
+        bodyLength += 1 + size;
+    }
+    bodyLength += 1 + reasonSize;
+
+    writer.put(BinaryLogger::MAGIC, sizeof(BinaryLogger::MAGIC));
+    writer.put("B", 1);
+    writer.raw(currentPid());
+    writer.raw(static_cast<uint32_t>(bodyLength));
+    for (uint32_t id = 1; id <= formats; ++id) {
+        const LogFormat& format = BinaryLogger::formatAt(id);
+        writer.put("F", 1);
+        writer.raw(id);
+        writer.raw(static_cast<uint8_t>(format.level));
+        writer.raw(static_cast<uint32_t>(format.line));
+        writer.shortString(format.file);
+        writer.shortString(format.format);
+    }
+    for (size_t i = 0; i < valid; ++i) {
+        const char* record = snapshot_ + order_[i] * SLOT_SIZE;
+        uint16_t size;
+        std::memcpy(&size, record, sizeof(size));
+        writer.put("R", 1);
+        writer.put(record, size);
+    }
+    writer.put("R", 1);
+    writer.put(reasonRecord, reasonSize);
+    bool written = writer.close();
+
+    dumping_.clear(std::memory_order_release);
+    return written;
+}
+
+void FlightRecorder::onSignal(int signal) {
+    const char* name = signalName(signal);
+    getInstance().writeDump(name, std::strlen(name));
+#ifdef FLIGHT_POSIX
+    if (signal == SIGUSR2) {
+        return;
+    }
+#endif
+    // 处理函数已恢复为默认动作，重新发出信号使进程照常终止并生成core
+    std::raise(signal);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/FormatTemplate.h"
+
+FormatTemplate::FormatTemplate(std::string_view format) {
+    size_t literalStart = 0;
+    auto addLiteral = [&](size_t end) {
+        if (end > literalStart) {
+            segments_.push_back(Segment{static_cast<uint32_t>(literalStart), static_cast<uint32_t>(end - literalStart), -1});
+            literalSize_ += end - literalStart;
+        }
+    };
+
+    size_t i = 0;
+    while (i < format.size()) {
+        if (format[i] != '{') {
+            ++i;
+            continue;
+        }
+        // 只识别{数字}，其他花括号作为原文
+        size_t close = i + 1;
+        int32_t index = 0;
+        while (close < format.size() && close - i <= 4 && format[close] >= '0' && format[close] <= '9') {
+            index = index * 10 + (format[close] - '0');
+            ++close;
+        }
+        if (close == i + 1 || close >= format.size() || format[close] != '}') {
+            ++i;
+            continue;
+        }
+        addLiteral(i);
+        segments_.push_back(Segment{static_cast<uint32_t>(i), static_cast<uint32_t>(close + 1 - i), index});
+        i = close + 1;
+        literalStart = i;
+    }
+    addLiteral(format.size());
+}
+
+void FormatTemplate::appendTo(std::string& out, std::string_view format, const FormatArg* args, size_t count) const {
+    size_t size = literalSize_;
+    for (const Segment& segment : segments_) {
+        if (segment.arg >= 0) {
+            size += static_cast<size_t>(segment.arg) < count ? args[segment.arg].view().size() : segment.length;
+        }
+    }
+    out.reserve(out.size() + size);
+
+    for (const Segment& segment : segments_) {
+        if (segment.arg >= 0 && static_cast<size_t>(segment.arg) < count) {
+            out += args[segment.arg].view();
+        } else {
+            out.append(format.data() + segment.begin, segment.length);
+        }
+    }
+}
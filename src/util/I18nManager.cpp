@@ -36,7 +36,13 @@ I18nManager& I18nManager::getInstance() {
     return instance;
 }
 
-I18nManager::I18nManager() : currentLanguage_(Language::CHINESE), initialized_(false) {}
+I18nManager::I18nManager() : currentLanguage_(Language::CHINESE), initialized_(false) {
+    // 加载语言文件之前按ID取文本得到键名，与getText(key)未初始化时的返回值一致
+    for (size_t i = 0; i < TEXT_ID_COUNT; ++i) {
+        texts_[i] = TEXT_KEYS[i];
+        templates_[i] = FormatTemplate(texts_[i]);
+    }
+}
 
 bool I18nManager::initialize(const std::string& dataDir) {
     // 需要读取数据文件
@@ -46,7 +52,7 @@ bool I18nManager::initialize(const std::string& dataDir) {
     
     // 确保数据目录存在
     if (!fs::exists(dataDir_)) {
-        Logger::getInstance().critical("数据目录不存在: " + dataDir_);
+        LOG_CRITICAL("数据目录不存在: " + dataDir_);
         throw SystemException(ErrorType::FILE_NOT_FOUND, "数据目录不存在: " + dataDir_);
     }
     
@@ -54,9 +60,9 @@ bool I18nManager::initialize(const std::string& dataDir) {
     bool result = loadLanguageFile(currentLanguage_);
     if (result) {
         initialized_ = true;
-        Logger::getInstance().info("国际化系统初始化成功，数据目录：" + dataDir);
+        LOG_INFO("国际化系统初始化成功，数据目录：" + dataDir);
     } else {
-        Logger::getInstance().critical("国际化系统初始化失败");
+        LOG_CRITICAL("国际化系统初始化失败");
         throw SystemException(ErrorType::DATA_INVALID, "国际化系统初始化失败");
     }
     
@@ -71,10 +77,10 @@ bool I18nManager::setLanguage(Language language) {
     bool result = loadLanguageFile(language);
     if (result) {
         currentLanguage_ = language;
-        Logger::getInstance().info("语言切换成功：" + languageToString(language));
+        LOG_INFO("语言切换成功：" + languageToString(language));
         return true;
     } else {
-        Logger::getInstance().critical("语言切换失败：" + languageToString(language));
+        LOG_CRITICAL("语言切换失败：" + languageToString(language));
         throw SystemException(ErrorType::DATA_INVALID, "语言切换失败：" + languageToString(language));
     }
 }
@@ -87,7 +93,7 @@ std::string I18nManager::getText(const std::string& key) const {
     try {
         // 先检查是否初始化
         if (!initialized_) {
-            Logger::getInstance().critical("I18nManager未初始化");
+            LOG_CRITICAL("I18nManager未初始化");
             throw SystemException(ErrorType::DATA_INVALID, "I18nManager未初始化");
         }
 
@@ -101,74 +107,11 @@ std::string I18nManager::getText(const std::string& key) const {
         return key;
     }
     catch (const std::exception& e) {
-        Logger::getInstance().error("getText发生异常: " + std::string(e.what()));
+        LOG_ERROR("getText发生异常: " + std::string(e.what()));
         return key;  // 出现任何异常都返回键本身
     }
 }
 
-template<typename... Args>
-std::string I18nManager::getFormattedText(const std::string& key, Args... args) const {
-    std::string text = getText(key);
-    try {
-        // 简单的字符串替换实现，替换{0}, {1}, {2}等占位符
-        return formatString(text, args...);
-    } catch (const std::exception& e) {
-        Logger::getInstance().error("格式化文本失败：" + std::string(e.what()) + " - 键：" + key);
-        return text;
-    }
-}
-
-// 递归终止条件
-std::string I18nManager::formatString(const std::string& format) const {
-    return format;
-}
-
-// 格式化值为字符串
-template<typename T>
-std::string I18nManager::formatValue(const T& value) const {
-    std::ostringstream oss;
-    oss << value;
-    return oss.str();
-}
-
-// 特化字符串类型，避免额外的转换
-template<>
-std::string I18nManager::formatValue(const std::string& value) const {
-    return value;
-}
-
-// 递归格式化函数
-template<typename T, typename... Args>
-std::string I18nManager::formatString(const std::string& format, T value, Args... args) const {
-    
-    //　递归终止条件，可变参数包为空
-    std::string result = format;
-    std::string placeholder = "{0}";
-    size_t pos = result.find(placeholder);
-    if (pos != std::string::npos) {
-        result.replace(pos, placeholder.length(), formatValue(value));
-    }
-    
-    // 递归处理其余参数，并更新后续占位符的索引
-    if constexpr (sizeof...(args) > 0) {
-        // 更新后续占位符，将{1}, {2}...变为{0}, {1}...
-        std::string nextFormat = result;
-        for (size_t i = 1; i <= sizeof...(args); ++i) {
-            std::string oldPlaceholder = "{" + std::to_string(i) + "}";
-            std::string newPlaceholder = "{" + std::to_string(i - 1) + "}";
-            
-            size_t placeholderPos = nextFormat.find(oldPlaceholder);
-            while (placeholderPos != std::string::npos) {
-                nextFormat.replace(placeholderPos, oldPlaceholder.length(), newPlaceholder);
-                placeholderPos = nextFormat.find(oldPlaceholder, placeholderPos + newPlaceholder.length());
-            }
-        }
-        return formatString(nextFormat, args...);
-    }
-    
-    return result;
-}
-
 std::string I18nManager::languageToString(Language language) {
     switch (language) {
         case Language::CHINESE:
@@ -193,19 +136,19 @@ Language I18nManager::stringToLanguage(const std::string& languageStr) {
 bool I18nManager::loadLanguageFile(Language language) {
     try {
         std::string filePath = getLanguageFilePath(language);
-        Logger::getInstance().debug("尝试加载语言文件: " + filePath);
+        LOG_DEBUG("尝试加载语言文件: " + filePath);
         
         // 检查文件是否存在
         bool fileExists = fs::exists(filePath);
         if (!fileExists) {
-            Logger::getInstance().critical("语言文件不存在: " + filePath);
+            LOG_CRITICAL("语言文件不存在: " + filePath);
             throw SystemException(ErrorType::FILE_NOT_FOUND, "语言数据文件不存在: " + filePath);
         }
         
         // 读取文件内容
         std::ifstream file(filePath);
         if (!file.is_open()) {
-            Logger::getInstance().critical("无法打开语言文件: " + filePath);
+            LOG_CRITICAL("无法打开语言文件: " + filePath);
             throw SystemException(ErrorType::FILE_ACCESS_DENIED, "语言数据文件无法打开: " + filePath);
         }
         
@@ -213,11 +156,11 @@ bool I18nManager::loadLanguageFile(Language language) {
         file.close();
         
         if (jsonStr.empty()) {
-            Logger::getInstance().critical("语言文件为空: " + filePath);
+            LOG_CRITICAL("语言文件为空: " + filePath);
             throw SystemException(ErrorType::DATA_INVALID, "语言数据文件为空: " + filePath);
         }
         
-        Logger::getInstance().debug("语言文件内容大小: " + std::to_string(jsonStr.size()) + " 字节");
+        LOG_DEBUG("语言文件内容大小: " + std::to_string(jsonStr.size()) + " 字节");
         
         // 解析JSON
         try {
@@ -242,21 +185,33 @@ bool I18nManager::loadLanguageFile(Language language) {
             
             // 检查是否加载了任何键值对
             if (tempMap.empty()) {
-                Logger::getInstance().critical("语言文件没有包含任何键值对");
+                LOG_CRITICAL("语言文件没有包含任何键值对");
                 throw SystemException(ErrorType::DATA_INVALID, "语言数据文件没有包含任何键值对: " + filePath);
             }
             
+            // 按生成的键名表建立ID到文本的数组；构建时已检查语言文件齐全，运行时文件被改动而缺少的键返回键名
+            // 同时解析每条文本的格式，格式化时不再扫描和改写格式字符串
+            std::array<std::string, TEXT_ID_COUNT> tempTexts;
+            std::array<FormatTemplate, TEXT_ID_COUNT> tempTemplates;
+            for (size_t i = 0; i < TEXT_ID_COUNT; ++i) {
+                auto found = tempMap.find(TEXT_KEYS[i]);
+                tempTexts[i] = found != tempMap.end() && !found->second.empty() ? found->second : TEXT_KEYS[i];
+                tempTemplates[i] = FormatTemplate(tempTexts[i]);
+            }
+            
             // 全部处理完成后，替换现有的映射表
             textMap_ = std::move(tempMap);
+            texts_ = std::move(tempTexts);
+            templates_ = std::move(tempTemplates);
             
-            Logger::getInstance().info("成功加载语言文件: " + filePath + "，共 " + std::to_string(textMap_.size()) + " 个文本项");
+            LOG_INFO("成功加载语言文件: " + filePath + "，共 " + std::to_string(textMap_.size()) + " 个文本项");
             return true;
         } catch (const json::exception& e) {
-            Logger::getInstance().critical("解析语言文件JSON失败: " + std::string(e.what()));
+            LOG_CRITICAL("解析语言文件JSON失败: " + std::string(e.what()));
             throw SystemException(ErrorType::DATA_INVALID, "语言数据文件解析失败: " + filePath);
         }
     } catch (...) {
-        Logger::getInstance().error("加载语言文件时发生未知异常");
+        LOG_ERROR("加载语言文件时发生未知异常");
         throw SystemException(ErrorType::UNKNOWN_ERROR, "加载语言文件时发生未知异常");
     }
 }
@@ -291,13 +246,3 @@ std::string I18nManager::getLanguageFilePath(Language language) const {
     
     return fullPath;
 }
-
-// 显式实例化常见的模板实例
-template std::string I18nManager::getFormattedText(const std::string& key, int) const;
-template std::string I18nManager::getFormattedText(const std::string& key, std::string) const;
-
-template std::string I18nManager::formatValue(const int&) const;
-template std::string I18nManager::formatValue(const std::string&) const;
-
-template std::string I18nManager::formatString(const std::string&, int) const;
-template std::string I18nManager::formatString(const std::string&, std::string) const;
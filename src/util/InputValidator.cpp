@@ -75,16 +75,16 @@ bool InputValidator::validateChoice(const std::string& input, int min, int max,
         bool isValid = (result >= min && result <= max);
         return isValid;
     } catch (const std::invalid_argument& e) {
-        Logger::getInstance().warning("输入验证错误（无效参数）: " + std::string(e.what()));
+        LOG_WARNING("输入验证错误（无效参数）: " + std::string(e.what()));
         return false;
     } catch (const std::out_of_range& e) {
-        Logger::getInstance().warning("输入验证错误（超出范围）: " + std::string(e.what()));
+        LOG_WARNING("输入验证错误（超出范围）: " + std::string(e.what()));
         return false;
     } catch (const std::exception& e) {
-        Logger::getInstance().warning("输入验证错误（其他）: " + std::string(e.what()));
+        LOG_WARNING("输入验证错误（其他）: " + std::string(e.what()));
         return false;
     } catch (...) {
-        Logger::getInstance().warning("输入验证错误（未知异常）");
+        LOG_WARNING("输入验证错误（未知异常）");
         return false;
     }
 }
@@ -0,0 +1,572 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/JsonStorage.h"
+#include "../../include/util/DataManager.h"
+#include "../../include/util/FileLock.h"
+#include "../../include/util/JsonStreamWriter.h"
+#include "../../include/util/LogRateLimiter.h"
+#include "../../include/util/Logger.h"
+#include "../../include/util/SnapshotFile.h"
+#include "../../include/system/SystemException.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+
+// 学期名编码为目录名：字母、数字、'-'、'_'原样保留，其余字节编码为%XX
+std::string encodeTerm(const std::string& term) {
+    std::string name;
+    for (unsigned char c : term) {
+        if (std::isalnum(c) || c == '-' || c == '_') {
+            name += static_cast<char>(c);
+        } else {
+            char escaped[4];
+            std::snprintf(escaped, sizeof(escaped), "%%%02X", c);
+            name += escaped;
+        }
+    }
+    return name;
+}
+
+// encodeTerm的逆变换；不是由encodeTerm生成的目录名（转义不完整、非十六进制等）返回空
+std::optional<std::string> decodeTerm(const std::string& name) {
+    std::string term;
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (name[i] != '%') {
+            term += name[i];
+            continue;
+        }
+        if (i + 2 >= name.size()) {
+            return std::nullopt;
+        }
+        unsigned int value = 0;
+        const char* first = name.data() + i + 1;
+        const char* last = first + 2;
+        if (std::from_chars(first, last, value, 16).ptr != last) {
+            return std::nullopt;
+        }
+        term += static_cast<char>(value);
+        i += 2;
+    }
+    if (term.empty() || encodeTerm(term) != name) {
+        return std::nullopt;
+    }
+    return term;
+}
+
+// 偏移索引的键：各主键字段的字符串值以\x1f连接
+std::string indexKey(StorageTable table, const json& record) {
+    std::string key;
+    for (const auto& column : storageColumns(table)) {
+        if (!column.primaryKey) {
+            continue;
+        }
+        if (!key.empty()) {
+            key += '\x1f';
+        }
+        auto it = record.find(column.field);
+        if (it != record.end()) {
+            key += it->is_string() ? it->get_ref<const std::string&>() : it->dump();
+        }
+    }
+    return key;
+}
+
+// 逐字节扫描顶层数组，不构建DOM：对每个对象元素回调其字节区间和第一层字段fields的字符串值
+// 遇到不符合格式的内容时返回false
+bool scanSpans(const char* data, size_t size, const std::vector<std::string>& fields,
+               const std::function<void(size_t, size_t, const std::vector<std::string>&)>& visitor) {
+    size_t pos = 0;
+    auto skipSpace = [&] {
+        while (pos < size && std::isspace(static_cast<unsigned char>(data[pos]))) {
+            ++pos;
+        }
+    };
+    // pos指向左引号，返回字符串内容（转义序列由JSON解析器还原），pos移到右引号之后
+    auto readString = [&](std::string& out) {
+        size_t begin = pos++;
+        bool escaped = false;
+        while (pos < size && data[pos] != '"') {
+            if (data[pos] == '\\') {
+                escaped = true;
+                ++pos;
+            }
+            ++pos;
+        }
+        if (pos >= size) {
+            return false;
+        }
+        ++pos;
+        out = escaped ? json::parse(data + begin, data + pos).get<std::string>()
+                      : std::string(data + begin + 1, pos - begin - 2);
+        return true;
+    };
+
+    skipSpace();
+    if (pos >= size || data[pos] != '[') {
+        return false;
+    }
+    ++pos;
+    std::vector<std::string> values(fields.size());
+    std::string text;
+    while (true) {
+        skipSpace();
+        if (pos >= size) {
+            return false;
+        }
+        if (data[pos] == ']') {
+            return true;
+        }
+        if (data[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        if (data[pos] != '{') {
+            return false;
+        }
+
+        size_t begin = pos;
+        int depth = 0;
+        bool expectKey = false;     // 第一层中下一个字符串是否为键
+        int field = -1;             // 当前键在fields中的序号
+        std::fill(values.begin(), values.end(), std::string());
+        while (pos < size) {
+            char c = data[pos];
+            if (c == '"') {
+                if (!readString(text)) {
+                    return false;
+                }
+                if (depth == 1 && expectKey) {
+                    auto it = std::find(fields.begin(), fields.end(), text);
+                    field = it != fields.end() ? static_cast<int>(it - fields.begin()) : -1;
+                    expectKey = false;
+                } else if (depth == 1 && field >= 0) {
+                    values[field] = std::move(text);
+                    field = -1;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+                expectKey = depth == 1;
+            } else if (c == '}' || c == ']') {
+                --depth;
+                if (depth == 0) {
+                    ++pos;
+                    break;
+                }
+            } else if (c == ',' && depth == 1) {
+                expectKey = true;
+                field = -1;
+            }
+            ++pos;
+        }
+        if (depth != 0) {
+            return false;
+        }
+        visitor(begin, pos - begin, values);
+    }
+}
+
+// 映射时刻的数据文件和归档文件；保存采用临时文件+重命名，已映射的内容之后不会改变
+class JsonSnapshot : public StorageSnapshot {
+public:
+    // 归档文件的映射，键为(学期, 表)
+    using ArchiveFiles = std::map<std::pair<std::string, StorageTable>, std::pair<MappedFile, std::string>>;
+
+    JsonSnapshot(std::array<MappedFile, 3> files, std::array<std::string, 3> paths, std::vector<std::string> terms,
+                 ArchiveFiles archives)
+        : files_(std::move(files)), paths_(std::move(paths)), terms_(std::move(terms)), archives_(std::move(archives)) {}
+
+    bool scan(StorageTable table, const std::function<void(json&)>& visitor) override {
+        const MappedFile& file = files_[static_cast<size_t>(table)];
+        if (file.empty()) {
+            return false;
+        }
+        return DataManager::parseJsonRecords(file.data(), file.size(), visitor, paths_[static_cast<size_t>(table)]) > 0;
+    }
+
+    std::vector<std::string> archivedTerms() override {
+        return terms_;
+    }
+
+    bool scanArchive(StorageTable table, const std::string& term, const std::function<void(json&)>& visitor) override {
+        auto it = archives_.find({term, table});
+        if (it == archives_.end() || it->second.first.empty()) {
+            return false;
+        }
+        const MappedFile& file = it->second.first;
+        return DataManager::parseJsonRecords(file.data(), file.size(), visitor, it->second.second) > 0;
+    }
+
+private:
+    std::array<MappedFile, 3> files_;
+    std::array<std::string, 3> paths_;
+    std::vector<std::string> terms_;
+    ArchiveFiles archives_;
+};
+
+} // namespace
+
+bool JsonStorage::scan(StorageTable table, const RecordVisitor& visitor) {
+    return DataManager::getInstance().forEachJsonRecord(fileName(table), visitor);
+}
+
+std::optional<json> JsonStorage::fetch(StorageTable table, const json& key) {
+    DataManager& dataManager = DataManager::getInstance();
+    std::string filePath = dataManager.getDataFilePath(fileName(table));
+    std::string target = indexKey(table, key);
+
+    std::lock_guard<std::mutex> lock(indexMutex_);
+    RecordIndex& index = indexes_[static_cast<size_t>(table)];
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        uint64_t fingerprint = snapshot::sourceFingerprint({filePath});
+        if ((attempt > 0 || index.fingerprint != fingerprint || index.file.empty())
+            && !rebuildIndex(table, index, fingerprint)) {
+            // 无法建立索引时逐条解析查找，不能把记录当作不存在
+            std::optional<json> found;
+            dataManager.forEachJsonRecord(fileName(table), [&](json& record) {
+                if (!found && indexKey(table, record) == target) {
+                    found = std::move(record);
+                }
+            });
+            return found;
+        }
+        auto it = index.spans.find(target);
+        if (it == index.spans.end()) {
+            return std::nullopt; // 索引与文件一致，记录不存在
+        }
+        const char* begin = index.file.data() + it->second.first;
+        json record = json::parse(begin, begin + it->second.second, nullptr, false);
+        if (!record.is_discarded() && indexKey(table, record) == target) {
+            return std::make_optional<json>(std::move(record));
+        }
+        // 映射与指纹之间文件被替换，重建后再查一次
+    }
+    return std::nullopt;
+}
+
+bool JsonStorage::rebuildIndex(StorageTable table, RecordIndex& index, uint64_t fingerprint) {
+    DataManager& dataManager = DataManager::getInstance();
+    std::string filePath = dataManager.getDataFilePath(fileName(table));
+
+    std::vector<std::string> fields;
+    for (const auto& column : storageColumns(table)) {
+        if (column.primaryKey) {
+            fields.emplace_back(column.field);
+        }
+    }
+
+    RecordIndex rebuilt;
+    rebuilt.file = dataManager.fileExists(filePath) ? MappedFile(filePath) : MappedFile();
+    rebuilt.fingerprint = fingerprint;
+    bool scanned = scanSpans(rebuilt.file.data(), rebuilt.file.size(), fields,
+        [&](size_t offset, size_t length, const std::vector<std::string>& values) {
+            std::string key;
+            for (const auto& value : values) {
+                key += (key.empty() ? "" : "\x1f") + value;
+            }
+            rebuilt.spans[key] = {offset, length};
+        });
+    if (!scanned && !rebuilt.file.empty()) {
+        LOG_WARNING("建立记录偏移索引失败，文件格式不符，改为逐条解析: " + filePath);
+        return false; // 不完整的索引会把记录误判为不存在，保留原索引
+    }
+    index = std::move(rebuilt);
+    LOG_DEBUG("建立记录偏移索引: " + filePath + "，共 " + std::to_string(index.spans.size()) + " 条记录");
+    return true;
+}
+
+bool JsonStorage::replaceAll(StorageTable table, RowVersions* versions,
+                             const std::function<void(const RecordSink&)>& producer) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    DataManager& dataManager = DataManager::getInstance();
+    FileLock directoryLock(dataManager.getDataFilePath(DataManager::LOCK_FILE)); // 检查与替换期间排斥其他进程的写入
+
+    std::unordered_map<std::string, json> stored;
+    if (versions) {
+        dataManager.forEachJsonRecord(fileName(table), [&](json& record) {
+            std::string key = storageRowKey(table, record).dump();
+            stored.emplace(std::move(key), std::move(record));
+        });
+        if (!versionsMatch(table, stored, *versions)) {
+            return false;
+        }
+    }
+
+    std::string filePath = dataManager.getDataFilePath(fileName(table));
+    JsonStreamWriter writer(filePath, compact_);
+    RowVersions written;
+    producer([&](const json& record) {
+        writer.write(versions ? withReplacedVersion(table, record, stored, *versions, written) : record);
+    });
+    writer.commit();
+    dataManager.manifest().bump(table);
+    if (versions) {
+        *versions = std::move(written);
+    }
+
+    LOG_RATE_LIMITED(LogLevel::INFO, 10, "成功保存文件: " + filePath + "，共 " + std::to_string(writer.recordCount())
+        + " 条记录，" + std::to_string(writer.bytesWritten()) + " 字节");
+    return true;
+}
+
+bool JsonStorage::applyRows(StorageTable table, const std::vector<RowChange>& changes, std::vector<RowConflict>& conflicts) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    DataManager& dataManager = DataManager::getInstance();
+    FileLock directoryLock(dataManager.getDataFilePath(DataManager::LOCK_FILE)); // 读-改-写期间排斥其他进程的写入
+
+    // 主键 -> 修改；同一主键的多次修改以最后一次为准
+    std::unordered_map<std::string, const RowChange*> pending;
+    for (const auto& change : changes) {
+        pending[change.key.dump()] = &change;
+    }
+
+    std::string filePath = dataManager.getDataFilePath(fileName(table));
+    JsonStreamWriter writer(filePath, compact_);
+    size_t applied = 0;
+
+    // 原文件已映射，写入临时文件不影响读取；提交时才替换
+    dataManager.forEachJsonRecord(fileName(table), [&](json& record) {
+        auto it = pending.find(storageRowKey(table, record).dump());
+        if (it == pending.end()) {
+            writer.write(record);
+            return;
+        }
+        const RowChange& change = *it->second;
+        if (change.expectedVersion && *change.expectedVersion != recordVersion(record)) {
+            conflicts.push_back({change.key, std::make_optional<json>(record)}); // 保留存储中的记录
+            writer.write(record);
+        } else {
+            if (change.record) {
+                writer.write(*change.record);
+            }
+            ++applied;
+        }
+        pending.erase(it);
+    });
+
+    // 剩余的是存储中不存在的行；按changes的顺序追加新增记录，保证输出稳定
+    for (const auto& change : changes) {
+        auto it = pending.find(change.key.dump());
+        if (it == pending.end() || it->second != &change) {
+            continue;
+        }
+        if (change.expectedVersion && *change.expectedVersion != 0) {
+            conflicts.push_back({change.key, std::nullopt}); // 已被其他进程删除
+        } else if (change.record) {
+            writer.write(*change.record);
+            ++applied;
+        }
+        pending.erase(it);
+    }
+
+    if (applied == 0) {
+        return true; // 没有可写入的行，保持原文件不变
+    }
+    writer.commit();
+    dataManager.manifest().bump(table);
+
+    LOG_RATE_LIMITED(LogLevel::INFO, 10, "成功保存文件: " + filePath + "，共 " + std::to_string(writer.recordCount())
+        + " 条记录，" + std::to_string(writer.bytesWritten()) + " 字节");
+    return true;
+}
+
+uint64_t JsonStorage::dataStamp() {
+    DataManager& dataManager = DataManager::getInstance();
+    return snapshot::sourceFingerprint({
+        dataManager.getDataFilePath(fileName(StorageTable::USERS)),
+        dataManager.getDataFilePath(fileName(StorageTable::COURSES)),
+        dataManager.getDataFilePath(fileName(StorageTable::ENROLLMENTS))});
+}
+
+std::unique_ptr<StorageSnapshot> JsonStorage::openSnapshot() {
+    DataManager& dataManager = DataManager::getInstance();
+    std::array<MappedFile, 3> files;
+    std::array<std::string, 3> paths;
+    std::vector<std::string> terms;
+    JsonSnapshot::ArchiveFiles archives;
+    {
+        // 写入者在数据目录锁内提交，持锁映射全部文件即得到一致的时间点，映射完成后立即释放
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        FileLock directoryLock(dataManager.getDataFilePath(DataManager::LOCK_FILE));
+        for (StorageTable table : {StorageTable::USERS, StorageTable::COURSES, StorageTable::ENROLLMENTS}) {
+            size_t slot = static_cast<size_t>(table);
+            paths[slot] = dataManager.getDataFilePath(fileName(table));
+            if (dataManager.fileExists(paths[slot])) {
+                files[slot] = MappedFile(paths[slot]);
+            }
+        }
+        terms = archivedTerms();
+        for (const auto& term : terms) {
+            for (StorageTable table : {StorageTable::COURSES, StorageTable::ENROLLMENTS}) {
+                std::string path = dataManager.getDataFilePath(archiveFile(table, term));
+                if (dataManager.fileExists(path)) {
+                    archives[{term, table}] = {MappedFile(path), path};
+                }
+            }
+        }
+    }
+    return std::make_unique<JsonSnapshot>(std::move(files), std::move(paths), std::move(terms), std::move(archives));
+}
+
+std::vector<std::string> JsonStorage::archivedTerms() {
+    std::vector<std::string> terms;
+    fs::path root = DataManager::getInstance().getDataFilePath(ARCHIVE_DIRECTORY);
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(root, error)) {
+        if (!entry.is_directory()) {
+            continue;
+        }
+        std::optional<std::string> term = decodeTerm(entry.path().filename().string());
+        if (!term) {
+            LOG_WARNING("忽略无法识别的归档目录：" + entry.path().string());
+            continue;
+        }
+        terms.push_back(std::move(*term));
+    }
+    std::sort(terms.begin(), terms.end());
+    return terms;
+}
+
+bool JsonStorage::scanArchive(StorageTable table, const std::string& term, const RecordVisitor& visitor) {
+    DataManager& dataManager = DataManager::getInstance();
+    std::string relative = archiveFile(table, term);
+    if (!dataManager.fileExists(dataManager.getDataFilePath(relative))) {
+        return false;
+    }
+    return dataManager.forEachJsonRecord(relative, visitor);
+}
+
+bool JsonStorage::archiveRows(StorageTable table, const std::string& term, const std::vector<json>& records) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    DataManager& dataManager = DataManager::getInstance();
+    FileLock directoryLock(dataManager.getDataFilePath(DataManager::LOCK_FILE));
+
+    std::string relative = archiveFile(table, term);
+    std::string filePath = dataManager.getDataFilePath(relative);
+    if (!dataManager.createDirectory(fs::path(filePath).parent_path().string())) {
+        throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法创建归档目录: " + filePath);
+    }
+
+    std::unordered_map<std::string, const json*> incoming; // 主键 -> 新记录
+    for (const auto& record : records) {
+        incoming[storageRowKey(table, record).dump()] = &record;
+    }
+
+    JsonStreamWriter writer(filePath, compact_);
+    if (dataManager.fileExists(filePath)) {
+        dataManager.forEachJsonRecord(relative, [&](json& record) {
+            if (incoming.count(storageRowKey(table, record).dump()) == 0) {
+                writer.write(record);
+            }
+        });
+    }
+    for (const auto& record : records) {
+        writer.write(record);
+    }
+    writer.commit();
+
+    LOG_INFO("成功归档 " + std::to_string(records.size()) + " 条记录到: " + filePath + "，共 "
+        + std::to_string(writer.recordCount()) + " 条记录");
+    return true;
+}
+
+bool JsonStorage::replaceImage(const std::vector<TableImage>& images, bool withArchives) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    DataManager& dataManager = DataManager::getInstance();
+    FileLock directoryLock(dataManager.getDataFilePath(DataManager::LOCK_FILE));
+
+    // 先写出全部临时文件；任一producer失败时写入器析构删除临时文件，现有文件保持不变
+    std::vector<std::unique_ptr<JsonStreamWriter>> writers;
+    std::set<std::string> written; // 写入的文件（相对数据目录）
+    for (const auto& image : images) {
+        std::string relative = image.term.empty() ? fileName(image.table) : archiveFile(image.table, image.term);
+        std::string filePath = dataManager.getDataFilePath(relative);
+        if (!image.term.empty() && !dataManager.createDirectory(fs::path(filePath).parent_path().string())) {
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法创建归档目录: " + filePath);
+        }
+        auto writer = std::make_unique<JsonStreamWriter>(filePath, compact_);
+        image.producer([&writer](const json& record) {
+            writer->write(record);
+        });
+        writers.push_back(std::move(writer));
+        written.insert(relative);
+    }
+    for (StorageTable table : {StorageTable::USERS, StorageTable::COURSES, StorageTable::ENROLLMENTS}) {
+        if (written.insert(fileName(table)).second) {
+            writers.push_back(std::make_unique<JsonStreamWriter>(dataManager.getDataFilePath(fileName(table)), compact_));
+        }
+    }
+
+    for (auto& writer : writers) {
+        writer->commit();
+    }
+    for (StorageTable table : {StorageTable::USERS, StorageTable::COURSES, StorageTable::ENROLLMENTS}) {
+        dataManager.manifest().bump(table);
+    }
+
+    if (withArchives) {
+        // 删除镜像中没有的归档文件，删空的学期目录一并删除
+        fs::path root = dataManager.getDataFilePath(ARCHIVE_DIRECTORY);
+        std::error_code error;
+        for (const auto& termDirectory : fs::directory_iterator(root, error)) {
+            if (!termDirectory.is_directory()) {
+                continue;
+            }
+            for (StorageTable table : {StorageTable::COURSES, StorageTable::ENROLLMENTS}) {
+                fs::path relative = fs::path(ARCHIVE_DIRECTORY) / termDirectory.path().filename() / fileName(table);
+                if (written.count(relative.string()) == 0) {
+                    fs::remove(termDirectory.path() / fileName(table), error);
+                }
+            }
+            if (fs::is_empty(termDirectory.path(), error)) {
+                fs::remove(termDirectory.path(), error);
+            }
+        }
+    }
+
+    LOG_INFO("已整体替换数据目录内容，共写入 " + std::to_string(writers.size()) + " 个文件");
+    return true;
+}
+
+std::string JsonStorage::archiveFile(StorageTable table, const std::string& term) {
+    return (fs::path(ARCHIVE_DIRECTORY) / encodeTerm(term) / fileName(table)).string();
+}
+
+const char* JsonStorage::fileName(StorageTable table) {
+    switch (table) {
+        case StorageTable::USERS:
+            return "users.json";
+        case StorageTable::COURSES:
+            return "courses.json";
+        case StorageTable::ENROLLMENTS:
+            break;
+    }
+    return "enrollment.json";
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/JsonStreamWriter.h"
+#include "../../include/system/SystemException.h"
+
+#include <openssl/evp.h>
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#define HAS_POSIX_IO 1
+#else
+#define HAS_POSIX_IO 0
+#endif
+
+namespace fs = std::filesystem;
+
+// 序列化器的输出端：写入固定大小的缓冲区，满时整块写入文件（需要时先计算摘要、再压缩）
+class JsonStreamWriter::FileOutput : public nlohmann::detail::output_adapter_protocol<char> {
+public:
+    FileOutput(const std::string& path, bool gzip, bool digest) : path_(path) {
+        buffer_.reserve(BUFFER_SIZE);
+        if (gzip) {
+            // windowBits加16输出gzip格式（带文件头和CRC32），可直接用gzip工具解压
+            if (deflateInit2(&zstream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw SystemException(ErrorType::OPERATION_FAILED, "初始化压缩流失败: " + path);
+            }
+            gzip_ = true;
+            compressed_.resize(BUFFER_SIZE);
+        }
+        if (digest) {
+            digest_ = EVP_MD_CTX_new();
+            if (digest_ == nullptr || EVP_DigestInit_ex(digest_, EVP_sha256(), nullptr) != 1) {
+                release();
+                throw SystemException(ErrorType::OPERATION_FAILED, "初始化摘要计算失败: " + path);
+            }
+        }
+#if HAS_POSIX_IO
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) {
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法打开临时文件: " + path);
+        }
+#else
+        file_ = std::fopen(path.c_str(), "wb");
+        if (file_ == nullptr) {
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法打开临时文件: " + path);
+        }
+#endif
+    }
+
+    ~FileOutput() override {
+        release();
+#if HAS_POSIX_IO
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#else
+        if (file_ != nullptr) {
+            std::fclose(file_);
+        }
+#endif
+    }
+
+    void write_character(char c) override {
+        if (buffer_.size() == BUFFER_SIZE) {
+            drain();
+        }
+        buffer_.push_back(c);
+    }
+
+    void write_characters(const char* s, std::size_t length) override {
+        if (buffer_.size() + length > BUFFER_SIZE) {
+            drain();
+            if (length > BUFFER_SIZE) {
+                emit(s, length); // 超长字符串直接写出，不经过缓冲区
+                return;
+            }
+        }
+        buffer_.insert(buffer_.end(), s, s + length);
+    }
+
+    void write(const char* s) {
+        write_characters(s, std::strlen(s));
+    }
+
+    // 写出缓冲区并同步到磁盘，随后关闭文件
+    void finish() {
+        drain();
+        if (gzip_) {
+            deflateChunk(nullptr, 0, Z_FINISH);
+        }
+        if (digest_ != nullptr) {
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int length = 0;
+            EVP_DigestFinal_ex(digest_, digest, &length);
+            static const char HEX[] = "0123456789abcdef";
+            digestHex_.clear();
+            for (unsigned int i = 0; i < length; ++i) {
+                digestHex_.push_back(HEX[digest[i] >> 4]);
+                digestHex_.push_back(HEX[digest[i] & 0x0F]);
+            }
+        }
+#if HAS_POSIX_IO
+#if defined(__linux__)
+        int synced = ::fdatasync(fd_);
+#else
+        int synced = ::fsync(fd_);
+#endif
+        int closed = ::close(fd_);
+        fd_ = -1;
+        if (synced != 0 || closed != 0) {
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "同步文件失败: " + path_);
+        }
+#else
+        int closed = std::fclose(file_);
+        file_ = nullptr;
+        if (closed != 0) {
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "关闭文件失败: " + path_);
+        }
+#endif
+    }
+
+    // 压缩时缓冲区中的数据尚未确定压缩后的大小，不计入
+    uint64_t bytesWritten() const { return written_ + (gzip_ ? 0 : buffer_.size()); }
+
+    const std::string& digestHex() const { return digestHex_; }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    void drain() {
+        if (!buffer_.empty()) {
+            emit(buffer_.data(), buffer_.size());
+            buffer_.clear();
+        }
+    }
+
+    // 未压缩的内容经此写出
+    void emit(const char* data, size_t size) {
+        if (digest_ != nullptr) {
+            EVP_DigestUpdate(digest_, data, size);
+        }
+        if (gzip_) {
+            deflateChunk(data, size, Z_NO_FLUSH);
+        } else {
+            writeAll(data, size);
+        }
+    }
+
+    void deflateChunk(const char* data, size_t size, int flush) {
+        zstream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        zstream_.avail_in = static_cast<uInt>(size);
+        int rc;
+        do {
+            zstream_.next_out = reinterpret_cast<Bytef*>(compressed_.data());
+            zstream_.avail_out = static_cast<uInt>(compressed_.size());
+            rc = deflate(&zstream_, flush);
+            if (rc == Z_STREAM_ERROR) {
+                throw SystemException(ErrorType::OPERATION_FAILED, "压缩数据失败: " + path_);
+            }
+            writeAll(compressed_.data(), compressed_.size() - zstream_.avail_out);
+        } while (zstream_.avail_out == 0 || (flush == Z_FINISH && rc != Z_STREAM_END));
+    }
+
+    void release() {
+        if (gzip_) {
+            deflateEnd(&zstream_);
+            gzip_ = false;
+        }
+        if (digest_ != nullptr) {
+            EVP_MD_CTX_free(digest_);
+            digest_ = nullptr;
+        }
+    }
+
+    void writeAll(const char* data, size_t size) {
+#if HAS_POSIX_IO
+        while (size > 0) {
+            ssize_t n = ::write(fd_, data, size);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw SystemException(ErrorType::FILE_ACCESS_DENIED, "写入文件失败: " + path_ + " - " + std::strerror(errno));
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+            written_ += static_cast<uint64_t>(n);
+        }
+#else
+        if (std::fwrite(data, 1, size, file_) != size) {
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "写入文件失败: " + path_);
+        }
+        written_ += size;
+#endif
+    }
+
+    std::string path_;          // 临时文件路径
+    std::vector<char> buffer_;  // 待写出的数据
+    uint64_t written_ = 0;      // 已写入文件的字节数
+    bool gzip_ = false;         // 是否压缩输出
+    z_stream zstream_{};        // 压缩流状态
+    std::vector<char> compressed_;  // 压缩输出缓冲区
+    EVP_MD_CTX* digest_ = nullptr;  // 未压缩内容的SHA-256上下文
+    std::string digestHex_;     // finish()后得到的摘要
+#if HAS_POSIX_IO
+    int fd_ = -1;
+#else
+    std::FILE* file_ = nullptr;
+#endif
+};
+
+JsonStreamWriter::JsonStreamWriter(const std::string& path, bool compact)
+    : JsonStreamWriter(path, JsonStreamOptions{compact, false, false}) {}
+
+JsonStreamWriter::JsonStreamWriter(const std::string& path, const JsonStreamOptions& options)
+    : path_(path),
+      tempPath_(path + ".tmp"),
+      compact_(options.compact) {
+    fs::path parentPath = fs::path(path_).parent_path();
+    if (!parentPath.empty() && !fs::exists(parentPath)) {
+        fs::create_directories(parentPath);
+    }
+    output_ = std::make_shared<FileOutput>(tempPath_, options.gzip, options.digest);
+    serializer_ = std::make_unique<nlohmann::detail::serializer<nlohmann::json>>(output_, ' ');
+}
+
+JsonStreamWriter::~JsonStreamWriter() {
+    if (!committed_) {
+        serializer_.reset();
+        output_.reset();
+        std::error_code ec;
+        fs::remove(tempPath_, ec); // 放弃未完成的写入
+    }
+}
+
+void JsonStreamWriter::write(const nlohmann::json& record) {
+    if (compact_) {
+        output_->write(recordCount_ == 0 ? "[\n" : ",\n");
+        serializer_->dump(record, false, false, 0);
+    } else {
+        // 记录位于数组内一层，起始缩进为INDENT
+        output_->write(recordCount_ == 0 ? "[\n    " : ",\n    ");
+        serializer_->dump(record, true, false, INDENT, INDENT);
+    }
+    ++recordCount_;
+}
+
+void JsonStreamWriter::commit() {
+    output_->write(recordCount_ == 0 ? "[]" : "\n]");
+    output_->finish();
+    digest_ = output_->digestHex();
+
+    try {
+        fs::rename(tempPath_, path_); // 同一文件系统内的rename是原子的
+    } catch (const std::exception& e) {
+        throw SystemException(ErrorType::FILE_ACCESS_DENIED, std::string("重命名临时文件失败: ") + e.what());
+    }
+    committed_ = true;
+}
+
+uint64_t JsonStreamWriter::bytesWritten() const {
+    return output_->bytesWritten();
+}
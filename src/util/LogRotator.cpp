@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/LogRotator.h"
+#include "../../include/util/FileLock.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define CURRENT_PID() static_cast<long>(::getpid())
+#define HAS_LOCALTIME_R 1
+#else
+#include <process.h>
+#define CURRENT_PID() static_cast<long>(::_getpid())
+#define HAS_LOCALTIME_R 0
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* ROTATE_LOCK = "rotate.lock"; // 日志目录下串行化轮转的锁文件
+constexpr size_t STAMP_LENGTH = 15;                // 段标识中时间部分"YYYYMMDD-HHMMSS"的长度
+
+bool toLocalTime(std::time_t time, std::tm& local) {
+#if HAS_LOCALTIME_R
+    return localtime_r(&time, &local) != nullptr;
+#else
+    return localtime_s(&local, &time) == 0;
+#endif
+}
+
+// 文件名拆分为主名和扩展名（含点），没有扩展名时ext为空
+void splitName(const std::string& file, std::string& stem, std::string& ext) {
+    size_t dot = file.rfind('.');
+    stem = dot == std::string::npos ? file : file.substr(0, dot);
+    ext = dot == std::string::npos ? std::string() : file.substr(dot);
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool allDigits(const std::string& text, size_t begin, size_t end) {
+    return begin < end && std::all_of(text.begin() + begin, text.begin() + end, [](char c) {
+        return c >= '0' && c <= '9';
+    });
+}
+
+// 段标识中的序号，没有序号时为1（同一秒的第一个段不带序号），无法解析时为0
+unsigned long stampSequence(const std::string& stamp) {
+    if (stamp.size() <= STAMP_LENGTH + 1) {
+        return 1;
+    }
+    unsigned long sequence = 0;
+    const char* end = stamp.data() + stamp.size();
+    auto result = std::from_chars(stamp.data() + STAMP_LENGTH + 1, end, sequence);
+    return result.ec == std::errc() && result.ptr == end ? sequence : 0;
+}
+
+} // namespace
+
+LogRotator::LogRotator(std::string directory, std::vector<std::string> files, const LogRotationOptions& options)
+    : directory_(std::move(directory)), files_(std::move(files)), options_(options) {
+    // 补做上次运行遗留的压缩和清理
+    if (options_.compress) {
+        queueUncompressed();
+    }
+    if (options_.keep > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(Task{std::string(), std::chrono::steady_clock::now()});
+        if (!worker_.joinable()) { // queueUncompressed()可能已启动压缩线程
+            worker_ = std::thread(&LogRotator::run, this);
+        }
+    }
+}
+
+LogRotator::~LogRotator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void LogRotator::beginSegment(std::time_t start) {
+    segmentStart_ = start;
+    retryAfter_ = 0;
+
+    std::tm local{};
+    if (!toLocalTime(start, local)) {
+        nextMidnight_ = start + 24 * 60 * 60;
+        return;
+    }
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    local.tm_mday += 1;   // mktime会规范化跨月和跨年
+    local.tm_isdst = -1;  // 由mktime判断夏令时
+    nextMidnight_ = std::mktime(&local);
+}
+
+bool LogRotator::due(uint64_t size, std::time_t now) const {
+    if (now < retryAfter_) {
+        return false;
+    }
+    return (options_.maxBytes > 0 && size >= options_.maxBytes) || (options_.daily && now >= nextMidnight_);
+}
+
+bool LogRotator::rotate(const AppendFile& current, std::time_t now) {
+    std::string rotated;
+    try {
+        FileLock lock(pathOf(ROTATE_LOCK));
+        if (!current.isFile(pathOf(files_[0]))) {
+            return true; // 其他进程已完成轮转
+        }
+
+        // 以段的起始时间命名，同一秒内多次轮转时追加序号
+        std::tm local{};
+        char buffer[32] = "00000000-000000";
+        if (toLocalTime(segmentStart_, local)) {
+            std::strftime(buffer, sizeof(buffer), "%Y%m%d-%H%M%S", &local);
+        }
+        std::string stamp = buffer;
+        for (int n = 2; fs::exists(pathOf(segmentName(files_[0], stamp)))
+                        || fs::exists(pathOf(segmentName(files_[0], stamp)) + ".gz"); ++n) {
+            stamp = std::string(buffer) + "-" + std::to_string(n);
+        }
+
+        for (const auto& file : files_) {
+            std::error_code error;
+            if (fs::exists(pathOf(file), error)) {
+                fs::rename(pathOf(file), pathOf(segmentName(file, stamp)));
+            }
+        }
+        rotated = pathOf(segmentName(files_[0], stamp));
+    } catch (const std::exception&) {
+        retryAfter_ = now + RETRY_DELAY_SECONDS; // 继续写原文件，稍后再试
+        return false;
+    }
+
+    if (options_.compress || options_.keep > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(Task{options_.compress ? rotated : std::string(),
+                              std::chrono::steady_clock::now() + std::chrono::seconds(COMPRESS_DELAY_SECONDS)});
+        if (!worker_.joinable()) {
+            worker_ = std::thread(&LogRotator::run, this);
+        }
+    }
+    cv_.notify_one();
+    return true;
+}
+
+std::string LogRotator::pathOf(const std::string& file) const {
+    return (fs::path(directory_) / file).string();
+}
+
+std::string LogRotator::segmentName(const std::string& file, const std::string& stamp) {
+    std::string stem;
+    std::string ext;
+    splitName(file, stem, ext);
+    return stem + "." + stamp + ext;
+}
+
+std::string LogRotator::segmentStamp(const std::string& file, const std::string& name) {
+    std::string stem;
+    std::string ext;
+    splitName(file, stem, ext);
+    std::string prefix = stem + ".";
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+        return std::string();
+    }
+    std::string rest = name.substr(prefix.size());
+    if (endsWith(rest, ext + ".gz")) {
+        rest.resize(rest.size() - ext.size() - 3);
+    } else if (endsWith(rest, ext)) {
+        rest.resize(rest.size() - ext.size());
+    } else {
+        return std::string();
+    }
+    // 段标识必须是"YYYYMMDD-HHMMSS"或"YYYYMMDD-HHMMSS-序号"，排除当前文件和其他同前缀的文件
+    bool valid = rest.size() >= STAMP_LENGTH && allDigits(rest, 0, 8) && rest[8] == '-'
+        && allDigits(rest, 9, STAMP_LENGTH)
+        && (rest.size() == STAMP_LENGTH || (rest[STAMP_LENGTH] == '-' && allDigits(rest, STAMP_LENGTH + 1, rest.size())));
+    return valid ? rest : std::string();
+}
+
+void LogRotator::queueUncompressed() {
+    std::error_code error;
+    std::vector<std::string> segments;
+    for (const auto& entry : fs::directory_iterator(directory_, error)) {
+        std::string name = entry.path().filename().string();
+        std::string stem;
+        std::string ext;
+        splitName(files_[0], stem, ext);
+        if (endsWith(name, ext) && !segmentStamp(files_[0], name).empty()) {
+            segments.push_back(entry.path().string());
+        }
+    }
+    if (segments.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto notBefore = std::chrono::steady_clock::now() + std::chrono::seconds(COMPRESS_DELAY_SECONDS);
+    for (auto& segment : segments) {
+        tasks_.push_back(Task{std::move(segment), notBefore});
+    }
+    if (!worker_.joinable()) {
+        worker_ = std::thread(&LogRotator::run, this);
+    }
+}
+
+void LogRotator::applyRetention() {
+    if (options_.keep == 0) {
+        return;
+    }
+    std::error_code error;
+    std::vector<std::string> stamps;
+    for (const auto& entry : fs::directory_iterator(directory_, error)) {
+        std::string stamp = segmentStamp(files_[0], entry.path().filename().string());
+        if (!stamp.empty()) {
+            stamps.push_back(stamp);
+        }
+    }
+    // 段标识为"时间[-序号]"，同一时间的段按序号的数值排序
+    // segmentStamp已保证时间部分定长，序号无法解析（如溢出）时按0排在最前
+    std::sort(stamps.begin(), stamps.end(), [](const std::string& a, const std::string& b) {
+        int order = a.compare(0, STAMP_LENGTH, b, 0, STAMP_LENGTH);
+        if (order != 0) {
+            return order < 0;
+        }
+        unsigned long sequenceA = stampSequence(a);
+        unsigned long sequenceB = stampSequence(b);
+        return sequenceA != sequenceB ? sequenceA < sequenceB : a < b;
+    });
+    stamps.erase(std::unique(stamps.begin(), stamps.end()), stamps.end());
+    if (stamps.size() <= options_.keep) {
+        return;
+    }
+
+    // 段标识按时间排序，删除最早的段及其伴随文件
+    for (size_t i = 0; i + options_.keep < stamps.size(); ++i) {
+        for (const auto& file : files_) {
+            fs::remove(pathOf(segmentName(file, stamps[i])), error);
+        }
+        fs::remove(pathOf(segmentName(files_[0], stamps[i])) + ".gz", error);
+    }
+}
+
+bool LogRotator::compress(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false; // 已被其他进程压缩或删除
+    }
+    // 临时文件带进程ID，多个进程同时补做同一段的压缩时互不破坏，最后的改名是原子的
+    std::string target = path + ".gz";
+    std::string temporary = target + "." + std::to_string(CURRENT_PID()) + ".tmp";
+    gzFile out = gzopen(temporary.c_str(), "wb6");
+    if (out == nullptr) {
+        return false;
+    }
+
+    std::vector<char> buffer(64 * 1024);
+    bool written = true;
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize count = in.gcount();
+        if (count > 0 && gzwrite(out, buffer.data(), static_cast<unsigned>(count)) != static_cast<int>(count)) {
+            written = false;
+            break;
+        }
+    }
+    written = gzclose(out) == Z_OK && written && !in.bad();
+    in.close();
+
+    std::error_code error;
+    if (!written) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    fs::rename(temporary, target, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    fs::remove(path, error);
+    return true;
+}
+
+void LogRotator::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (tasks_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        auto notBefore = tasks_.front().notBefore;
+        if (std::chrono::steady_clock::now() < notBefore) {
+            cv_.wait_until(lock, notBefore);
+            continue;
+        }
+
+        Task task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        if (!task.path.empty()) {
+            compress(task.path);
+        }
+        applyRetention();
+        lock.lock();
+    }
+    // 未完成的压缩在下次启动时补做
+}
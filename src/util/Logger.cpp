@@ -15,41 +15,87 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "../../include/util/Logger.h"
-#include <iostream>
-#include <fstream>
-#include <sstream>
+#include "../../include/util/FlightRecorder.h"
 #include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
-#include <iomanip>
 #include <filesystem>
 #include <stdexcept>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define HAS_POSIX_IO 1
+#else
+#define HAS_POSIX_IO 0
+#endif
+
 namespace fs = std::filesystem;
 
 
-std::string getCurrentTimeString() {
-    // 获取系统时间
-    auto now = std::chrono::system_clock::now();
-    
-    // 转换为本地时间
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm* local_tm = std::localtime(&now_time_t);
-    if (!local_tm) {
-        return "ERROR_TIME";
+namespace {
+
+constexpr size_t TIMESTAMP_LENGTH = 23; // "YYYY-MM-DD HH:MM:SS.mmm"
+
+// 线程局部的时间戳缓存：秒数变化时才转换本地时间并格式化日期时间部分，其余情况只改写毫秒
+// 各线程使用自己的缓存和localtime_r，不共享std::localtime的静态结果，也不分配内存
+class TimestampCache {
+public:
+    const char* format(std::chrono::system_clock::time_point now) {
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+        int64_t second = ms / 1000;
+        int millis = static_cast<int>(ms % 1000);
+        if (millis < 0) { // 1970年以前的时间
+            millis += 1000;
+            --second;
+        }
+        
+        if (second != second_) {
+            std::time_t time = static_cast<std::time_t>(second);
+            std::tm local{};
+#if HAS_POSIX_IO
+            bool converted = localtime_r(&time, &local) != nullptr;
+#else
+            bool converted = localtime_s(&local, &time) == 0;
+#endif
+            if (!converted || std::strftime(buffer_, sizeof(buffer_), "%Y-%m-%d %H:%M:%S", &local) != TIMESTAMP_LENGTH - 4) {
+                std::memcpy(buffer_, "0000-00-00 00:00:00", TIMESTAMP_LENGTH - 4);
+            }
+            buffer_[TIMESTAMP_LENGTH - 4] = '.';
+            buffer_[TIMESTAMP_LENGTH] = '\0';
+            second_ = second;
+        }
+        
+        buffer_[TIMESTAMP_LENGTH - 3] = static_cast<char>('0' + millis / 100);
+        buffer_[TIMESTAMP_LENGTH - 2] = static_cast<char>('0' + millis / 10 % 10);
+        buffer_[TIMESTAMP_LENGTH - 1] = static_cast<char>('0' + millis % 10);
+        return buffer_;
     }
-    
-    // 获取毫秒部分
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-    
-    // 格式化时间字符串
-    std::stringstream ss;
-    ss << std::put_time(local_tm, "%Y-%m-%d %H:%M:%S")
-       << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    
-    return ss.str();
+
+private:
+    int64_t second_ = INT64_MIN;          // 缓存对应的秒数
+    char buffer_[TIMESTAMP_LENGTH + 1] = {};
+};
+
+thread_local TimestampCache timestampCache;
+
+// "[时间戳] [级别] 消息"，一次分配得到完整的日志行
+std::string formatLine(const char* levelTag, const std::string& message) {
+    const char* timestamp = timestampCache.format(std::chrono::system_clock::now());
+    size_t tagLength = std::strlen(levelTag);
+    std::string line;
+    line.reserve(TIMESTAMP_LENGTH + tagLength + message.size() + 5);
+    line += '[';
+    line.append(timestamp, TIMESTAMP_LENGTH);
+    line += "] [";
+    line.append(levelTag, tagLength);
+    line += "] ";
+    line += message;
+    return line;
 }
 
+} // namespace
+
 Logger& Logger::getInstance() {
     static Logger instance; // Meyer's单例模式
     return instance;
@@ -58,15 +104,13 @@ Logger& Logger::getInstance() {
 Logger::Logger() : initialized_(false), logLevel_(LogLevel::INFO) {}
 
 Logger::~Logger() {
-    // 确保所有文件都关闭
-    if (infoFile_.is_open()) infoFile_.close();
-    if (warnFile_.is_open()) warnFile_.close();
-    if (errorFile_.is_open()) errorFile_.close();
-    if (criticalFile_.is_open()) criticalFile_.close();
-    if (debugFile_.is_open()) debugFile_.close();   
+    // 写出异步缓冲区中的剩余日志
+    stopAsync();
+
+    // AppendFile析构时关闭文件
 }
 
-bool Logger::initialize(const std::string& logDir, LogLevel logLevel) {
+bool Logger::initialize(const std::string& logDir, LogLevel logLevel, const LogRotationOptions& rotation) {
     try {
         // 防止重复初始化
         if (initialized_) {
@@ -81,25 +125,17 @@ bool Logger::initialize(const std::string& logDir, LogLevel logLevel) {
             fs::create_directories(logDir);
         }
         
-        // 构建日志文件路径
-        std::string infoPath = logDir + "/Info.log";
-        std::string warnPath = logDir + "/Warn.log";
-        std::string errorPath = logDir + "/Error.log";
-        std::string criticalPath = logDir + "/Critical.log";
-        std::string debugPath = logDir + "/Debug.log";
-        
-        // 打开日志文件，使用追加模式
-        infoFile_.open(infoPath, std::ios::app);
-        warnFile_.open(warnPath, std::ios::app);
-        errorFile_.open(errorPath, std::ios::app);
-        criticalFile_.open(criticalPath, std::ios::app);
-        debugFile_.open(debugPath, std::ios::app);  
-        
-        // 检查文件是否成功打开
-        if (!infoFile_.is_open() || !warnFile_.is_open() || !errorFile_.is_open() || !criticalFile_.is_open() || !debugFile_.is_open()) {
+        // 打开日志文件和索引文件，使用追加模式
+        logDir_ = logDir;
+        if (!openFiles()) {
             return false;
         }
         
+        // 已有日志文件时，当前段从它最后修改的时间算起，跨天后的首次写入即轮转
+        rotator_ = std::make_unique<LogRotator>(logDir, std::vector<std::string>{LOG_FILE, indexFileName(LogLevel::WARNING),
+            indexFileName(LogLevel::ERROR), indexFileName(LogLevel::CRITICAL)}, rotation);
+        rotator_->beginSegment(logFile_->size() > 0 ? logFile_->modified() : std::time(nullptr));
+        
         // 初始化成功
         initialized_ = true;
         
@@ -115,113 +151,264 @@ bool Logger::initialize(const std::string& logDir, LogLevel logLevel) {
     }
 }
 
-void Logger::debug(const std::string& message) {
-    if (logLevel_ > LogLevel::DEBUG) return;
-    
-    std::string logMsg = "[" + getCurrentTimeString() + "] [DEBUG] " + message;
-    
-    try {
-        if (initialized_ && infoFile_.is_open()) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            debugFile_ << logMsg << std::endl;
+bool Logger::openFiles() {
+    auto logFile = std::make_unique<AppendFile>(logDir_ + "/" + LOG_FILE);
+    if (!logFile->isOpen()) {
+        return false;
+    }
+    std::array<std::unique_ptr<AppendFile>, 3> indexFiles;
+    for (LogLevel level : {LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL}) {
+        auto& indexFile = indexFiles[static_cast<size_t>(level) - static_cast<size_t>(LogLevel::WARNING)];
+        indexFile = std::make_unique<AppendFile>(logDir_ + "/" + indexFileName(level));
+        if (!indexFile->isOpen()) {
+            return false;
         }
-    } catch (...) {
-        // 忽略写入错误，确保不影响程序运行
     }
+    logFile_ = std::move(logFile);
+    indexFiles_ = std::move(indexFiles);
+    return true;
+}
+
+void Logger::rotateIfDue(size_t incoming) {
+    if (!rotator_) {
+        return;
+    }
+    uint64_t size = logFile_->size();
+    std::time_t now = std::time(nullptr);
+    if (size == 0 || !rotator_->due(size + incoming, now)) {
+        return;
+    }
+    // 改名失败时继续写原文件；重新打开失败时保留原文件描述符，内容写入已改名的段
+    if (rotator_->rotate(*logFile_, now) && openFiles()) {
+        rotator_->beginSegment(now);
+    }
+}
+
+void Logger::debug(const std::string& message) {
+    if (!isEnabled(LogLevel::DEBUG)) return;
+    
+    FlightRecorder::recordText(LogLevel::DEBUG, message);
+    dispatch(LogLevel::DEBUG, formatLine("DEBUG", message));
 }
 
 void Logger::info(const std::string& message) {
-    if (logLevel_ > LogLevel::INFO) return;  // 如果日志级别大于INFO，则不记录
+    if (!isEnabled(LogLevel::INFO)) return;  // 如果日志级别大于INFO，则不记录
     
-    std::string logMsg = "[" + getCurrentTimeString() + "] [INFO] " + message;
+    FlightRecorder::recordText(LogLevel::INFO, message);
+    dispatch(LogLevel::INFO, formatLine("INFO", message));
+}
+
+void Logger::warning(const std::string& message) {
+    if (!isEnabled(LogLevel::WARNING)) return;
     
-    try {
-        if (initialized_ && infoFile_.is_open()) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            infoFile_ << logMsg << std::endl;
-            // 同时写入下级日志文件
-            if (debugFile_.is_open()) {
-                debugFile_ << logMsg << std::endl;
+    FlightRecorder::recordText(LogLevel::WARNING, message);
+    dispatch(LogLevel::WARNING, formatLine("WARNING", message));
+}
+
+void Logger::error(const std::string& message) {
+    if (!isEnabled(LogLevel::ERROR)) return;
+    
+    FlightRecorder::recordText(LogLevel::ERROR, message);
+    dispatch(LogLevel::ERROR, formatLine("ERROR", message));
+}
+
+void Logger::critical(const std::string& message) {
+    if (!isEnabled(LogLevel::CRITICAL)) return;
+    
+    FlightRecorder::recordText(LogLevel::CRITICAL, message);
+    dispatch(LogLevel::CRITICAL, formatLine("CRITICAL", message));
+    // 严重错误之后进程可能随即退出，等待其写入文件
+    flush();
+    FlightRecorder::getInstance().dumpOnFailure("严重错误");
+}
+
+void Logger::log(LogLevel level, const std::string& message) {
+    switch (level) {
+        case LogLevel::DEBUG: debug(message); break;
+        case LogLevel::INFO: info(message); break;
+        case LogLevel::WARNING: warning(message); break;
+        case LogLevel::ERROR: error(message); break;
+        case LogLevel::CRITICAL: critical(message); break;
+    }
+}
+
+void Logger::dispatch(LogLevel level, std::string line) {
+    if (!initialized_) {
+        return;
+    }
+    
+    if (async_.load(std::memory_order_acquire)) {
+        Record record{level, std::move(line)};
+        while (!buffer_->tryPush(record)) {
+            if (overflow_ != LogOverflowPolicy::BLOCK) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
             }
+            // 等待写入线程写完一批腾出空间
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCv_.notify_one();
+            progressCv_.wait_for(lock, std::chrono::milliseconds(1));
         }
+        enqueued_.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writeRecord(level, line);
+        flushFiles();
     } catch (...) {
         // 忽略写入错误，确保不影响程序运行
     }
 }
 
-void Logger::warning(const std::string& message) {
-    if (logLevel_ > LogLevel::WARNING) return;
-    
-    std::string logMsg = "[" + getCurrentTimeString() + "] [WARNING] " + message;
+void Logger::writeRecord(LogLevel level, const std::string& line) {
+    if (level >= LogLevel::WARNING) {
+        pendingIndex_.emplace_back(level, pending_.size());
+    }
     
-    try {
-        if (initialized_ && warnFile_.is_open()) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            warnFile_ << logMsg << std::endl;
-            // 同时写入下级日志文件
-            if (infoFile_.is_open()) {
-                infoFile_ << logMsg << std::endl;
-            }
-            if (debugFile_.is_open()) {
-                debugFile_ << logMsg << std::endl;
+    // 日志内容中的换行转义为\n，保证一条记录占一行
+    if (line.find('\n') == std::string::npos) {
+        pending_ += line;
+    } else {
+        for (char c : line) {
+            if (c == '\n') {
+                pending_ += "\\n";
+            } else {
+                pending_ += c;
             }
         }
-    } catch (...) {
-        // 忽略写入错误，确保不影响程序运行
     }
+    pending_ += '\n';
 }
 
-void Logger::error(const std::string& message) {
-    if (logLevel_ > LogLevel::ERROR) return;
+void Logger::flushFiles() {
+    if (pending_.empty()) {
+        return;
+    }
     
-    std::string logMsg = "[" + getCurrentTimeString() + "] [ERROR] " + message;
+    rotateIfDue(pending_.size());
     
-    try {
-        if (initialized_ && errorFile_.is_open()) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            errorFile_ << logMsg << std::endl;
-            // 同时写入下级日志文件
-            if (warnFile_.is_open()) {
-                warnFile_ << logMsg << std::endl;
+    uint64_t base = 0;
+    bool written = logFile_->append(pending_.data(), pending_.size(), base);
+    pending_.clear();
+    if (written) {
+        // 偏移以8字节小端序追加，按级别查看时无需扫描整个日志文件；每个索引文件每批只写一次
+        std::array<std::string, 3> entries;
+        for (const auto& [level, relative] : pendingIndex_) {
+            uint64_t offset = base + relative;
+            std::string& entry = entries[static_cast<size_t>(level) - static_cast<size_t>(LogLevel::WARNING)];
+            for (int i = 0; i < 8; ++i) {
+                entry += static_cast<char>(offset >> (8 * i));
             }
-            if (infoFile_.is_open()) {
-                infoFile_ << logMsg << std::endl;
-            }
-            if (debugFile_.is_open()) {
-                debugFile_ << logMsg << std::endl;
+        }
+        for (size_t i = 0; i < entries.size(); ++i) {
+            uint64_t ignored;
+            if (!entries[i].empty()) {
+                indexFiles_[i]->append(entries[i].data(), entries[i].size(), ignored);
             }
         }
-    } catch (...) {
-        // 忽略写入错误，确保不影响程序运行
     }
+    pendingIndex_.clear();
 }
 
-void Logger::critical(const std::string& message) {
-    if (logLevel_ > LogLevel::CRITICAL) return;
+bool Logger::startAsync(const AsyncLogOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!initialized_) {
+        return false;
+    }
+    if (async_.load()) {
+        return true;
+    }
     
-    std::string logMsg = "[" + getCurrentTimeString() + "] [CRITICAL] " + message;
+    buffer_ = std::make_unique<MpscRingBuffer<Record>>(options.capacity);
+    overflow_ = options.overflow;
+    stopping_ = false;
+    writer_ = std::thread(&Logger::run, this);
+    async_.store(true, std::memory_order_release);
+    return true;
+}
+
+void Logger::stopAsync() {
+    if (!async_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wakeCv_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
     
+    // 切换前已读到异步标志的生产者可能在写入线程退出后才放入缓冲区，在此补写
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (drain() > 0) {
+    }
+}
+
+void Logger::flush() {
+    if (!async_.load(std::memory_order_acquire)) {
+        return; // 同步模式每条日志写入后即刷新
+    }
+    
+    uint64_t target = enqueued_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    wakeCv_.notify_one();
+    while (written_.load(std::memory_order_acquire) < target && async_.load(std::memory_order_acquire)) {
+        progressCv_.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS));
+    }
+}
+
+uint64_t Logger::droppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void Logger::run() {
+    while (true) {
+        if (drain() > 0) {
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        if (stopping_) {
+            break; // 退出前的最后一次drain已写空缓冲区
+        }
+        wakeCv_.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS), [this] {
+            return stopping_ || buffer_->readable();
+        });
+    }
+}
+
+size_t Logger::drain() {
+    size_t count = 0;
+    Record record;
     try {
-        if (initialized_ && errorFile_.is_open()) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            criticalFile_ << logMsg << std::endl;
-            // 同时写入下级日志文件
-            if (warnFile_.is_open()) {
-                warnFile_ << logMsg << std::endl;
-            }
-            if (infoFile_.is_open()) {
-                infoFile_ << logMsg << std::endl;
-            }
-            if (debugFile_.is_open()) {
-                debugFile_ << logMsg << std::endl;
-            }
-            if (errorFile_.is_open()) {
-                errorFile_ << logMsg << std::endl;
-            }
+        while (count < BATCH_SIZE && buffer_->tryPop(record)) {
+            writeRecord(record.level, record.line);
+            ++count;
+        }
+        
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (overflow_ == LogOverflowPolicy::COUNT && dropped != reportedDrops_ && !buffer_->readable()) {
+            writeRecord(LogLevel::WARNING, formatLine("WARNING", "日志缓冲区已满，丢弃了 "
+                + std::to_string(dropped - reportedDrops_) + " 条日志"));
+            reportedDrops_ = dropped;
+            flushFiles();
+        } else if (count > 0) {
+            flushFiles();
         }
     } catch (...) {
         // 忽略写入错误，确保不影响程序运行
     }
+    
+    if (count > 0) {
+        written_.fetch_add(count, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        progressCv_.notify_all();
+    }
+    return count;
 }
 
 void Logger::setLogLevel(LogLevel level) {
@@ -239,6 +426,15 @@ std::string Logger::logLevelToString(LogLevel level) {
     }
 }
 
+const char* Logger::indexFileName(LogLevel level) {
+    switch (level) {
+        case LogLevel::WARNING: return "Warn.idx";
+        case LogLevel::ERROR: return "Error.idx";
+        case LogLevel::CRITICAL: return "Critical.idx";
+        default: return nullptr;
+    }
+}
+
 LogLevel Logger::stringToLogLevel(const std::string& levelStr) {
     if (levelStr == "DEBUG") return LogLevel::DEBUG;
     else if (levelStr == "INFO") return LogLevel::INFO;
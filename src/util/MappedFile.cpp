@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/MappedFile.h"
+#include "../../include/system/SystemException.h"
+
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAS_MMAP 1
+#else
+#include <fstream>
+#include <iterator>
+#define HAS_MMAP 0
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#if HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法打开文件: " + path);
+    }
+    
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法获取文件信息: " + path);
+    }
+    
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法映射文件: " + path);
+        }
+        // 顺序读取，提示内核预读
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(addr);
+        mapped_ = true;
+    }
+    // 映射建立后即可关闭文件描述符；文件被重命名替换时，映射仍指向原内容
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法打开文件: " + path);
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_),
+      size_(other.size_),
+      mapped_(other.mapped_),
+      buffer_(std::move(other.buffer_)) {
+    if (!mapped_) {
+        data_ = buffer_.data();
+    }
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.mapped_ = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        mapped_ = other.mapped_;
+        buffer_ = std::move(other.buffer_);
+        if (!mapped_) {
+            data_ = buffer_.data();
+        }
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_ = false;
+    }
+    return *this;
+}
+
+void MappedFile::release() {
+#if HAS_MMAP
+    if (mapped_ && data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/PasswordHasher.h"
+#include "../../include/system/SystemException.h"
+
+// OpenSSL库头文件
+#include <openssl/sha.h>
+#include <openssl/evp.h>
+#include <openssl/crypto.h>
+#include <openssl/opensslv.h> // 用于版本检查
+
+namespace {
+
+// 每个线程持有一个摘要上下文，避免每次哈希都分配和释放EVP_MD_CTX
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+class DigestContext {
+public:
+    DigestContext() : ctx_(EVP_MD_CTX_new()), md_(EVP_MD_fetch(nullptr, "SHA256", nullptr)) {
+        if (ctx_ == nullptr || md_ == nullptr) {
+            EVP_MD_CTX_free(ctx_);
+            EVP_MD_free(md_);
+            throw SystemException(ErrorType::OPERATION_FAILED, "OpenSSL错误：无法创建EVP_MD_CTX");
+        }
+    }
+
+    ~DigestContext() {
+        EVP_MD_CTX_free(ctx_);
+        EVP_MD_free(md_);
+    }
+
+    DigestContext(const DigestContext&) = delete;
+
+    DigestContext& operator=(const DigestContext&) = delete;
+
+    void digest(std::string_view password, std::string_view salt, unsigned char* out) {
+        // EVP_DigestInit_ex会重置已有上下文，不会重新分配
+        if (EVP_DigestInit_ex(ctx_, md_, nullptr) != 1) {
+            throw SystemException(ErrorType::OPERATION_FAILED, "OpenSSL错误：无法初始化摘要");
+        }
+        // 分两次更新，省去password + salt的临时字符串
+        if (EVP_DigestUpdate(ctx_, password.data(), password.size()) != 1 ||
+            EVP_DigestUpdate(ctx_, salt.data(), salt.size()) != 1) {
+            throw SystemException(ErrorType::OPERATION_FAILED, "OpenSSL错误：无法更新摘要");
+        }
+        unsigned int hashLen = PasswordHasher::DIGEST_SIZE;
+        if (EVP_DigestFinal_ex(ctx_, out, &hashLen) != 1) {
+            throw SystemException(ErrorType::OPERATION_FAILED, "OpenSSL错误：无法完成摘要");
+        }
+    }
+
+private:
+    EVP_MD_CTX* ctx_;
+    EVP_MD* md_;
+};
+#else
+class DigestContext {
+public:
+    void digest(std::string_view password, std::string_view salt, unsigned char* out) {
+        // 旧版OpenSSL使用SHA256接口，上下文在栈上，无需分配
+        SHA256_CTX sha256;
+        SHA256_Init(&sha256);
+        SHA256_Update(&sha256, password.data(), password.size());
+        SHA256_Update(&sha256, salt.data(), salt.size());
+        SHA256_Final(out, &sha256);
+    }
+};
+#endif
+
+DigestContext& threadContext() {
+    thread_local DigestContext context;
+    return context;
+}
+
+constexpr char HEX_CHARS[] = "0123456789abcdef";
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+PasswordHasher::Digest PasswordHasher::digest(std::string_view password, std::string_view salt) {
+    Digest result;
+    threadContext().digest(password, salt, result.data());
+    return result;
+}
+
+std::string PasswordHasher::hashHex(std::string_view password, std::string_view salt) {
+    return toHex(digest(password, salt));
+}
+
+bool PasswordHasher::verify(std::string_view password, std::string_view salt, std::string_view storedHash) {
+    Digest expected;
+    if (!fromHex(storedHash, expected)) {
+        return false;
+    }
+    Digest actual = digest(password, salt);
+    return CRYPTO_memcmp(actual.data(), expected.data(), DIGEST_SIZE) == 0;
+}
+
+std::string PasswordHasher::toHex(const Digest& digest) {
+    std::string hex(DIGEST_SIZE * 2, '0');
+    for (size_t i = 0; i < DIGEST_SIZE; ++i) {
+        hex[i * 2] = HEX_CHARS[digest[i] >> 4];
+        hex[i * 2 + 1] = HEX_CHARS[digest[i] & 0x0f];
+    }
+    return hex;
+}
+
+bool PasswordHasher::fromHex(std::string_view hex, Digest& digest) {
+    if (hex.size() != DIGEST_SIZE * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < DIGEST_SIZE; ++i) {
+        int high = hexValue(hex[i * 2]);
+        int low = hexValue(hex[i * 2 + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        digest[i] = static_cast<unsigned char>((high << 4) | low);
+    }
+    return true;
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/SnapshotFile.h"
+#include "../../include/system/SystemException.h"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char MAGIC[8] = {'C', 'S', 'S', 'N', 'A', 'P', 'S', 'H'};
+constexpr uint32_t ENDIAN_MARKER = 0x01020304;
+
+struct FileHeader {
+    char magic[8];            // 魔数
+    uint32_t version;         // 格式版本
+    uint32_t endianMarker;    // 字节序标记
+    uint32_t sectionCount;    // 段数量
+    uint32_t tableChecksum;   // 段表的CRC32
+    uint64_t sourceStamp;     // 生成快照时JSON数据文件的指纹
+    uint64_t reserved[2];
+};
+static_assert(sizeof(FileHeader) == 48, "快照文件头必须为48字节");
+
+struct SectionEntry {
+    uint32_t id;              // 段类型
+    uint32_t recordSize;      // 单条记录字节数
+    uint64_t offset;          // 段数据在文件中的偏移
+    uint64_t length;          // 段数据字节数
+    uint64_t recordCount;     // 记录条数
+    uint32_t checksum;        // 段数据的CRC32
+    uint32_t reserved;
+};
+static_assert(sizeof(SectionEntry) == 40, "快照段表项必须为40字节");
+
+struct StringRecord {
+    uint64_t offset;          // 在STRING_DATA中的偏移
+    uint32_t length;          // 字节数
+    uint32_t reserved;
+};
+static_assert(sizeof(StringRecord) == 16, "字符串索引记录必须为16字节");
+
+constexpr uint64_t align8(uint64_t value) {
+    return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+} // namespace
+
+namespace snapshot {
+
+uint32_t crc32(const char* data, size_t length) {
+    static const std::array<uint32_t, 256> table = makeCrcTable();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+uint64_t sourceFingerprint(const std::vector<std::string>& paths) {
+    // FNV-1a组合各文件的大小和修改时间
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    for (const auto& path : paths) {
+        std::error_code ec;
+        uint64_t size = fs::file_size(path, ec);
+        if (ec) {
+            mix(0xFFFFFFFFFFFFFFFFULL); // 文件不存在
+            continue;
+        }
+        auto mtime = fs::last_write_time(path, ec);
+        mix(size);
+        mix(ec ? 0 : static_cast<uint64_t>(mtime.time_since_epoch().count()));
+    }
+    return hash;
+}
+
+} // namespace snapshot
+
+uint32_t SnapshotWriter::intern(const std::string& value) {
+    auto it = stringIds_.find(value);
+    if (it != stringIds_.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    auto inserted = stringIds_.emplace(value, id).first;
+    strings_.push_back(inserted->first);
+    return id;
+}
+
+void SnapshotWriter::addRawSection(SnapshotSection id, uint32_t recordSize, uint64_t recordCount, std::vector<char> payload) {
+    sections_.push_back({id, recordSize, recordCount, std::move(payload)});
+}
+
+void SnapshotWriter::writeToFile(const std::string& path, uint64_t sourceStamp) {
+    // 字符串表最后生成，保证包含所有段引用的字符串
+    std::vector<StringRecord> index;
+    std::vector<char> data;
+    index.reserve(strings_.size());
+    for (std::string_view value : strings_) {
+        index.push_back({static_cast<uint64_t>(data.size()), static_cast<uint32_t>(value.size()), 0});
+        data.insert(data.end(), value.begin(), value.end());
+    }
+
+    std::vector<Section> sections;
+    sections.reserve(sections_.size() + 2);
+    {
+        std::vector<char> indexPayload(index.size() * sizeof(StringRecord));
+        if (!index.empty()) {
+            std::memcpy(indexPayload.data(), index.data(), indexPayload.size());
+        }
+        sections.push_back({SnapshotSection::STRING_INDEX, sizeof(StringRecord), index.size(), std::move(indexPayload)});
+        sections.push_back({SnapshotSection::STRING_DATA, 1, data.size(), std::move(data)});
+    }
+    for (auto& section : sections_) {
+        sections.push_back(std::move(section));
+    }
+    sections_.clear();
+
+    // 计算段表
+    std::vector<SectionEntry> table;
+    uint64_t offset = align8(sizeof(FileHeader) + sections.size() * sizeof(SectionEntry));
+    for (const auto& section : sections) {
+        SectionEntry entry{};
+        entry.id = static_cast<uint32_t>(section.id);
+        entry.recordSize = section.recordSize;
+        entry.offset = offset;
+        entry.length = section.payload.size();
+        entry.recordCount = section.recordCount;
+        entry.checksum = snapshot::crc32(section.payload.data(), section.payload.size());
+        table.push_back(entry);
+        offset = align8(offset + entry.length);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = SnapshotReader::FORMAT_VERSION;
+    header.endianMarker = ENDIAN_MARKER;
+    header.sectionCount = static_cast<uint32_t>(table.size());
+    header.tableChecksum = snapshot::crc32(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionEntry));
+    header.sourceStamp = sourceStamp;
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "无法打开临时文件: " + tempPath);
+        }
+
+        const char padding[8] = {};
+        uint64_t written = 0;
+        auto write = [&](const char* bytes, uint64_t length) {
+            file.write(bytes, static_cast<std::streamsize>(length));
+            written += length;
+        };
+        auto pad = [&]() {
+            write(padding, align8(written) - written);
+        };
+
+        write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionEntry));
+        pad();
+        for (const auto& section : sections) {
+            write(section.payload.data(), section.payload.size());
+            pad();
+        }
+
+        if (!file) {
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "写入快照文件失败: " + tempPath);
+        }
+    }
+
+    try {
+        fs::rename(tempPath, path);
+    } catch (const std::exception& e) {
+        throw SystemException(ErrorType::FILE_ACCESS_DENIED, std::string("重命名快照文件失败: ") + e.what());
+    }
+}
+
+SnapshotReader::SnapshotReader(const std::string& path) : file_(path) {
+    if (file_.size() < sizeof(FileHeader)) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "快照文件过短: " + path);
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.endianMarker != ENDIAN_MARKER) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "不是有效的快照文件: " + path);
+    }
+    if (header.version != FORMAT_VERSION) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "快照版本不受支持: " + std::to_string(header.version));
+    }
+
+    uint64_t tableSize = static_cast<uint64_t>(header.sectionCount) * sizeof(SectionEntry);
+    if (sizeof(FileHeader) + tableSize > file_.size()) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "快照段表越界: " + path);
+    }
+    const char* tableData = file_.data() + sizeof(FileHeader);
+    if (snapshot::crc32(tableData, tableSize) != header.tableChecksum) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "快照段表校验失败: " + path);
+    }
+
+    for (uint32_t i = 0; i < header.sectionCount; ++i) {
+        SectionEntry entry;
+        std::memcpy(&entry, tableData + i * sizeof(SectionEntry), sizeof(entry));
+        if (entry.offset > file_.size() || entry.length > file_.size() - entry.offset ||
+            (entry.recordSize > 0 && entry.recordCount * entry.recordSize != entry.length)) {
+            throw SystemException(ErrorType::FILE_CORRUPTED, "快照段越界: " + std::to_string(entry.id));
+        }
+        const char* data = file_.data() + entry.offset;
+        if (snapshot::crc32(data, entry.length) != entry.checksum) {
+            throw SystemException(ErrorType::FILE_CORRUPTED, "快照段校验失败: " + std::to_string(entry.id));
+        }
+        sections_[entry.id] = {data, entry.recordSize, entry.recordCount};
+    }
+
+    sourceStamp_ = header.sourceStamp;
+
+    // 校验字符串索引不越界，之后string()可以直接取用
+    const SectionView& index = section(SnapshotSection::STRING_INDEX);
+    const SectionView& data = section(SnapshotSection::STRING_DATA);
+    if (index.recordSize != sizeof(StringRecord)) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "快照字符串索引格式错误");
+    }
+    for (uint64_t i = 0; i < index.recordCount; ++i) {
+        StringRecord record;
+        std::memcpy(&record, index.data + i * sizeof(StringRecord), sizeof(record));
+        if (record.offset > data.recordCount || record.length > data.recordCount - record.offset) {
+            throw SystemException(ErrorType::FILE_CORRUPTED, "快照字符串越界");
+        }
+    }
+}
+
+std::string_view SnapshotReader::string(uint32_t ref) const {
+    const SectionView& index = section(SnapshotSection::STRING_INDEX);
+    if (ref >= index.recordCount) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "快照字符串引用越界: " + std::to_string(ref));
+    }
+    StringRecord record;
+    std::memcpy(&record, index.data + static_cast<size_t>(ref) * sizeof(StringRecord), sizeof(record));
+    return std::string_view(section(SnapshotSection::STRING_DATA).data + record.offset, record.length);
+}
+
+size_t SnapshotReader::recordCount(SnapshotSection id) const {
+    return static_cast<size_t>(section(id).recordCount);
+}
+
+const char* SnapshotReader::recordData(SnapshotSection id, size_t recordSize, size_t index) const {
+    const SectionView& view = section(id);
+    if (view.recordSize != recordSize || index >= view.recordCount) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "快照记录格式错误: 段 " + std::to_string(static_cast<uint32_t>(id)));
+    }
+    return view.data + index * recordSize;
+}
+
+const SnapshotReader::SectionView& SnapshotReader::section(SnapshotSection id) const {
+    auto it = sections_.find(static_cast<uint32_t>(id));
+    if (it == sections_.end()) {
+        throw SystemException(ErrorType::FILE_CORRUPTED, "快照缺少段: " + std::to_string(static_cast<uint32_t>(id)));
+    }
+    return it->second;
+}
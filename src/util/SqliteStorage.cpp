@@ -0,0 +1,591 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/SqliteStorage.h"
+#include "../../include/util/DataManager.h"
+#include "../../include/util/FileLock.h"
+#include "../../include/system/SystemException.h"
+#include "../../include/util/Logger.h"
+
+#include <sqlite3.h>
+#include <filesystem>
+#include <random>
+#include <unordered_map>
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr StorageTable ALL_TABLES[] = {StorageTable::USERS, StorageTable::COURSES, StorageTable::ENROLLMENTS};
+
+// 事务作用域：未提交时在析构中回滚
+class Transaction {
+public:
+    explicit Transaction(sqlite3* db) : db_(db) {
+        if (sqlite3_exec(db_, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw SystemException(ErrorType::LOCK_FAILURE, std::string("开始SQLite事务失败: ") + sqlite3_errmsg(db_));
+        }
+    }
+
+    ~Transaction() {
+        if (!committed_) {
+            sqlite3_exec(db_, "ROLLBACK", nullptr, nullptr, nullptr);
+        }
+    }
+
+    void commit() {
+        if (sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw SystemException(ErrorType::OPERATION_FAILED, std::string("提交SQLite事务失败: ") + sqlite3_errmsg(db_));
+        }
+        committed_ = true;
+    }
+
+private:
+    sqlite3* db_;
+    bool committed_ = false;
+};
+
+// 重置语句以便下次使用
+struct StatementReset {
+    sqlite3_stmt* stmt;
+    ~StatementReset() {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+};
+
+void bindText(sqlite3_stmt* stmt, int index, const json& value) {
+    std::string text = value.is_string() ? value.get<std::string>() : value.dump();
+    sqlite3_bind_text(stmt, index, text.data(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+}
+
+// 独立只读连接上的读事务：WAL模式下读事务固定在开始时的数据库版本，不阻塞写入者
+class SqliteSnapshot : public StorageSnapshot {
+public:
+    explicit SqliteSnapshot(const std::string& path) {
+        if (sqlite3_open_v2(path.c_str(), &db_, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+            std::string message = db_ ? sqlite3_errmsg(db_) : "内存不足";
+            sqlite3_close(db_);
+            throw SystemException(ErrorType::FILE_ACCESS_DENIED, "打开SQLite数据库失败: " + path + " - " + message);
+        }
+        sqlite3_busy_timeout(db_, 5000);
+        // 读事务在第一条查询时才取得快照，立即读取一次元数据使时间点固定在打开时
+        if (sqlite3_exec(db_, "BEGIN; SELECT value FROM meta WHERE key = 'generation'", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            std::string message = sqlite3_errmsg(db_);
+            sqlite3_close(db_);
+            throw SystemException(ErrorType::OPERATION_FAILED, "开始SQLite读事务失败: " + message);
+        }
+    }
+
+    ~SqliteSnapshot() override {
+        sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr);
+        sqlite3_close(db_);
+    }
+
+    bool scan(StorageTable table, const std::function<void(json&)>& visitor) override {
+        return query(std::string("SELECT record FROM ") + storageTableName(table) + " ORDER BY " + keyList(table), nullptr,
+            [&visitor](sqlite3_stmt* stmt) {
+                const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+                json record = json::parse(text, text + sqlite3_column_bytes(stmt, 0));
+                visitor(record);
+            }) > 0;
+    }
+
+    std::vector<std::string> archivedTerms() override {
+        std::vector<std::string> terms;
+        query(std::string("SELECT term FROM ") + storageTableName(StorageTable::COURSES) + "_archive UNION "
+              "SELECT term FROM " + storageTableName(StorageTable::ENROLLMENTS) + "_archive ORDER BY term", nullptr,
+            [&terms](sqlite3_stmt* stmt) {
+                terms.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)), sqlite3_column_bytes(stmt, 0));
+            });
+        return terms;
+    }
+
+    bool scanArchive(StorageTable table, const std::string& term, const std::function<void(json&)>& visitor) override {
+        return query(std::string("SELECT record FROM ") + storageTableName(table) + "_archive WHERE term = ? ORDER BY "
+                     + keyList(table), &term,
+            [&visitor](sqlite3_stmt* stmt) {
+                const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+                json record = json::parse(text, text + sqlite3_column_bytes(stmt, 0));
+                visitor(record);
+            }) > 0;
+    }
+
+private:
+    static std::string keyList(StorageTable table) {
+        std::string keys;
+        for (const auto& column : storageColumns(table)) {
+            if (column.primaryKey) {
+                keys += (keys.empty() ? "" : ", ") + std::string(column.column);
+            }
+        }
+        return keys;
+    }
+
+    // 在读事务中执行查询，每行调用一次row；term非空时绑定为第一个参数。返回行数
+    size_t query(const std::string& sql, const std::string* term, const std::function<void(sqlite3_stmt*)>& row) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            throw SystemException(ErrorType::OPERATION_FAILED, std::string("准备SQL语句失败: ") + sqlite3_errmsg(db_));
+        }
+        if (term) {
+            sqlite3_bind_text(stmt, 1, term->data(), static_cast<int>(term->size()), SQLITE_TRANSIENT);
+        }
+
+        size_t count = 0;
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            row(stmt);
+            ++count;
+        }
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            throw SystemException(ErrorType::OPERATION_FAILED, std::string("读取数据表失败: ") + sqlite3_errmsg(db_));
+        }
+        return count;
+    }
+
+    sqlite3* db_ = nullptr;
+};
+
+} // namespace
+
+SqliteStorage::SqliteStorage(const std::string& path) : path_(path) {
+    created_ = !std::filesystem::exists(path_);
+
+    if (sqlite3_open_v2(path_.c_str(), &db_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        std::string message = db_ ? sqlite3_errmsg(db_) : "内存不足";
+        sqlite3_close(db_);
+        db_ = nullptr;
+        throw SystemException(ErrorType::FILE_ACCESS_DENIED, "打开SQLite数据库失败: " + path_ + " - " + message);
+    }
+
+    try {
+        sqlite3_busy_timeout(db_, 5000); // 与管理器锁一致的5秒超时
+        exec("PRAGMA journal_mode=WAL");
+        exec("PRAGMA synchronous=NORMAL");
+        createSchema();
+    } catch (...) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+        throw;
+    }
+
+    LOG_INFO("已打开SQLite数据库: " + path_);
+}
+
+SqliteStorage::~SqliteStorage() {
+    for (auto& stmts : statements_) {
+        sqlite3_finalize(stmts.upsert);
+        sqlite3_finalize(stmts.remove);
+        sqlite3_finalize(stmts.scan);
+        sqlite3_finalize(stmts.find);
+        sqlite3_finalize(stmts.clear);
+        sqlite3_finalize(stmts.archiveUpsert);
+        sqlite3_finalize(stmts.archiveScan);
+        sqlite3_finalize(stmts.archiveClear);
+        sqlite3_finalize(stmts.archiveClearAll);
+    }
+    sqlite3_close(db_);
+}
+
+bool SqliteStorage::scan(StorageTable table, const RecordVisitor& visitor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return scanRows(table, visitor) > 0;
+}
+
+std::optional<json> SqliteStorage::fetch(StorageTable table, const json& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return findRow(table, key);
+}
+
+bool SqliteStorage::replaceAll(StorageTable table, RowVersions* versions,
+                               const std::function<void(const RecordSink&)>& producer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FileLock directoryLock(DataManager::getInstance().getDataFilePath(DataManager::LOCK_FILE)); // 使数据清单的代数与提交顺序一致
+    Transaction transaction(db_);
+
+    // 版本检查与替换在同一写事务中，其他连接无法插入修改
+    std::unordered_map<std::string, json> stored;
+    if (versions) {
+        scanRows(table, [&](json& record) {
+            std::string key = storageRowKey(table, record).dump();
+            stored.emplace(std::move(key), std::move(record));
+        });
+        if (!versionsMatch(table, stored, *versions)) {
+            return false; // 事务在析构时回滚
+        }
+    }
+
+    sqlite3_stmt* clear = statements(table).clear;
+    {
+        StatementReset reset{clear};
+        check(sqlite3_step(clear) == SQLITE_DONE ? SQLITE_OK : sqlite3_errcode(db_), "清空数据表");
+    }
+
+    RowVersions written;
+    producer([&](const json& record) {
+        upsertRow(table, versions ? withReplacedVersion(table, record, stored, *versions, written) : record);
+    });
+
+    bumpGeneration();
+    transaction.commit();
+    DataManager::getInstance().manifest().bump(table);
+    if (versions) {
+        *versions = std::move(written);
+    }
+    return true;
+}
+
+bool SqliteStorage::applyRows(StorageTable table, const std::vector<RowChange>& changes, std::vector<RowConflict>& conflicts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FileLock directoryLock(DataManager::getInstance().getDataFilePath(DataManager::LOCK_FILE));
+    Transaction transaction(db_);
+
+    size_t applied = 0;
+    for (const auto& change : changes) {
+        if (change.expectedVersion) {
+            // 版本检查与写入在同一写事务中，其他连接无法插入修改
+            std::optional<json> current = findRow(table, change.key);
+            uint64_t version = current ? recordVersion(*current) : 0;
+            if (version != *change.expectedVersion) {
+                conflicts.push_back({change.key, std::move(current)});
+                continue;
+            }
+        }
+        if (change.record) {
+            upsertRow(table, *change.record);
+        } else {
+            removeRow(table, change.key);
+        }
+        ++applied;
+    }
+    if (applied == 0) {
+        return true; // 事务在析构时回滚
+    }
+
+    bumpGeneration();
+    transaction.commit();
+    DataManager::getInstance().manifest().bump(table);
+    return true;
+}
+
+uint64_t SqliteStorage::dataStamp() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t instance = static_cast<uint64_t>(readMeta("instance"));
+    uint64_t generation = static_cast<uint64_t>(readMeta("generation"));
+    return instance ^ (generation * 0x9E3779B97F4A7C15ULL);
+}
+
+std::unique_ptr<StorageSnapshot> SqliteStorage::openSnapshot() {
+    return std::make_unique<SqliteSnapshot>(path_);
+}
+
+std::vector<std::string> SqliteStorage::archivedTerms() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sqlite3_stmt* stmt = prepare(std::string("SELECT term FROM ") + storageTableName(StorageTable::COURSES) + "_archive UNION "
+                                 "SELECT term FROM " + storageTableName(StorageTable::ENROLLMENTS) + "_archive ORDER BY term");
+    std::vector<std::string> terms;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        terms.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)), sqlite3_column_bytes(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    check(rc == SQLITE_DONE ? SQLITE_OK : rc, "读取归档学期");
+    return terms;
+}
+
+bool SqliteStorage::scanArchive(StorageTable table, const std::string& term, const RecordVisitor& visitor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sqlite3_stmt* stmt = archiveStatements(table).archiveScan;
+    StatementReset reset{stmt};
+    sqlite3_bind_text(stmt, 1, term.data(), static_cast<int>(term.size()), SQLITE_TRANSIENT);
+
+    size_t count = 0;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        int length = sqlite3_column_bytes(stmt, 0);
+        json record = json::parse(text, text + length);
+        visitor(record);
+        ++count;
+    }
+    check(rc == SQLITE_DONE ? SQLITE_OK : rc, "读取归档数据");
+    return count > 0;
+}
+
+bool SqliteStorage::archiveRows(StorageTable table, const std::string& term, const std::vector<json>& records) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FileLock directoryLock(DataManager::getInstance().getDataFilePath(DataManager::LOCK_FILE));
+    Transaction transaction(db_);
+
+    for (const auto& record : records) {
+        upsertArchiveRow(table, term, record);
+    }
+
+    transaction.commit();
+    return true;
+}
+
+bool SqliteStorage::replaceImage(const std::vector<TableImage>& images, bool withArchives) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FileLock directoryLock(DataManager::getInstance().getDataFilePath(DataManager::LOCK_FILE));
+    Transaction transaction(db_);
+
+    for (StorageTable table : ALL_TABLES) {
+        StatementReset reset{statements(table).clear};
+        check(sqlite3_step(statements(table).clear) == SQLITE_DONE ? SQLITE_OK : sqlite3_errcode(db_), "清空数据表");
+        if (withArchives && table != StorageTable::USERS) {
+            StatementReset archiveReset{statements(table).archiveClearAll};
+            check(sqlite3_step(statements(table).archiveClearAll) == SQLITE_DONE ? SQLITE_OK : sqlite3_errcode(db_), "清空归档表");
+        }
+    }
+
+    for (const auto& image : images) {
+        if (image.term.empty()) {
+            image.producer([this, &image](const json& record) {
+                upsertRow(image.table, record);
+            });
+            continue;
+        }
+        if (!withArchives) {
+            sqlite3_stmt* clear = archiveStatements(image.table).archiveClear;
+            StatementReset reset{clear};
+            sqlite3_bind_text(clear, 1, image.term.data(), static_cast<int>(image.term.size()), SQLITE_TRANSIENT);
+            check(sqlite3_step(clear) == SQLITE_DONE ? SQLITE_OK : sqlite3_errcode(db_), "清空归档分区");
+        }
+        image.producer([this, &image](const json& record) {
+            upsertArchiveRow(image.table, image.term, record);
+        });
+    }
+
+    // 初始化标记与数据在同一事务中提交，中途失败的导入下次启动时重做
+    exec("UPDATE meta SET value = 1 WHERE key = 'initialized'");
+    bumpGeneration();
+    transaction.commit();
+    for (StorageTable table : ALL_TABLES) {
+        DataManager::getInstance().manifest().bump(table);
+    }
+    return true;
+}
+
+bool SqliteStorage::isInitialized() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return readMeta("initialized") != 0;
+}
+
+void SqliteStorage::exec(const char* sql) {
+    char* error = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &error) != SQLITE_OK) {
+        std::string message = error ? error : "未知错误";
+        sqlite3_free(error);
+        throw SystemException(ErrorType::OPERATION_FAILED, "执行SQL失败: " + message);
+    }
+}
+
+void SqliteStorage::createSchema() {
+    // 元数据：实例ID区分重建的数据库，代数在每次写事务中递增
+    exec("CREATE TABLE IF NOT EXISTS meta (key TEXT NOT NULL PRIMARY KEY, value INTEGER NOT NULL) WITHOUT ROWID");
+    std::random_device random;
+    int64_t instance = (static_cast<int64_t>(random()) << 31) ^ static_cast<int64_t>(random());
+    exec(("INSERT OR IGNORE INTO meta (key, value) VALUES ('instance', " + std::to_string(instance) + ")").c_str());
+    exec("INSERT OR IGNORE INTO meta (key, value) VALUES ('generation', 0)");
+    exec(created_ ? "INSERT OR IGNORE INTO meta (key, value) VALUES ('initialized', 0)"
+                  : "INSERT OR IGNORE INTO meta (key, value) VALUES ('initialized', 1)");
+
+    for (StorageTable table : ALL_TABLES) {
+        const std::string name = storageTableName(table);
+        const auto& columns = storageColumns(table);
+
+        std::string columnList;    // 建表列定义
+        std::string keyList;       // 主键列
+        std::string insertColumns; // 插入列
+        std::string placeholders;
+        std::string keyMatch;      // 按主键匹配
+        for (const auto& column : columns) {
+            columnList += std::string(column.column) + " TEXT NOT NULL, ";
+            insertColumns += std::string(column.column) + ", ";
+            placeholders += "?, ";
+            if (column.primaryKey) {
+                keyList += (keyList.empty() ? "" : ", ") + std::string(column.column);
+                keyMatch += (keyMatch.empty() ? "" : " AND ") + std::string(column.column) + " = ?";
+            }
+        }
+
+        exec(("CREATE TABLE IF NOT EXISTS " + name + " (" + columnList +
+              "record TEXT NOT NULL, PRIMARY KEY (" + keyList + ")) WITHOUT ROWID").c_str());
+
+        // 查询列和复合主键的非首列单独建索引
+        bool firstKey = true;
+        for (const auto& column : columns) {
+            if (column.primaryKey && firstKey) {
+                firstKey = false;
+                continue;
+            }
+            exec(("CREATE INDEX IF NOT EXISTS idx_" + name + "_" + column.column +
+                  " ON " + name + " (" + column.column + ")").c_str());
+        }
+
+        Statements& stmts = statements(table);
+        stmts.upsert = prepare("INSERT OR REPLACE INTO " + name + " (" + insertColumns + "record) VALUES (" + placeholders + "?)");
+        stmts.remove = prepare("DELETE FROM " + name + " WHERE " + keyMatch);
+        stmts.scan = prepare("SELECT record FROM " + name + " ORDER BY " + keyList);
+        stmts.find = prepare("SELECT record FROM " + name + " WHERE " + keyMatch);
+        stmts.clear = prepare("DELETE FROM " + name);
+
+        if (table == StorageTable::USERS) {
+            continue;
+        }
+        // 归档表：按学期分区，只保存主键列和完整记录
+        std::string archiveColumns;
+        std::string archiveKeys;
+        std::string archivePlaceholders;
+        for (const auto& column : columns) {
+            if (column.primaryKey) {
+                archiveColumns += std::string(column.column) + " TEXT NOT NULL, ";
+                archiveKeys += ", " + std::string(column.column);
+                archivePlaceholders += "?, ";
+            }
+        }
+        exec(("CREATE TABLE IF NOT EXISTS " + name + "_archive (term TEXT NOT NULL, " + archiveColumns +
+              "record TEXT NOT NULL, PRIMARY KEY (term" + archiveKeys + ")) WITHOUT ROWID").c_str());
+        stmts.archiveUpsert = prepare("INSERT OR REPLACE INTO " + name + "_archive (term" + archiveKeys + ", record) VALUES (?, "
+                                      + archivePlaceholders + "?)");
+        stmts.archiveScan = prepare("SELECT record FROM " + name + "_archive WHERE term = ? ORDER BY term" + archiveKeys);
+        stmts.archiveClear = prepare("DELETE FROM " + name + "_archive WHERE term = ?");
+        stmts.archiveClearAll = prepare("DELETE FROM " + name + "_archive");
+    }
+}
+
+sqlite3_stmt* SqliteStorage::prepare(const std::string& sql) {
+    sqlite3_stmt* stmt = nullptr;
+    check(sqlite3_prepare_v3(db_, sql.c_str(), static_cast<int>(sql.size()), SQLITE_PREPARE_PERSISTENT, &stmt, nullptr),
+          "编译SQL语句");
+    return stmt;
+}
+
+SqliteStorage::Statements& SqliteStorage::statements(StorageTable table) {
+    return statements_[static_cast<size_t>(table)];
+}
+
+SqliteStorage::Statements& SqliteStorage::archiveStatements(StorageTable table) {
+    Statements& stmts = statements(table);
+    if (!stmts.archiveScan) {
+        throw SystemException(ErrorType::OPERATION_FAILED, std::string("数据表没有归档分区: ") + storageTableName(table));
+    }
+    return stmts;
+}
+
+void SqliteStorage::upsertRow(StorageTable table, const json& record) {
+    sqlite3_stmt* stmt = statements(table).upsert;
+    StatementReset reset{stmt};
+
+    int index = 1;
+    for (const auto& column : storageColumns(table)) {
+        bindText(stmt, index++, record.at(column.field));
+    }
+    std::string text = record.dump(); // 完整记录以紧凑JSON保存
+    sqlite3_bind_text(stmt, index, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+
+    check(sqlite3_step(stmt) == SQLITE_DONE ? SQLITE_OK : sqlite3_errcode(db_), "写入数据行");
+}
+
+void SqliteStorage::removeRow(StorageTable table, const json& key) {
+    sqlite3_stmt* stmt = statements(table).remove;
+    StatementReset reset{stmt};
+
+    int index = 1;
+    for (const auto& column : storageColumns(table)) {
+        if (column.primaryKey) {
+            bindText(stmt, index++, key.at(column.field));
+        }
+    }
+
+    check(sqlite3_step(stmt) == SQLITE_DONE ? SQLITE_OK : sqlite3_errcode(db_), "删除数据行");
+}
+
+void SqliteStorage::upsertArchiveRow(StorageTable table, const std::string& term, const json& record) {
+    sqlite3_stmt* stmt = archiveStatements(table).archiveUpsert;
+    StatementReset reset{stmt};
+    sqlite3_bind_text(stmt, 1, term.data(), static_cast<int>(term.size()), SQLITE_TRANSIENT);
+    int index = 2;
+    for (const auto& column : storageColumns(table)) {
+        if (column.primaryKey) {
+            bindText(stmt, index++, record.at(column.field));
+        }
+    }
+    std::string text = record.dump();
+    sqlite3_bind_text(stmt, index, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+    check(sqlite3_step(stmt) == SQLITE_DONE ? SQLITE_OK : sqlite3_errcode(db_), "写入归档行");
+}
+
+size_t SqliteStorage::scanRows(StorageTable table, const RecordVisitor& visitor) {
+    sqlite3_stmt* stmt = statements(table).scan;
+    StatementReset reset{stmt};
+
+    size_t count = 0;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        int length = sqlite3_column_bytes(stmt, 0);
+        json record = json::parse(text, text + length);
+        visitor(record);
+        ++count;
+    }
+    check(rc == SQLITE_DONE ? SQLITE_OK : rc, "读取数据表");
+    return count;
+}
+
+std::optional<json> SqliteStorage::findRow(StorageTable table, const json& key) {
+    sqlite3_stmt* stmt = statements(table).find;
+    StatementReset reset{stmt};
+
+    int index = 1;
+    for (const auto& column : storageColumns(table)) {
+        if (column.primaryKey) {
+            bindText(stmt, index++, key.at(column.field));
+        }
+    }
+
+    int rc = sqlite3_step(stmt);
+    if (rc == SQLITE_ROW) {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        int length = sqlite3_column_bytes(stmt, 0);
+        return std::make_optional<json>(json::parse(text, text + length));
+    }
+    check(rc == SQLITE_DONE ? SQLITE_OK : rc, "读取数据行");
+    return std::nullopt;
+}
+
+void SqliteStorage::bumpGeneration() {
+    exec("UPDATE meta SET value = value + 1 WHERE key = 'generation'");
+}
+
+int64_t SqliteStorage::readMeta(const char* key) {
+    sqlite3_stmt* stmt = prepare(std::string("SELECT value FROM meta WHERE key = '") + key + "'");
+    int64_t value = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        value = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+void SqliteStorage::check(int rc, const char* action) const {
+    if (rc != SQLITE_OK) {
+        throw SystemException(ErrorType::OPERATION_FAILED, std::string(action) + "失败: " + sqlite3_errmsg(db_));
+    }
+}
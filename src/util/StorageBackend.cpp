@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "../../include/util/StorageBackend.h"
+#include "../../include/util/Logger.h"
+
+#include <unordered_map>
+
+bool StorageBackend::applyRowsMerging(StorageTable table, std::vector<RowChange> changes, const MergeFunction& merge,
+                                      std::vector<RowChange>& written, std::vector<RowConflict>& rejected) {
+    for (int attempt = 0; attempt < MAX_MERGE_ATTEMPTS && !changes.empty(); ++attempt) {
+        for (auto& change : changes) {
+            if (change.record && change.expectedVersion) {
+                (*change.record)[RECORD_VERSION_FIELD] = *change.expectedVersion + 1;
+            }
+        }
+
+        std::vector<RowConflict> conflicts;
+        if (!applyRows(table, changes, conflicts)) {
+            return false;
+        }
+
+        std::unordered_map<std::string, const RowConflict*> conflicted; // 主键 -> 冲突
+        for (const auto& conflict : conflicts) {
+            conflicted[conflict.key.dump()] = &conflict;
+        }
+
+        std::vector<RowChange> retry;
+        for (auto& change : changes) {
+            auto it = conflicted.find(change.key.dump());
+            if (it == conflicted.end()) {
+                written.push_back(std::move(change));
+                continue;
+            }
+            const RowConflict& conflict = *it->second;
+            std::optional<RowChange> merged = merge(change, conflict);
+            if (!merged) {
+                rejected.push_back(conflict);
+                continue;
+            }
+            merged->expectedVersion = conflict.current ? recordVersion(*conflict.current) : 0;
+            retry.push_back(std::move(*merged));
+        }
+        if (!retry.empty()) {
+            LOG_INFO(std::string("合并其他进程对") + storageTableName(table) + "的并发修改，共 "
+                + std::to_string(retry.size()) + " 行");
+        }
+        changes = std::move(retry);
+    }
+
+    if (!rejected.empty()) {
+        LOG_WARNING(std::string("与其他进程的修改冲突，放弃 ") + std::to_string(rejected.size()) + " 行"
+            + storageTableName(table) + "的本地修改");
+    }
+    if (!changes.empty()) {
+        LOG_WARNING(std::string("多次合并后仍有版本冲突：") + storageTableName(table) + "，稍后重试");
+        return false;
+    }
+    return rejected.empty();
+}
+
+bool StorageBackend::versionsMatch(StorageTable table, const std::unordered_map<std::string, nlohmann::json>& stored,
+                                   const RowVersions& versions) {
+    size_t conflicts = 0;
+    for (const auto& [key, record] : stored) {
+        auto it = versions.find(key);
+        if ((it != versions.end() ? it->second : 0) != recordVersion(record)) {
+            ++conflicts;
+        }
+    }
+    for (const auto& [key, version] : versions) {
+        if (version != 0 && stored.count(key) == 0) {
+            ++conflicts; // 已被其他进程删除
+        }
+    }
+    if (conflicts > 0) {
+        LOG_WARNING(std::string("整体保存") + storageTableName(table) + "时发现 " + std::to_string(conflicts)
+            + " 行已被其他进程修改，放弃本次保存");
+    }
+    return conflicts == 0;
+}
+
+nlohmann::json StorageBackend::withReplacedVersion(StorageTable table, const nlohmann::json& record,
+                                                   const std::unordered_map<std::string, nlohmann::json>& stored,
+                                                   const RowVersions& versions, RowVersions& written) {
+    std::string key = storageRowKey(table, record).dump();
+    nlohmann::json result = record;
+    result.erase(RECORD_VERSION_FIELD);
+
+    auto current = stored.find(key);
+    bool unchanged = false;
+    if (current != stored.end()) {
+        nlohmann::json storedRecord = current->second;
+        storedRecord.erase(RECORD_VERSION_FIELD);
+        unchanged = storedRecord == result;
+    }
+
+    uint64_t version;
+    if (unchanged) {
+        version = recordVersion(current->second); // 内容未变的行不改版本，其他进程不必与之合并
+    } else {
+        auto it = versions.find(key);
+        version = (it != versions.end() ? it->second : 0) + 1;
+    }
+    result[RECORD_VERSION_FIELD] = version;
+    written[std::move(key)] = version;
+    return result;
+}
+
+bool StorageBackend::upsert(StorageTable table, const nlohmann::json& record) {
+    std::vector<RowConflict> conflicts;
+    return applyRows(table, {RowChange{storageRowKey(table, record), std::make_optional<nlohmann::json>(record), std::nullopt}},
+                     conflicts);
+}
+
+bool StorageBackend::remove(StorageTable table, const nlohmann::json& key) {
+    std::vector<RowConflict> conflicts;
+    return applyRows(table, {RowChange{key, std::nullopt, std::nullopt}}, conflicts);
+}
+
+const char* storageTableName(StorageTable table) {
+    switch (table) {
+        case StorageTable::USERS:
+            return "users";
+        case StorageTable::COURSES:
+            return "courses";
+        case StorageTable::ENROLLMENTS:
+            return "enrollments";
+    }
+    return "";
+}
+
+const std::vector<StorageColumn>& storageColumns(StorageTable table) {
+    // 主键列在前；其余为建立索引的查询列
+    static const std::vector<StorageColumn> users = {
+        {"id", "id", true},
+        {"type", "type", false}
+    };
+    static const std::vector<StorageColumn> courses = {
+        {"id", "id", true},
+        {"teacher_id", "teacherId", false},
+        {"semester", "semester", false}
+    };
+    static const std::vector<StorageColumn> enrollments = {
+        {"student_id", "studentId", true},
+        {"course_id", "courseId", true}
+    };
+
+    switch (table) {
+        case StorageTable::USERS:
+            return users;
+        case StorageTable::COURSES:
+            return courses;
+        case StorageTable::ENROLLMENTS:
+            break;
+    }
+    return enrollments;
+}
+
+nlohmann::json storageRowKey(StorageTable table, const nlohmann::json& record) {
+    nlohmann::json key = nlohmann::json::object();
+    for (const auto& column : storageColumns(table)) {
+        if (column.primaryKey) {
+            key[column.field] = record.at(column.field);
+        }
+    }
+    return key;
+}
+
+uint64_t recordVersion(const nlohmann::json& record) {
+    auto it = record.find(RECORD_VERSION_FIELD);
+    return it != record.end() && it->is_number_unsigned() ? it->get<uint64_t>() : 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// 文本ID生成工具：构建时根据各语言文件生成I18nKeys.h
+// 用法：i18n_keygen <输出头文件> <语言文件>...
+// 每个键生成一个TextId枚举值（键名转为大写）和对应的键名表，I18nManager加载语言文件时按ID建立数组，
+// 调用处用getText(TextId::COURSE_ID)按下标取文本。
+// 任一语言文件缺少键、文本为空或占位符{n}与其他语言不一致时报错并返回非零，使构建失败；
+// 生成的内容未变化时不重写文件，避免无关的重新编译
+#include "../nlohmann/json.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+// 文本中出现的占位符{0}、{1}...
+std::set<std::string> placeholders(const std::string& text) {
+    static const std::regex pattern("\\{[0-9]+\\}");
+    std::set<std::string> found;
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), pattern); it != std::sregex_iterator(); ++it) {
+        found.insert(it->str());
+    }
+    return found;
+}
+
+std::string toEnumName(const std::string& key) {
+    std::string name = key;
+    for (char& c : name) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return name;
+}
+
+bool loadTexts(const std::string& path, std::map<std::string, std::string>& texts) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "无法打开语言文件: " << path << std::endl;
+        return false;
+    }
+    try {
+        json content = json::parse(file);
+        for (auto it = content.begin(); it != content.end(); ++it) {
+            if (!it.value().is_string()) {
+                std::cerr << path << ": 键 " << it.key() << " 的值不是字符串" << std::endl;
+                return false;
+            }
+            texts[it.key()] = it.value().get<std::string>();
+        }
+    } catch (const json::exception& e) {
+        std::cerr << "解析语言文件失败: " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "用法: " << argv[0] << " <输出头文件> <语言文件>..." << std::endl;
+        return 1;
+    }
+    std::string outputPath = argv[1];
+    std::vector<std::string> paths(argv + 2, argv + argc);
+    std::vector<std::map<std::string, std::string>> languages(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!loadTexts(paths[i], languages[i])) {
+            return 1;
+        }
+    }
+
+    // 所有语言文件中出现过的键都必须在每个语言文件中有非空的翻译
+    std::set<std::string> keys;
+    for (const auto& texts : languages) {
+        for (const auto& entry : texts) {
+            keys.insert(entry.first);
+        }
+    }
+    static const std::regex keyPattern("[a-z][a-z0-9_]*");
+    int errors = 0;
+    for (const std::string& key : keys) {
+        if (!std::regex_match(key, keyPattern)) {
+            std::cerr << "键名只能由小写字母、数字和下划线组成且以字母开头: " << key << std::endl;
+            ++errors;
+            continue;
+        }
+        const std::string* reference = nullptr;
+        for (size_t i = 0; i < languages.size(); ++i) {
+            auto it = languages[i].find(key);
+            if (it == languages[i].end() || it->second.empty()) {
+                std::cerr << paths[i] << ": 缺少键 " << key << " 的翻译" << std::endl;
+                ++errors;
+            } else if (reference == nullptr) {
+                reference = &it->second;
+            } else if (placeholders(it->second) != placeholders(*reference)) {
+                std::cerr << paths[i] << ": 键 " << key << " 的占位符与其他语言不一致" << std::endl;
+                ++errors;
+            }
+        }
+    }
+    if (errors > 0) {
+        std::cerr << "语言文件检查失败，共 " << errors << " 处错误" << std::endl;
+        return 1;
+    }
+
+    std::ostringstream out;
+    out << "// 由i18n_keygen根据语言文件生成，请勿手工修改\n"
+        << "#pragma once\n\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n\n"
+        << "// 文本ID，与语言文件中的键一一对应\n"
+        << "enum class TextId : uint16_t {\n";
+    for (const std::string& key : keys) {
+        out << "    " << toEnumName(key) << ",\n";
+    }
+    out << "};\n\n"
+        << "inline constexpr size_t TEXT_ID_COUNT = " << keys.size() << ";\n\n"
+        << "// 下标为TextId的键名\n"
+        << "inline constexpr const char* TEXT_KEYS[TEXT_ID_COUNT] = {\n";
+    for (const std::string& key : keys) {
+        out << "    \"" << key << "\",\n";
+    }
+    out << "};\n";
+
+    std::string generated = out.str();
+    std::ifstream existing(outputPath, std::ios::binary);
+    if (existing.is_open()) {
+        std::string current((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+        if (current == generated) {
+            return 0;
+        }
+    }
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    output << generated;
+    if (!output) {
+        std::cerr << "写入失败: " << outputPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
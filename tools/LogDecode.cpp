@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// 二进制日志解码工具：把course_system.binlog还原为与文本日志相同格式的行
+// 用法：course_log_decode <日志目录或.binlog文件> [--level=DEBUG|INFO|WARNING|ERROR|CRITICAL] [--source]
+// 输出级别不低于指定级别的记录（默认DEBUG）；--source在每行末尾附加调用处的文件名和行号。
+// 同一批次内的记录已按时间排序，多个进程追加的批次按写入文件的顺序输出
+#include "../include/util/BinaryLogger.h"
+#include "../include/util/MappedFile.h"
+
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// 文件中的格式定义
+struct Format {
+    LogLevel level = LogLevel::INFO;
+    uint32_t line = 0;
+    std::string file;
+    std::string format;
+};
+
+// 按小端序顺序读取的游标，越界后ok()为false
+class Reader {
+public:
+    Reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template<typename T>
+    T read() {
+        T value{};
+        if (size_ - position_ < sizeof(T)) {
+            failed_ = true;
+            position_ = size_;
+            return value;
+        }
+        std::memcpy(&value, data_ + position_, sizeof(T));
+        position_ += sizeof(T);
+        return value;
+    }
+
+    std::string_view bytes(size_t length) {
+        if (size_ - position_ < length) {
+            failed_ = true;
+            position_ = size_;
+            return {};
+        }
+        std::string_view view(data_ + position_, length);
+        position_ += length;
+        return view;
+    }
+
+    std::string_view shortString() {
+        return bytes(read<uint16_t>());
+    }
+
+    bool atEnd() const { return position_ >= size_; }
+
+    bool ok() const { return !failed_; }
+
+    size_t position() const { return position_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t position_ = 0;
+    bool failed_ = false;
+};
+
+bool parseLevel(std::string_view tag, LogLevel& level) {
+    for (LogLevel candidate : {LogLevel::DEBUG, LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL}) {
+        if (tag == Logger::logLevelToString(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// "YYYY-MM-DD HH:MM:SS.mmm"，与文本日志的时间戳一致
+std::string formatTimestamp(int64_t nanoseconds) {
+    int64_t ms = nanoseconds / 1000000;
+    int64_t second = ms / 1000;
+    int millis = static_cast<int>(ms % 1000);
+    if (millis < 0) {
+        millis += 1000;
+        --second;
+    }
+    std::time_t time = static_cast<std::time_t>(second);
+    std::tm local{};
+#if defined(__unix__) || defined(__APPLE__)
+    bool converted = localtime_r(&time, &local) != nullptr;
+#else
+    bool converted = localtime_s(&local, &time) == 0;
+#endif
+    char buffer[32];
+    if (!converted || std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local) == 0) {
+        std::strcpy(buffer, "0000-00-00 00:00:00");
+    }
+    char millisText[8];
+    std::snprintf(millisText, sizeof(millisText), ".%03d", millis);
+    return std::string(buffer) + millisText;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "用法: " << argv[0] << " <日志目录或.binlog文件> [--level=DEBUG|INFO|WARNING|ERROR|CRITICAL] [--source]"
+                  << std::endl;
+        return 1;
+    }
+    std::string path = argv[1];
+    LogLevel minLevel = LogLevel::DEBUG;
+    bool showSource = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--source") {
+            showSource = true;
+        } else if (arg.rfind("--level=", 0) != 0 || !parseLevel(arg.substr(std::string("--level=").size()), minLevel)) {
+            std::cerr << "未知参数: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (std::filesystem::is_directory(path)) {
+        path += std::string("/") + BinaryLogger::LOG_FILE;
+    }
+
+    MappedFile log;
+    try {
+        log = MappedFile(path);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (log.size() < sizeof(BinaryLogger::MAGIC)
+        || std::memcmp(log.data(), BinaryLogger::MAGIC, sizeof(BinaryLogger::MAGIC)) != 0) {
+        std::cerr << "不是二进制日志文件: " << path << std::endl;
+        return 1;
+    }
+
+    std::unordered_map<uint32_t, std::unordered_map<uint32_t, Format>> formats; // 进程ID -> 格式ID -> 格式
+    Reader file(log.data() + sizeof(BinaryLogger::MAGIC), log.size() - sizeof(BinaryLogger::MAGIC));
+    size_t unknown = 0;
+    std::string line;
+    while (!file.atEnd()) {
+        char kind = file.read<char>();
+        if (kind == BinaryLogger::MAGIC[0]) {
+            file.bytes(sizeof(BinaryLogger::MAGIC) - 1); // 多个进程同时创建文件时重复写入的文件头
+            continue;
+        }
+        if (kind != 'B') {
+            std::cerr << "文件在偏移 " << sizeof(BinaryLogger::MAGIC) + file.position() - 1 << " 处损坏，停止解码" << std::endl;
+            return 1;
+        }
+        uint32_t pid = file.read<uint32_t>();
+        uint32_t length = file.read<uint32_t>();
+        std::string_view body = file.bytes(length);
+        if (!file.ok()) {
+            std::cerr << "最后一个批次不完整，已忽略" << std::endl;
+            break;
+        }
+
+        auto& processFormats = formats[pid];
+        Reader batch(body.data(), body.size());
+        while (!batch.atEnd() && batch.ok()) {
+            char entry = batch.read<char>();
+            if (entry == 'F') {
+                uint32_t id = batch.read<uint32_t>();
+                Format& format = processFormats[id];
+                format.level = static_cast<LogLevel>(batch.read<uint8_t>());
+                format.line = batch.read<uint32_t>();
+                format.file = std::string(batch.shortString());
+                format.format = std::string(batch.shortString());
+                continue;
+            }
+            if (entry != 'R') {
+                break;
+            }
+
+            uint16_t size = batch.read<uint16_t>();
+            if (size < BinaryLogger::RECORD_HEADER_SIZE) {
+                break;
+            }
+            uint32_t id = batch.read<uint32_t>();
+            int64_t timestamp = batch.read<int64_t>();
+            std::string_view args = batch.bytes(size - BinaryLogger::RECORD_HEADER_SIZE);
+            auto it = processFormats.find(id);
+            if (it == processFormats.end()) {
+                ++unknown;
+                continue;
+            }
+            const Format& format = it->second;
+            if (format.level < minLevel) {
+                continue;
+            }
+
+            line = "[" + formatTimestamp(timestamp) + "] [" + Logger::logLevelToString(format.level) + "] ";
+            for (char c : BinaryLogger::render(format.format, args.data(), args.size())) {
+                if (c == '\n') {
+                    line += "\\n"; // 与文本日志一致，一条记录占一行
+                } else {
+                    line += c;
+                }
+            }
+            if (showSource) {
+                line += " (" + format.file + ":" + std::to_string(format.line) + ")";
+            }
+            std::cout << line << '\n';
+        }
+        if (!batch.ok()) {
+            std::cerr << "进程 " << pid << " 的一个批次内容损坏，已跳过其余记录" << std::endl;
+        }
+    }
+    if (unknown > 0) {
+        std::cerr << "忽略 " << unknown << " 条缺少格式定义的记录" << std::endl;
+    }
+    return 0;
+}
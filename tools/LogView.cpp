@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2025 哲神
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// 日志查看工具：从单一日志文件（course_system.log）按级别生成视图
+// 用法：course_log_view <日志目录> [--level=DEBUG|INFO|WARNING|ERROR|CRITICAL]
+// 输出级别不低于指定级别的记录（默认INFO），与原先各级别日志文件的内容一致。
+// WARNING及以上直接按偏移索引定位，不扫描整个日志文件；更低级别顺序扫描并按行内级别标记筛选，
+// 等价于 grep -E '^\[[^]]*\] \[(INFO|WARNING|ERROR|CRITICAL)\]' course_system.log
+#include "../include/util/Logger.h"
+#include "../include/util/MappedFile.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// 日志行的级别标记：第二个方括号中的内容，格式不符时返回空
+std::string_view levelTag(std::string_view line) {
+    size_t first = line.find("] [");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    size_t begin = first + 3;
+    size_t end = line.find(']', begin);
+    return end == std::string_view::npos ? std::string_view() : line.substr(begin, end - begin);
+}
+
+bool parseLevel(std::string_view tag, LogLevel& level) {
+    for (LogLevel candidate : {LogLevel::DEBUG, LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL}) {
+        if (tag == Logger::logLevelToString(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 读取一个索引文件中的全部偏移
+void readIndex(const std::string& path, std::vector<uint64_t>& offsets) {
+    std::ifstream file(path, std::ios::binary);
+    unsigned char bytes[8];
+    while (file.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+        uint64_t offset = 0;
+        for (int i = 0; i < 8; ++i) {
+            offset |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        offsets.push_back(offset);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "用法: " << argv[0] << " <日志目录> [--level=DEBUG|INFO|WARNING|ERROR|CRITICAL]" << std::endl;
+        return 1;
+    }
+    std::string logDir = argv[1];
+    LogLevel minLevel = LogLevel::INFO;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--level=", 0) != 0 || !parseLevel(arg.substr(std::string("--level=").size()), minLevel)) {
+            std::cerr << "未知参数: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    MappedFile log;
+    try {
+        log = MappedFile(logDir + "/" + Logger::LOG_FILE);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::string_view content(log.data(), log.size());
+
+    if (minLevel < LogLevel::WARNING) {
+        size_t begin = 0;
+        while (begin < content.size()) {
+            size_t end = content.find('\n', begin);
+            if (end == std::string_view::npos) {
+                end = content.size();
+            }
+            std::string_view line = content.substr(begin, end - begin);
+            LogLevel level;
+            if (parseLevel(levelTag(line), level) && level >= minLevel) {
+                std::cout << line << '\n';
+            }
+            begin = end + 1;
+        }
+        return 0;
+    }
+
+    // 多个进程的索引项可能交错，合并后按偏移排序即为日志中的顺序
+    std::vector<uint64_t> offsets;
+    for (LogLevel level : {LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL}) {
+        if (level >= minLevel) {
+            readIndex(logDir + "/" + Logger::indexFileName(level), offsets);
+        }
+    }
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+
+    size_t stale = 0;
+    for (uint64_t offset : offsets) {
+        if (offset >= content.size() || (offset > 0 && content[offset - 1] != '\n')) {
+            ++stale; // 日志文件被截断或替换后残留的索引项
+            continue;
+        }
+        size_t end = content.find('\n', offset);
+        std::cout << content.substr(offset, end == std::string_view::npos ? std::string_view::npos : end - offset) << '\n';
+    }
+    if (stale > 0) {
+        std::cerr << "忽略 " << stale << " 个无效的索引项" << std::endl;
+    }
+    return 0;
+}